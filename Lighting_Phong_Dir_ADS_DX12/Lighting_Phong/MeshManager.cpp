@@ -12,6 +12,11 @@ CMeshManager::~CMeshManager()
 {
 	if (m_d3dDevice != nullptr)
 		FlushCommandQueue();
+
+	m_FrameScheduler.Report("Frame scheduler");
+	m_FramePacer.Report("Frame pacing");
+	m_Timer.Report("Frame limiter");
+	m_FrameStats.Report("Frame stats");
 }
 
 void CMeshManager::EnableDebugLayer_CreateFactory()
@@ -97,29 +102,44 @@ void CMeshManager::Create_CommandList_Allocator_Queue()
 
 void CMeshManager::Create_SwapChain()
 {
+	m_FramePacer.Release();
 	m_SwapChain.Reset();
 
-	DXGI_SWAP_CHAIN_DESC sd;
-	sd.BufferDesc.Width = m_ClientWidth;
-	sd.BufferDesc.Height = m_ClientHeight;
-	sd.BufferDesc.RefreshRate.Numerator = 60;
-	sd.BufferDesc.RefreshRate.Denominator = 1;
-	sd.BufferDesc.Format = m_BackBufferFormat;
-	sd.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-	sd.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+	//waitable object   , tearing - FRAME_PACING_MAX_THROUGHPUT
+	m_TearingSupported = Check_Tearing_Support(m_dxgiFactory.Get());
+	m_SwapChainFlags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH |
+		Get_Frame_Pacing_Swap_Chain_Flags(m_TearingSupported);
+
+	DXGI_SWAP_CHAIN_DESC1 sd = {};
+	sd.Width = m_ClientWidth;
+	sd.Height = m_ClientHeight;
+	sd.Format = m_BackBufferFormat;
+	sd.Stereo = false;
 	sd.SampleDesc.Count = m_4xMsaaState ? 4 : 1;
 	sd.SampleDesc.Quality = m_4xMsaaState ? (m_4xMsaaQuality - 1) : 0;
 	sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
 	sd.BufferCount = m_SwapChainBufferCount;
-	sd.OutputWindow = m_hWnd;
-	sd.Windowed = true;
+	sd.Scaling = DXGI_SCALING_STRETCH;
 	sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-	sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
+	sd.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+	sd.Flags = m_SwapChainFlags;
 
-	ThrowIfFailed(m_dxgiFactory->CreateSwapChain(
+	Microsoft::WRL::ComPtr<IDXGISwapChain1> SwapChain1;
+	ThrowIfFailed(m_dxgiFactory->CreateSwapChainForHwnd(
 		m_CommandQueue.Get(),
+		m_hWnd,
 		&sd,
-		m_SwapChain.GetAddressOf()));
+		nullptr,
+		nullptr,
+		SwapChain1.GetAddressOf()));
+
+	ThrowIfFailed(SwapChain1.As(&m_SwapChain));
+
+	//Present  ALLOW_TEARING    exclusive fullscreen
+	if (m_TearingSupported)
+		ThrowIfFailed(m_dxgiFactory->MakeWindowAssociation(m_hWnd, DXGI_MWA_NO_ALT_ENTER));
+
+	m_FramePacer.Init(m_SwapChain.Get(), FRAME_PACING_MODE, FRAMES_IN_FLIGHT, m_TearingSupported);
 }
 
 void CMeshManager::Create_RtvAndDsv_DescriptorHeaps()
@@ -160,24 +180,12 @@ void CMeshManager::Resize_SwapChainBuffers()
 		m_SwapChainBufferCount,
 		m_ClientWidth, m_ClientHeight,
 		m_BackBufferFormat,
-		DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH));
+		m_SwapChainFlags));
 }
 
 void CMeshManager::FlushCommandQueue()
 {
-	m_CurrentFence++;
-
-	ThrowIfFailed(m_CommandQueue->Signal(m_Fence.Get(), m_CurrentFence));
-
-	if (m_Fence->GetCompletedValue() < m_CurrentFence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-
-		ThrowIfFailed(m_Fence->SetEventOnCompletion(m_CurrentFence, eventHandle));
-
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	m_FrameScheduler.Flush();
 }
 
 void CMeshManager::Create_RenderTarget()
@@ -240,11 +248,18 @@ D3D12_CPU_DESCRIPTOR_HANDLE CMeshManager::DepthStencilView()
 
 void CMeshManager::Execute_Init_Commands()
 {
+	//    
+	m_UploadBatch.Record(m_CommandList.Get());
+
 	ThrowIfFailed(m_CommandList->Close());
 	ID3D12CommandList* cmdsLists[] = { m_CommandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
 	FlushCommandQueue();
+
+	// , upload    
+	m_UploadRing.Retire_All(m_FrameScheduler.Current_Fence());
+	m_UploadRing.Reclaim();
 }
 
 void CMeshManager::Update_ViewPort_And_Scissor()
@@ -307,8 +322,6 @@ void CMeshManager::Build_Shaders_And_InputLayout()
 
 void CMeshManager::Create_Cube_Geometry()
 {
-	ThrowIfFailed(m_CommandList->Reset(m_DirectCmdListAlloc.Get(), nullptr));
-
 	std::array<Vertex, 24> Vertices =
 	{
 		Vertex({ DirectX::XMFLOAT3(-15.000000, -15.000000, -15.000000), DirectX::XMFLOAT3(0.000000, -1.000000, 0.000000) }),
@@ -359,10 +372,10 @@ void CMeshManager::Create_Cube_Geometry()
 	m_Cube->Name = "Cube";
 
 	m_Cube->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
-		m_CommandList.Get(), Vertices.data(), VbByteSize, m_Cube->VertexBufferUploader);
+		Vertices.data(), VbByteSize, m_UploadBatch);
 
 	m_Cube->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
-		m_CommandList.Get(), Indices.data(), IbByteSize, m_Cube->IndexBufferUploader);
+		Indices.data(), IbByteSize, m_UploadBatch);
 
 	m_Cube->VertexByteStride = sizeof(Vertex);
 	m_Cube->VertexBufferByteSize = VbByteSize;
@@ -519,10 +532,24 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 
 	CreateFence_GetDescriptorsSize();
 
+	m_UploadRing.Init(m_d3dDevice.Get(), m_Fence.Get(), UPLOAD_RING_SIZE);
+	m_UploadBatch.Init(&m_UploadRing);
+
 	Check_Multisample_Quality();
 
 	Create_CommandList_Allocator_Queue();
 
+	m_FrameScheduler.Init(m_CommandQueue.Get(), m_Fence.Get(), m_NumFrameResources);
+	m_FrameScheduler.Set_Frames_In_Flight(FRAMES_IN_FLIGHT);
+
+#ifdef FRAME_SCHEDULER_VERIFY
+	Verify_Frame_Scheduler();
+#endif
+
+#ifdef FRAME_PACING_VERIFY
+	Verify_Frame_Pacing();
+#endif
+
 	Create_SwapChain();
 
 	Create_RtvAndDsv_DescriptorHeaps();
@@ -533,8 +560,6 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 
 	Create_DepthStencil_Buff_And_View();
 
-	Execute_Init_Commands();
-
 	Update_ViewPort_And_Scissor();
 
 	Build_Shaders_And_InputLayout();
@@ -552,6 +577,7 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 	Create_PipelineStateObject();
 
 	Execute_Init_Commands();
+	m_UploadBatch.Report("Init upload");
 
 	DirectX::XMVECTOR Pos = DirectX::XMVectorSet(0, 0.0f, -100.0f, 1.0f);
 	DirectX::XMVECTOR Target = DirectX::XMVectorZero();
@@ -563,13 +589,37 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 	DirectX::XMMATRIX MatProj = DirectX::XMMatrixPerspectiveFovLH(0.25f * DirectX::XM_PI, 4.0f / 3.0f, 1.0f, 1000.0f);
 	XMStoreFloat4x4(&m_Proj, MatProj);
 
+#ifdef TIMER_LIMITER_BENCHMARK
+	Benchmark_Frame_Limiter(30.0f, 90, 2.0);
+#endif
+
 	m_Timer.Timer_Start(30);
+
+#ifdef FRAME_STATS_VERIFY
+	Verify_Frame_Stats();
+#endif
+
+#ifdef FRAME_STATS_BENCHMARK
+	Benchmark_Frame_Stats();
+#endif
+
+#if FRAME_STATS_EXPORT_SECONDS > 0
+	m_FrameStats.Start_Export(FRAME_STATS_EXPORT_NAME, FRAME_STATS_EXPORT_SECONDS);
+#endif
 }
 
 void CMeshManager::Update_MeshManager()
 {
+	m_FrameStats.Begin_Frame();
+
+	//    swap chain   ,  LOW_LATENCY
+	//     
+	m_FramePacer.Wait_Frame();
+
 	m_Timer.Calculate_FPS();
 	float ElapsedTime = m_Timer.Get_Elapsed_Time();
+	m_FramePacer.Input_Sampled();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
 
 	static float Angle = 0.0f;
 
@@ -596,16 +646,12 @@ void CMeshManager::Update_MeshManager()
 	//       
 	DirectX::XMMATRIX MatWorldView = MatWorld * MatView;
 
-	m_CurrFrameResourceIndex = (m_CurrFrameResourceIndex + 1) % m_NumFrameResources;
-	m_CurrFrameResource = m_FrameResources[m_CurrFrameResourceIndex].get();
+	m_FrameStats.Phase_End(FRAME_PHASE_UPDATE);
 
-	if (m_CurrFrameResource->Fence != 0 && m_Fence->GetCompletedValue() < m_CurrFrameResource->Fence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-		ThrowIfFailed(m_Fence->SetEventOnCompletion(m_CurrFrameResource->Fence, eventHandle));
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	//,  GPU    
+	m_CurrFrameResourceIndex = m_FrameScheduler.Begin_Frame();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
+	m_CurrFrameResource = m_FrameResources[m_CurrFrameResourceIndex].get();
 
 	auto currObjectCB = m_CurrFrameResource->ObjectCB.get();
 
@@ -658,6 +704,8 @@ void CMeshManager::DrawRenderItems_
 
 void CMeshManager::Draw_MeshManager()
 {
+	m_FrameStats.Phase_End(FRAME_PHASE_UPDATE);
+
 	auto CmdListAlloc = m_CurrFrameResource->CmdListAlloc;
 
 	ThrowIfFailed(CmdListAlloc->Reset());
@@ -693,14 +741,19 @@ void CMeshManager::Draw_MeshManager()
 
 	ThrowIfFailed(m_CommandList->Close());
 
+	m_FrameStats.Phase_End(FRAME_PHASE_RECORD);
+
 	ID3D12CommandList* cmdsLists[] = { m_CommandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
-	ThrowIfFailed(m_SwapChain->Present(0, 0));
+	//   Present  FRAME_PACING_MODE
+	m_FramePacer.Present();
 
-	m_CurrBackBuffer = (m_CurrBackBuffer + 1) % m_SwapChainBufferCount;
+	m_CurrBackBuffer = m_SwapChain->GetCurrentBackBufferIndex();
 
-	FlushCommandQueue();
+	//  ,  frame resource    fence
+	m_CurrFrameResource->Fence = m_FrameScheduler.End_Frame();
+	m_FrameStats.Phase_End(FRAME_PHASE_SUBMIT);
 }
 
 
@@ -28,6 +28,11 @@
 #include "d3dUtil.h"
 
 #include "Timer.h"
+#include "UploadRing.h"
+#include "UploadBatch.h"
+#include "FrameScheduler.h"
+#include "FramePacer.h"
+#include "FrameStats.h"
 
 #pragma comment(lib,"d3dcompiler.lib")
 #pragma comment(lib, "D3D12.lib")
@@ -35,6 +40,24 @@
 
 #define NUM_FRAME_RESOURCES 3
 
+//,  CPU   GPU: 1 - CPU  GPU  ,
+//  NUM_FRAME_RESOURCES
+#define FRAMES_IN_FLIGHT 3
+
+// : FRAME_PACING_MAX_THROUGHPUT, FRAME_PACING_VSYNC
+// FRAME_PACING_LOW_LATENCY, . FramePacer.h.  
+//Present(0)  vsync,    CFramePacer
+#define FRAME_PACING_MODE FRAME_PACING_MAX_THROUGHPUT
+
+//       
+//FRAME_STATS_EXPORT_NAME.csv  .json, 0 -  .  
+//,        
+#define FRAME_STATS_EXPORT_SECONDS 0
+#define FRAME_STATS_EXPORT_NAME "frame_stats"
+
+//upload     
+#define UPLOAD_RING_SIZE (1024 * 1024)
+
 template<typename T>
 class UploadBuffer
 {
@@ -118,9 +141,6 @@ struct MeshGeometry
 	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferGPU = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferGPU = nullptr;
 
-	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferUploader = nullptr;
-	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferUploader = nullptr;
-
 	UINT VertexByteStride = 0;
 	UINT VertexBufferByteSize = 0;
 	DXGI_FORMAT IndexFormat = DXGI_FORMAT_R16_UINT;
@@ -147,12 +167,6 @@ struct MeshGeometry
 
 		return ibv;
 	}
-
-	void DisposeUploaders()
-	{
-		VertexBufferUploader = nullptr;
-		IndexBufferUploader = nullptr;
-	}
 };
 
 struct RenderItem
@@ -249,6 +263,7 @@ private:
 	void DrawRenderItems_ube(ID3D12GraphicsCommandList* CmdList, const std::vector<std::unique_ptr<RenderItem>>& Ritems);
 	
 	CTimer m_Timer;
+	CFrameStats m_FrameStats;
 
 	const int m_NumFrameResources = NUM_FRAME_RESOURCES;
 	UINT m_PassCbvOffset = 0;
@@ -279,12 +294,13 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_DirectCmdListAlloc;
 	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_CommandList;
 
-	Microsoft::WRL::ComPtr<IDXGISwapChain> m_SwapChain;
+	Microsoft::WRL::ComPtr<IDXGISwapChain3> m_SwapChain;
 
 	int m_ClientWidth = 800;
 	int m_ClientHeight = 600;
 
-	static const int m_SwapChainBufferCount = 2;
+	//      swap chain (FRAMES_IN_FLIGHT)
+	static const int m_SwapChainBufferCount = 3;
 
 	HWND m_hWnd;
 
@@ -294,7 +310,18 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_SwapChainBuffer[m_SwapChainBufferCount];
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_DepthStencilBuffer;
 		
-	UINT64 m_CurrentFence = 0;
+	//fence   ,  GPU
+	CFrameScheduler m_FrameScheduler;
+
+	//    ,  swap chain  ResizeBuffers
+	CFramePacer m_FramePacer;
+	bool m_TearingSupported = false;
+	UINT m_SwapChainFlags = 0;
+
+	// upload    , 
+	//     
+	CUploadRing m_UploadRing;
+	CUploadBatch m_UploadBatch;
 	int m_CurrBackBuffer = 0;
 	
 	D3D12_VIEWPORT m_ScreenViewport;
@@ -0,0 +1,129 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Frame Pacer DirectX12
+//======================================================================================
+
+#ifndef _FRAMEPACER_
+#define _FRAMEPACER_
+
+#include <windows.h>
+#include <wrl.h>
+#include <dxgi1_5.h>
+#include <functional>
+
+#include "d3dUtil.h"
+
+//,        
+#define FRAME_PACER_HISTORY 16
+
+enum FramePacingMode
+{
+	//Present(0)  tearing,  :   
+	FRAME_PACING_MAX_THROUGHPUT,
+	//Present(1),   swap chain  FramesInFlight 
+	FRAME_PACING_VSYNC,
+	//Present(1),    :   
+	// vblank,      
+	FRAME_PACING_LOW_LATENCY
+};
+
+//    swap chain,  DXGI -  
+struct FramePacingPolicy
+{
+	UINT SyncInterval = 1;
+	UINT PresentFlags = 0;
+	//SetMaximumFrameLatency,    
+	UINT MaxFrameLatency = 1;
+};
+
+FramePacingPolicy Get_Frame_Pacing_Policy(FramePacingMode Mode, UINT FramesInFlight, bool TearingSupported);
+
+// swap chain,   CFramePacer: waitable object ,
+//ALLOW_TEARING -    
+UINT Get_Frame_Pacing_Swap_Chain_Flags(bool TearingSupported);
+bool Check_Tearing_Support(IDXGIFactory4* Factory);
+
+struct FramePacerStats
+{
+	UINT64 Frames = 0;
+	//  Wait_Frame:  waitable object swap chain
+	double WaitMs = 0.0;
+	//  ->   Present
+	double InputToPresentMs = 0.0;
+	double MaxInputToPresentMs = 0.0;
+	//  -> vblank  (GetFrameStatistics)
+	UINT64 Displayed = 0;
+	double InputToDisplayMs = 0.0;
+	double MaxInputToDisplayMs = 0.0;
+};
+
+// :     waitable object swap chain
+//(IDXGISwapChain2), Present     , 
+//   Present     .
+//SwapChain == nullptr - : ,   Present 
+// Set_Mock,    Frame_Displayed
+class CFramePacer
+{
+public:
+	CFramePacer() = default;
+	~CFramePacer();
+
+	CFramePacer(const CFramePacer& rhs) = delete;
+	CFramePacer& operator=(const CFramePacer& rhs) = delete;
+
+	//swap chain   Get_Frame_Pacing_Swap_Chain_Flags
+	void Init(IDXGISwapChain2* SwapChain, FramePacingMode Mode, UINT FramesInFlight, bool TearingSupported);
+	// waitable object,   swap chain
+	void Release();
+
+	FramePacingMode Mode() const;
+	const FramePacingPolicy& Policy() const;
+
+	//  : ,    swap chain  
+	void Wait_Frame();
+	//   
+	void Input_Sampled();
+	//Present   ,   
+	UINT Present();
+
+	// Present  PresentId   TimeMs ( Now_Ms)
+	void Frame_Displayed(UINT PresentId, double TimeMs);
+
+	double Now_Ms() const;
+
+	void Set_Mock(std::function<double()> Clock, std::function<void()> Wait,
+		std::function<void(UINT, UINT)> Present);
+
+	const FramePacerStats& Get_Stats() const;
+	void Report(const char* Name);
+
+private:
+	void Poll_Frame_Statistics();
+
+	IDXGISwapChain2* m_SwapChain = nullptr;
+	HANDLE m_Waitable = nullptr;
+
+	FramePacingMode m_Mode = FRAME_PACING_VSYNC;
+	FramePacingPolicy m_Policy;
+
+	double m_InputTime = 0.0;
+	UINT m_PresentCount = 0;
+	UINT m_LastDisplayed = 0;
+
+	//     Present
+	UINT m_HistoryId[FRAME_PACER_HISTORY] = {};
+	double m_HistoryInput[FRAME_PACER_HISTORY] = {};
+
+	std::function<double()> m_MockClock;
+	std::function<void()> m_MockWait;
+	std::function<void(UINT, UINT)> m_MockPresent;
+
+	FramePacerStats m_Stats;
+};
+
+//CPU   60  (cpu 4 ms, gpu 6 ms):  
+//  CFramePacer   , 
+//       -  LOW_LATENCY
+// ,   VSYNC   .   OutputDebugString
+void Verify_Frame_Pacing();
+
+#endif
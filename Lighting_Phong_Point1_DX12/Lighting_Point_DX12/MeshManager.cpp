@@ -12,6 +12,11 @@ CMeshManager::~CMeshManager()
 {
 	if (m_d3dDevice != nullptr)
 		FlushCommandQueue();
+
+	m_FrameScheduler.Report("Frame scheduler");
+	m_FramePacer.Report("Frame pacing");
+	m_Timer.Report("Frame limiter");
+	m_FrameStats.Report("Frame stats");
 }
 
 void CMeshManager::EnableDebugLayer_CreateFactory()
@@ -97,29 +102,44 @@ void CMeshManager::Create_CommandList_Allocator_Queue()
 
 void CMeshManager::Create_SwapChain()
 {
+	m_FramePacer.Release();
 	m_SwapChain.Reset();
 
-	DXGI_SWAP_CHAIN_DESC sd;
-	sd.BufferDesc.Width = m_ClientWidth;
-	sd.BufferDesc.Height = m_ClientHeight;
-	sd.BufferDesc.RefreshRate.Numerator = 60;
-	sd.BufferDesc.RefreshRate.Denominator = 1;
-	sd.BufferDesc.Format = m_BackBufferFormat;
-	sd.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-	sd.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+	//waitable object   , tearing - FRAME_PACING_MAX_THROUGHPUT
+	m_TearingSupported = Check_Tearing_Support(m_dxgiFactory.Get());
+	m_SwapChainFlags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH |
+		Get_Frame_Pacing_Swap_Chain_Flags(m_TearingSupported);
+
+	DXGI_SWAP_CHAIN_DESC1 sd = {};
+	sd.Width = m_ClientWidth;
+	sd.Height = m_ClientHeight;
+	sd.Format = m_BackBufferFormat;
+	sd.Stereo = false;
 	sd.SampleDesc.Count = m_4xMsaaState ? 4 : 1;
 	sd.SampleDesc.Quality = m_4xMsaaState ? (m_4xMsaaQuality - 1) : 0;
 	sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
 	sd.BufferCount = m_SwapChainBufferCount;
-	sd.OutputWindow = m_hWnd;
-	sd.Windowed = true;
+	sd.Scaling = DXGI_SCALING_STRETCH;
 	sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-	sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
+	sd.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+	sd.Flags = m_SwapChainFlags;
 
-	ThrowIfFailed(m_dxgiFactory->CreateSwapChain(
+	Microsoft::WRL::ComPtr<IDXGISwapChain1> SwapChain1;
+	ThrowIfFailed(m_dxgiFactory->CreateSwapChainForHwnd(
 		m_CommandQueue.Get(),
+		m_hWnd,
 		&sd,
-		m_SwapChain.GetAddressOf()));
+		nullptr,
+		nullptr,
+		SwapChain1.GetAddressOf()));
+
+	ThrowIfFailed(SwapChain1.As(&m_SwapChain));
+
+	//Present  ALLOW_TEARING    exclusive fullscreen
+	if (m_TearingSupported)
+		ThrowIfFailed(m_dxgiFactory->MakeWindowAssociation(m_hWnd, DXGI_MWA_NO_ALT_ENTER));
+
+	m_FramePacer.Init(m_SwapChain.Get(), FRAME_PACING_MODE, FRAMES_IN_FLIGHT, m_TearingSupported);
 }
 
 void CMeshManager::Create_RtvAndDsv_DescriptorHeaps()
@@ -160,24 +180,12 @@ void CMeshManager::Resize_SwapChainBuffers()
 		m_SwapChainBufferCount,
 		m_ClientWidth, m_ClientHeight,
 		m_BackBufferFormat,
-		DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH));
+		m_SwapChainFlags));
 }
 
 void CMeshManager::FlushCommandQueue()
 {
-	m_CurrentFence++;
-
-	ThrowIfFailed(m_CommandQueue->Signal(m_Fence.Get(), m_CurrentFence));
-
-	if (m_Fence->GetCompletedValue() < m_CurrentFence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-
-		ThrowIfFailed(m_Fence->SetEventOnCompletion(m_CurrentFence, eventHandle));
-
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	m_FrameScheduler.Flush();
 }
 
 void CMeshManager::Create_RenderTarget()
@@ -240,11 +248,18 @@ D3D12_CPU_DESCRIPTOR_HANDLE CMeshManager::DepthStencilView()
 
 void CMeshManager::Execute_Init_Commands()
 {
+	//    
+	m_UploadBatch.Record(m_CommandList.Get());
+
 	ThrowIfFailed(m_CommandList->Close());
 	ID3D12CommandList* cmdsLists[] = { m_CommandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
 	FlushCommandQueue();
+
+	// , upload    
+	m_UploadRing.Retire_All(m_FrameScheduler.Current_Fence());
+	m_UploadRing.Reclaim();
 }
 
 void CMeshManager::Update_ViewPort_And_Scissor()
@@ -295,6 +310,22 @@ void CMeshManager::Create_Root_Signature()
 
 void CMeshManager::Build_Shaders_And_InputLayout()
 {
+#ifdef COMPACT_VERTEX_FORMAT
+	const D3D_SHADER_MACRO Defines[] =
+	{
+		{ "COMPACT_VERTEX_FORMAT", "1" },
+		{ nullptr, nullptr }
+	};
+
+	m_vsByteCode = d3dUtil::CompileShader(L"Shaders\\light_point.hlsl", Defines, "VS", "vs_5_0");
+	m_psByteCode = d3dUtil::CompileShader(L"Shaders\\light_point.hlsl", Defines, "PS", "ps_5_0");
+
+	m_InputLayout =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "NORMAL", 0, DXGI_FORMAT_R16G16_SNORM, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
+#else
 	m_vsByteCode = d3dUtil::CompileShader(L"Shaders\\light_point.hlsl", nullptr, "VS", "vs_5_0");
 	m_psByteCode = d3dUtil::CompileShader(L"Shaders\\light_point.hlsl", nullptr, "PS", "ps_5_0");
 
@@ -303,6 +334,7 @@ void CMeshManager::Build_Shaders_And_InputLayout()
 		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{ "NORMAL", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
+#endif
 }
 
 void CMeshManager::Build_Side(std::vector<Vertex> &VertBuff, std::vector<std::uint16_t> &Indices)
@@ -358,8 +390,6 @@ void CMeshManager::Build_Side(std::vector<Vertex> &VertBuff, std::vector<std::ui
 
 void CMeshManager::Create_Plane_Geometry()
 {
-	ThrowIfFailed(m_CommandList->Reset(m_DirectCmdListAlloc.Get(), nullptr));
-	
 	m_NumCellsPerRow = 25;
 	m_NumCellsPerCol = 25;
 	m_CellSpacing = 2.0;
@@ -379,19 +409,65 @@ void CMeshManager::Create_Plane_Geometry()
 
 	Build_Side(Vertices, Indices);
 
-	const UINT VbByteSize = (UINT)Vertices.size() * sizeof(Vertex);
+	//        GPU
+	VertexCacheStats Before = Analyze_Vertex_Cache(Indices.data(), (UINT)Indices.size(), (UINT)Vertices.size(), 16);
+
+	Optimize_Vertex_Cache(Indices.data(), (UINT)Indices.size(), (UINT)Vertices.size());
+	Optimize_Vertex_Fetch(Vertices.data(), (UINT)Vertices.size(), sizeof(Vertex), Indices.data(), (UINT)Indices.size());
+
+	VertexCacheStats After = Analyze_Vertex_Cache(Indices.data(), (UINT)Indices.size(), (UINT)Vertices.size(), 16);
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Plane: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+		Before.ACMR, After.ACMR, Before.ATVR, After.ATVR);
+	OutputDebugStringA(Buffer);
+
+#ifdef MESH_OPTIMIZER_VERIFY
+	Verify_Vertex_Cache_Optimizer();
+#endif
+
 	const UINT IbByteSize = (UINT)Indices.size() * sizeof(std::uint16_t);
 
 	m_Plane = std::make_unique<MeshGeometry>();
 	m_Plane->Name = "Plane";
 
+#ifdef COMPACT_VERTEX_FORMAT
+	//    ,   octahedral
+	QuantizeBounds Bounds;
+	Compute_Quantize_Bounds(Vertices.data(), (UINT)Vertices.size(), sizeof(Vertex), Bounds);
+
+	std::vector<VertexCompact> Compact(Vertices.size());
+	Quantize_Pos_Normal(Vertices.data(), (UINT)Vertices.size(), sizeof(Vertex), Bounds, Compact.data());
+
+	const UINT VbByteSize = (UINT)Compact.size() * sizeof(VertexCompact);
+
 	m_Plane->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
-		m_CommandList.Get(), Vertices.data(), VbByteSize, m_Plane->VertexBufferUploader);
+		Compact.data(), VbByteSize, m_UploadBatch);
 
-	m_Plane->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
-		m_CommandList.Get(), Indices.data(), IbByteSize, m_Plane->IndexBufferUploader);
+	m_Plane->VertexByteStride = sizeof(VertexCompact);
+	m_Plane->PosScale = DirectX::XMFLOAT4(Bounds.Extent[0], Bounds.Extent[1], Bounds.Extent[2], 0.0f);
+	m_Plane->PosBias = DirectX::XMFLOAT4(Bounds.Min[0], Bounds.Min[1], Bounds.Min[2], 0.0f);
+
+	//  CPU    
+	QuantizeError Error = Verify_Quantize_Pos_Normal(Vertices.data(), (UINT)Vertices.size(),
+		sizeof(Vertex), Bounds, Compact.data());
+
+	sprintf_s(Buffer, "Plane: compact VB %u -> %u bytes, max pos error %.4f, max normal error %.3f deg%s\n",
+		(UINT)(Vertices.size() * sizeof(Vertex)), VbByteSize, Error.MaxPosError, Error.MaxAttrError,
+		Error.PosInTolerance ? "" : " (OUT OF TOLERANCE)");
+	OutputDebugStringA(Buffer);
+#else
+	const UINT VbByteSize = (UINT)Vertices.size() * sizeof(Vertex);
+
+	m_Plane->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
+		Vertices.data(), VbByteSize, m_UploadBatch);
 
 	m_Plane->VertexByteStride = sizeof(Vertex);
+#endif
+
+	m_Plane->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
+		Indices.data(), IbByteSize, m_UploadBatch);
+
 	m_Plane->VertexBufferByteSize = VbByteSize;
 	m_Plane->IndexFormat = DXGI_FORMAT_R16_UINT;
 	m_Plane->IndexBufferByteSize = IbByteSize;
@@ -546,10 +622,24 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 
 	CreateFence_GetDescriptorsSize();
 
+	m_UploadRing.Init(m_d3dDevice.Get(), m_Fence.Get(), UPLOAD_RING_SIZE);
+	m_UploadBatch.Init(&m_UploadRing);
+
 	Check_Multisample_Quality();
 
 	Create_CommandList_Allocator_Queue();
 
+	m_FrameScheduler.Init(m_CommandQueue.Get(), m_Fence.Get(), m_NumFrameResources);
+	m_FrameScheduler.Set_Frames_In_Flight(FRAMES_IN_FLIGHT);
+
+#ifdef FRAME_SCHEDULER_VERIFY
+	Verify_Frame_Scheduler();
+#endif
+
+#ifdef FRAME_PACING_VERIFY
+	Verify_Frame_Pacing();
+#endif
+
 	Create_SwapChain();
 
 	Create_RtvAndDsv_DescriptorHeaps();
@@ -560,8 +650,6 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 
 	Create_DepthStencil_Buff_And_View();
 
-	Execute_Init_Commands();
-
 	Update_ViewPort_And_Scissor();
 
 	Build_Shaders_And_InputLayout();
@@ -579,6 +667,7 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 	Create_PipelineStateObject();
 
 	Execute_Init_Commands();
+	m_UploadBatch.Report("Init upload");
 
 	DirectX::XMVECTOR Pos = DirectX::XMVectorSet(0, 15.0f, -50.0f, 1.0f);
 	DirectX::XMVECTOR Target = DirectX::XMVectorZero();
@@ -590,13 +679,37 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 	DirectX::XMMATRIX MatProj = DirectX::XMMatrixPerspectiveFovLH(0.25f * DirectX::XM_PI, 4.0f / 3.0f, 1.0f, 1000.0f);
 	XMStoreFloat4x4(&m_Proj, MatProj);
 
+#ifdef TIMER_LIMITER_BENCHMARK
+	Benchmark_Frame_Limiter(30.0f, 90, 2.0);
+#endif
+
 	m_Timer.Timer_Start(30);
+
+#ifdef FRAME_STATS_VERIFY
+	Verify_Frame_Stats();
+#endif
+
+#ifdef FRAME_STATS_BENCHMARK
+	Benchmark_Frame_Stats();
+#endif
+
+#if FRAME_STATS_EXPORT_SECONDS > 0
+	m_FrameStats.Start_Export(FRAME_STATS_EXPORT_NAME, FRAME_STATS_EXPORT_SECONDS);
+#endif
 }
 
 void CMeshManager::Update_MeshManager()
 {
+	m_FrameStats.Begin_Frame();
+
+	//    swap chain   ,  LOW_LATENCY
+	//     
+	m_FramePacer.Wait_Frame();
+
 	m_Timer.Calculate_FPS();
 	float ElapsedTime = m_Timer.Get_Elapsed_Time();
+	m_FramePacer.Input_Sampled();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
 
 	DirectX::XMMATRIX MatWorld = DirectX::XMMatrixIdentity();
 	DirectX::XMMATRIX MatProj = XMLoadFloat4x4(&m_Proj);
@@ -607,16 +720,12 @@ void CMeshManager::Update_MeshManager()
 	//     
 	DirectX::XMMATRIX MatWorldView = MatWorld * MatView;
 
-	m_CurrFrameResourceIndex = (m_CurrFrameResourceIndex + 1) % m_NumFrameResources;
-	m_CurrFrameResource = m_FrameResources[m_CurrFrameResourceIndex].get();
+	m_FrameStats.Phase_End(FRAME_PHASE_UPDATE);
 
-	if (m_CurrFrameResource->Fence != 0 && m_Fence->GetCompletedValue() < m_CurrFrameResource->Fence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-		ThrowIfFailed(m_Fence->SetEventOnCompletion(m_CurrFrameResource->Fence, eventHandle));
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	//,  GPU    
+	m_CurrFrameResourceIndex = m_FrameScheduler.Begin_Frame();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
+	m_CurrFrameResource = m_FrameResources[m_CurrFrameResourceIndex].get();
 
 	auto currObjectCB = m_CurrFrameResource->ObjectCB.get();
 
@@ -628,6 +737,8 @@ void CMeshManager::Update_MeshManager()
 
 			ObjectConstants ObjConstants;
 			DirectX::XMStoreFloat4x4(&ObjConstants.WorldView, DirectX::XMMatrixTranspose(MatWorldView));
+			ObjConstants.PosScale = e->Geo->PosScale;
+			ObjConstants.PosBias = e->Geo->PosBias;
 
 			currObjectCB->CopyData(e->ObjCBIndex, ObjConstants);
 
@@ -669,6 +780,8 @@ void CMeshManager::DrawRenderItems_
 
 void CMeshManager::Draw_MeshManager()
 {
+	m_FrameStats.Phase_End(FRAME_PHASE_UPDATE);
+
 	auto CmdListAlloc = m_CurrFrameResource->CmdListAlloc;
 
 	ThrowIfFailed(CmdListAlloc->Reset());
@@ -704,14 +817,19 @@ void CMeshManager::Draw_MeshManager()
 
 	ThrowIfFailed(m_CommandList->Close());
 
+	m_FrameStats.Phase_End(FRAME_PHASE_RECORD);
+
 	ID3D12CommandList* cmdsLists[] = { m_CommandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
-	ThrowIfFailed(m_SwapChain->Present(0, 0));
+	//   Present  FRAME_PACING_MODE
+	m_FramePacer.Present();
 
-	m_CurrBackBuffer = (m_CurrBackBuffer + 1) % m_SwapChainBufferCount;
+	m_CurrBackBuffer = m_SwapChain->GetCurrentBackBufferIndex();
 
-	FlushCommandQueue();
+	//  ,  frame resource    fence
+	m_CurrFrameResource->Fence = m_FrameScheduler.End_Frame();
+	m_FrameStats.Phase_End(FRAME_PHASE_SUBMIT);
 }
 
 
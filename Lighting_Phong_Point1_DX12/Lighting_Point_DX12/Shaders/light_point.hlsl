@@ -1,6 +1,9 @@
 cbuffer cbPerObject : register(b0)
 {
 	float4x4 gWorldView;
+	//unpack quantized position: PosL * gPosScale + gPosBias
+	float4 gPosScale;
+	float4 gPosBias;
 };
 
 cbuffer cbPass : register(b1)
@@ -11,9 +14,24 @@ cbuffer cbPass : register(b1)
 struct VertexIn
 {
 	float3 PosL  : POSITION;
+#ifdef COMPACT_VERTEX_FORMAT
+    float2 Normal : NORMAL;
+#else
     float3 Normal : NORMAL;
+#endif
 };
 
+#ifdef COMPACT_VERTEX_FORMAT
+//octahedral normal from R16G16_SNORM
+float3 Oct_Decode(float2 e)
+{
+	float3 n = float3(e.xy, 1.0f - abs(e.x) - abs(e.y));
+	float t = saturate(-n.z);
+	n.xy += n.xy >= 0.0f ? -t : t;
+	return normalize(n);
+}
+#endif
+
 struct VertexOut
 {
 	float4 PosH  : SV_POSITION;
@@ -29,13 +47,22 @@ static float3 Att = {0.0f, 0.01f, 0.01f};
 VertexOut VS(VertexIn vin)
 {
 	VertexOut vout;
+
+#ifdef COMPACT_VERTEX_FORMAT
+	//R16G16B16A16_UNORM gives [0, 1] relative to mesh bounding box
+	float3 PosL = vin.PosL * gPosScale.xyz + gPosBias.xyz;
+	float3 Normal = Oct_Decode(vin.Normal);
+#else
+	float3 PosL = vin.PosL;
+	float3 Normal = vin.Normal;
+#endif
 	
-	vout.PosH = mul(float4(vin.PosL, 1.0f), gWorldViewProj);
+	vout.PosH = mul(float4(PosL, 1.0f), gWorldViewProj);
 	
-	float4 PosW = mul(float4(vin.PosL, 1.0f), gWorldView);
+	float4 PosW = mul(float4(PosL, 1.0f), gWorldView);
 	vout.PosW = PosW.xyz;
 	
-    vout.tNormal = mul(vin.Normal, (float3x3)gWorldView);
+    vout.tNormal = mul(Normal, (float3x3)gWorldView);
 
     vout.LightPos = mul(float4(LightPos, 1.0f), gWorldView);
     
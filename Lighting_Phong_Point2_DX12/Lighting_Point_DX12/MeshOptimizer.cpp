@@ -0,0 +1,836 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Mesh Optimizer
+//======================================================================================
+
+#include "MeshOptimizer.h"
+
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <float.h>
+#include <stdio.h>
+#include <algorithm>
+
+//FNV-1a
+static UINT64 Hash_Vertex(const BYTE* Vertex, UINT VertexStride)
+{
+	UINT64 Hash = 14695981039346656037ULL;
+
+	for (UINT i = 0; i < VertexStride; i++)
+	{
+		Hash ^= Vertex[i];
+		Hash *= 1099511628211ULL;
+	}
+
+	return Hash;
+}
+
+void Weld_Vertices(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	std::vector<BYTE>& UniqueVertices, std::vector<UINT>& Indices)
+{
+	const BYTE* Src = (const BYTE*)Vertices;
+
+	//    ,   
+	//    
+	UINT TableSize = 1;
+	while (TableSize < VertexCount * 2)
+		TableSize <<= 1;
+
+	std::vector<UINT> Table(TableSize, UINT_MAX);
+
+	UniqueVertices.clear();
+	UniqueVertices.reserve((size_t)VertexCount * VertexStride);
+	Indices.resize(VertexCount);
+
+	UINT UniqueCount = 0;
+
+	for (UINT i = 0; i < VertexCount; i++)
+	{
+		const BYTE* Vertex = Src + (size_t)i * VertexStride;
+
+		UINT Slot = (UINT)Hash_Vertex(Vertex, VertexStride) & (TableSize - 1);
+
+		for (;;)
+		{
+			UINT Unique = Table[Slot];
+
+			if (Unique == UINT_MAX)
+			{
+				Table[Slot] = UniqueCount;
+				UniqueVertices.insert(UniqueVertices.end(), Vertex, Vertex + VertexStride);
+				Indices[i] = UniqueCount++;
+				break;
+			}
+
+			if (memcmp(&UniqueVertices[(size_t)Unique * VertexStride], Vertex, VertexStride) == 0)
+			{
+				Indices[i] = Unique;
+				break;
+			}
+
+			Slot = (Slot + 1) & (TableSize - 1);
+		}
+	}
+}
+
+bool Verify_Welded_Mesh(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	const void* UniqueVertices, const std::vector<UINT>& Indices)
+{
+	if (Indices.size() != VertexCount)
+		return false;
+
+	const BYTE* Src = (const BYTE*)Vertices;
+	const BYTE* Unique = (const BYTE*)UniqueVertices;
+
+	for (UINT i = 0; i < VertexCount; i++)
+	{
+		if (memcmp(Src + (size_t)i * VertexStride, Unique + (size_t)Indices[i] * VertexStride, VertexStride) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+#define FORSYTH_CACHE_SIZE 32
+
+static float Forsyth_Vertex_Score(int CachePosition, UINT RemainingTriangles)
+{
+	//    
+	if (RemainingTriangles == 0)
+		return -1.0f;
+
+	float Score = 0.0f;
+
+	if (CachePosition >= 0)
+	{
+		//     ,
+		//        
+		if (CachePosition < 3)
+		{
+			Score = 0.75f;
+		}
+		else
+		{
+			const float Scaler = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+			Score = powf(1.0f - (CachePosition - 3) * Scaler, 1.5f);
+		}
+	}
+
+	//     
+	//  
+	Score += 2.0f * powf((float)RemainingTriangles, -0.5f);
+
+	return Score;
+}
+
+template<typename T>
+static void Optimize_Vertex_Cache_T(T* Indices, UINT IndexCount, UINT VertexCount)
+{
+	UINT TriCount = IndexCount / 3;
+
+	if (TriCount == 0)
+		return;
+
+	//        
+	std::vector<UINT> Remaining(VertexCount, 0);
+	for (UINT i = 0; i < TriCount * 3; i++)
+		Remaining[Indices[i]]++;
+
+	std::vector<UINT> Offset(VertexCount + 1, 0);
+	for (UINT v = 0; v < VertexCount; v++)
+		Offset[v + 1] = Offset[v] + Remaining[v];
+
+	std::vector<UINT> Adjacency(TriCount * 3);
+	std::vector<UINT> Fill(Offset.begin(), Offset.end() - 1);
+	for (UINT i = 0; i < TriCount * 3; i++)
+		Adjacency[Fill[Indices[i]]++] = i / 3;
+
+	std::vector<int> CachePosition(VertexCount, -1);
+	std::vector<float> VertexScore(VertexCount);
+	for (UINT v = 0; v < VertexCount; v++)
+		VertexScore[v] = Forsyth_Vertex_Score(-1, Remaining[v]);
+
+	std::vector<float> TriScore(TriCount);
+	std::vector<bool> Emitted(TriCount, false);
+
+	int Best = 0;
+	for (UINT t = 0; t < TriCount; t++)
+	{
+		TriScore[t] = VertexScore[Indices[t * 3 + 0]] + VertexScore[Indices[t * 3 + 1]] + VertexScore[Indices[t * 3 + 2]];
+
+		if (TriScore[t] > TriScore[Best])
+			Best = t;
+	}
+
+	std::vector<T> Output(TriCount * 3);
+
+	UINT Cache[FORSYTH_CACHE_SIZE + 3];
+	UINT CacheCount = 0;
+	UINT ScanCursor = 0;
+
+	for (UINT n = 0; n < TriCount; n++)
+	{
+		//       -    
+		if (Best < 0)
+		{
+			while (Emitted[ScanCursor])
+				ScanCursor++;
+
+			Best = ScanCursor;
+		}
+
+		const T* Tri = &Indices[Best * 3];
+
+		Output[n * 3 + 0] = Tri[0];
+		Output[n * 3 + 1] = Tri[1];
+		Output[n * 3 + 2] = Tri[2];
+
+		Emitted[Best] = true;
+
+		//     
+		for (int k = 0; k < 3; k++)
+		{
+			UINT v = Tri[k];
+			UINT* List = &Adjacency[Offset[v]];
+
+			for (UINT i = 0; i < Remaining[v]; i++)
+			{
+				if (List[i] == (UINT)Best)
+				{
+					List[i] = List[Remaining[v] - 1];
+					Remaining[v]--;
+					break;
+				}
+			}
+		}
+
+		//    ,  
+		UINT NewCache[FORSYTH_CACHE_SIZE + 3];
+		UINT NewCount = 0;
+
+		for (int k = 0; k < 3; k++)
+		{
+			bool Found = false;
+			for (UINT i = 0; i < NewCount; i++)
+				Found |= NewCache[i] == Tri[k];
+
+			if (!Found)
+				NewCache[NewCount++] = Tri[k];
+		}
+
+		for (UINT i = 0; i < CacheCount; i++)
+		{
+			UINT v = Cache[i];
+
+			if (v != Tri[0] && v != Tri[1] && v != Tri[2])
+				NewCache[NewCount++] = v;
+		}
+
+		for (UINT i = 0; i < NewCount; i++)
+		{
+			UINT v = NewCache[i];
+			CachePosition[v] = i < FORSYTH_CACHE_SIZE ? (int)i : -1;
+			VertexScore[v] = Forsyth_Vertex_Score(CachePosition[v], Remaining[v]);
+		}
+
+		//      
+		//     
+		Best = -1;
+		float BestScore = -1.0f;
+
+		for (UINT i = 0; i < NewCount; i++)
+		{
+			UINT v = NewCache[i];
+
+			for (UINT j = 0; j < Remaining[v]; j++)
+			{
+				UINT t = Adjacency[Offset[v] + j];
+
+				TriScore[t] = VertexScore[Indices[t * 3 + 0]] + VertexScore[Indices[t * 3 + 1]] + VertexScore[Indices[t * 3 + 2]];
+
+				if (TriScore[t] > BestScore)
+				{
+					BestScore = TriScore[t];
+					Best = t;
+				}
+			}
+		}
+
+		CacheCount = NewCount < FORSYTH_CACHE_SIZE ? NewCount : FORSYTH_CACHE_SIZE;
+		memcpy(Cache, NewCache, CacheCount * sizeof(UINT));
+	}
+
+	memcpy(Indices, Output.data(), TriCount * 3 * sizeof(T));
+}
+
+void Optimize_Vertex_Cache(UINT* Indices, UINT IndexCount, UINT VertexCount)
+{
+	Optimize_Vertex_Cache_T(Indices, IndexCount, VertexCount);
+}
+
+void Optimize_Vertex_Cache(WORD* Indices, UINT IndexCount, UINT VertexCount)
+{
+	Optimize_Vertex_Cache_T(Indices, IndexCount, VertexCount);
+}
+
+template<typename T>
+static UINT Optimize_Vertex_Fetch_T(void* Vertices, UINT VertexCount, UINT VertexStride, T* Indices, UINT IndexCount)
+{
+	std::vector<UINT> Remap(VertexCount, UINT_MAX);
+	UINT Next = 0;
+
+	for (UINT i = 0; i < IndexCount; i++)
+	{
+		UINT v = Indices[i];
+
+		if (Remap[v] == UINT_MAX)
+			Remap[v] = Next++;
+
+		Indices[i] = (T)Remap[v];
+	}
+
+	UINT UsedCount = Next;
+
+	for (UINT v = 0; v < VertexCount; v++)
+	{
+		if (Remap[v] == UINT_MAX)
+			Remap[v] = Next++;
+	}
+
+	BYTE* Dst = (BYTE*)Vertices;
+	std::vector<BYTE> Src(Dst, Dst + (size_t)VertexCount * VertexStride);
+
+	for (UINT v = 0; v < VertexCount; v++)
+		memcpy(Dst + (size_t)Remap[v] * VertexStride, &Src[(size_t)v * VertexStride], VertexStride);
+
+	return UsedCount;
+}
+
+UINT Optimize_Vertex_Fetch(void* Vertices, UINT VertexCount, UINT VertexStride, UINT* Indices, UINT IndexCount)
+{
+	return Optimize_Vertex_Fetch_T(Vertices, VertexCount, VertexStride, Indices, IndexCount);
+}
+
+UINT Optimize_Vertex_Fetch(void* Vertices, UINT VertexCount, UINT VertexStride, WORD* Indices, UINT IndexCount)
+{
+	return Optimize_Vertex_Fetch_T(Vertices, VertexCount, VertexStride, Indices, IndexCount);
+}
+
+template<typename T>
+static VertexCacheStats Analyze_Vertex_Cache_T(const T* Indices, UINT IndexCount, UINT VertexCount, UINT CacheSize)
+{
+	//  FIFO      
+	//  CacheSize 
+	std::vector<UINT> LoadTime(VertexCount, 0);
+	std::vector<bool> Used(VertexCount, false);
+
+	UINT Misses = 0;
+	UINT UsedCount = 0;
+
+	for (UINT i = 0; i < IndexCount; i++)
+	{
+		UINT v = Indices[i];
+
+		if (!Used[v])
+		{
+			Used[v] = true;
+			UsedCount++;
+		}
+
+		if (LoadTime[v] == 0 || Misses + 1 - LoadTime[v] > CacheSize)
+		{
+			Misses++;
+			LoadTime[v] = Misses;
+		}
+	}
+
+	VertexCacheStats Stats;
+	Stats.ACMR = IndexCount >= 3 ? (float)Misses / (IndexCount / 3) : 0.0f;
+	Stats.ATVR = UsedCount > 0 ? (float)Misses / UsedCount : 0.0f;
+
+	return Stats;
+}
+
+VertexCacheStats Analyze_Vertex_Cache(const UINT* Indices, UINT IndexCount, UINT VertexCount, UINT CacheSize)
+{
+	return Analyze_Vertex_Cache_T(Indices, IndexCount, VertexCount, CacheSize);
+}
+
+VertexCacheStats Analyze_Vertex_Cache(const WORD* Indices, UINT IndexCount, UINT VertexCount, UINT CacheSize)
+{
+	return Analyze_Vertex_Cache_T(Indices, IndexCount, VertexCount, CacheSize);
+}
+
+void Compute_Quantize_Bounds(const void* Vertices, UINT VertexCount, UINT VertexStride, QuantizeBounds& Bounds)
+{
+	float Min[3] = { FLT_MAX, FLT_MAX, FLT_MAX };
+	float Max[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+	const BYTE* Src = (const BYTE*)Vertices;
+
+	for (UINT i = 0; i < VertexCount; i++)
+	{
+		float Pos[3];
+		memcpy(Pos, Src + (size_t)i * VertexStride, sizeof(Pos));
+
+		for (int a = 0; a < 3; a++)
+		{
+			if (Pos[a] < Min[a]) Min[a] = Pos[a];
+			if (Pos[a] > Max[a]) Max[a] = Pos[a];
+		}
+	}
+
+	for (int a = 0; a < 3; a++)
+	{
+		Bounds.Min[a] = VertexCount ? Min[a] : 0.0f;
+		Bounds.Extent[a] = VertexCount ? Max[a] - Min[a] : 0.0f;
+	}
+}
+
+WORD Quantize_Unorm16(float Value, float Min, float Extent)
+{
+	//    
+	if (Extent <= 0.0f)
+		return 0;
+
+	float Q = (Value - Min) / Extent * 65535.0f + 0.5f;
+
+	if (Q <= 0.0f)
+		return 0;
+
+	if (Q >= 65535.0f)
+		return 65535;
+
+	return (WORD)Q;
+}
+
+float Dequantize_Unorm16(WORD Value, float Min, float Extent)
+{
+	return Min + Value * (Extent / 65535.0f);
+}
+
+WORD Float_To_Half(float Value)
+{
+	UINT Bits;
+	memcpy(&Bits, &Value, sizeof(Bits));
+
+	UINT Sign = (Bits >> 16) & 0x8000;
+	UINT Abs = Bits & 0x7FFFFFFF;
+
+	//NaN
+	if (Abs > 0x7F800000)
+		return (WORD)(Sign | 0x7E00);
+
+	// 65504   - 
+	if (Abs >= 0x477FF000)
+		return (WORD)(Sign | 0x7C00);
+
+	// 2^-14 -  half
+	if (Abs < 0x38800000)
+	{
+		//   
+		if (Abs < 0x33000000)
+			return (WORD)Sign;
+
+		UINT Exp = Abs >> 23;
+		UINT Mant = (Abs & 0x7FFFFF) | 0x800000;
+		UINT Shift = 126 - Exp;
+
+		UINT Result = Mant >> Shift;
+		UINT Rem = Mant & ((1u << Shift) - 1);
+		UINT Halfway = 1u << (Shift - 1);
+
+		//   
+		if (Rem > Halfway || (Rem == Halfway && (Result & 1)))
+			Result++;
+
+		return (WORD)(Sign | Result);
+	}
+
+	//  127 -> 15
+	UINT Result = (Abs - 0x38000000) >> 13;
+	UINT Rem = Abs & 0x1FFF;
+
+	if (Rem > 0x1000 || (Rem == 0x1000 && (Result & 1)))
+		Result++;
+
+	return (WORD)(Sign | Result);
+}
+
+float Half_To_Float(WORD Value)
+{
+	UINT Sign = (UINT)(Value & 0x8000) << 16;
+	UINT Exp = (Value >> 10) & 0x1F;
+	UINT Mant = Value & 0x3FF;
+
+	UINT Bits;
+
+	if (Exp == 0x1F)
+	{
+		Bits = Sign | 0x7F800000 | (Mant << 13);
+	}
+	else if (Exp == 0)
+	{
+		//  , Mant * 2^-24
+		float Result = Mant * (1.0f / 16777216.0f);
+		return Sign ? -Result : Result;
+	}
+	else
+	{
+		Bits = Sign | ((Exp + 112) << 23) | (Mant << 13);
+	}
+
+	float Result;
+	memcpy(&Result, &Bits, sizeof(Result));
+
+	return Result;
+}
+
+static SHORT Quantize_Snorm16(float Value)
+{
+	if (Value > 1.0f) Value = 1.0f;
+	if (Value < -1.0f) Value = -1.0f;
+
+	return (SHORT)(Value * 32767.0f + (Value >= 0.0f ? 0.5f : -0.5f));
+}
+
+static float Dequantize_Snorm16(SHORT Value)
+{
+	//-32768  -32767   -1    GPU
+	float Result = Value / 32767.0f;
+
+	return Result < -1.0f ? -1.0f : Result;
+}
+
+void Encode_Octahedral(const float Normal[3], SHORT Oct[2])
+{
+	float L1 = fabsf(Normal[0]) + fabsf(Normal[1]) + fabsf(Normal[2]);
+
+	if (L1 <= 0.0f)
+	{
+		Oct[0] = 0;
+		Oct[1] = 0;
+		return;
+	}
+
+	float X = Normal[0] / L1;
+	float Y = Normal[1] / L1;
+
+	//      
+	if (Normal[2] < 0.0f)
+	{
+		float FoldX = (1.0f - fabsf(Y)) * (X >= 0.0f ? 1.0f : -1.0f);
+		float FoldY = (1.0f - fabsf(X)) * (Y >= 0.0f ? 1.0f : -1.0f);
+
+		X = FoldX;
+		Y = FoldY;
+	}
+
+	Oct[0] = Quantize_Snorm16(X);
+	Oct[1] = Quantize_Snorm16(Y);
+}
+
+void Decode_Octahedral(const SHORT Oct[2], float Normal[3])
+{
+	float X = Dequantize_Snorm16(Oct[0]);
+	float Y = Dequantize_Snorm16(Oct[1]);
+	float Z = 1.0f - fabsf(X) - fabsf(Y);
+
+	float T = Z < 0.0f ? -Z : 0.0f;
+
+	X += X >= 0.0f ? -T : T;
+	Y += Y >= 0.0f ? -T : T;
+
+	float Len = sqrtf(X * X + Y * Y + Z * Z);
+
+	Normal[0] = X / Len;
+	Normal[1] = Y / Len;
+	Normal[2] = Z / Len;
+}
+
+static void Quantize_Position(const float Pos[3], const QuantizeBounds& Bounds, WORD Quantized[4])
+{
+	for (int a = 0; a < 3; a++)
+		Quantized[a] = Quantize_Unorm16(Pos[a], Bounds.Min[a], Bounds.Extent[a]);
+
+	Quantized[3] = 0;
+}
+
+//   , Tolerance -   
+static float Position_Error(const float Pos[3], const QuantizeBounds& Bounds, const WORD Quantized[4], bool& InTolerance)
+{
+	float MaxError = 0.0f;
+
+	for (int a = 0; a < 3; a++)
+	{
+		float Error = fabsf(Dequantize_Unorm16(Quantized[a], Bounds.Min[a], Bounds.Extent[a]) - Pos[a]);
+		float Tolerance = Bounds.Extent[a] / 65535.0f * 0.5f + (fabsf(Pos[a]) + Bounds.Extent[a]) * FLT_EPSILON * 2.0f;
+
+		if (Error > Tolerance)
+			InTolerance = false;
+
+		if (Error > MaxError)
+			MaxError = Error;
+	}
+
+	return MaxError;
+}
+
+void Quantize_Pos_Tex(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	const QuantizeBounds& Bounds, void* Quantized)
+{
+	const BYTE* Src = (const BYTE*)Vertices;
+	BYTE* Dst = (BYTE*)Quantized;
+
+	for (UINT i = 0; i < VertexCount; i++)
+	{
+		float Data[5];
+		memcpy(Data, Src + (size_t)i * VertexStride, sizeof(Data));
+
+		WORD Packed[6];
+		Quantize_Position(Data, Bounds, Packed);
+		Packed[4] = Float_To_Half(Data[3]);
+		Packed[5] = Float_To_Half(Data[4]);
+
+		memcpy(Dst + (size_t)i * QUANTIZED_VERTEX_STRIDE, Packed, QUANTIZED_VERTEX_STRIDE);
+	}
+}
+
+void Quantize_Pos_Normal(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	const QuantizeBounds& Bounds, void* Quantized)
+{
+	const BYTE* Src = (const BYTE*)Vertices;
+	BYTE* Dst = (BYTE*)Quantized;
+
+	for (UINT i = 0; i < VertexCount; i++)
+	{
+		float Data[6];
+		memcpy(Data, Src + (size_t)i * VertexStride, sizeof(Data));
+
+		WORD Packed[6];
+		Quantize_Position(Data, Bounds, Packed);
+		Encode_Octahedral(Data + 3, (SHORT*)(Packed + 4));
+
+		memcpy(Dst + (size_t)i * QUANTIZED_VERTEX_STRIDE, Packed, QUANTIZED_VERTEX_STRIDE);
+	}
+}
+
+QuantizeError Verify_Quantize_Pos_Tex(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	const QuantizeBounds& Bounds, const void* Quantized)
+{
+	QuantizeError Result = { 0.0f, 0.0f, true };
+
+	const BYTE* Src = (const BYTE*)Vertices;
+	const BYTE* Packed = (const BYTE*)Quantized;
+
+	for (UINT i = 0; i < VertexCount; i++)
+	{
+		float Data[5];
+		memcpy(Data, Src + (size_t)i * VertexStride, sizeof(Data));
+
+		WORD Q[6];
+		memcpy(Q, Packed + (size_t)i * QUANTIZED_VERTEX_STRIDE, QUANTIZED_VERTEX_STRIDE);
+
+		float PosError = Position_Error(Data, Bounds, Q, Result.PosInTolerance);
+		if (PosError > Result.MaxPosError)
+			Result.MaxPosError = PosError;
+
+		for (int t = 0; t < 2; t++)
+		{
+			float TexError = fabsf(Half_To_Float(Q[4 + t]) - Data[3 + t]);
+			if (TexError > Result.MaxAttrError)
+				Result.MaxAttrError = TexError;
+		}
+	}
+
+	return Result;
+}
+
+QuantizeError Verify_Quantize_Pos_Normal(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	const QuantizeBounds& Bounds, const void* Quantized)
+{
+	QuantizeError Result = { 0.0f, 0.0f, true };
+
+	const BYTE* Src = (const BYTE*)Vertices;
+	const BYTE* Packed = (const BYTE*)Quantized;
+
+	for (UINT i = 0; i < VertexCount; i++)
+	{
+		float Data[6];
+		memcpy(Data, Src + (size_t)i * VertexStride, sizeof(Data));
+
+		WORD Q[6];
+		memcpy(Q, Packed + (size_t)i * QUANTIZED_VERTEX_STRIDE, QUANTIZED_VERTEX_STRIDE);
+
+		float PosError = Position_Error(Data, Bounds, Q, Result.PosInTolerance);
+		if (PosError > Result.MaxPosError)
+			Result.MaxPosError = PosError;
+
+		float Normal[3];
+		Decode_Octahedral((const SHORT*)(Q + 4), Normal);
+
+		float Len = sqrtf(Data[3] * Data[3] + Data[4] * Data[4] + Data[5] * Data[5]);
+		if (Len <= 0.0f)
+			continue;
+
+		float Dot = (Normal[0] * Data[3] + Normal[1] * Data[4] + Normal[2] * Data[5]) / Len;
+		if (Dot > 1.0f) Dot = 1.0f;
+		if (Dot < -1.0f) Dot = -1.0f;
+
+		float Angle = acosf(Dot) * (180.0f / 3.14159265f);
+		if (Angle > Result.MaxAttrError)
+			Result.MaxAttrError = Angle;
+	}
+
+	return Result;
+}
+
+struct VerifyGridVertex
+{
+	float Pos[3];
+	//    
+	UINT Id;
+};
+
+struct VerifyTriangle
+{
+	UINT V[3];
+
+	bool operator<(const VerifyTriangle& Other) const
+	{
+		if (V[0] != Other.V[0]) return V[0] < Other.V[0];
+		if (V[1] != Other.V[1]) return V[1] < Other.V[1];
+		return V[2] < Other.V[2];
+	}
+
+	bool operator!=(const VerifyTriangle& Other) const
+	{
+		return V[0] != Other.V[0] || V[1] != Other.V[1] || V[2] != Other.V[2];
+	}
+};
+
+//    ,   
+static VerifyTriangle Make_Verify_Triangle(UINT A, UINT B, UINT C)
+{
+	VerifyTriangle Tri;
+
+	if (A <= B && A <= C) { Tri.V[0] = A; Tri.V[1] = B; Tri.V[2] = C; }
+	else if (B <= A && B <= C) { Tri.V[0] = B; Tri.V[1] = C; Tri.V[2] = A; }
+	else { Tri.V[0] = C; Tri.V[1] = A; Tri.V[2] = B; }
+
+	return Tri;
+}
+
+void Verify_Vertex_Cache_Optimizer()
+{
+	const UINT GridSize = 256;
+	const UINT VertexCount = GridSize * GridSize;
+	const UINT CacheSize = 16;
+
+	std::vector<VerifyGridVertex> Vertices(VertexCount);
+
+	for (UINT z = 0; z < GridSize; z++)
+	{
+		for (UINT x = 0; x < GridSize; x++)
+		{
+			VerifyGridVertex& V = Vertices[z * GridSize + x];
+			V.Pos[0] = (float)x;
+			V.Pos[1] = 0.0f;
+			V.Pos[2] = (float)z;
+			V.Id = z * GridSize + x;
+		}
+	}
+
+	//   ,  Build_Side
+	std::vector<UINT> Indices;
+	Indices.reserve((GridSize - 1) * (GridSize - 1) * 6);
+
+	for (UINT z = 0; z < GridSize - 1; z++)
+	{
+		for (UINT x = 0; x < GridSize - 1; x++)
+		{
+			UINT i0 = z * GridSize + x;
+			UINT i1 = i0 + 1;
+			UINT i2 = i0 + GridSize;
+			UINT i3 = i2 + 1;
+
+			Indices.push_back(i0); Indices.push_back(i2); Indices.push_back(i1);
+			Indices.push_back(i1); Indices.push_back(i2); Indices.push_back(i3);
+		}
+	}
+
+	UINT IndexCount = (UINT)Indices.size();
+
+	std::vector<VerifyTriangle> SrcTriangles(IndexCount / 3);
+	for (UINT i = 0; i < IndexCount; i += 3)
+		SrcTriangles[i / 3] = Make_Verify_Triangle(Indices[i], Indices[i + 1], Indices[i + 2]);
+
+	VertexCacheStats Before = Analyze_Vertex_Cache(Indices.data(), IndexCount, VertexCount, CacheSize);
+
+	Optimize_Vertex_Cache(Indices.data(), IndexCount, VertexCount);
+	UINT UsedCount = Optimize_Vertex_Fetch(Vertices.data(), VertexCount, sizeof(VerifyGridVertex), Indices.data(), IndexCount);
+
+	VertexCacheStats After = Analyze_Vertex_Cache(Indices.data(), IndexCount, VertexCount, CacheSize);
+
+	bool StatsOk = After.ACMR < Before.ACMR && After.ATVR < Before.ATVR;
+
+	//          
+	bool VerticesOk = UsedCount == VertexCount;
+	std::vector<bool> Seen(VertexCount, false);
+
+	for (UINT i = 0; i < VertexCount && VerticesOk; i++)
+	{
+		const VerifyGridVertex& V = Vertices[i];
+
+		if (V.Id >= VertexCount || Seen[V.Id] ||
+			V.Pos[0] != (float)(V.Id % GridSize) || V.Pos[2] != (float)(V.Id / GridSize))
+		{
+			VerticesOk = false;
+			break;
+		}
+
+		Seen[V.Id] = true;
+	}
+
+	//         
+	bool TrianglesOk = VerticesOk && IndexCount == SrcTriangles.size() * 3;
+
+	if (TrianglesOk)
+	{
+		std::vector<VerifyTriangle> DstTriangles(IndexCount / 3);
+
+		for (UINT i = 0; i < IndexCount && TrianglesOk; i += 3)
+		{
+			if (Indices[i] >= VertexCount || Indices[i + 1] >= VertexCount || Indices[i + 2] >= VertexCount)
+			{
+				TrianglesOk = false;
+				break;
+			}
+
+			DstTriangles[i / 3] = Make_Verify_Triangle(Vertices[Indices[i]].Id,
+				Vertices[Indices[i + 1]].Id, Vertices[Indices[i + 2]].Id);
+		}
+
+		if (TrianglesOk)
+		{
+			std::sort(SrcTriangles.begin(), SrcTriangles.end());
+			std::sort(DstTriangles.begin(), DstTriangles.end());
+
+			for (size_t i = 0; i < SrcTriangles.size(); i++)
+			{
+				if (SrcTriangles[i] != DstTriangles[i])
+				{
+					TrianglesOk = false;
+					break;
+				}
+			}
+		}
+	}
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Vertex cache optimizer: %ux%u grid ACMR %.3f -> %.3f, ATVR %.3f -> %.3f %s, triangles %s, vertices %s, %s\n",
+		GridSize, GridSize, Before.ACMR, After.ACMR, Before.ATVR, After.ATVR,
+		StatsOk ? "OK" : "FAILED", TrianglesOk ? "OK" : "FAILED", VerticesOk ? "OK" : "FAILED",
+		StatsOk && TrianglesOk && VerticesOk ? "OK" : "FAILED");
+	OutputDebugStringA(Buffer);
+}
@@ -0,0 +1,72 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Ring Allocator DirectX12
+//======================================================================================
+
+#ifndef _RINGALLOCATOR_
+#define _RINGALLOCATOR_
+
+#include <windows.h>
+#include <deque>
+
+//       
+//  D3D12.   ,    
+//:    ,      
+//  Retire     GPU (Reclaim)
+class CRingAllocator
+{
+public:
+	CRingAllocator() = default;
+
+	void Init(UINT64 Capacity);
+
+	//false -    ,    Align
+	//( ),      
+	bool Allocate(UINT64 Size, UINT64 Align, UINT64& Offset, UINT& Id);
+
+	// Fence GPU    
+	void Retire(UINT Id, UINT64 Fence);
+	//    
+	void Retire_All(UINT64 Fence);
+
+	//    , 
+	//    
+	UINT64 Reclaim(UINT64 CompletedFence);
+
+	//   , false -    
+	//  GPU   
+	bool Oldest_Fence(UINT64& Fence) const;
+
+	UINT64 Used() const;
+	UINT64 Capacity() const;
+	UINT Pending() const;
+
+private:
+	struct RingBlock
+	{
+		UINT Id;
+		// ,      
+		UINT64 End;
+		//         
+		UINT64 Bytes;
+		UINT64 Fence;
+		bool Retired;
+	};
+
+	std::deque<RingBlock> m_Blocks;
+
+	UINT64 m_Capacity = 0;
+	//   [m_Tail, m_Head)
+	UINT64 m_Head = 0;
+	UINT64 m_Tail = 0;
+	UINT64 m_Used = 0;
+	UINT m_NextId = 0;
+};
+
+//CPU :      ,
+//       . 
+//,          ,
+//          
+//  .   OutputDebugString
+void Verify_Ring_Allocator();
+
+#endif
@@ -0,0 +1,351 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Frame Scheduler DirectX12
+//======================================================================================
+
+#include "FrameScheduler.h"
+
+#include <stdio.h>
+#include <vector>
+
+static double Get_Time_Ms()
+{
+	LARGE_INTEGER Frequency, Counter;
+	QueryPerformanceFrequency(&Frequency);
+	QueryPerformanceCounter(&Counter);
+
+	return Counter.QuadPart * 1000.0 / Frequency.QuadPart;
+}
+
+CFenceEvent::CFenceEvent()
+{
+	m_Event = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
+
+	if (m_Event == nullptr)
+		ThrowIfFailed(HRESULT_FROM_WIN32(GetLastError()));
+}
+
+CFenceEvent::~CFenceEvent()
+{
+	if (m_Event != nullptr)
+		CloseHandle(m_Event);
+}
+
+void CFenceEvent::Wait(ID3D12Fence* Fence, UINT64 Value)
+{
+	if (Fence->GetCompletedValue() >= Value)
+		return;
+
+	ThrowIfFailed(Fence->SetEventOnCompletion(Value, m_Event));
+
+	WaitForSingleObject(m_Event, INFINITE);
+}
+
+void CFrameScheduler::Init(ID3D12CommandQueue* Queue, ID3D12Fence* Fence, UINT FrameCount)
+{
+	m_Queue = Queue;
+	m_Fence = Fence;
+
+	if (FrameCount == 0)
+		FrameCount = 1;
+	if (FrameCount > FRAME_SCHEDULER_MAX_FRAMES)
+		FrameCount = FRAME_SCHEDULER_MAX_FRAMES;
+
+	m_FrameCount = FrameCount;
+	m_FramesInFlight = FrameCount;
+	m_FrameIndex = 0;
+
+	//       
+	m_CurrentFence = Fence != nullptr ? Fence->GetCompletedValue() : m_MockCompleted;
+
+	for (UINT i = 0; i < FRAME_SCHEDULER_MAX_FRAMES; i++)
+		m_FrameFence[i] = 0;
+}
+
+void CFrameScheduler::Set_Frames_In_Flight(UINT Count)
+{
+	if (Count < 1)
+		Count = 1;
+	if (Count > m_FrameCount)
+		Count = m_FrameCount;
+
+	m_FramesInFlight = Count;
+}
+
+UINT CFrameScheduler::Frames_In_Flight() const
+{
+	return m_FramesInFlight;
+}
+
+UINT CFrameScheduler::Begin_Frame()
+{
+	m_FrameIndex = (m_FrameIndex + 1) % m_FrameCount;
+
+	// N   N - Frames_In_Flight:    
+	//     frame resource,   -  
+	UINT Oldest = (m_FrameIndex + m_FrameCount - m_FramesInFlight) % m_FrameCount;
+	UINT64 WaitFence = m_FrameFence[Oldest];
+
+	if (WaitFence != 0 && Completed_Fence() < WaitFence)
+	{
+		double Start = Get_Time_Ms();
+		Wait(WaitFence);
+
+		m_Stats.Waits++;
+		m_Stats.WaitMs += Get_Time_Ms() - Start;
+	}
+
+	return m_FrameIndex;
+}
+
+UINT64 CFrameScheduler::End_Frame()
+{
+	UINT64 Fence = Signal();
+	m_FrameFence[m_FrameIndex] = Fence;
+
+	m_Stats.Frames++;
+
+	//   GPU,  
+	UINT64 Completed = Completed_Fence();
+	UINT InFlight = 0;
+	for (UINT i = 0; i < m_FrameCount; i++)
+	{
+		if (m_FrameFence[i] > Completed)
+			InFlight++;
+	}
+
+	if (InFlight > m_Stats.PeakInFlight)
+		m_Stats.PeakInFlight = InFlight;
+
+	return Fence;
+}
+
+UINT64 CFrameScheduler::Signal()
+{
+	m_CurrentFence++;
+
+	if (m_Queue != nullptr)
+		ThrowIfFailed(m_Queue->Signal(m_Fence, m_CurrentFence));
+
+	return m_CurrentFence;
+}
+
+void CFrameScheduler::Wait(UINT64 Value)
+{
+	if (Completed_Fence() >= Value)
+		return;
+
+	if (m_Fence != nullptr)
+	{
+		m_FenceEvent.Wait(m_Fence, Value);
+	}
+	else if (m_MockWait)
+	{
+		m_MockWait(Value);
+	}
+}
+
+void CFrameScheduler::Flush()
+{
+	Wait(Signal());
+
+	m_Stats.Flushes++;
+}
+
+UINT64 CFrameScheduler::Current_Fence() const
+{
+	return m_CurrentFence;
+}
+
+UINT64 CFrameScheduler::Completed_Fence() const
+{
+	return m_Fence != nullptr ? m_Fence->GetCompletedValue() : m_MockCompleted;
+}
+
+UINT CFrameScheduler::Frame_Index() const
+{
+	return m_FrameIndex;
+}
+
+void CFrameScheduler::Mock_Complete(UINT64 Value)
+{
+	if (Value > m_MockCompleted)
+		m_MockCompleted = Value;
+}
+
+void CFrameScheduler::Set_Mock_Wait(std::function<void(UINT64)> MockWait)
+{
+	m_MockWait = MockWait;
+}
+
+const FrameSchedulerStats& CFrameScheduler::Get_Stats() const
+{
+	return m_Stats;
+}
+
+void CFrameScheduler::Report(const char* Name)
+{
+	char Buffer[256];
+	sprintf_s(Buffer, "%s: %llu frames, %u/%u in flight peak %u, %llu waits %.1f ms (%.3f ms per frame), %llu flushes\n",
+		Name, m_Stats.Frames, m_FramesInFlight, m_FrameCount, m_Stats.PeakInFlight, m_Stats.Waits, m_Stats.WaitMs,
+		m_Stats.Frames ? m_Stats.WaitMs / m_Stats.Frames : 0.0, m_Stats.Flushes);
+	OutputDebugStringA(Buffer);
+}
+
+// : GPU    ,  
+//GpuMs  ,     
+struct SimulatedQueue
+{
+	CFrameScheduler Scheduler;
+
+	double Now = 0.0;
+	double GpuFree = 0.0;
+	//   GPU   fence
+	std::vector<double> EndTime;
+
+	void Advance(double Time)
+	{
+		if (Time > Now)
+			Now = Time;
+
+		UINT64 Completed = 0;
+		for (UINT64 Value = 1; Value < EndTime.size(); Value++)
+		{
+			if (EndTime[(size_t)Value] <= Now)
+				Completed = Value;
+		}
+
+		Scheduler.Mock_Complete(Completed);
+	}
+
+	void Submit(UINT64 Fence, double GpuMs)
+	{
+		double Start = Now > GpuFree ? Now : GpuFree;
+		GpuFree = Start + GpuMs;
+
+		if (EndTime.size() <= Fence)
+			EndTime.resize((size_t)Fence + 1, 0.0);
+		EndTime[(size_t)Fence] = GpuFree;
+	}
+};
+
+struct SimulatedRun
+{
+	double FrameMs = 0.0;
+	UINT PeakInFlight = 0;
+	UINT64 Waits = 0;
+	bool Valid = true;
+};
+
+static SimulatedRun Run_Simulated_Queue(UINT FrameCount, UINT FramesInFlight, UINT Frames,
+	double CpuMs, double GpuMs, bool Jitter)
+{
+	SimulatedQueue Queue;
+	Queue.EndTime.push_back(0.0);
+
+	Queue.Scheduler.Init(nullptr, nullptr, FrameCount);
+	Queue.Scheduler.Set_Frames_In_Flight(FramesInFlight);
+	Queue.Scheduler.Set_Mock_Wait([&Queue](UINT64 Value)
+	{
+		//Signal   (Flush)     
+		if (Value >= Queue.EndTime.size())
+			Queue.Submit(Value, 0.0);
+
+		//CPU ,  GPU    Value
+		Queue.Advance(Queue.EndTime[(size_t)Value]);
+	});
+
+	SimulatedRun Run;
+	UINT64 LastFence[FRAME_SCHEDULER_MAX_FRAMES] = {};
+	UINT Seed = 12345;
+
+	for (UINT Frame = 0; Frame < Frames; Frame++)
+	{
+		Queue.Advance(Queue.Now);
+
+		UINT Index = Queue.Scheduler.Begin_Frame();
+
+		//     GPU
+		if (LastFence[Index] != 0 && Queue.EndTime[(size_t)LastFence[Index]] > Queue.Now)
+			Run.Valid = false;
+
+		//  GPU,    
+		UINT Pending = 0;
+		for (UINT64 Value = 1; Value < Queue.EndTime.size(); Value++)
+		{
+			if (Queue.EndTime[(size_t)Value] > Queue.Now)
+				Pending++;
+		}
+
+		if (Pending + 1 > FramesInFlight)
+			Run.Valid = false;
+
+		double Cpu = CpuMs;
+		double Gpu = GpuMs;
+		if (Jitter)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			Cpu *= 0.5 + (Seed >> 8) % 1000 / 1000.0;
+			Seed = Seed * 1664525 + 1013904223;
+			Gpu *= 0.5 + (Seed >> 8) % 1000 / 1000.0;
+		}
+
+		//  
+		Queue.Advance(Queue.Now + Cpu);
+
+		UINT64 Fence = Queue.Scheduler.End_Frame();
+		Queue.Submit(Fence, Gpu);
+		LastFence[Index] = Fence;
+	}
+
+	Queue.Scheduler.Flush();
+
+	// Flush  
+	if (Queue.Scheduler.Completed_Fence() != Queue.Scheduler.Current_Fence())
+		Run.Valid = false;
+
+	Run.FrameMs = Queue.Now / Frames;
+	Run.PeakInFlight = Queue.Scheduler.Get_Stats().PeakInFlight;
+	Run.Waits = Queue.Scheduler.Get_Stats().Waits;
+
+	return Run;
+}
+
+void Verify_Frame_Scheduler()
+{
+	const UINT FrameCount = 3;
+	const UINT Frames = 1000;
+	const double CpuMs = 4.0;
+	const double GpuMs = 6.0;
+
+	bool Valid = true;
+	char Buffer[256];
+
+	for (UINT Depth = 1; Depth <= FrameCount; Depth++)
+	{
+		//GPU  CPU,  
+		SimulatedRun GpuBound = Run_Simulated_Queue(FrameCount, Depth, Frames, CpuMs, GpuMs, false);
+		SimulatedRun CpuBound = Run_Simulated_Queue(FrameCount, Depth, Frames, GpuMs, CpuMs, false);
+		SimulatedRun Jitter = Run_Simulated_Queue(FrameCount, Depth, Frames, CpuMs, GpuMs, true);
+
+		//    CPU + GPU,   -   
+		double Expected = Depth == 1 ? CpuMs + GpuMs : GpuMs;
+		double Overlap = 1.0 - GpuBound.FrameMs / (CpuMs + GpuMs);
+
+		bool DepthValid = GpuBound.Valid && CpuBound.Valid && Jitter.Valid &&
+			GpuBound.FrameMs < Expected * 1.01 && GpuBound.FrameMs > Expected * 0.99 &&
+			CpuBound.FrameMs < Expected * 1.01 && CpuBound.FrameMs > Expected * 0.99 &&
+			GpuBound.PeakInFlight <= Depth && Jitter.PeakInFlight <= Depth &&
+			(Depth == 1 || GpuBound.PeakInFlight == Depth);
+
+		if (!DepthValid)
+			Valid = false;
+
+		sprintf_s(Buffer, "Frame scheduler depth %u: %.2f ms per frame (cpu %.0f + gpu %.0f), overlap %.0f%%, peak %u in flight, jitter %.2f ms %s\n",
+			Depth, GpuBound.FrameMs, CpuMs, GpuMs, Overlap * 100.0, GpuBound.PeakInFlight, Jitter.FrameMs,
+			DepthValid ? "OK" : "FAILED");
+		OutputDebugStringA(Buffer);
+	}
+
+	sprintf_s(Buffer, "Frame scheduler: %s\n", Valid ? "OK" : "FAILED");
+	OutputDebugStringA(Buffer);
+}
@@ -4,77 +4,322 @@
 
 #include "Timer.h"
 
-int CTimer::Calculate_FPS()
+#include <stdio.h>
+#include <math.h>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <mmsystem.h>
+#pragma comment(lib, "winmm.lib")
+#else
+#include <time.h>
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+static double To_Ms(Clock::duration Duration)
+{
+	return std::chrono::duration<double, std::milli>(Duration).count();
+}
+
+static void Print_Report(const char* Buffer)
+{
+#ifdef _WIN32
+	OutputDebugStringA(Buffer);
+#else
+	fputs(Buffer, stdout);
+#endif
+}
+
+// CPU  , 
+static double Get_Thread_Cpu_Ms()
+{
+#ifdef _WIN32
+	FILETIME Creation, Exit, Kernel, User;
+	GetThreadTimes(GetCurrentThread(), &Creation, &Exit, &Kernel, &User);
+
+	ULARGE_INTEGER KernelTime, UserTime;
+	KernelTime.LowPart = Kernel.dwLowDateTime;
+	KernelTime.HighPart = Kernel.dwHighDateTime;
+	UserTime.LowPart = User.dwLowDateTime;
+	UserTime.HighPart = User.dwHighDateTime;
+
+	//  100 
+	return (KernelTime.QuadPart + UserTime.QuadPart) / 10000.0;
+#else
+	timespec Time;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &Time);
+
+	return Time.tv_sec * 1000.0 + Time.tv_nsec / 1000000.0;
+#endif
+}
+
+CTimer::~CTimer()
+{
+#ifdef _WIN32
+	if (m_SystemPeriod)
+		timeEndPeriod(1);
+#endif
+}
+
+void CTimer::Timer_Start(float LimitFPS, TimerLimitMode Mode)
+{
+	m_LimitFPS = LimitFPS;
+	m_LimitMode = Mode;
+
+	m_FramePeriod = Clock::duration::zero();
+	if (LimitFPS > 0.0f)
+		m_FramePeriod = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(1.0 / LimitFPS));
+
+#ifdef _WIN32
+	//  Sleep  sleep_for     15.6 
+	if (!m_SystemPeriod && Mode == TIMER_LIMIT_HYBRID)
+		m_SystemPeriod = timeBeginPeriod(1) == TIMERR_NOERROR;
+#endif
+
+	m_LastTime = Clock::now();
+	m_StartTime = m_LastTime;
+	m_AppStartTime = m_LastTime;
+	m_Deadline = m_LastTime;
+
+	m_FrameRate = 0;
+	m_FPSFrameCount = 0;
+	m_FPSTimeElapsed = 0.0f;
+
+	m_SpinMargin = std::chrono::microseconds(TIMER_SPIN_MARGIN_US);
+	m_Stats = TimerLimiterStats();
+}
+
+void CTimer::Wait_Until(Clock::time_point Deadline)
 {
-	QueryPerformanceCounter((LARGE_INTEGER *)&m_CurrentTime);
+	const Clock::duration MinMargin = std::chrono::microseconds(TIMER_SPIN_MARGIN_MIN_US);
+	const Clock::duration MaxMargin = std::chrono::microseconds(TIMER_SPIN_MARGIN_MAX_US);
 
-	float TimeElapsed; 
-	
-	TimeElapsed = (m_CurrentTime - m_LastTime) * m_TimeScale;
+	Clock::time_point Now = Clock::now();
 
-	if(m_LimitFPS > 0.0f)
+	if (m_LimitMode == TIMER_LIMIT_HYBRID)
 	{
-	while ( TimeElapsed < (1.0f / m_LimitFPS))
-        {
-		    QueryPerformanceCounter((LARGE_INTEGER*)&m_CurrentTime);
-		    //     
-	        TimeElapsed = (m_CurrentTime - m_LastTime) * m_TimeScale;
-        }
+		Clock::time_point SleepStart = Now;
+
+		//,        
+		while (Deadline - Now > m_SpinMargin)
+		{
+			Clock::time_point Wake = Deadline - m_SpinMargin;
+			std::this_thread::sleep_for(Wake - Now);
+			Now = Clock::now();
+
+			// -  ,  , 
+			//,       
+			Clock::duration Target = (Now - Wake) * 3 / 2;
+			if (Target > m_SpinMargin)
+				m_SpinMargin = Target;
+			else
+				m_SpinMargin -= (m_SpinMargin - Target) / 16;
+
+			if (m_SpinMargin < MinMargin)
+				m_SpinMargin = MinMargin;
+			if (m_SpinMargin > MaxMargin)
+				m_SpinMargin = MaxMargin;
+		}
+
+		m_Stats.SleepMs += To_Ms(Now - SleepStart);
 	}
-	m_LastTime = m_CurrentTime;
 
-	m_FPSFrameCount++;
-	m_FPSTimeElapsed += TimeElapsed;
-	if ( m_FPSTimeElapsed > 1.0f) 
-    {
-	m_FrameRate			= m_FPSFrameCount;
-	m_FPSFrameCount		= 0;
-	m_FPSTimeElapsed	= 0.0f;
+	Clock::time_point SpinStart = Now;
+
+	//    
+	while (Now < Deadline)
+	{
+		if (m_LimitMode == TIMER_LIMIT_HYBRID)
+			std::this_thread::yield();
+
+		Now = Clock::now();
 	}
-   	
-	return m_FrameRate;
+
+	m_Stats.SpinMs += To_Ms(Now - SpinStart);
+
+	double Error = To_Ms(Now - Deadline);
+
+	m_Stats.Frames++;
+	m_Stats.ErrorMs += Error;
+	m_Stats.ErrorSqMs += Error * Error;
+	if (Error > m_Stats.MaxErrorMs)
+		m_Stats.MaxErrorMs = Error;
 }
 
-void CTimer::Timer_Start(float LimitFPS)
+int CTimer::Calculate_FPS()
 {
-	m_LimitFPS = LimitFPS;
+	Clock::time_point CurrentTime = Clock::now();
+
+	if (m_LimitFPS > 0.0f)
+	{
+		Clock::time_point Deadline;
+
+		if (m_LimitMode == TIMER_LIMIT_SPIN)
+		{
+			//     ,  
+			Deadline = m_LastTime + m_FramePeriod;
+		}
+		else
+		{
+			//   :    
+			//,   
+			m_Deadline += m_FramePeriod;
 
-	QueryPerformanceFrequency((LARGE_INTEGER *)&m_PerfFreq);
-	QueryPerformanceCounter((LARGE_INTEGER *) &m_LastTime); 
-	m_StartTime= m_LastTime;
-	m_AppStartTime= m_LastTime;
-			
-	m_TimeScale			= 1.0f / m_PerfFreq;
+			if (CurrentTime - m_Deadline > m_FramePeriod)
+			{
+				//   - ,   
+				m_Deadline = CurrentTime;
+				m_Stats.Resyncs++;
+			}
 
-	m_FrameRate			= 0;
-	m_FPSFrameCount		= 0;
-	m_FPSTimeElapsed	= 0.0f;
+			Deadline = m_Deadline;
+		}
 
+		if (CurrentTime < Deadline)
+		{
+			Wait_Until(Deadline);
+			CurrentTime = Clock::now();
+		}
+		else
+		{
+			m_Stats.Late++;
+		}
+	}
+
+	//     
+	float TimeElapsed = std::chrono::duration<float>(CurrentTime - m_LastTime).count();
+	m_LastTime = CurrentTime;
+
+	m_FPSFrameCount++;
+	m_FPSTimeElapsed += TimeElapsed;
+	if (m_FPSTimeElapsed > 1.0f)
+	{
+		m_FrameRate = m_FPSFrameCount;
+		m_FPSFrameCount = 0;
+		m_FPSTimeElapsed = 0.0f;
+	}
+
+	return m_FrameRate;
 }
 
 float CTimer::Get_Absolute_Time()
 {
-	__int64 nowTime;
-    QueryPerformanceCounter((LARGE_INTEGER*)&nowTime);
-	m_AbsoluteTime = nowTime * m_TimeScale;
-    return (FLOAT) m_AbsoluteTime;
+	m_AbsoluteTime = std::chrono::duration<float>(Clock::now().time_since_epoch()).count();
+	return m_AbsoluteTime;
 }
 
 float CTimer::Get_App_Time()
 {
-	__int64 nowTime;
-    QueryPerformanceCounter((LARGE_INTEGER*)&nowTime);
-	m_AppTime = ((nowTime - m_AppStartTime)*m_TimeScale);
-    return  m_AppTime;
-
+	m_AppTime = std::chrono::duration<float>(Clock::now() - m_AppStartTime).count();
+	return m_AppTime;
 }
 
 float CTimer::Get_Elapsed_Time()
 {
-	__int64 nowTime;
-	QueryPerformanceCounter((LARGE_INTEGER*)&nowTime);
-	m_ElapsedTime = (nowTime - m_StartTime)*m_TimeScale;
-	m_StartTime=nowTime;
+	Clock::time_point NowTime = Clock::now();
+	m_ElapsedTime = std::chrono::duration<float>(NowTime - m_StartTime).count();
+	m_StartTime = NowTime;
 	return m_ElapsedTime;
+}
+
+const TimerLimiterStats& CTimer::Get_Limiter_Stats() const
+{
+	return m_Stats;
+}
+
+void CTimer::Report(const char* Name)
+{
+	double Frames = m_Stats.Frames ? (double)m_Stats.Frames : 1.0;
+	double Mean = m_Stats.ErrorMs / Frames;
+	double Variance = m_Stats.ErrorSqMs / Frames - Mean * Mean;
+
+	char Buffer[320];
+	snprintf(Buffer, sizeof(Buffer), "%s: %s %.0f fps, %llu waits, error %.3f ms (sd %.3f, max %.3f), sleep %.1f ms, spin %.1f ms, margin %.2f ms, %llu late, %llu resyncs\n",
+		Name, m_LimitMode == TIMER_LIMIT_HYBRID ? "hybrid" : "spin", m_LimitFPS, m_Stats.Frames,
+		Mean, sqrt(Variance > 0.0 ? Variance : 0.0), m_Stats.MaxErrorMs, m_Stats.SleepMs, m_Stats.SpinMs,
+		To_Ms(m_SpinMargin), m_Stats.Late, m_Stats.Resyncs);
+	Print_Report(Buffer);
+}
+
+struct LimiterRun
+{
+	double CpuPercent = 0.0;
+	double IntervalErrorMs = 0.0;
+	double MaxIntervalErrorMs = 0.0;
+	double DriftMs = 0.0;
+};
+
+static LimiterRun Run_Frame_Limiter(TimerLimitMode Mode, float LimitFPS, unsigned int Frames, double WorkMs)
+{
+	CTimer Timer;
+	Timer.Timer_Start(LimitFPS, Mode);
+
+	std::vector<Clock::time_point> Times(Frames + 1);
 
-}
\ No newline at end of file
+	double CpuStart = Get_Thread_Cpu_Ms();
+	Times[0] = Clock::now();
+	Timer.Calculate_FPS();
+
+	for (unsigned int Frame = 1; Frame <= Frames; Frame++)
+	{
+		//  -   ,   CPU 
+		//     
+		Clock::time_point WorkEnd = Clock::now() +
+			std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(WorkMs));
+		while (Clock::now() < WorkEnd)
+		{
+		}
+
+		Timer.Calculate_FPS();
+		Times[Frame] = Clock::now();
+	}
+
+	double CpuMs = Get_Thread_Cpu_Ms() - CpuStart;
+	double WallMs = To_Ms(Times[Frames] - Times[0]);
+	double PeriodMs = 1000.0 / LimitFPS;
+
+	LimiterRun Run;
+	Run.CpuPercent = WallMs > 0.0 ? CpuMs * 100.0 / WallMs : 0.0;
+
+	//   -    Times[0]
+	for (unsigned int Frame = 2; Frame <= Frames; Frame++)
+	{
+		double Error = fabs(To_Ms(Times[Frame] - Times[Frame - 1]) - PeriodMs);
+
+		Run.IntervalErrorMs += Error;
+		if (Error > Run.MaxIntervalErrorMs)
+			Run.MaxIntervalErrorMs = Error;
+	}
+
+	if (Frames > 1)
+		Run.IntervalErrorMs /= Frames - 1;
+
+	//    
+	Run.DriftMs = To_Ms(Times[Frames] - Times[1]) - PeriodMs * (Frames - 1);
+
+	return Run;
+}
+
+void Benchmark_Frame_Limiter(float LimitFPS, unsigned int Frames, double WorkMs)
+{
+	if (LimitFPS <= 0.0f || Frames < 2)
+		return;
+
+	LimiterRun Spin = Run_Frame_Limiter(TIMER_LIMIT_SPIN, LimitFPS, Frames, WorkMs);
+	LimiterRun Hybrid = Run_Frame_Limiter(TIMER_LIMIT_HYBRID, LimitFPS, Frames, WorkMs);
+
+	const LimiterRun* Runs[] = { &Spin, &Hybrid };
+	const char* Names[] = { "spin", "hybrid" };
+
+	char Buffer[256];
+	for (int i = 0; i < 2; i++)
+	{
+		snprintf(Buffer, sizeof(Buffer), "Frame limiter %s: %.0f fps, work %.1f ms, cpu %.1f%%, interval error %.3f ms (max %.3f), drift %.2f ms over %u frames\n",
+			Names[i], LimitFPS, WorkMs, Runs[i]->CpuPercent, Runs[i]->IntervalErrorMs,
+			Runs[i]->MaxIntervalErrorMs, Runs[i]->DriftMs, Frames);
+		Print_Report(Buffer);
+	}
+}
@@ -5,39 +5,95 @@
 #ifndef _TIMER_
 #define _TIMER_
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
+
+#include <chrono>
+
+//     , :  
+//,        
+#define TIMER_SPIN_MARGIN_US 2000
+#define TIMER_SPIN_MARGIN_MIN_US 200
+#define TIMER_SPIN_MARGIN_MAX_US 4000
+
+enum TimerLimitMode
+{
+	//     ,  -  ,
+	//        
+	TIMER_LIMIT_HYBRID,
+	// :       
+	//,   
+	TIMER_LIMIT_SPIN
+};
+
+struct TimerLimiterStats
+{
+	unsigned long long Frames = 0;
+	//     , 
+	double ErrorMs = 0.0;
+	double ErrorSqMs = 0.0;
+	double MaxErrorMs = 0.0;
+	double SleepMs = 0.0;
+	double SpinMs = 0.0;
+	//   ,  
+	unsigned long long Late = 0;
+	//    ,     
+	unsigned long long Resyncs = 0;
+};
 
 class CTimer
 {
 public:
-	
-	void Timer_Start(float LimitFPS);
+	CTimer() = default;
+	~CTimer();
+
+	CTimer(const CTimer& rhs) = delete;
+	CTimer& operator=(const CTimer& rhs) = delete;
+
+	//LimitFPS <= 0 -  
+	void Timer_Start(float LimitFPS, TimerLimitMode Mode = TIMER_LIMIT_HYBRID);
 	int Calculate_FPS();
 	float Get_Elapsed_Time();
 	float Get_App_Time();
 	float Get_Absolute_Time();
-	
+
+	const TimerLimiterStats& Get_Limiter_Stats() const;
+	void Report(const char* Name);
 
 private:
-	unsigned long   m_FrameRate;
-	float           m_TimeScale;
-	float           m_TimeElapsed;
-    __int64         m_CurrentTime;
-    __int64         m_LastTime;
-	__int64         m_PerfFreq;
-	
-	unsigned long   m_FPSFrameCount;
-	float           m_FPSTimeElapsed;
-	
-	float m_AbsoluteTime;
-	float m_ElapsedTime;
-	float m_AppTime;
-
-	__int64 m_StartTime;
-	__int64 m_AppStartTime;
-
-	float m_LimitFPS;
+	typedef std::chrono::steady_clock Clock;
+
+	void Wait_Until(Clock::time_point Deadline);
+
+	TimerLimitMode m_LimitMode = TIMER_LIMIT_HYBRID;
+	float m_LimitFPS = 0.0f;
+	Clock::duration m_FramePeriod = Clock::duration::zero();
+	Clock::time_point m_Deadline;
+	Clock::duration m_SpinMargin = std::chrono::microseconds(TIMER_SPIN_MARGIN_US);
+
+	unsigned long m_FrameRate = 0;
+	unsigned long m_FPSFrameCount = 0;
+	float m_FPSTimeElapsed = 0.0f;
+
+	Clock::time_point m_LastTime;
+	Clock::time_point m_StartTime;
+	Clock::time_point m_AppStartTime;
+
+	float m_AbsoluteTime = 0.0f;
+	float m_ElapsedTime = 0.0f;
+	float m_AppTime = 0.0f;
+
+	//timeBeginPeriod(1)    
+	bool m_SystemPeriod = false;
+
+	TimerLimiterStats m_Stats;
 };
 
+//Frames   WorkMs   LimitFPS   TIMER_LIMIT_SPIN
+// TIMER_LIMIT_HYBRID:  CPU ,    
+//   .   OutputDebugString (stdout
+// Windows)
+void Benchmark_Frame_Limiter(float LimitFPS, unsigned int Frames, double WorkMs);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,561 @@
+//======================================================================================
+//	Ed Kurlyak 2023 BC Encoder DirectX12
+//======================================================================================
+
+#include "BcEncoder.h"
+
+#include <string.h>
+#include <limits.h>
+#include <float.h>
+#include <math.h>
+
+//    ,   
+#define BC_MIN_BAND_ROWS 4
+
+static WORD Pack_565(const float* Color)
+{
+	int r = (int)(Color[0] * (31.0f / 255.0f) + 0.5f);
+	int g = (int)(Color[1] * (63.0f / 255.0f) + 0.5f);
+	int b = (int)(Color[2] * (31.0f / 255.0f) + 0.5f);
+
+	r = r < 0 ? 0 : (r > 31 ? 31 : r);
+	g = g < 0 ? 0 : (g > 63 ? 63 : g);
+	b = b < 0 ? 0 : (b > 31 ? 31 : b);
+
+	return (WORD)((r << 11) | (g << 5) | b);
+}
+
+static void Unpack_565(WORD Color, int* Rgb)
+{
+	int r = Color >> 11;
+	int g = (Color >> 5) & 63;
+	int b = Color & 31;
+
+	Rgb[0] = (r << 3) | (r >> 2);
+	Rgb[1] = (g << 2) | (g >> 4);
+	Rgb[2] = (b << 3) | (b >> 2);
+}
+
+//  4 , FourColors -  c0 > c1 ( BC3 )
+static void Bc1_Palette(WORD c0, WORD c1, bool FourColors, int Palette[4][3])
+{
+	Unpack_565(c0, Palette[0]);
+	Unpack_565(c1, Palette[1]);
+
+	for (int c = 0; c < 3; c++)
+	{
+		if (FourColors)
+		{
+			Palette[2][c] = (2 * Palette[0][c] + Palette[1][c]) / 3;
+			Palette[3][c] = (Palette[0][c] + 2 * Palette[1][c]) / 3;
+		}
+		else
+		{
+			Palette[2][c] = (Palette[0][c] + Palette[1][c]) / 2;
+			Palette[3][c] = 0;
+		}
+	}
+}
+
+//     ,   
+static UINT Bc1_Select_Indices(const BYTE* Texels, const int Palette[4][3], BYTE* Indices)
+{
+	UINT Error = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		const BYTE* t = Texels + i * 4;
+
+		UINT Best = UINT_MAX;
+		for (int p = 0; p < 4; p++)
+		{
+			int dr = t[0] - Palette[p][0];
+			int dg = t[1] - Palette[p][1];
+			int db = t[2] - Palette[p][2];
+			UINT d = (UINT)(dr * dr + dg * dg + db * db);
+
+			if (d < Best)
+			{
+				Best = d;
+				Indices[i] = (BYTE)p;
+			}
+		}
+
+		Error += Best;
+	}
+
+	return Error;
+}
+
+//     ( ),
+//  -     
+static void Bc1_Principal_Endpoints(const BYTE* Texels, float* E0, float* E1)
+{
+	float Mean[3] = { 0.0f, 0.0f, 0.0f };
+	float Min[3] = { 255.0f, 255.0f, 255.0f };
+	float Max[3] = { 0.0f, 0.0f, 0.0f };
+
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			float v = Texels[i * 4 + c];
+			Mean[c] += v;
+			Min[c] = v < Min[c] ? v : Min[c];
+			Max[c] = v > Max[c] ? v : Max[c];
+		}
+	}
+
+	for (int c = 0; c < 3; c++)
+		Mean[c] /= 16.0f;
+
+	float Cov[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+	for (int i = 0; i < 16; i++)
+	{
+		float r = Texels[i * 4 + 0] - Mean[0];
+		float g = Texels[i * 4 + 1] - Mean[1];
+		float b = Texels[i * 4 + 2] - Mean[2];
+
+		Cov[0] += r * r;
+		Cov[1] += r * g;
+		Cov[2] += r * b;
+		Cov[3] += g * g;
+		Cov[4] += g * b;
+		Cov[5] += b * b;
+	}
+
+	float Axis[3] = { Max[0] - Min[0], Max[1] - Min[1], Max[2] - Min[2] };
+
+	for (int Iter = 0; Iter < 8; Iter++)
+	{
+		float x = Axis[0] * Cov[0] + Axis[1] * Cov[1] + Axis[2] * Cov[2];
+		float y = Axis[0] * Cov[1] + Axis[1] * Cov[3] + Axis[2] * Cov[4];
+		float z = Axis[0] * Cov[2] + Axis[1] * Cov[4] + Axis[2] * Cov[5];
+
+		float Len = fabsf(x) > fabsf(y) ? fabsf(x) : fabsf(y);
+		Len = fabsf(z) > Len ? fabsf(z) : Len;
+
+		//   
+		if (Len < 1e-6f)
+			break;
+
+		Axis[0] = x / Len;
+		Axis[1] = y / Len;
+		Axis[2] = z / Len;
+	}
+
+	float AxisLen2 = Axis[0] * Axis[0] + Axis[1] * Axis[1] + Axis[2] * Axis[2];
+
+	if (AxisLen2 < 1e-6f)
+	{
+		for (int c = 0; c < 3; c++)
+			E0[c] = E1[c] = Mean[c];
+
+		return;
+	}
+
+	float MinT = FLT_MAX;
+	float MaxT = -FLT_MAX;
+
+	for (int i = 0; i < 16; i++)
+	{
+		float t = ((Texels[i * 4 + 0] - Mean[0]) * Axis[0] +
+			(Texels[i * 4 + 1] - Mean[1]) * Axis[1] +
+			(Texels[i * 4 + 2] - Mean[2]) * Axis[2]) / AxisLen2;
+
+		MinT = t < MinT ? t : MinT;
+		MaxT = t > MaxT ? t : MaxT;
+	}
+
+	for (int c = 0; c < 3; c++)
+	{
+		E0[c] = Mean[c] + Axis[c] * MaxT;
+		E1[c] = Mean[c] + Axis[c] * MinT;
+	}
+}
+
+//       
+static bool Bc1_Refine_Endpoints(const BYTE* Texels, const BYTE* Indices, float* E0, float* E1)
+{
+	static const float Weight[4] = { 1.0f, 0.0f, 2.0f / 3.0f, 1.0f / 3.0f };
+
+	float A = 0.0f, B = 0.0f, C = 0.0f;
+	float X[3] = { 0.0f, 0.0f, 0.0f };
+	float Y[3] = { 0.0f, 0.0f, 0.0f };
+
+	for (int i = 0; i < 16; i++)
+	{
+		float a = Weight[Indices[i]];
+		float b = 1.0f - a;
+
+		A += a * a;
+		B += b * b;
+		C += a * b;
+
+		for (int c = 0; c < 3; c++)
+		{
+			X[c] += a * Texels[i * 4 + c];
+			Y[c] += b * Texels[i * 4 + c];
+		}
+	}
+
+	float Det = A * B - C * C;
+	if (fabsf(Det) < 1e-6f)
+		return false;
+
+	for (int c = 0; c < 3; c++)
+	{
+		E0[c] = (X[c] * B - Y[c] * C) / Det;
+		E1[c] = (Y[c] * A - X[c] * C) / Det;
+	}
+
+	return true;
+}
+
+//c0  c1    ,      
+static void Bc1_Write_Block(WORD c0, WORD c1, const BYTE* Indices, BYTE* Block)
+{
+	BYTE Remap[4] = { 0, 1, 2, 3 };
+
+	//       c0 > c1,
+	//     0 <-> 1, 2 <-> 3
+	if (c0 < c1)
+	{
+		WORD Temp = c0;
+		c0 = c1;
+		c1 = Temp;
+
+		Remap[0] = 1;
+		Remap[1] = 0;
+		Remap[2] = 3;
+		Remap[3] = 2;
+	}
+
+	UINT Bits = 0;
+
+	// c0 == c1     c0
+	if (c0 != c1)
+	{
+		for (int i = 0; i < 16; i++)
+			Bits |= (UINT)Remap[Indices[i]] << (i * 2);
+	}
+
+	Block[0] = (BYTE)(c0 & 0xFF);
+	Block[1] = (BYTE)(c0 >> 8);
+	Block[2] = (BYTE)(c1 & 0xFF);
+	Block[3] = (BYTE)(c1 >> 8);
+	Block[4] = (BYTE)(Bits & 0xFF);
+	Block[5] = (BYTE)((Bits >> 8) & 0xFF);
+	Block[6] = (BYTE)((Bits >> 16) & 0xFF);
+	Block[7] = (BYTE)(Bits >> 24);
+}
+
+void Encode_BC1_Block(const BYTE* Texels, BYTE* Block)
+{
+	float E0[3], E1[3];
+	Bc1_Principal_Endpoints(Texels, E0, E1);
+
+	WORD Best0 = Pack_565(E0);
+	WORD Best1 = Pack_565(E1);
+
+	int Palette[4][3];
+	BYTE BestIndices[16];
+
+	Bc1_Palette(Best0, Best1, true, Palette);
+	UINT BestError = Bc1_Select_Indices(Texels, Palette, BestIndices);
+
+	//    ,   
+	BYTE Indices[16];
+	memcpy(Indices, BestIndices, sizeof(Indices));
+
+	for (int Iter = 0; Iter < 2 && BestError > 0; Iter++)
+	{
+		if (!Bc1_Refine_Endpoints(Texels, Indices, E0, E1))
+			break;
+
+		WORD c0 = Pack_565(E0);
+		WORD c1 = Pack_565(E1);
+
+		Bc1_Palette(c0, c1, true, Palette);
+		UINT Error = Bc1_Select_Indices(Texels, Palette, Indices);
+
+		if (Error >= BestError)
+			break;
+
+		BestError = Error;
+		Best0 = c0;
+		Best1 = c1;
+		memcpy(BestIndices, Indices, sizeof(Indices));
+	}
+
+	Bc1_Write_Block(Best0, Best1, BestIndices, Block);
+}
+
+// , a0 > a1 - 8 ,  6   0  255
+static void Bc3_Alpha_Palette(int a0, int a1, int* Palette)
+{
+	Palette[0] = a0;
+	Palette[1] = a1;
+
+	if (a0 > a1)
+	{
+		for (int i = 1; i < 7; i++)
+			Palette[i + 1] = ((7 - i) * a0 + i * a1) / 7;
+	}
+	else
+	{
+		for (int i = 1; i < 5; i++)
+			Palette[i + 1] = ((5 - i) * a0 + i * a1) / 5;
+
+		Palette[6] = 0;
+		Palette[7] = 255;
+	}
+}
+
+static UINT Bc3_Select_Alpha(const BYTE* Texels, int a0, int a1, UINT64& Bits)
+{
+	int Palette[8];
+	Bc3_Alpha_Palette(a0, a1, Palette);
+
+	UINT Error = 0;
+	Bits = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		int a = Texels[i * 4 + 3];
+
+		UINT Best = UINT_MAX;
+		UINT BestIndex = 0;
+		for (UINT p = 0; p < 8; p++)
+		{
+			UINT d = (UINT)((a - Palette[p]) * (a - Palette[p]));
+			if (d < Best)
+			{
+				Best = d;
+				BestIndex = p;
+			}
+		}
+
+		Bits |= (UINT64)BestIndex << (i * 3);
+		Error += Best;
+	}
+
+	return Error;
+}
+
+void Encode_BC3_Block(const BYTE* Texels, BYTE* Block)
+{
+	// 8     
+	int Min = 255, Max = 0;
+	// 6      0  255,
+	// 0  255  
+	int InnerMin = 255, InnerMax = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		int a = Texels[i * 4 + 3];
+
+		Min = a < Min ? a : Min;
+		Max = a > Max ? a : Max;
+
+		if (a != 0 && a != 255)
+		{
+			InnerMin = a < InnerMin ? a : InnerMin;
+			InnerMax = a > InnerMax ? a : InnerMax;
+		}
+	}
+
+	int a0 = Max;
+	int a1 = Min;
+
+	UINT64 Bits;
+	UINT Error = Max > Min ? Bc3_Select_Alpha(Texels, a0, a1, Bits) : 0;
+
+	if (Max == Min)
+	{
+		//   ,  0
+		Bits = 0;
+	}
+	else if (Error > 0)
+	{
+		if (InnerMin > InnerMax)
+		{
+			InnerMin = 0;
+			InnerMax = 0;
+		}
+
+		UINT64 Bits6;
+		UINT Error6 = Bc3_Select_Alpha(Texels, InnerMin, InnerMax, Bits6);
+
+		if (Error6 < Error)
+		{
+			a0 = InnerMin;
+			a1 = InnerMax;
+			Bits = Bits6;
+		}
+	}
+
+	Block[0] = (BYTE)a0;
+	Block[1] = (BYTE)a1;
+
+	for (int i = 0; i < 6; i++)
+		Block[2 + i] = (BYTE)(Bits >> (i * 8));
+
+	//  BC3     ,
+	//Bc1_Write_Block     c0 > c1
+	Encode_BC1_Block(Texels, Block + 8);
+}
+
+void Decode_BC1_Block(const BYTE* Block, BYTE* Texels)
+{
+	WORD c0 = (WORD)(Block[0] | (Block[1] << 8));
+	WORD c1 = (WORD)(Block[2] | (Block[3] << 8));
+	UINT Bits = Block[4] | (Block[5] << 8) | (Block[6] << 16) | ((UINT)Block[7] << 24);
+
+	int Palette[4][3];
+	Bc1_Palette(c0, c1, c0 > c1, Palette);
+
+	for (int i = 0; i < 16; i++)
+	{
+		UINT Index = (Bits >> (i * 2)) & 3;
+
+		Texels[i * 4 + 0] = (BYTE)Palette[Index][0];
+		Texels[i * 4 + 1] = (BYTE)Palette[Index][1];
+		Texels[i * 4 + 2] = (BYTE)Palette[Index][2];
+		//     3 
+		Texels[i * 4 + 3] = (c0 <= c1 && Index == 3) ? 0 : 255;
+	}
+}
+
+void Decode_BC3_Block(const BYTE* Block, BYTE* Texels)
+{
+	// BC3     
+	WORD c0 = (WORD)(Block[8] | (Block[9] << 8));
+	WORD c1 = (WORD)(Block[10] | (Block[11] << 8));
+	UINT Bits = Block[12] | (Block[13] << 8) | (Block[14] << 16) | ((UINT)Block[15] << 24);
+
+	int Palette[4][3];
+	Bc1_Palette(c0, c1, true, Palette);
+
+	int AlphaPalette[8];
+	Bc3_Alpha_Palette(Block[0], Block[1], AlphaPalette);
+
+	UINT64 AlphaBits = 0;
+	for (int i = 0; i < 6; i++)
+		AlphaBits |= (UINT64)Block[2 + i] << (i * 8);
+
+	for (int i = 0; i < 16; i++)
+	{
+		UINT Index = (Bits >> (i * 2)) & 3;
+
+		Texels[i * 4 + 0] = (BYTE)Palette[Index][0];
+		Texels[i * 4 + 1] = (BYTE)Palette[Index][1];
+		Texels[i * 4 + 2] = (BYTE)Palette[Index][2];
+		Texels[i * 4 + 3] = (BYTE)AlphaPalette[(AlphaBits >> (i * 3)) & 7];
+	}
+}
+
+UINT Bc_Block_Size(DXGI_FORMAT Format)
+{
+	if (Format == DXGI_FORMAT_BC1_UNORM)
+		return BC1_BLOCK_SIZE;
+
+	if (Format == DXGI_FORMAT_BC3_UNORM)
+		return BC3_BLOCK_SIZE;
+
+	return 0;
+}
+
+// 4x4  ,     
+static void Fetch_Block(const BYTE* Src, UINT SrcRowPitch, UINT Width, UINT Height,
+	UINT BlockX, UINT BlockY, BYTE* Texels)
+{
+	for (UINT y = 0; y < 4; y++)
+	{
+		UINT sy = BlockY * 4 + y;
+		sy = sy < Height ? sy : Height - 1;
+
+		for (UINT x = 0; x < 4; x++)
+		{
+			UINT sx = BlockX * 4 + x;
+			sx = sx < Width ? sx : Width - 1;
+
+			memcpy(Texels + (y * 4 + x) * 4, Src + (size_t)sy * SrcRowPitch + sx * 4, 4);
+		}
+	}
+}
+
+void Compress_BC(DXGI_FORMAT Format, const BYTE* Src, UINT SrcRowPitch, UINT Width, UINT Height,
+	BYTE* Dst, UINT DstRowPitch, CThreadPool* Pool)
+{
+	UINT BlockSize = Bc_Block_Size(Format);
+	UINT BlocksWide = (Width + 3) / 4;
+	UINT BlocksHigh = (Height + 3) / 4;
+
+	Run_Parallel_Rows(Pool, BlocksHigh, BC_MIN_BAND_ROWS, [&](UINT Row0, UINT Row1)
+	{
+		BYTE Texels[16 * 4];
+
+		for (UINT by = Row0; by < Row1; by++)
+		{
+			BYTE* Out = Dst + (size_t)by * DstRowPitch;
+
+			for (UINT bx = 0; bx < BlocksWide; bx++)
+			{
+				Fetch_Block(Src, SrcRowPitch, Width, Height, bx, by, Texels);
+
+				if (Format == DXGI_FORMAT_BC3_UNORM)
+					Encode_BC3_Block(Texels, Out + bx * BlockSize);
+				else
+					Encode_BC1_Block(Texels, Out + bx * BlockSize);
+			}
+		}
+	});
+}
+
+void Decompress_BC(DXGI_FORMAT Format, const BYTE* Src, UINT SrcRowPitch, UINT Width, UINT Height,
+	BYTE* Dst, UINT DstRowPitch)
+{
+	UINT BlockSize = Bc_Block_Size(Format);
+	BYTE Texels[16 * 4];
+
+	for (UINT by = 0; by < (Height + 3) / 4; by++)
+	{
+		for (UINT bx = 0; bx < (Width + 3) / 4; bx++)
+		{
+			const BYTE* Block = Src + (size_t)by * SrcRowPitch + bx * BlockSize;
+
+			if (Format == DXGI_FORMAT_BC3_UNORM)
+				Decode_BC3_Block(Block, Texels);
+			else
+				Decode_BC1_Block(Block, Texels);
+
+			for (UINT y = 0; y < 4 && by * 4 + y < Height; y++)
+			{
+				for (UINT x = 0; x < 4 && bx * 4 + x < Width; x++)
+					memcpy(Dst + (size_t)(by * 4 + y) * DstRowPitch + (bx * 4 + x) * 4, Texels + (y * 4 + x) * 4, 4);
+			}
+		}
+	}
+}
+
+double Compute_PSNR(const BYTE* A, const BYTE* B, UINT Width, UINT Height, UINT Channels)
+{
+	double Sum = 0.0;
+
+	for (size_t i = 0; i < (size_t)Width * Height; i++)
+	{
+		for (UINT c = 0; c < Channels; c++)
+		{
+			double d = (double)A[i * 4 + c] - (double)B[i * 4 + c];
+			Sum += d * d;
+		}
+	}
+
+	double Mse = Sum / ((double)Width * Height * Channels);
+	if (Mse <= 0.0)
+		return 100.0;
+
+	return 10.0 * log10(255.0 * 255.0 / Mse);
+}
@@ -0,0 +1,68 @@
+//======================================================================================
+//	Ed Kurlyak 2023 BMP File DirectX12
+//======================================================================================
+
+#ifndef _BMPFILE_
+#define _BMPFILE_
+
+#include <windows.h>
+#include <string>
+
+//        D3D,
+//      
+#define BMP_DECODE_TOP_DOWN 1
+
+struct BmpInfo
+{
+	UINT Width;
+	UINT Height;
+	//24  32
+	UINT BitCount;
+	//      (biHeight < 0)
+	bool TopDown;
+	UINT DataOffset;
+	//       4 
+	UINT RowPitch;
+};
+
+//  BMP  : 24  BI_RGB, 32  BI_RGB
+// BI_BITFIELDS   BGRA,  BITMAPINFOHEADER  
+bool Bmp_Parse_Header(const BYTE* Data, UINT64 Size, BmpInfo& Info);
+
+//   RGBA8    (  
+// ), Dst - Height   Width * 4    DstRowPitch,
+//    upload 
+void Bmp_Decode_RGBA(const BYTE* Data, const BmpInfo& Info, void* Dst, UINT DstRowPitch, UINT Flags);
+
+//BMP    file mapping,  
+//     
+class CBmpFile
+{
+public:
+	CBmpFile();
+	~CBmpFile();
+
+	CBmpFile(const CBmpFile& rhs) = delete;
+	CBmpFile& operator=(const CBmpFile& rhs) = delete;
+
+	bool Open(const std::wstring& Filename);
+	void Close();
+
+	UINT Width() const;
+	UINT Height() const;
+	const BmpInfo& Info() const;
+
+	void Decode_RGBA(void* Dst, UINT DstRowPitch, UINT Flags) const;
+
+private:
+	HANDLE m_File = INVALID_HANDLE_VALUE;
+	HANDLE m_Mapping = NULL;
+	const BYTE* m_View = nullptr;
+	BmpInfo m_Info = {};
+};
+
+//   MB/s    256x256  8192x8192,
+//   SSSE3  AVX2,    OutputDebugString
+void Benchmark_Bmp_Decoder();
+
+#endif
@@ -14,6 +14,13 @@ CMeshManager::~CMeshManager()
 {
 	if (m_d3dDevice != nullptr)
 		FlushCommandQueue();
+
+	m_FrameScheduler.Report("Frame scheduler");
+	m_FramePacer.Report("Frame pacing");
+	m_Timer.Report("Frame limiter");
+	m_FrameStats.Report("Frame stats");
+
+	m_TextBuffer.Report("Text buffer");
 }
 
 void CMeshManager::EnableDebugLayer_CreateFactory()
@@ -46,6 +53,11 @@ void CMeshManager::Create_Device()
 
 	StrAdapterName = AdapterDesc.Description;
 
+	// wchar_t  char   Print_Text()
+	std::transform(StrAdapterName.begin(), StrAdapterName.end(), std::back_inserter(StrAdapterNameText), [](wchar_t c) {
+		return (char)c;
+		});
+
 	HRESULT hardwareResult = D3D12CreateDevice(
 		nullptr,             // default adapter
 		D3D_FEATURE_LEVEL_11_0,
@@ -114,29 +126,44 @@ void CMeshManager::Create_CommandList_Allocator_Queue()
 
 void CMeshManager::Create_SwapChain()
 {
+	m_FramePacer.Release();
 	m_SwapChain.Reset();
 
-	DXGI_SWAP_CHAIN_DESC sd;
-	sd.BufferDesc.Width = m_ClientWidth;
-	sd.BufferDesc.Height = m_ClientHeight;
-	sd.BufferDesc.RefreshRate.Numerator = 60;
-	sd.BufferDesc.RefreshRate.Denominator = 1;
-	sd.BufferDesc.Format = m_BackBufferFormat;
-	sd.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-	sd.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+	//waitable object   , tearing - FRAME_PACING_MAX_THROUGHPUT
+	m_TearingSupported = Check_Tearing_Support(m_dxgiFactory.Get());
+	m_SwapChainFlags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH |
+		Get_Frame_Pacing_Swap_Chain_Flags(m_TearingSupported);
+
+	DXGI_SWAP_CHAIN_DESC1 sd = {};
+	sd.Width = m_ClientWidth;
+	sd.Height = m_ClientHeight;
+	sd.Format = m_BackBufferFormat;
+	sd.Stereo = false;
 	sd.SampleDesc.Count = m_4xMsaaState ? 4 : 1;
 	sd.SampleDesc.Quality = m_4xMsaaState ? (m_4xMsaaQuality - 1) : 0;
 	sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
 	sd.BufferCount = m_SwapChainBufferCount;
-	sd.OutputWindow = m_hWnd;
-	sd.Windowed = true;
+	sd.Scaling = DXGI_SCALING_STRETCH;
 	sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-	sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
+	sd.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+	sd.Flags = m_SwapChainFlags;
 
-	ThrowIfFailed(m_dxgiFactory->CreateSwapChain(
+	Microsoft::WRL::ComPtr<IDXGISwapChain1> SwapChain1;
+	ThrowIfFailed(m_dxgiFactory->CreateSwapChainForHwnd(
 		m_CommandQueue.Get(),
+		m_hWnd,
 		&sd,
-		m_SwapChain.GetAddressOf()));
+		nullptr,
+		nullptr,
+		SwapChain1.GetAddressOf()));
+
+	ThrowIfFailed(SwapChain1.As(&m_SwapChain));
+
+	//Present  ALLOW_TEARING    exclusive fullscreen
+	if (m_TearingSupported)
+		ThrowIfFailed(m_dxgiFactory->MakeWindowAssociation(m_hWnd, DXGI_MWA_NO_ALT_ENTER));
+
+	m_FramePacer.Init(m_SwapChain.Get(), FRAME_PACING_MODE, FRAMES_IN_FLIGHT, m_TearingSupported);
 }
 
 void CMeshManager::Resize_SwapChainBuffers()
@@ -158,24 +185,12 @@ void CMeshManager::Resize_SwapChainBuffers()
 		m_SwapChainBufferCount,
 		m_ClientWidth, m_ClientHeight,
 		m_BackBufferFormat,
-		DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH));
+		m_SwapChainFlags));
 }
 
 void CMeshManager::FlushCommandQueue()
 {
-	m_CurrentFence++;
-
-	ThrowIfFailed(m_CommandQueue->Signal(m_Fence.Get(), m_CurrentFence));
-
-	if (m_Fence->GetCompletedValue() < m_CurrentFence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-
-		ThrowIfFailed(m_Fence->SetEventOnCompletion(m_CurrentFence, eventHandle));
-
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	m_FrameScheduler.Flush();
 }
 
 void CMeshManager::Create_Dsv_DescriptorHeaps_And_View()
@@ -231,11 +246,18 @@ D3D12_CPU_DESCRIPTOR_HANDLE CMeshManager::DepthStencilView()
 
 void CMeshManager::Execute_Init_Commands()
 {
+	//    
+	m_UploadBatch.Record(m_CommandList.Get());
+
 	ThrowIfFailed(m_CommandList->Close());
 	ID3D12CommandList* cmdsLists[] = { m_CommandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
 	FlushCommandQueue();
+
+	// , upload    
+	m_UploadRing.Retire_All(m_FrameScheduler.Current_Fence());
+	m_UploadRing.Reclaim();
 }
 
 void CMeshManager::Update_ViewPort_And_Scissor()
@@ -252,83 +274,51 @@ void CMeshManager::Update_ViewPort_And_Scissor()
 
 void CMeshManager::LoadTextures()
 {
-	ThrowIfFailed(m_CommandList->Reset(m_DirectCmdListAlloc.Get(), nullptr));
-
 	auto FontTex = std::make_unique<Texture>();
 	FontTex->Name = "FontTex";
 	FontTex->Filename = L"./ExportedFont.bmp";
 
-	// BMP      
-	FILE* Fp = NULL;
-	fopen_s(&Fp, "ExportedFont.bmp", "rb");
-	if (Fp == NULL)
-		MessageBox(NULL, L"Error Open File", L"INFO", MB_OK);
-
-	//   
-	BITMAPFILEHEADER Bfh;
-	fread(&Bfh, sizeof(BITMAPFILEHEADER), 1, Fp);
-
-	//   
-	BITMAPINFOHEADER Bih;
-	fread(&Bih, sizeof(BITMAPINFOHEADER), 1, Fp);
-
-	//   BMP    
-	fseek(Fp, Bfh.bfOffBits, SEEK_SET);
-
-	//      BMP 
-	unsigned char* ResTemp;
-	ResTemp = new unsigned char[Bih.biHeight * Bih.biWidth * 4];
-	//   rgb  
-	fread(ResTemp, Bih.biHeight * Bih.biWidth * 4, 1, Fp);
-
-	//   
-	fclose(Fp);
-
-	TextureWidth = Bih.biWidth;
-	TextureHeight = Bih.biHeight;
+	//ExportedFont.bmp   ExportedFont.tex (BC3,  
+	//  )  ,  BMP  ,
+	//    
+	if (Texture_Binary_Is_Stale(L"ExportedFont.bmp", L"ExportedFont.tex"))
+	{
+		CThreadPool Pool;
+		Convert_Bmp_To_Texture(L"ExportedFont.bmp", L"ExportedFont.tex", BMP_DECODE_TOP_DOWN, true, false, &Pool);
+	}
 
-	unsigned char* Res = new unsigned char[TextureWidth * TextureHeight * 4];
+#ifdef TEXTURE_COOKER_REPORT
+	{
+		CThreadPool Pool;
+		Report_Texture_Compression({ L"ExportedFont.bmp" }, BMP_DECODE_TOP_DOWN, true, false, &Pool);
+	}
+#endif
 
-	int index = 0;
-	for (int h = 0; h < Bih.biHeight; h++)
+	CTextureFile Tex;
+	if (!Tex.Open(L"ExportedFont.tex"))
 	{
-		for (int w = 0; w < Bih.biWidth; w++)
-		{
-
-			// BMP   
-			int Index1 = (h * Bih.biWidth + w) * 4;
-			int Index2 = ((Bih.biHeight - 1 - h) * Bih.biWidth + w) * 4;
-			
-			// RGB 
-			Res[Index2 + 0] = ResTemp[Index1 + 0];
-			Res[Index2 + 1] = ResTemp[Index1 + 1];
-			Res[Index2 + 2] = ResTemp[Index1 + 2];
-			Res[Index2 + 3] = ResTemp[Index1 + 3];
-		}
+		MessageBox(NULL, L"Error Open File", L"INFO", MB_OK);
+		return;
 	}
 
 	FontTex->Resource = CreateTexture(m_d3dDevice.Get(),
-		m_CommandList.Get(), Res, TextureWidth * TextureHeight * 4, FontTex->UploadHeap);
-	
-	delete[] Res;
+		Tex, m_UploadBatch);
 
 	m_Textures[FontTex->Name] = std::move(FontTex);
 }
 
 Microsoft::WRL::ComPtr<ID3D12Resource> CMeshManager::CreateTexture(
 	ID3D12Device* device,
-	ID3D12GraphicsCommandList* cmdList,
-	const void* initData,
-	UINT64 byteSize,
-	Microsoft::WRL::ComPtr<ID3D12Resource>& UploadBuffer)
+	const CTextureFile& Tex,
+	CUploadBatch& UploadBatch)
 {
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_Texture;
 	
 	D3D12_RESOURCE_DESC textureDesc = {};
-	textureDesc.MipLevels = 1;
-	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	textureDesc.Width = TextureWidth;
-	textureDesc.Height = TextureHeight;
+	textureDesc.MipLevels = (UINT16)Tex.MipLevels();
+	textureDesc.Format = Tex.Format();
+	textureDesc.Width = Tex.Width();
+	textureDesc.Height = Tex.Height();
 	textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 	textureDesc.DepthOrArraySize = 1;
 	textureDesc.SampleDesc.Count = 1;
@@ -343,24 +333,26 @@ Microsoft::WRL::ComPtr<ID3D12Resource> CMeshManager::CreateTexture(
 		nullptr,
 		IID_PPV_ARGS(m_Texture.GetAddressOf())));
 
-	const UINT64 UploadBufferSize = GetRequiredIntermediateSize(m_Texture.Get(), 0, 1);
-
-	ThrowIfFailed(device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(UploadBufferSize),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&UploadBuffer)));
+	//   upload   D3D12 ( 256 ),
+	// BC      4x4.  
+	//      upload 
+	UINT MipLevels = Tex.MipLevels();
+	std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> Footprints(MipLevels);
+	UploadAllocation Upload = UploadBatch.Allocate_Texture(textureDesc, Footprints.data());
 
-	D3D12_SUBRESOURCE_DATA textureData = {};
-	textureData.pData = initData;
-	textureData.RowPitch = TextureWidth * 4;
-	textureData.SlicePitch = textureData.RowPitch * TextureHeight;
+	//    .tex    upload 
+	for (UINT Level = 0; Level < MipLevels; Level++)
+		Tex.Copy_Level(Level, Upload.Mapped + Footprints[Level].Offset, Footprints[Level].Footprint.RowPitch);
 
-	UpdateSubresources(cmdList, m_Texture.Get(), UploadBuffer.Get(), 0, 0, 1, &textureData);
+	for (UINT Level = 0; Level < MipLevels; Level++)
+	{
+		CD3DX12_TEXTURE_COPY_LOCATION Dst(m_Texture.Get(), Level);
+		CD3DX12_TEXTURE_COPY_LOCATION Src(Upload.Resource, Footprints[Level]);
+		UploadBatch.Copy_Texture_Region(Dst, 0, 0, Src);
+	}
 
-	cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_Texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+	//   COPY_DEST,  PSR    
+	UploadBatch.Add_Resource(m_Texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
 	return m_Texture;
 }
@@ -418,6 +410,8 @@ void CMeshManager::Create_Frame_Resources()
 		m_FrameResources.push_back(std::make_unique<FrameResource>(m_d3dDevice.Get(),
 			1, 0));
 	}
+
+	m_TextBuffer.Init(m_d3dDevice.Get(), m_NumFrameResources, TEXT_BUFFER_MAX_CHARS);
 }
 
 
@@ -586,18 +580,30 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 
 	CreateFence_GetDescriptorsSize();
 
+	m_UploadRing.Init(m_d3dDevice.Get(), m_Fence.Get(), UPLOAD_RING_SIZE);
+	m_UploadBatch.Init(&m_UploadRing);
+
 	Check_Multisample_Quality();
 
 	Create_CommandList_Allocator_Queue();
 
+	m_FrameScheduler.Init(m_CommandQueue.Get(), m_Fence.Get(), m_NumFrameResources);
+	m_FrameScheduler.Set_Frames_In_Flight(FRAMES_IN_FLIGHT);
+
+#ifdef FRAME_SCHEDULER_VERIFY
+	Verify_Frame_Scheduler();
+#endif
+
+#ifdef FRAME_PACING_VERIFY
+	Verify_Frame_Pacing();
+#endif
+
 	Create_SwapChain();
 
 	Resize_SwapChainBuffers();
 
 	Create_Dsv_DescriptorHeaps_And_View();
 
-	Execute_Init_Commands();
-
 	Update_ViewPort_And_Scissor();
 
 	LoadTextures();
@@ -608,6 +614,10 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 
 	Create_Frame_Resources();
 
+#ifdef TEXT_BUFFER_VERIFY
+	Verify_Text_Buffer();
+#endif
+
 	Create_Cube_Shaders_And_InputLayout_Pass1();
 
 	Create_RootSignature();
@@ -615,6 +625,7 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 	Create_PipelineStateObject_Pass1();
 
 	Execute_Init_Commands();
+	m_UploadBatch.Report("Init upload");
 
 	DirectX::XMVECTOR Pos = DirectX::XMVectorSet(0, 0.0f, -8.0f, 1.0f);
 	DirectX::XMVECTOR Target = DirectX::XMVectorZero();
@@ -626,50 +637,33 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 	DirectX::XMMATRIX MatProj = DirectX::XMMatrixPerspectiveFovLH(0.25f * DirectX::XM_PI, 4.0f / 3.0f, 1.0f, 1000.0f);
 	XMStoreFloat4x4(&m_Proj, MatProj);
 	
-	m_Timer.Timer_Start(30);
-}
+#ifdef TIMER_LIMITER_BENCHMARK
+	Benchmark_Frame_Limiter(30.0f, 90, 2.0);
+#endif
 
-void CMeshManager::Print_Text(unsigned int StringNum, char* Text, float x, float y, float SizeX, float SizeY)
-{
+	m_Timer.Timer_Start(30);
 
-	UINT Length = (UINT)strlen(Text);
+#ifdef FRAME_STATS_VERIFY
+	Verify_Frame_Stats();
+#endif
 
-	std::vector<Vertex> VertBuff;
+#ifdef FRAME_STATS_BENCHMARK
+	Benchmark_Frame_Stats();
+#endif
 
-	for (unsigned int i = 0; i < Length; i++)
-	{
-		//  16 
-		//    
-		float TexWidth = 256.0f;
-		//     3 
-		float Tw1 = 3.0f / TexWidth;
-		//  9 
-		float Tw2 = 9.0f / TexWidth;
-
-		char character = Text[i];
-		float uv_x = (character % 16) / 16.0f;
-		float uv_y = (character / 16) / 16.0f;
-
-		Vertex VertexUpLeft = { x + i * SizeX,			y,	0.0f, uv_x + Tw1,		uv_y };
-		Vertex VertexUpRight = { x + i * SizeX + SizeX,	y,	0.0f, uv_x + Tw1 + Tw2,	uv_y };
-		Vertex VertexDownRight = { x + i * SizeX + SizeX,	y + SizeY,	0.0f, uv_x + Tw1 + Tw2,	uv_y + 1.0f / 16.0f };
-		Vertex VertexDownLeft = { x + i * SizeX,			y + SizeY,	0.0f, uv_x + Tw1,		uv_y + 1.0f / 16.0f };
-
-		VertBuff.push_back(VertexDownLeft);
-		VertBuff.push_back(VertexUpLeft);
-		VertBuff.push_back(VertexUpRight);
-
-		VertBuff.push_back(VertexDownLeft);
-		VertBuff.push_back(VertexUpRight);
-		VertBuff.push_back(VertexDownRight);
-	}
+#if FRAME_STATS_EXPORT_SECONDS > 0
+	m_FrameStats.Start_Export(FRAME_STATS_EXPORT_NAME, FRAME_STATS_EXPORT_SECONDS);
+#endif
+}
 
-	Vert_Buff_DX[StringNum] = std::make_unique<UploadBuffer<Vertex>>(m_d3dDevice.Get(), VertBuff.size(), false);
+void CMeshManager::Print_Text(const char* Text, float x, float y, float SizeX, float SizeY)
+{
+	//       
+	D3D12_VERTEX_BUFFER_VIEW vbv;
+	UINT VertexCount = m_TextBuffer.Append_Text(Text, x, y, SizeX, SizeY, vbv);
 
-	for (unsigned int i = 0; i < VertBuff.size(); i++)
-	{
-		Vert_Buff_DX[StringNum]->CopyData(i, VertBuff[i]);
-	}
+	if (VertexCount == 0)
+		return;
 
 	// 
 	ID3D12DescriptorHeap* descriptorHeaps[] = { m_SrvDescriptorHeap.Get() };
@@ -679,36 +673,39 @@ void CMeshManager::Print_Text(unsigned int StringNum, char* Text, float x, float
 	m_CommandList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 
 	//  
-	D3D12_VERTEX_BUFFER_VIEW vbv;
-	vbv.BufferLocation = Vert_Buff_DX[StringNum]->Resource()->GetGPUVirtualAddress();
-	vbv.StrideInBytes = sizeof(Vertex);
-	vbv.SizeInBytes = (UINT)VertBuff.size() * sizeof(Vertex);;
-
 	m_CommandList->IASetVertexBuffers(0, 1, &vbv);
 
 	//    -  
-	m_CommandList->DrawInstanced(VertBuff.size(), 1, 0, 0);
+	m_CommandList->DrawInstanced(VertexCount, 1, 0, 0);
 }
 
 void CMeshManager::Update_MeshManager()
 {
+	m_FrameStats.Begin_Frame();
+
+	//    swap chain   ,  LOW_LATENCY
+	//     
+	m_FramePacer.Wait_Frame();
 
 	float ElapsedTime = m_Timer.Get_Elapsed_Time();
+	m_FramePacer.Input_Sampled();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
+
+	m_FrameStats.Phase_End(FRAME_PHASE_UPDATE);
 
-	m_CurrFrameResourceIndex = (m_CurrFrameResourceIndex + 1) % m_NumFrameResources;
+	//,  GPU    
+	m_CurrFrameResourceIndex = m_FrameScheduler.Begin_Frame();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
 	m_CurrFrameResource = m_FrameResources[m_CurrFrameResourceIndex].get();
 
-	if (m_CurrFrameResource->Fence != 0 && m_Fence->GetCompletedValue() < m_CurrFrameResource->Fence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-		ThrowIfFailed(m_Fence->SetEventOnCompletion(m_CurrFrameResource->Fence, eventHandle));
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	//GPU       
+	m_TextBuffer.Begin_Frame(m_CurrFrameResourceIndex);
 }
 
 void CMeshManager::Draw_MeshManager()
 {
+	m_FrameStats.Phase_End(FRAME_PHASE_UPDATE);
+
 	auto CmdListAlloc = m_CurrFrameResource->CmdListAlloc;
 
 	ThrowIfFailed(CmdListAlloc->Reset());
@@ -740,19 +737,29 @@ void CMeshManager::Draw_MeshManager()
 	float char_w = 10.0f;
 	float char_h = 20.0f;
 
-	std::string AdapterNameBuff;
-	// wchar_t  char   Print_Text()
-	std::transform(StrAdapterName.begin(), StrAdapterName.end(), std::back_inserter(AdapterNameBuff), [](wchar_t c) {
-		return (char)c;
-		});
-
-	sprintf_s(buff, 256, "Vendor %s", AdapterNameBuff.c_str());
-	Print_Text(0, buff, 100.0f, 100.0f + char_h * 0.0f, char_w, char_h);
+	sprintf_s(buff, 256, "Vendor %s", StrAdapterNameText.c_str());
+	Print_Text(buff, 100.0f, 100.0f + char_h * 0.0f, char_w, char_h);
 		
+	// FPS   ,   - 
+	m_FrameStats.Phase_End(FRAME_PHASE_RECORD);
 	unsigned int UnisgnedIntFPS = m_Timer.Calculate_FPS();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
 
 	sprintf_s(buff, 256, "FPS %d", UnisgnedIntFPS);
-	Print_Text(1, buff, 100.0f, 100.0f + char_h * 2.0f, char_w, char_h);
+	Print_Text(buff, 100.0f, 100.0f + char_h * 2.0f, char_w, char_h);
+
+	//    FRAME_STATS_HISTORY 
+	FrameStatsSummary Stats = m_FrameStats.Get_Summary();
+
+	sprintf_s(buff, 256, "Frame ms p50 %.2f p95 %.2f p99 %.2f max %.2f", Stats.P50Ms, Stats.P95Ms, Stats.P99Ms, Stats.MaxMs);
+	Print_Text(buff, 100.0f, 100.0f + char_h * 3.0f, char_w, char_h);
+
+	sprintf_s(buff, 256, "CPU ms update %.2f record %.2f submit %.2f wait %.2f", Stats.PhaseMs[FRAME_PHASE_UPDATE],
+		Stats.PhaseMs[FRAME_PHASE_RECORD], Stats.PhaseMs[FRAME_PHASE_SUBMIT], Stats.PhaseMs[FRAME_PHASE_WAIT]);
+	Print_Text(buff, 100.0f, 100.0f + char_h * 4.0f, char_w, char_h);
+
+	sprintf_s(buff, 256, "Stutters %llu", Stats.Stutters);
+	Print_Text(buff, 100.0f, 100.0f + char_h * 5.0f, char_w, char_h);
 	
 
 	m_CommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
@@ -760,14 +767,19 @@ void CMeshManager::Draw_MeshManager()
 		
 	ThrowIfFailed(m_CommandList->Close());
 
+	m_FrameStats.Phase_End(FRAME_PHASE_RECORD);
+
 	ID3D12CommandList* cmdsLists[] = { m_CommandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
-	ThrowIfFailed(m_SwapChain->Present(0, 0));
+	//   Present  FRAME_PACING_MODE
+	m_FramePacer.Present();
 
-	m_CurrBackBuffer = (m_CurrBackBuffer + 1) % m_SwapChainBufferCount;
+	m_CurrBackBuffer = m_SwapChain->GetCurrentBackBufferIndex();
 
-	FlushCommandQueue();
+	//  ,  frame resource    fence
+	m_CurrFrameResource->Fence = m_FrameScheduler.End_Frame();
+	m_FrameStats.Phase_End(FRAME_PHASE_SUBMIT);
 }
 
 
@@ -28,6 +28,15 @@
 #include "d3dUtil.h"
 
 #include "Timer.h"
+#include "UploadRing.h"
+#include "UploadBatch.h"
+#include "FrameScheduler.h"
+#include "FramePacer.h"
+#include "FrameStats.h"
+#include "TextBuffer.h"
+
+#include "BmpFile.h"
+#include "TextureFile.h"
 
 #pragma comment(lib,"d3dcompiler.lib")
 #pragma comment(lib, "D3D12.lib")
@@ -35,6 +44,24 @@
 
 #define NUM_FRAME_RESOURCES 3
 
+//,  CPU   GPU: 1 - CPU  GPU  ,
+//  NUM_FRAME_RESOURCES
+#define FRAMES_IN_FLIGHT 3
+
+// : FRAME_PACING_MAX_THROUGHPUT, FRAME_PACING_VSYNC
+// FRAME_PACING_LOW_LATENCY, . FramePacer.h.  
+//Present(0)  vsync,    CFramePacer
+#define FRAME_PACING_MODE FRAME_PACING_MAX_THROUGHPUT
+
+//       
+//FRAME_STATS_EXPORT_NAME.csv  .json, 0 -  .  
+//,        
+#define FRAME_STATS_EXPORT_SECONDS 0
+#define FRAME_STATS_EXPORT_NAME "frame_stats"
+
+//upload     
+#define UPLOAD_RING_SIZE (1024 * 1024)
+
 template<typename T>
 class UploadBuffer
 {
@@ -97,12 +124,6 @@ static DirectX::XMFLOAT4X4 Identity4x4()
 	return I;
 }
 
-struct Vertex
-{
-	float x, y, z;
-	float tu, tv;
-};
-
 struct SubmeshGeometry
 {
 	UINT IndexCount = 0;
@@ -117,9 +138,6 @@ struct MeshGeometry
 	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferGPU = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferGPU = nullptr;
 
-	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferUploader = nullptr;
-	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferUploader = nullptr;
-
 	UINT VertexByteStride = 0;
 	UINT VertexBufferByteSize = 0;
 	DXGI_FORMAT IndexFormat = DXGI_FORMAT_R16_UINT;
@@ -146,12 +164,6 @@ struct MeshGeometry
 
 		return ibv;
 	}
-
-	void DisposeUploaders()
-	{
-		VertexBufferUploader = nullptr;
-		IndexBufferUploader = nullptr;
-	}
 };
 
 struct Texture
@@ -161,7 +173,6 @@ struct Texture
 	std::wstring Filename;
 
 	Microsoft::WRL::ComPtr<ID3D12Resource> Resource = nullptr;
-	Microsoft::WRL::ComPtr<ID3D12Resource> UploadHeap = nullptr;
 };
 
 struct FrameResource
@@ -195,7 +206,7 @@ public:
 	void Init_MeshManager(HWND hWnd);
 	void Update_MeshManager();
 	void Draw_MeshManager();
-	void Print_Text(unsigned int StringNum, char* Text, float x, float y, float SizeX, float SizeY);
+	void Print_Text(const char* Text, float x, float y, float SizeX, float SizeY);
 
 private:
 	void EnableDebugLayer_CreateFactory();
@@ -213,10 +224,8 @@ private:
 	void LoadTextures();
 	Microsoft::WRL::ComPtr<ID3D12Resource> CreateTexture(
 		ID3D12Device* device,
-		ID3D12GraphicsCommandList* cmdList,
-		const void* initData,
-		UINT64 byteSize,
-		Microsoft::WRL::ComPtr<ID3D12Resource>& UploadBuffer);
+		const CTextureFile& Tex,
+		CUploadBatch& UploadBatch);
 	void Create_ShaderResource_Heap_And_View_Pass1();
 	void Create_Main_RenderTargetHeap_And_View_Pass1();
 	void Create_Cube_Shaders_And_InputLayout_Pass1();
@@ -227,10 +236,11 @@ private:
 	D3D12_CPU_DESCRIPTOR_HANDLE CurrentBackBufferView();
 	ID3D12Resource* CurrentBackBuffer();
 
-	//       
-	std::unique_ptr<UploadBuffer<Vertex>> Vert_Buff_DX[2];
+	//   ,     frame resource
+	CTextBuffer m_TextBuffer;
 
 	CTimer m_Timer;
+	CFrameStats m_FrameStats;
 	
 	const int m_NumFrameResources = NUM_FRAME_RESOURCES;
 	std::vector<std::unique_ptr<FrameResource>> m_FrameResources;
@@ -256,19 +266,31 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_DirectCmdListAlloc;
 	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_CommandList;
 
-	Microsoft::WRL::ComPtr<IDXGISwapChain> m_SwapChain;
+	Microsoft::WRL::ComPtr<IDXGISwapChain3> m_SwapChain;
 
 	int m_ClientWidth = 800;
 	int m_ClientHeight = 600;
 
-	static const int m_SwapChainBufferCount = 2;
+	//      swap chain (FRAMES_IN_FLIGHT)
+	static const int m_SwapChainBufferCount = 3;
 
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_SwapChainBuffer[m_SwapChainBufferCount];
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_DepthStencilBuffer;
 
 	HWND m_hWnd;
 
-	UINT64 m_CurrentFence = 0;
+	//fence   ,  GPU
+	CFrameScheduler m_FrameScheduler;
+
+	//    ,  swap chain  ResizeBuffers
+	CFramePacer m_FramePacer;
+	bool m_TearingSupported = false;
+	UINT m_SwapChainFlags = 0;
+
+	// upload    , 
+	//     
+	CUploadRing m_UploadRing;
+	CUploadBatch m_UploadBatch;
 
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_DsvHeap;
 
@@ -293,10 +315,9 @@ private:
 	DirectX::XMFLOAT4X4 m_View = Identity4x4();
 	DirectX::XMFLOAT4X4 m_Proj = Identity4x4();
 
-	UINT TextureWidth = 0;
-	UINT TextureHeight = 0;
-
 	std::wstring StrAdapterName;
+	// Print_Text(),      
+	std::string StrAdapterNameText;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,249 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Text Buffer DirectX12
+//======================================================================================
+
+#include "TextBuffer.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+// GPU    
+#define TEXT_FAKE_GPU_ADDRESS 0x100000000ull
+
+#define TEXT_VERTS_PER_CHAR 6
+
+CTextBuffer::~CTextBuffer()
+{
+	if (m_Resource != nullptr)
+		m_Resource->Unmap(0, nullptr);
+}
+
+void CTextBuffer::Init(ID3D12Device* Device, UINT FrameCount, UINT MaxChars)
+{
+	m_FrameCount = FrameCount;
+	m_MaxChars = MaxChars;
+
+	UINT64 Size = (UINT64)FrameCount * MaxChars * TEXT_VERTS_PER_CHAR * sizeof(TextVertex);
+
+	if (Device != nullptr)
+	{
+		ThrowIfFailed(Device->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+			D3D12_HEAP_FLAG_NONE,
+			&CD3DX12_RESOURCE_DESC::Buffer(Size),
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(m_Resource.GetAddressOf())));
+
+		//CPU  ,   upload  
+		CD3DX12_RANGE ReadRange(0, 0);
+		ThrowIfFailed(m_Resource->Map(0, &ReadRange, reinterpret_cast<void**>(&m_Cpu)));
+		m_Gpu = m_Resource->GetGPUVirtualAddress();
+	}
+	else
+	{
+		m_Memory.reset(new BYTE[(size_t)Size]);
+		m_Cpu = m_Memory.get();
+		m_Gpu = TEXT_FAKE_GPU_ADDRESS;
+	}
+}
+
+void CTextBuffer::Begin_Frame(UINT FrameIndex)
+{
+	if (m_FrameChars > m_Stats.PeakFrameChars)
+		m_Stats.PeakFrameChars = m_FrameChars;
+
+	m_FrameOffset = (UINT64)FrameIndex * m_MaxChars * TEXT_VERTS_PER_CHAR * sizeof(TextVertex);
+	m_FrameChars = 0;
+
+	m_Stats.Frames++;
+}
+
+UINT CTextBuffer::Append_Text(const char* Text, float x, float y, float SizeX, float SizeY,
+	D3D12_VERTEX_BUFFER_VIEW& View)
+{
+	UINT Length = (UINT)strlen(Text);
+
+	if (Length == 0)
+		return 0;
+
+	if (m_FrameChars + Length > m_MaxChars)
+	{
+		m_Stats.Dropped++;
+		return 0;
+	}
+
+	UINT64 Offset = m_FrameOffset + (UINT64)m_FrameChars * TEXT_VERTS_PER_CHAR * sizeof(TextVertex);
+	TextVertex* Dst = reinterpret_cast<TextVertex*>(m_Cpu + Offset);
+
+	//  16 
+	//    
+	float TexWidth = 256.0f;
+	//     3 
+	float Tw1 = 3.0f / TexWidth;
+	//  9 
+	float Tw2 = 9.0f / TexWidth;
+
+	for (UINT i = 0; i < Length; i++)
+	{
+		char character = Text[i];
+		float uv_x = (character % 16) / 16.0f;
+		float uv_y = (character / 16) / 16.0f;
+
+		TextVertex VertexUpLeft = { x + i * SizeX,			y,	0.0f, uv_x + Tw1,		uv_y };
+		TextVertex VertexUpRight = { x + i * SizeX + SizeX,	y,	0.0f, uv_x + Tw1 + Tw2,	uv_y };
+		TextVertex VertexDownRight = { x + i * SizeX + SizeX,	y + SizeY,	0.0f, uv_x + Tw1 + Tw2,	uv_y + 1.0f / 16.0f };
+		TextVertex VertexDownLeft = { x + i * SizeX,			y + SizeY,	0.0f, uv_x + Tw1,		uv_y + 1.0f / 16.0f };
+
+		// write-combined,   
+		*Dst++ = VertexDownLeft;
+		*Dst++ = VertexUpLeft;
+		*Dst++ = VertexUpRight;
+
+		*Dst++ = VertexDownLeft;
+		*Dst++ = VertexUpRight;
+		*Dst++ = VertexDownRight;
+	}
+
+	UINT VertexCount = Length * TEXT_VERTS_PER_CHAR;
+
+	View.BufferLocation = m_Gpu + Offset;
+	View.StrideInBytes = sizeof(TextVertex);
+	View.SizeInBytes = VertexCount * sizeof(TextVertex);
+
+	m_FrameChars += Length;
+
+	m_Stats.Strings++;
+	m_Stats.Chars += Length;
+
+	return VertexCount;
+}
+
+const TextBufferStats& CTextBuffer::Get_Stats() const
+{
+	return m_Stats;
+}
+
+void CTextBuffer::Report(const char* Name)
+{
+	UINT PeakFrameChars = m_FrameChars > m_Stats.PeakFrameChars ? m_FrameChars : m_Stats.PeakFrameChars;
+
+	char Buffer[256];
+	sprintf_s(Buffer, "%s: %u x %.1f KB, %llu strings %llu chars in %u frames, peak frame %u chars, %llu dropped\n",
+		Name, m_FrameCount, m_MaxChars * TEXT_VERTS_PER_CHAR * sizeof(TextVertex) / 1024.0,
+		m_Stats.Strings, m_Stats.Chars, m_Stats.Frames, PeakFrameChars, m_Stats.Dropped);
+	OutputDebugStringA(Buffer);
+}
+
+#ifdef TEXT_BUFFER_VERIFY
+
+//         
+static std::atomic<UINT64> g_TextVerifyAllocations(0);
+
+void* operator new(size_t Size)
+{
+	g_TextVerifyAllocations++;
+
+	void* Ptr = malloc(Size ? Size : 1);
+	if (Ptr == nullptr)
+		throw std::bad_alloc();
+
+	return Ptr;
+}
+
+void operator delete(void* Ptr) noexcept
+{
+	free(Ptr);
+}
+
+void* operator new[](size_t Size)
+{
+	return operator new(Size);
+}
+
+void operator delete[](void* Ptr) noexcept
+{
+	operator delete(Ptr);
+}
+
+void Verify_Text_Buffer()
+{
+	const UINT FrameCount = 3;
+	const UINT MaxChars = 64;
+	const UINT WarmupFrames = 8;
+	const UINT64 PartSize = (UINT64)MaxChars * TEXT_VERTS_PER_CHAR * sizeof(TextVertex);
+
+	CTextBuffer TextBuffer;
+	TextBuffer.Init(nullptr, FrameCount, MaxChars);
+
+	bool Valid = true;
+	bool Dropped = true;
+	UINT64 WarmupAllocations = 0;
+
+	char Buff[256];
+
+	for (UINT Frame = 0; Frame < 300; Frame++)
+	{
+		if (Frame == WarmupFrames)
+			WarmupAllocations = g_TextVerifyAllocations;
+
+		UINT FrameIndex = Frame % FrameCount;
+		TextBuffer.Begin_Frame(FrameIndex);
+
+		//  ,   Draw_MeshManager
+		D3D12_VERTEX_BUFFER_VIEW View[2];
+
+		sprintf_s(Buff, 256, "Vendor %s", "Test Adapter");
+		UINT Count0 = TextBuffer.Append_Text(Buff, 100.0f, 100.0f, 10.0f, 20.0f, View[0]);
+
+		sprintf_s(Buff, 256, "FPS %d", Frame * 7);
+		UINT Count1 = TextBuffer.Append_Text(Buff, 100.0f, 140.0f, 10.0f, 20.0f, View[1]);
+
+		if (Count0 != strlen("Vendor Test Adapter") * TEXT_VERTS_PER_CHAR || Count1 == 0)
+			Valid = false;
+
+		//    ,    
+		D3D12_GPU_VIRTUAL_ADDRESS PartStart = TEXT_FAKE_GPU_ADDRESS + FrameIndex * PartSize;
+
+		if (View[0].BufferLocation != PartStart ||
+			View[1].BufferLocation != View[0].BufferLocation + View[0].SizeInBytes ||
+			View[1].BufferLocation + View[1].SizeInBytes > PartStart + PartSize ||
+			View[0].StrideInBytes != sizeof(TextVertex))
+			Valid = false;
+
+		//      -   
+		const TextVertex* Vertices = reinterpret_cast<const TextVertex*>(
+			TextBuffer.m_Cpu + (View[0].BufferLocation - TEXT_FAKE_GPU_ADDRESS));
+		const TextVertex& Check = Vertices[TEXT_VERTS_PER_CHAR + 2];
+
+		if (Check.x != 100.0f + 2 * 10.0f || Check.y != 100.0f ||
+			Check.tu != ('e' % 16) / 16.0f + 3.0f / 256.0f + 9.0f / 256.0f || Check.tv != ('e' / 16) / 16.0f)
+			Valid = false;
+
+		//    ,  
+		if (Frame % 50 == 0)
+		{
+			memset(Buff, 'W', MaxChars);
+			Buff[MaxChars] = '\0';
+
+			D3D12_VERTEX_BUFFER_VIEW Long;
+			if (TextBuffer.Append_Text(Buff, 0.0f, 0.0f, 10.0f, 20.0f, Long) != 0)
+				Dropped = false;
+		}
+	}
+
+	UINT64 SteadyAllocations = g_TextVerifyAllocations - WarmupAllocations;
+
+	const TextBufferStats& Stats = TextBuffer.Get_Stats();
+	if (Stats.Dropped != 6)
+		Dropped = false;
+
+	sprintf_s(Buff, "Text buffer: %s, %u x %.1f KB, %llu strings, %llu allocations after warm-up, overflow %s\n",
+		Valid && Dropped && SteadyAllocations == 0 ? "OK" : "FAILED", FrameCount, PartSize / 1024.0,
+		Stats.Strings, SteadyAllocations, Dropped ? "OK" : "FAILED");
+	OutputDebugStringA(Buff);
+}
+
+#endif
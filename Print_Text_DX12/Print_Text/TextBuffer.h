@@ -0,0 +1,87 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Text Buffer DirectX12
+//======================================================================================
+
+#ifndef _TEXTBUFFER_
+#define _TEXTBUFFER_
+
+#include <windows.h>
+#include <memory>
+
+#include "d3dUtil.h"
+
+//      
+#define TEXT_BUFFER_MAX_CHARS 1024
+
+// ,   m_InputLayout
+struct TextVertex
+{
+	float x, y, z;
+	float tu, tv;
+};
+
+struct TextBufferStats
+{
+	UINT64 Strings = 0;
+	UINT64 Chars = 0;
+	//,     
+	UINT64 Dropped = 0;
+	UINT PeakFrameChars = 0;
+	UINT Frames = 0;
+};
+
+//   :  upload  
+//       frame resources.  
+//   ,     , Begin_Frame
+//     .   Init
+// . Device == nullptr -      
+//GPU ,    CPU
+class CTextBuffer
+{
+public:
+	CTextBuffer() = default;
+	~CTextBuffer();
+
+	CTextBuffer(const CTextBuffer& rhs) = delete;
+	CTextBuffer& operator=(const CTextBuffer& rhs) = delete;
+
+	void Init(ID3D12Device* Device, UINT FrameCount, UINT MaxChars);
+
+	//GPU   FrameIndex,     
+	void Begin_Frame(UINT FrameIndex);
+
+	//   ,   16x16   256x256,
+	//  , 0 -     
+	UINT Append_Text(const char* Text, float x, float y, float SizeX, float SizeY,
+		D3D12_VERTEX_BUFFER_VIEW& View);
+
+	const TextBufferStats& Get_Stats() const;
+	void Report(const char* Name);
+
+private:
+	Microsoft::WRL::ComPtr<ID3D12Resource> m_Resource;
+	std::unique_ptr<BYTE[]> m_Memory;
+
+	BYTE* m_Cpu = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS m_Gpu = 0;
+
+	UINT m_FrameCount = 0;
+	UINT m_MaxChars = 0;
+
+	//        
+	UINT64 m_FrameOffset = 0;
+	UINT m_FrameChars = 0;
+
+	TextBufferStats m_Stats;
+
+	friend void Verify_Text_Buffer();
+};
+
+//CPU   :       
+//  ,     , 
+// ,        
+// (  operator new,  
+// TEXT_BUFFER_VERIFY).   OutputDebugString
+void Verify_Text_Buffer();
+
+#endif
@@ -0,0 +1,96 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Texture File DirectX12
+//======================================================================================
+
+#ifndef _TEXTUREFILE_
+#define _TEXTUREFILE_
+
+#include <windows.h>
+#include <dxgiformat.h>
+#include <string>
+#include <vector>
+
+#include "ThreadPool.h"
+
+//'BTEX'
+#define TEXTURE_FILE_MAGIC 0x58455442
+#define TEXTURE_FILE_VERSION 1
+
+//  mip      16 
+#define TEXTURE_FILE_ALIGN 16
+
+//16384x16384  15 
+#define TEXTURE_MAX_MIP_LEVELS 15
+
+struct TextureFileHeader
+{
+	UINT Magic;
+	UINT Version;
+	UINT HeaderSize;
+	//DXGI_FORMAT_BC1_UNORM, DXGI_FORMAT_BC3_UNORM  DXGI_FORMAT_R8G8B8A8_UNORM
+	UINT Format;
+	UINT Width;
+	UINT Height;
+	UINT MipLevels;
+	//    ,    
+	//   ( BC     4x4)
+	UINT LevelOffset[TEXTURE_MAX_MIP_LEVELS];
+	UINT LevelRowPitch[TEXTURE_MAX_MIP_LEVELS];
+	UINT LevelNumRows[TEXTURE_MAX_MIP_LEVELS];
+};
+
+//    file mapping,  
+//     upload 
+class CTextureFile
+{
+public:
+	CTextureFile();
+	~CTextureFile();
+
+	CTextureFile(const CTextureFile& rhs) = delete;
+	CTextureFile& operator=(const CTextureFile& rhs) = delete;
+
+	bool Open(const std::wstring& Filename);
+	void Close();
+
+	DXGI_FORMAT Format() const;
+	UINT Width() const;
+	UINT Height() const;
+	UINT MipLevels() const;
+
+	const BYTE* Level_Data(UINT Level) const;
+	UINT Level_Row_Pitch(UINT Level) const;
+	UINT Level_Num_Rows(UINT Level) const;
+
+	//     DstRowPitch
+	//(D3D12     256 )
+	void Copy_Level(UINT Level, void* Dst, UINT DstRowPitch) const;
+
+private:
+	HANDLE m_File = INVALID_HANDLE_VALUE;
+	HANDLE m_Mapping = NULL;
+	const BYTE* m_View = nullptr;
+	const TextureFileHeader* m_Header = nullptr;
+};
+
+//       
+UINT Texture_Row_Pitch(DXGI_FORMAT Format, UINT Width);
+UINT Texture_Num_Rows(DXGI_FORMAT Format, UINT Height);
+
+// BMP  BC1 (     255)  BC3,
+//AlphaUsed -     , Flags  
+//Bmp_Decode_RGBA, GenerateMips -   mip ,
+//   Pool (nullptr -   ).
+//    4   
+bool Convert_Bmp_To_Texture(const std::wstring& BmpFilename, const std::wstring& TexFilename,
+	UINT Flags, bool AlphaUsed, bool GenerateMips, CThreadPool* Pool);
+
+//  ,      BMP
+bool Texture_Binary_Is_Stale(const std::wstring& BmpFilename, const std::wstring& TexFilename);
+
+//       OutputDebugString ,
+// , PSNR     
+void Report_Texture_Compression(const std::vector<std::wstring>& BmpFilenames,
+	UINT Flags, bool AlphaUsed, bool GenerateMips, CThreadPool* Pool);
+
+#endif
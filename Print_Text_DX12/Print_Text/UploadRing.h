@@ -0,0 +1,99 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Upload Ring DirectX12
+//======================================================================================
+
+#ifndef _UPLOADRING_
+#define _UPLOADRING_
+
+#include <windows.h>
+#include <limits.h>
+#include <mutex>
+#include <vector>
+
+#include "d3dUtil.h"
+#include "RingAllocator.h"
+
+//  , CopyBufferRegion   
+#define UPLOAD_BUFFER_ALIGN 16
+
+//  upload ,    Mapped + Offset,
+//   Resource   Offset
+struct UploadAllocation
+{
+	ID3D12Resource* Resource = nullptr;
+	UINT64 Offset = 0;
+	BYTE* Mapped = nullptr;
+	UINT Id = UINT_MAX;
+	bool Overflow = false;
+};
+
+struct UploadRingStats
+{
+	UINT Allocations = 0;
+	UINT64 Bytes = 0;
+	UINT64 PeakUsed = 0;
+	//   GPU,     
+	UINT Waits = 0;
+	//    -  upload 
+	UINT Overflows = 0;
+	UINT64 OverflowBytes = 0;
+};
+
+//   upload     .
+//     Retire   ,
+//Allocate     
+class CUploadRing
+{
+public:
+	CUploadRing() = default;
+	~CUploadRing();
+
+	CUploadRing(const CUploadRing& rhs) = delete;
+	CUploadRing& operator=(const CUploadRing& rhs) = delete;
+
+	void Init(ID3D12Device* Device, ID3D12Fence* Fence, UINT64 Capacity);
+
+	UploadAllocation Allocate(UINT64 Size, UINT64 Align);
+
+	//   ,   Footprints 
+	// Offset     CopyTextureRegion
+	UploadAllocation Allocate_Texture(const D3D12_RESOURCE_DESC& Desc,
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT* Footprints);
+
+	//   Allocation   Fence
+	void Retire(const UploadAllocation& Allocation, UINT64 Fence);
+	// ,    
+	void Retire_All(UINT64 Fence);
+
+	//      
+	void Reclaim();
+
+	UploadRingStats Get_Stats();
+	void Report(const char* Name);
+
+private:
+	struct OverflowBuffer
+	{
+		Microsoft::WRL::ComPtr<ID3D12Resource> Resource;
+		UINT Id;
+		UINT64 Fence;
+		bool Retired;
+	};
+
+	void Reclaim_Locked(UINT64 CompletedFence);
+
+	ID3D12Device* m_Device = nullptr;
+	ID3D12Fence* m_Fence = nullptr;
+
+	Microsoft::WRL::ComPtr<ID3D12Resource> m_Buffer;
+	BYTE* m_Mapped = nullptr;
+
+	std::mutex m_Mutex;
+	CRingAllocator m_Ring;
+	std::vector<OverflowBuffer> m_Overflow;
+	UINT m_NextOverflowId = 0;
+
+	UploadRingStats m_Stats;
+};
+
+#endif
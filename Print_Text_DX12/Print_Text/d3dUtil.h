@@ -14,6 +14,8 @@
 
 #pragma comment(lib,"d3dcompiler.lib")
 
+class CUploadBatch;
+
 class DxException
 {
 public:
@@ -55,10 +57,9 @@ public:
 
 	static Microsoft::WRL::ComPtr<ID3D12Resource> CreateDefaultBuffer(
 		ID3D12Device* device,
-		ID3D12GraphicsCommandList* cmdList,
 		const void* initData,
 		UINT64 byteSize,
-		Microsoft::WRL::ComPtr<ID3D12Resource>& UploadBuffer);
+		CUploadBatch& UploadBatch);
 
 	static Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(
 		const std::wstring& Filename,
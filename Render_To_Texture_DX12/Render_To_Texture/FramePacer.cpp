@@ -0,0 +1,398 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Frame Pacer DirectX12
+//======================================================================================
+
+#include "FramePacer.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+
+static double Qpc_To_Ms(LONGLONG Counter)
+{
+	LARGE_INTEGER Frequency;
+	QueryPerformanceFrequency(&Frequency);
+
+	return Counter * 1000.0 / Frequency.QuadPart;
+}
+
+static const char* Get_Mode_Name(FramePacingMode Mode)
+{
+	switch (Mode)
+	{
+	case FRAME_PACING_MAX_THROUGHPUT:
+		return "max throughput";
+	case FRAME_PACING_VSYNC:
+		return "vsync";
+	default:
+		return "low latency";
+	}
+}
+
+FramePacingPolicy Get_Frame_Pacing_Policy(FramePacingMode Mode, UINT FramesInFlight, bool TearingSupported)
+{
+	if (FramesInFlight < 1)
+		FramesInFlight = 1;
+
+	FramePacingPolicy Policy;
+
+	switch (Mode)
+	{
+	case FRAME_PACING_MAX_THROUGHPUT:
+		Policy.SyncInterval = 0;
+		Policy.PresentFlags = TearingSupported ? DXGI_PRESENT_ALLOW_TEARING : 0;
+		Policy.MaxFrameLatency = FramesInFlight;
+		break;
+	case FRAME_PACING_VSYNC:
+		Policy.SyncInterval = 1;
+		Policy.PresentFlags = 0;
+		Policy.MaxFrameLatency = FramesInFlight;
+		break;
+	default:
+		Policy.SyncInterval = 1;
+		Policy.PresentFlags = 0;
+		Policy.MaxFrameLatency = 1;
+		break;
+	}
+
+	return Policy;
+}
+
+UINT Get_Frame_Pacing_Swap_Chain_Flags(bool TearingSupported)
+{
+	UINT Flags = DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
+
+	if (TearingSupported)
+		Flags |= DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING;
+
+	return Flags;
+}
+
+bool Check_Tearing_Support(IDXGIFactory4* Factory)
+{
+	BOOL Allow = FALSE;
+
+	//IDXGIFactory5   Windows 10
+	Microsoft::WRL::ComPtr<IDXGIFactory5> Factory5;
+	if (SUCCEEDED(Factory->QueryInterface(IID_PPV_ARGS(&Factory5))))
+	{
+		if (FAILED(Factory5->CheckFeatureSupport(DXGI_FEATURE_PRESENT_ALLOW_TEARING,
+			&Allow, sizeof(Allow))))
+			Allow = FALSE;
+	}
+
+	return Allow == TRUE;
+}
+
+CFramePacer::~CFramePacer()
+{
+	Release();
+}
+
+void CFramePacer::Init(IDXGISwapChain2* SwapChain, FramePacingMode Mode, UINT FramesInFlight, bool TearingSupported)
+{
+	Release();
+
+	m_SwapChain = SwapChain;
+	m_Mode = Mode;
+	m_Policy = Get_Frame_Pacing_Policy(Mode, FramesInFlight, TearingSupported);
+
+	// Present   swap chain  
+	m_PresentCount = 0;
+	m_LastDisplayed = 0;
+
+	for (UINT i = 0; i < FRAME_PACER_HISTORY; i++)
+		m_HistoryId[i] = 0;
+
+	if (SwapChain != nullptr)
+	{
+		ThrowIfFailed(SwapChain->SetMaximumFrameLatency(m_Policy.MaxFrameLatency));
+		m_Waitable = SwapChain->GetFrameLatencyWaitableObject();
+	}
+}
+
+void CFramePacer::Release()
+{
+	if (m_Waitable != nullptr)
+		CloseHandle(m_Waitable);
+
+	m_Waitable = nullptr;
+	m_SwapChain = nullptr;
+}
+
+FramePacingMode CFramePacer::Mode() const
+{
+	return m_Mode;
+}
+
+const FramePacingPolicy& CFramePacer::Policy() const
+{
+	return m_Policy;
+}
+
+void CFramePacer::Wait_Frame()
+{
+	double Start = Now_Ms();
+
+	// -   ,      
+	if (m_Waitable != nullptr)
+		WaitForSingleObjectEx(m_Waitable, 1000, TRUE);
+	else if (m_MockWait)
+		m_MockWait();
+
+	m_Stats.WaitMs += Now_Ms() - Start;
+}
+
+void CFramePacer::Input_Sampled()
+{
+	m_InputTime = Now_Ms();
+}
+
+UINT CFramePacer::Present()
+{
+	UINT Id = m_PresentCount + 1;
+
+	if (m_SwapChain != nullptr)
+	{
+		ThrowIfFailed(m_SwapChain->Present(m_Policy.SyncInterval, m_Policy.PresentFlags));
+		ThrowIfFailed(m_SwapChain->GetLastPresentCount(&Id));
+	}
+	else if (m_MockPresent)
+	{
+		m_MockPresent(m_Policy.SyncInterval, m_Policy.PresentFlags);
+	}
+
+	m_PresentCount = Id;
+
+	double Latency = Now_Ms() - m_InputTime;
+
+	m_Stats.Frames++;
+	m_Stats.InputToPresentMs += Latency;
+	if (Latency > m_Stats.MaxInputToPresentMs)
+		m_Stats.MaxInputToPresentMs = Latency;
+
+	m_HistoryId[Id % FRAME_PACER_HISTORY] = Id;
+	m_HistoryInput[Id % FRAME_PACER_HISTORY] = m_InputTime;
+
+	Poll_Frame_Statistics();
+
+	return Id;
+}
+
+void CFramePacer::Frame_Displayed(UINT PresentId, double TimeMs)
+{
+	if (PresentId <= m_LastDisplayed)
+		return;
+
+	m_LastDisplayed = PresentId;
+
+	//   -    
+	UINT Slot = PresentId % FRAME_PACER_HISTORY;
+	if (m_HistoryId[Slot] != PresentId)
+		return;
+
+	double Latency = TimeMs - m_HistoryInput[Slot];
+
+	m_Stats.Displayed++;
+	m_Stats.InputToDisplayMs += Latency;
+	if (Latency > m_Stats.MaxInputToDisplayMs)
+		m_Stats.MaxInputToDisplayMs = Latency;
+}
+
+void CFramePacer::Poll_Frame_Statistics()
+{
+	if (m_SwapChain == nullptr)
+		return;
+
+	//    Present   vblank,
+	//    -      Present
+	DXGI_FRAME_STATISTICS Statistics;
+	if (FAILED(m_SwapChain->GetFrameStatistics(&Statistics)))
+		return;
+
+	Frame_Displayed(Statistics.PresentCount, Qpc_To_Ms(Statistics.SyncQPCTime.QuadPart));
+}
+
+double CFramePacer::Now_Ms() const
+{
+	if (m_MockClock)
+		return m_MockClock();
+
+	LARGE_INTEGER Counter;
+	QueryPerformanceCounter(&Counter);
+
+	return Qpc_To_Ms(Counter.QuadPart);
+}
+
+void CFramePacer::Set_Mock(std::function<double()> Clock, std::function<void()> Wait,
+	std::function<void(UINT, UINT)> Present)
+{
+	m_MockClock = Clock;
+	m_MockWait = Wait;
+	m_MockPresent = Present;
+}
+
+const FramePacerStats& CFramePacer::Get_Stats() const
+{
+	return m_Stats;
+}
+
+void CFramePacer::Report(const char* Name)
+{
+	double Frames = m_Stats.Frames ? (double)m_Stats.Frames : 1.0;
+	double Displayed = m_Stats.Displayed ? (double)m_Stats.Displayed : 1.0;
+
+	char Buffer[320];
+	sprintf_s(Buffer, "%s: %s (sync %u, latency %u), %llu frames, wait %.3f ms per frame, input to present %.2f ms (max %.2f), input to display %.2f ms (max %.2f, %llu frames)\n",
+		Name, Get_Mode_Name(m_Mode), m_Policy.SyncInterval, m_Policy.MaxFrameLatency, m_Stats.Frames,
+		m_Stats.WaitMs / Frames, m_Stats.InputToPresentMs / Frames, m_Stats.MaxInputToPresentMs,
+		m_Stats.InputToDisplayMs / Displayed, m_Stats.MaxInputToDisplayMs, m_Stats.Displayed);
+	OutputDebugStringA(Buffer);
+}
+
+//  swap chain: GPU    , 
+//  1    vblank  GPU 
+//  ,   0 -   GPU
+struct SimulatedDisplay
+{
+	double RefreshMs = 1000.0 / 60.0;
+	double GpuMs = 0.0;
+	UINT MaxFrameLatency = 1;
+
+	double Now = 0.0;
+	double GpuFree = 0.0;
+	//    Present, 0  
+	std::vector<double> DisplayTime;
+
+	//waitable object: ,     MaxFrameLatency
+	void Wait()
+	{
+		size_t Count = DisplayTime.size() - 1;
+		if (Count < MaxFrameLatency)
+			return;
+
+		double Free = DisplayTime[Count - MaxFrameLatency + 1];
+		if (Free > Now)
+			Now = Free;
+	}
+
+	void Present(UINT SyncInterval)
+	{
+		double Start = Now > GpuFree ? Now : GpuFree;
+		GpuFree = Start + GpuMs;
+
+		double Display = GpuFree;
+		if (SyncInterval > 0)
+		{
+			Display = (floor(GpuFree / RefreshMs) + 1.0) * RefreshMs;
+
+			double Previous = DisplayTime.back();
+			if (DisplayTime.size() > 1 && Display < Previous + RefreshMs * SyncInterval)
+				Display = Previous + RefreshMs * SyncInterval;
+		}
+
+		DisplayTime.push_back(Display);
+	}
+};
+
+struct SimulatedPacing
+{
+	double FrameMs = 0.0;
+	double LatencyMs = 0.0;
+	double MaxLatencyMs = 0.0;
+	FramePacingPolicy Policy;
+};
+
+static SimulatedPacing Run_Simulated_Pacing(FramePacingMode Mode, UINT FramesInFlight,
+	double CpuMs, double GpuMs, UINT Frames)
+{
+	SimulatedDisplay Display;
+	Display.GpuMs = GpuMs;
+	Display.DisplayTime.push_back(0.0);
+
+	CFramePacer Pacer;
+	Pacer.Init(nullptr, Mode, FramesInFlight, true);
+	Pacer.Set_Mock([&Display]() { return Display.Now; },
+		[&Display]() { Display.Wait(); },
+		[&Display](UINT SyncInterval, UINT PresentFlags) { Display.Present(SyncInterval); });
+
+	Display.MaxFrameLatency = Pacer.Policy().MaxFrameLatency;
+
+	for (UINT Frame = 0; Frame < Frames; Frame++)
+	{
+		Pacer.Wait_Frame();
+		Pacer.Input_Sampled();
+
+		// ,    
+		Display.Now += CpuMs;
+
+		UINT Id = Pacer.Present();
+		Pacer.Frame_Displayed(Id, Display.DisplayTime[Id]);
+	}
+
+	//   
+	UINT Half = Frames / 2;
+
+	SimulatedPacing Run;
+	Run.FrameMs = (Display.DisplayTime[Frames] - Display.DisplayTime[Half]) / (Frames - Half);
+	Run.LatencyMs = Pacer.Get_Stats().InputToDisplayMs / Pacer.Get_Stats().Displayed;
+	Run.MaxLatencyMs = Pacer.Get_Stats().MaxInputToDisplayMs;
+	Run.Policy = Pacer.Policy();
+
+	return Run;
+}
+
+void Verify_Frame_Pacing()
+{
+	const UINT FramesInFlight = 3;
+	const UINT Frames = 600;
+	const double CpuMs = 4.0;
+	const double GpuMs = 6.0;
+	const double RefreshMs = 1000.0 / 60.0;
+
+	bool Valid = true;
+	char Buffer[256];
+
+	//  swap chain
+	FramePacingPolicy NoTearing = Get_Frame_Pacing_Policy(FRAME_PACING_MAX_THROUGHPUT, FramesInFlight, false);
+	FramePacingPolicy Tearing = Get_Frame_Pacing_Policy(FRAME_PACING_MAX_THROUGHPUT, FramesInFlight, true);
+
+	if (NoTearing.SyncInterval != 0 || NoTearing.PresentFlags != 0 ||
+		Tearing.PresentFlags != DXGI_PRESENT_ALLOW_TEARING || Tearing.MaxFrameLatency != FramesInFlight ||
+		Get_Frame_Pacing_Policy(FRAME_PACING_VSYNC, FramesInFlight, true).PresentFlags != 0 ||
+		Get_Frame_Pacing_Policy(FRAME_PACING_LOW_LATENCY, FramesInFlight, true).MaxFrameLatency != 1)
+		Valid = false;
+
+	SimulatedPacing Throughput = Run_Simulated_Pacing(FRAME_PACING_MAX_THROUGHPUT, FramesInFlight, CpuMs, GpuMs, Frames);
+	SimulatedPacing Vsync = Run_Simulated_Pacing(FRAME_PACING_VSYNC, FramesInFlight, CpuMs, GpuMs, Frames);
+	SimulatedPacing LowLatency = Run_Simulated_Pacing(FRAME_PACING_LOW_LATENCY, FramesInFlight, CpuMs, GpuMs, Frames);
+
+	// vsync     ,  vsync - 
+	double Slowest = CpuMs > GpuMs ? CpuMs : GpuMs;
+	if (fabs(Throughput.FrameMs - Slowest) > Slowest * 0.01 ||
+		fabs(Vsync.FrameMs - RefreshMs) > RefreshMs * 0.01 ||
+		fabs(LowLatency.FrameMs - RefreshMs) > RefreshMs * 0.01)
+		Valid = false;
+
+	//         vblank
+	// CPU + GPU,  VSYNC   
+	double Bound = ceil((CpuMs + GpuMs) / RefreshMs) * RefreshMs;
+	if (LowLatency.MaxLatencyMs > Bound + 0.01 || Vsync.LatencyMs < LowLatency.LatencyMs + RefreshMs ||
+		Throughput.LatencyMs > Vsync.LatencyMs)
+		Valid = false;
+
+	const SimulatedPacing* Runs[] = { &Throughput, &Vsync, &LowLatency };
+	const FramePacingMode Modes[] = { FRAME_PACING_MAX_THROUGHPUT, FRAME_PACING_VSYNC, FRAME_PACING_LOW_LATENCY };
+
+	for (UINT i = 0; i < _countof(Runs); i++)
+	{
+		sprintf_s(Buffer, "Frame pacing %s: %.2f ms per frame, input to display %.2f ms (max %.2f), sync %u, latency %u\n",
+			Get_Mode_Name(Modes[i]), Runs[i]->FrameMs, Runs[i]->LatencyMs, Runs[i]->MaxLatencyMs,
+			Runs[i]->Policy.SyncInterval, Runs[i]->Policy.MaxFrameLatency);
+		OutputDebugStringA(Buffer);
+	}
+
+	sprintf_s(Buffer, "Frame pacing (cpu %.0f ms, gpu %.0f ms, %.0f Hz): %s\n",
+		CpuMs, GpuMs, 1000.0 / RefreshMs, Valid ? "OK" : "FAILED");
+	OutputDebugStringA(Buffer);
+}
@@ -0,0 +1,177 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Frame Stats
+//======================================================================================
+
+#ifndef _FRAMESTATS_
+#define _FRAMESTATS_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+//   ,     
+#define FRAME_STATS_HISTORY 1024
+
+//    ,     1/32
+#define FRAME_HISTOGRAM_SUB_BITS 5
+//    
+#define FRAME_HISTOGRAM_MAX_BIT 31
+
+// -      
+#define FRAME_STATS_STUTTER_FACTOR 2.0f
+
+enum FramePhase
+{
+	FRAME_PHASE_UPDATE,
+	FRAME_PHASE_RECORD,
+	//ExecuteCommandLists  Present
+	FRAME_PHASE_SUBMIT,
+	// ,  FPS, fence frame resource
+	FRAME_PHASE_WAIT,
+	FRAME_PHASE_COUNT
+};
+
+//   HdrHistogram:   ,  2^SUB_BITS
+// ,      2^SUB_BITS 
+//.     ,    
+class CFrameHistogram
+{
+public:
+	static const unsigned int SubCount = 1u << FRAME_HISTOGRAM_SUB_BITS;
+	static const unsigned int BucketCount = SubCount + (FRAME_HISTOGRAM_MAX_BIT + 1 - FRAME_HISTOGRAM_SUB_BITS) * SubCount;
+
+	CFrameHistogram();
+
+	CFrameHistogram(const CFrameHistogram& rhs) = delete;
+	CFrameHistogram& operator=(const CFrameHistogram& rhs) = delete;
+
+	void Add(unsigned int ValueUs);
+	//    
+	void Remove(unsigned int ValueUs);
+	void Clear();
+
+	unsigned long long Total() const;
+	//  ,    Percentile  
+	unsigned int Percentile(double Percentile) const;
+	unsigned int Max() const;
+	unsigned int Count(unsigned int Index) const;
+
+	static unsigned int Bucket_Index(unsigned int ValueUs);
+	static unsigned int Bucket_Lowest(unsigned int Index);
+	static unsigned int Bucket_Highest(unsigned int Index);
+
+private:
+	std::atomic<unsigned int> m_Counts[BucketCount];
+};
+
+struct FrameStatsSummary
+{
+	unsigned long long Frames = 0;
+	unsigned long long Stutters = 0;
+	//  
+	unsigned int Window = 0;
+	//    
+	double P50Ms = 0.0;
+	double P95Ms = 0.0;
+	double P99Ms = 0.0;
+	double MaxMs = 0.0;
+	//  
+	double AvgMs = 0.0;
+	double PhaseMs[FRAME_PHASE_COUNT] = {};
+};
+
+//  ( Begin_Frame   Begin_Frame)     CPU.
+//        
+//FRAME_STATS_HISTORY .    ,  ;
+//Get_Summary         
+// ,   
+class CFrameStats
+{
+public:
+	CFrameStats();
+	~CFrameStats();
+
+	CFrameStats(const CFrameStats& rhs) = delete;
+	CFrameStats& operator=(const CFrameStats& rhs) = delete;
+
+	//  ,       
+	void Begin_Frame();
+	//      Phase
+	void Phase_End(FramePhase Phase);
+
+	// ,  
+	void Record_Frame(float FrameMs, const float* PhaseMs);
+
+	FrameStatsSummary Get_Summary() const;
+
+	bool Export_Csv(const char* Filename) const;
+	bool Export_Json(const char* Filename) const;
+
+	//    IntervalSec  BaseName.csv  BaseName.json,
+	//     
+	void Start_Export(const std::string& BaseName, double IntervalSec);
+	void Stop_Export();
+
+	void Report(const char* Name) const;
+
+private:
+	friend void Verify_Frame_Stats();
+
+	typedef std::chrono::steady_clock Clock;
+
+	struct FrameSlot
+	{
+		std::atomic<float> FrameMs;
+		std::atomic<float> PhaseMs[FRAME_PHASE_COUNT];
+		std::atomic<unsigned int> Stutter;
+	};
+
+	struct FrameRecord
+	{
+		unsigned long long Index;
+		float FrameMs;
+		float PhaseMs[FRAME_PHASE_COUNT];
+		unsigned int Stutter;
+	};
+
+	// ,    
+	unsigned int Snapshot(FrameRecord* Records) const;
+
+	FrameSlot m_Slots[FRAME_STATS_HISTORY];
+	// ,    
+	std::atomic<unsigned long long> m_Writing;
+	// , release   
+	std::atomic<unsigned long long> m_Written;
+	std::atomic<unsigned long long> m_Stutters;
+
+	CFrameHistogram m_Histogram;
+
+	// -   
+	bool m_Started = false;
+	Clock::time_point m_FrameStart;
+	Clock::time_point m_PhaseStart;
+	float m_PhaseMs[FRAME_PHASE_COUNT] = {};
+	//    
+	float m_Baseline = 0.0f;
+
+	std::thread m_ExportThread;
+	std::mutex m_ExportMutex;
+	std::condition_variable m_ExportSignal;
+	bool m_ExportStop = false;
+	std::string m_ExportName;
+};
+
+//CPU  :     , 
+// ,  ,     
+//    .   OutputDebugString (stdout
+// Windows)
+void Verify_Frame_Stats();
+
+//  : Record_Frame  Begin_Frame   ,
+//  
+void Benchmark_Frame_Stats();
+
+#endif
@@ -12,6 +12,11 @@ CMeshManager::~CMeshManager()
 {
 	if (m_d3dDevice != nullptr)
 		FlushCommandQueue();
+
+	m_FrameScheduler.Report("Frame scheduler");
+	m_FramePacer.Report("Frame pacing");
+	m_Timer.Report("Frame limiter");
+	m_FrameStats.Report("Frame stats");
 }
 
 void CMeshManager::EnableDebugLayer_CreateFactory()
@@ -97,29 +102,44 @@ void CMeshManager::Create_CommandList_Allocator_Queue()
 
 void CMeshManager::Create_SwapChain()
 {
+	m_FramePacer.Release();
 	m_SwapChain.Reset();
 
-	DXGI_SWAP_CHAIN_DESC sd;
-	sd.BufferDesc.Width = m_ClientWidth;
-	sd.BufferDesc.Height = m_ClientHeight;
-	sd.BufferDesc.RefreshRate.Numerator = 60;
-	sd.BufferDesc.RefreshRate.Denominator = 1;
-	sd.BufferDesc.Format = m_BackBufferFormat;
-	sd.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-	sd.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+	//waitable object   , tearing - FRAME_PACING_MAX_THROUGHPUT
+	m_TearingSupported = Check_Tearing_Support(m_dxgiFactory.Get());
+	m_SwapChainFlags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH |
+		Get_Frame_Pacing_Swap_Chain_Flags(m_TearingSupported);
+
+	DXGI_SWAP_CHAIN_DESC1 sd = {};
+	sd.Width = m_ClientWidth;
+	sd.Height = m_ClientHeight;
+	sd.Format = m_BackBufferFormat;
+	sd.Stereo = false;
 	sd.SampleDesc.Count = m_4xMsaaState ? 4 : 1;
 	sd.SampleDesc.Quality = m_4xMsaaState ? (m_4xMsaaQuality - 1) : 0;
 	sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
 	sd.BufferCount = m_SwapChainBufferCount;
-	sd.OutputWindow = m_hWnd;
-	sd.Windowed = true;
+	sd.Scaling = DXGI_SCALING_STRETCH;
 	sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-	sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
+	sd.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+	sd.Flags = m_SwapChainFlags;
 
-	ThrowIfFailed(m_dxgiFactory->CreateSwapChain(
+	Microsoft::WRL::ComPtr<IDXGISwapChain1> SwapChain1;
+	ThrowIfFailed(m_dxgiFactory->CreateSwapChainForHwnd(
 		m_CommandQueue.Get(),
+		m_hWnd,
 		&sd,
-		m_SwapChain.GetAddressOf()));
+		nullptr,
+		nullptr,
+		SwapChain1.GetAddressOf()));
+
+	ThrowIfFailed(SwapChain1.As(&m_SwapChain));
+
+	//Present  ALLOW_TEARING    exclusive fullscreen
+	if (m_TearingSupported)
+		ThrowIfFailed(m_dxgiFactory->MakeWindowAssociation(m_hWnd, DXGI_MWA_NO_ALT_ENTER));
+
+	m_FramePacer.Init(m_SwapChain.Get(), FRAME_PACING_MODE, FRAMES_IN_FLIGHT, m_TearingSupported);
 }
 
 void CMeshManager::Resize_SwapChainBuffers()
@@ -141,24 +161,12 @@ void CMeshManager::Resize_SwapChainBuffers()
 		m_SwapChainBufferCount,
 		m_ClientWidth, m_ClientHeight,
 		m_BackBufferFormat,
-		DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH));
+		m_SwapChainFlags));
 }
 
 void CMeshManager::FlushCommandQueue()
 {
-	m_CurrentFence++;
-
-	ThrowIfFailed(m_CommandQueue->Signal(m_Fence.Get(), m_CurrentFence));
-
-	if (m_Fence->GetCompletedValue() < m_CurrentFence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-
-		ThrowIfFailed(m_Fence->SetEventOnCompletion(m_CurrentFence, eventHandle));
-
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	m_FrameScheduler.Flush();
 }
 
 void CMeshManager::Create_Dsv_DescriptorHeaps_And_View()
@@ -214,11 +222,18 @@ D3D12_CPU_DESCRIPTOR_HANDLE CMeshManager::DepthStencilView()
 
 void CMeshManager::Execute_Init_Commands()
 {
+	//    
+	m_UploadBatch.Record(m_CommandList.Get());
+
 	ThrowIfFailed(m_CommandList->Close());
 	ID3D12CommandList* cmdsLists[] = { m_CommandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
 	FlushCommandQueue();
+
+	// , upload    
+	m_UploadRing.Retire_All(m_FrameScheduler.Current_Fence());
+	m_UploadRing.Reclaim();
 }
 
 void CMeshManager::Update_ViewPort_And_Scissor()
@@ -275,70 +290,47 @@ void CMeshManager::LoadTextures()
 	CrateTex->Name = "WoodCrateTex";
 	CrateTex->Filename = L"./texture256.bmp";
 
-	// BMP      
-	FILE* Fp = NULL;
-	fopen_s(&Fp, "texture256.bmp", "rb");
-	if (Fp == NULL)
-		MessageBox(NULL, L"Error Open File", L"INFO", MB_OK);
-
-	//   
-	BITMAPFILEHEADER Bfh;
-	fread(&Bfh, sizeof(BITMAPFILEHEADER), 1, Fp);
-
-	//   
-	BITMAPINFOHEADER Bih;
-	fread(&Bih, sizeof(BITMAPINFOHEADER), 1, Fp);
-
-	//   BMP    
-	fseek(Fp, Bfh.bfOffBits, SEEK_SET);
-
-	//      BMP 
-	unsigned char* ResTemp;
-	ResTemp = new unsigned char[Bih.biHeight * Bih.biWidth * 3];
-	//   rgb  
-	fread(ResTemp, Bih.biHeight * Bih.biWidth * 3, 1, Fp);
-
-	//   
-	fclose(Fp);
-
-	TextureWidth = Bih.biWidth;
-	TextureHeight = Bih.biHeight;
-
-	unsigned char* Res = new unsigned char[TextureWidth * TextureHeight * 4];
+	//texture256.bmp   texture256.tex (BC1  mip ,
+	//      )  ,  BMP
+	// ,     
+	if (Texture_Binary_Is_Stale(L"texture256.bmp", L"texture256.tex"))
+	{
+		CThreadPool Pool;
+		Convert_Bmp_To_Texture(L"texture256.bmp", L"texture256.tex", 0, true, true, &Pool);
+	}
 
-	for (UINT i = 0; i < TextureWidth * TextureHeight; i++)
+#ifdef TEXTURE_COOKER_REPORT
 	{
-		UINT Indx1 = i * 3;
-		UINT Indx2 = i * 4;
+		CThreadPool Pool;
+		Report_Texture_Compression({ L"texture256.bmp" }, 0, true, true, &Pool);
+	}
+#endif
 
-		Res[Indx2 + 0] = ResTemp[Indx1 + 2];
-		Res[Indx2 + 1] = ResTemp[Indx1 + 1];
-		Res[Indx2 + 2] = ResTemp[Indx1 + 0];
-		Res[Indx2 + 3] = 255;
+	CTextureFile Tex;
+	if (!Tex.Open(L"texture256.tex"))
+	{
+		MessageBox(NULL, L"Error Open File", L"INFO", MB_OK);
+		return;
 	}
 
 	CrateTex->Resource = CreateTexture(m_d3dDevice.Get(),
-		m_CommandList.Get(), Res, TextureWidth * TextureHeight * 4, CrateTex->UploadHeap);
-	
-	delete[] Res;
+		Tex, m_UploadBatch);
 
 	m_Cube->Textures[CrateTex->Name] = std::move(CrateTex);
 }
 
 Microsoft::WRL::ComPtr<ID3D12Resource> CMeshManager::CreateTexture(
 	ID3D12Device* device,
-	ID3D12GraphicsCommandList* CmdList,
-	const void* initData,
-	UINT64 byteSize,
-	Microsoft::WRL::ComPtr<ID3D12Resource>& UploadBuffer)
+	const CTextureFile& Tex,
+	CUploadBatch& UploadBatch)
 {
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_Texture;
 	
 	D3D12_RESOURCE_DESC textureDesc = {};
-	textureDesc.MipLevels = 1;
-	textureDesc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-	textureDesc.Width = TextureWidth;
-	textureDesc.Height = TextureHeight;
+	textureDesc.MipLevels = (UINT16)Tex.MipLevels();
+	textureDesc.Format = Tex.Format();
+	textureDesc.Width = Tex.Width();
+	textureDesc.Height = Tex.Height();
 	textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
 	textureDesc.DepthOrArraySize = 1;
 	textureDesc.SampleDesc.Count = 1;
@@ -353,24 +345,26 @@ Microsoft::WRL::ComPtr<ID3D12Resource> CMeshManager::CreateTexture(
 		nullptr,
 		IID_PPV_ARGS(m_Texture.GetAddressOf())));
 
-	const UINT64 UploadBufferSize = GetRequiredIntermediateSize(m_Texture.Get(), 0, 1);
+	//   upload   D3D12 ( 256 ),
+	// BC      4x4.  
+	//      upload 
+	UINT MipLevels = Tex.MipLevels();
+	std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> Footprints(MipLevels);
+	UploadAllocation Upload = UploadBatch.Allocate_Texture(textureDesc, Footprints.data());
 
-	ThrowIfFailed(device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(UploadBufferSize),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&UploadBuffer)));
-
-	D3D12_SUBRESOURCE_DATA textureData = {};
-	textureData.pData = initData;
-	textureData.RowPitch = TextureWidth * 4;
-	textureData.SlicePitch = textureData.RowPitch * TextureHeight;
+	//    .tex    upload 
+	for (UINT Level = 0; Level < MipLevels; Level++)
+		Tex.Copy_Level(Level, Upload.Mapped + Footprints[Level].Offset, Footprints[Level].Footprint.RowPitch);
 
-	UpdateSubresources(CmdList, m_Texture.Get(), UploadBuffer.Get(), 0, 0, 1, &textureData);
+	for (UINT Level = 0; Level < MipLevels; Level++)
+	{
+		CD3DX12_TEXTURE_COPY_LOCATION Dst(m_Texture.Get(), Level);
+		CD3DX12_TEXTURE_COPY_LOCATION Src(Upload.Resource, Footprints[Level]);
+		UploadBatch.Copy_Texture_Region(Dst, 0, 0, Src);
+	}
 
-	CmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_Texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+	//   COPY_DEST,  PSR    
+	UploadBatch.Add_Resource(m_Texture.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
 	return m_Texture;
 }
@@ -456,8 +450,6 @@ void CMeshManager::Create_Cube_Shaders_And_InputLayout_Pass1()
 
 void CMeshManager::Create_Cube_Geometry_Pass1()
 {
-	ThrowIfFailed(m_CommandList->Reset(m_DirectCmdListAlloc.Get(), nullptr));
-
 	std::array<Vertex, 24> Vertices =
 	{
 		Vertex({ DirectX::XMFLOAT3(-1.0f, 1.0f, -1.0f), DirectX::XMFLOAT2(0.0f, 0.0f) }),
@@ -519,10 +511,10 @@ void CMeshManager::Create_Cube_Geometry_Pass1()
 	m_Cube->Name = "Cube";
 
 	m_Cube->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
-		m_CommandList.Get(), Vertices.data(), VbByteSize, m_Cube->VertexBufferUploader);
+		Vertices.data(), VbByteSize, m_UploadBatch);
 
 	m_Cube->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
-		m_CommandList.Get(), Indices.data(), IbByteSize, m_Cube->IndexBufferUploader);
+		Indices.data(), IbByteSize, m_UploadBatch);
 
 	m_Cube->VertexByteStride = sizeof(Vertex);
 	m_Cube->VertexBufferByteSize = VbByteSize;
@@ -775,7 +767,7 @@ void CMeshManager::Create_ScreenAlignedQuad_Geometry_Pass2()
 	m_SQABuff->Name = "SAQ";
 	
 	m_SQABuff->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
-		m_CommandList.Get(), VerticesSAQ.data(), vbSAQByteSize, m_SQABuff->VertexBufferUploader);
+		VerticesSAQ.data(), vbSAQByteSize, m_UploadBatch);
 
 	m_SQABuff->VertexByteStride = sizeof(VertexSAQ);
 	m_SQABuff->VertexBufferByteSize = vbSAQByteSize;
@@ -833,18 +825,30 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 
 	CreateFence_GetDescriptorsSize();
 
+	m_UploadRing.Init(m_d3dDevice.Get(), m_Fence.Get(), UPLOAD_RING_SIZE);
+	m_UploadBatch.Init(&m_UploadRing);
+
 	Check_Multisample_Quality();
 
 	Create_CommandList_Allocator_Queue();
 
+	m_FrameScheduler.Init(m_CommandQueue.Get(), m_Fence.Get(), m_NumFrameResources);
+	m_FrameScheduler.Set_Frames_In_Flight(FRAMES_IN_FLIGHT);
+
+#ifdef FRAME_SCHEDULER_VERIFY
+	Verify_Frame_Scheduler();
+#endif
+
+#ifdef FRAME_PACING_VERIFY
+	Verify_Frame_Pacing();
+#endif
+
 	Create_SwapChain();
 
 	Resize_SwapChainBuffers();
 
 	Create_Dsv_DescriptorHeaps_And_View();
 
-	Execute_Init_Commands();
-
 	Update_ViewPort_And_Scissor();
 
 	Create_RenderTargetHeap_And_View_For_Pass1();
@@ -878,6 +882,7 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 	Create_PipelineStateObject_Pass2();
 
 	Execute_Init_Commands();
+	m_UploadBatch.Report("Init upload");
 
 	DirectX::XMVECTOR Pos = DirectX::XMVectorSet(0, 0.0f, -8.0f, 1.0f);
 	DirectX::XMVECTOR Target = DirectX::XMVectorZero();
@@ -889,13 +894,37 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 	DirectX::XMMATRIX MatProj = DirectX::XMMatrixPerspectiveFovLH(0.25f * DirectX::XM_PI, 4.0f / 3.0f, 1.0f, 1000.0f);
 	XMStoreFloat4x4(&m_Proj, MatProj);
 	
+#ifdef TIMER_LIMITER_BENCHMARK
+	Benchmark_Frame_Limiter(30.0f, 90, 2.0);
+#endif
+
 	m_Timer.Timer_Start(30);
+
+#ifdef FRAME_STATS_VERIFY
+	Verify_Frame_Stats();
+#endif
+
+#ifdef FRAME_STATS_BENCHMARK
+	Benchmark_Frame_Stats();
+#endif
+
+#if FRAME_STATS_EXPORT_SECONDS > 0
+	m_FrameStats.Start_Export(FRAME_STATS_EXPORT_NAME, FRAME_STATS_EXPORT_SECONDS);
+#endif
 }
 
 void CMeshManager::Update_MeshManager()
 {
+	m_FrameStats.Begin_Frame();
+
+	//    swap chain   ,  LOW_LATENCY
+	//     
+	m_FramePacer.Wait_Frame();
+
 	m_Timer.Calculate_FPS();
 	float ElapsedTime = m_Timer.Get_Elapsed_Time();
+	m_FramePacer.Input_Sampled();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
 
 	static float Angle = 0.0f;
 
@@ -920,16 +949,12 @@ void CMeshManager::Update_MeshManager()
 	//    
 	DirectX::XMMATRIX ViewProj = MatView * Proj;
 
-	m_CurrFrameResourceIndex = (m_CurrFrameResourceIndex + 1) % m_NumFrameResources;
-	m_CurrFrameResource = m_FrameResources[m_CurrFrameResourceIndex].get();
+	m_FrameStats.Phase_End(FRAME_PHASE_UPDATE);
 
-	if (m_CurrFrameResource->Fence != 0 && m_Fence->GetCompletedValue() < m_CurrFrameResource->Fence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-		ThrowIfFailed(m_Fence->SetEventOnCompletion(m_CurrFrameResource->Fence, eventHandle));
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	//,  GPU    
+	m_CurrFrameResourceIndex = m_FrameScheduler.Begin_Frame();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
+	m_CurrFrameResource = m_FrameResources[m_CurrFrameResourceIndex].get();
 
 	auto currObjectCB = m_CurrFrameResource->ObjectCB.get();
 
@@ -990,6 +1015,8 @@ void CMeshManager::DrawRenderItems_
 
 void CMeshManager::Draw_MeshManager()
 {
+	m_FrameStats.Phase_End(FRAME_PHASE_UPDATE);
+
 	auto CmdListAlloc = m_CurrFrameResource->CmdListAlloc;
 
 	ThrowIfFailed(CmdListAlloc->Reset());
@@ -1062,15 +1089,19 @@ void CMeshManager::Draw_MeshManager()
 
 	ThrowIfFailed(m_CommandList->Close());
 
+	m_FrameStats.Phase_End(FRAME_PHASE_RECORD);
+
 	ID3D12CommandList* cmdsLists[] = { m_CommandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
-	ThrowIfFailed(m_SwapChain->Present(0, 0));
+	//   Present  FRAME_PACING_MODE
+	m_FramePacer.Present();
 
-	m_CurrBackBuffer = (m_CurrBackBuffer + 1) % m_SwapChainBufferCount;
+	m_CurrBackBuffer = m_SwapChain->GetCurrentBackBufferIndex();
 
-	m_CurrFrameResource->Fence = ++m_CurrentFence;
-	m_CommandQueue->Signal(m_Fence.Get(), m_CurrentFence);
+	//  ,  frame resource    fence
+	m_CurrFrameResource->Fence = m_FrameScheduler.End_Frame();
+	m_FrameStats.Phase_End(FRAME_PHASE_SUBMIT);
 }
 
 
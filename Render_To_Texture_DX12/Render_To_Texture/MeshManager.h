@@ -28,6 +28,14 @@
 #include "d3dUtil.h"
 
 #include "Timer.h"
+#include "UploadRing.h"
+#include "UploadBatch.h"
+#include "FrameScheduler.h"
+#include "FramePacer.h"
+#include "FrameStats.h"
+
+#include "BmpFile.h"
+#include "TextureFile.h"
 
 #pragma comment(lib,"d3dcompiler.lib")
 #pragma comment(lib, "D3D12.lib")
@@ -35,6 +43,24 @@
 
 #define NUM_FRAME_RESOURCES 3
 
+//,  CPU   GPU: 1 - CPU  GPU  ,
+//  NUM_FRAME_RESOURCES
+#define FRAMES_IN_FLIGHT 3
+
+// : FRAME_PACING_MAX_THROUGHPUT, FRAME_PACING_VSYNC
+// FRAME_PACING_LOW_LATENCY, . FramePacer.h.  
+//Present(0)  vsync,    CFramePacer
+#define FRAME_PACING_MODE FRAME_PACING_MAX_THROUGHPUT
+
+//       
+//FRAME_STATS_EXPORT_NAME.csv  .json, 0 -  .  
+//,        
+#define FRAME_STATS_EXPORT_SECONDS 0
+#define FRAME_STATS_EXPORT_NAME "frame_stats"
+
+//upload     
+#define UPLOAD_RING_SIZE (1024 * 1024)
+
 template<typename T>
 class UploadBuffer
 {
@@ -104,7 +130,6 @@ struct Texture
 	std::wstring Filename;
 
 	Microsoft::WRL::ComPtr<ID3D12Resource> Resource = nullptr;
-	Microsoft::WRL::ComPtr<ID3D12Resource> UploadHeap = nullptr;
 };
 
 struct SubmeshGeometry
@@ -123,9 +148,6 @@ struct MeshGeometry
 	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferGPU = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferGPU = nullptr;
 
-	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferUploader = nullptr;
-	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferUploader = nullptr;
-
 	UINT VertexByteStride = 0;
 	UINT VertexBufferByteSize = 0;
 	DXGI_FORMAT IndexFormat = DXGI_FORMAT_R16_UINT;
@@ -152,12 +174,6 @@ struct MeshGeometry
 
 		return ibv;
 	}
-
-	void DisposeUploaders()
-	{
-		VertexBufferUploader = nullptr;
-		IndexBufferUploader = nullptr;
-	}
 };
 
 struct RenderItem
@@ -255,10 +271,8 @@ private:
 	void LoadTextures();
 	Microsoft::WRL::ComPtr<ID3D12Resource> CreateTexture(
 		ID3D12Device* device,
-		ID3D12GraphicsCommandList* CmdList,
-		const void* initData,
-		UINT64 byteSize,
-		Microsoft::WRL::ComPtr<ID3D12Resource>& UploadBuffer);
+		const CTextureFile& Tex,
+		CUploadBatch& UploadBatch);
 	void Create_ShaderResource_Heap_And_View_Pass1();
 	void Create_Main_RenderTargetHeap_And_View_Pass2();
 	void Create_ShaderRVHeap_And_View_Pass2();
@@ -278,6 +292,7 @@ private:
 	void DrawRenderItems_ube(ID3D12GraphicsCommandList* CmdList, const std::vector<std::unique_ptr<RenderItem>>& Ritems);
 
 	CTimer m_Timer;
+	CFrameStats m_FrameStats;
 
 	const int m_NumFrameResources = NUM_FRAME_RESOURCES;
 	UINT m_PassCbvOffset = 0;
@@ -308,19 +323,31 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_DirectCmdListAlloc;
 	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_CommandList;
 
-	Microsoft::WRL::ComPtr<IDXGISwapChain> m_SwapChain;
+	Microsoft::WRL::ComPtr<IDXGISwapChain3> m_SwapChain;
 
 	int m_ClientWidth = 800;
 	int m_ClientHeight = 600;
 
-	static const int m_SwapChainBufferCount = 2;
+	//      swap chain (FRAMES_IN_FLIGHT)
+	static const int m_SwapChainBufferCount = 3;
 
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_SwapChainBuffer[m_SwapChainBufferCount];
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_DepthStencilBuffer;
 
 	HWND m_hWnd;
 
-	UINT64 m_CurrentFence = 0;
+	//fence   ,  GPU
+	CFrameScheduler m_FrameScheduler;
+
+	//    ,  swap chain  ResizeBuffers
+	CFramePacer m_FramePacer;
+	bool m_TearingSupported = false;
+	UINT m_SwapChainFlags = 0;
+
+	// upload    , 
+	//     
+	CUploadRing m_UploadRing;
+	CUploadBatch m_UploadBatch;
 
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_DsvHeap;
 
@@ -359,9 +386,6 @@ private:
 	DirectX::XMFLOAT4X4 m_World = Identity4x4();
 	DirectX::XMFLOAT4X4 m_View = Identity4x4();
 	DirectX::XMFLOAT4X4 m_Proj = Identity4x4();
-
-	UINT TextureWidth = 0;
-	UINT TextureHeight = 0;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,314 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Ring Allocator DirectX12
+//======================================================================================
+
+#include "RingAllocator.h"
+
+#include <stdio.h>
+#include <vector>
+
+void CRingAllocator::Init(UINT64 Capacity)
+{
+	m_Blocks.clear();
+	m_Capacity = Capacity;
+	m_Head = 0;
+	m_Tail = 0;
+	m_Used = 0;
+	m_NextId = 0;
+}
+
+bool CRingAllocator::Allocate(UINT64 Size, UINT64 Align, UINT64& Offset, UINT& Id)
+{
+	//       
+	if (Size == 0)
+		Size = 1;
+
+	//   ,         
+	if (m_Blocks.empty())
+		m_Head = m_Tail = 0;
+
+	UINT64 Aligned = (m_Head + Align - 1) & ~(Align - 1);
+	UINT64 End;
+	UINT64 Bytes;
+
+	if (m_Blocks.empty() || m_Head > m_Tail)
+	{
+		// [m_Head, m_Capacity)  [0, m_Tail)
+		if (Aligned + Size <= m_Capacity)
+		{
+			End = Aligned + Size;
+			Bytes = End - m_Head;
+		}
+		else if (Size <= m_Tail)
+		{
+			//    ,    
+			Aligned = 0;
+			End = Size;
+			Bytes = m_Capacity - m_Head + Size;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else
+	{
+		//    ,  [m_Head, m_Tail)
+		if (Aligned + Size > m_Tail)
+			return false;
+
+		End = Aligned + Size;
+		Bytes = End - m_Head;
+	}
+
+	RingBlock Block;
+	Block.Id = m_NextId++;
+	Block.End = End;
+	Block.Bytes = Bytes;
+	Block.Fence = 0;
+	Block.Retired = false;
+	m_Blocks.push_back(Block);
+
+	m_Head = End == m_Capacity ? 0 : End;
+	m_Used += Bytes;
+
+	Offset = Aligned;
+	Id = Block.Id;
+
+	return true;
+}
+
+void CRingAllocator::Retire(UINT Id, UINT64 Fence)
+{
+	//   ,     
+	if (m_Blocks.empty() || Id - m_Blocks.front().Id >= (UINT)m_Blocks.size())
+		return;
+
+	RingBlock& Block = m_Blocks[Id - m_Blocks.front().Id];
+	Block.Fence = Fence;
+	Block.Retired = true;
+}
+
+void CRingAllocator::Retire_All(UINT64 Fence)
+{
+	for (RingBlock& Block : m_Blocks)
+	{
+		if (!Block.Retired)
+		{
+			Block.Fence = Fence;
+			Block.Retired = true;
+		}
+	}
+}
+
+UINT64 CRingAllocator::Reclaim(UINT64 CompletedFence)
+{
+	UINT64 Freed = 0;
+
+	while (!m_Blocks.empty() && m_Blocks.front().Retired && m_Blocks.front().Fence <= CompletedFence)
+	{
+		const RingBlock& Block = m_Blocks.front();
+
+		m_Tail = Block.End == m_Capacity ? 0 : Block.End;
+		m_Used -= Block.Bytes;
+		Freed += Block.Bytes;
+
+		m_Blocks.pop_front();
+	}
+
+	return Freed;
+}
+
+bool CRingAllocator::Oldest_Fence(UINT64& Fence) const
+{
+	if (m_Blocks.empty() || !m_Blocks.front().Retired)
+		return false;
+
+	Fence = m_Blocks.front().Fence;
+	return true;
+}
+
+UINT64 CRingAllocator::Used() const
+{
+	return m_Used;
+}
+
+UINT64 CRingAllocator::Capacity() const
+{
+	return m_Capacity;
+}
+
+UINT CRingAllocator::Pending() const
+{
+	UINT Count = 0;
+
+	for (const RingBlock& Block : m_Blocks)
+	{
+		if (!Block.Retired)
+			Count++;
+	}
+
+	return Count;
+}
+
+void Verify_Ring_Allocator()
+{
+	struct TestBlock
+	{
+		UINT Id;
+		UINT64 Offset;
+		UINT64 Size;
+		UINT64 Fence;
+		bool Retired;
+	};
+
+	const UINT64 Capacity = 65536;
+	static const UINT64 Aligns[] = { 1, 4, 16, 256, 512, 4096 };
+
+	CRingAllocator Ring;
+	Ring.Init(Capacity);
+
+	//    , -1 -  
+	std::vector<int> Owner((size_t)Capacity, -1);
+	std::deque<TestBlock> Live;
+
+	bool Valid = true;
+	UINT Allocations = 0, Waits = 0, Wraps = 0, Full = 0;
+	UINT64 PeakUsed = 0;
+	UINT64 Completed = 0;
+	UINT64 Fence = 0;
+
+	UINT Seed = 12345;
+
+	for (UINT Frame = 0; Frame < 20000; Frame++)
+	{
+		Fence = Frame + 1;
+
+		Seed = Seed * 1664525 + 1013904223;
+		UINT Count = (Seed >> 8) % 6;
+
+		for (UINT i = 0; i < Count; i++)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			UINT64 Align = Aligns[(Seed >> 8) % _countof(Aligns)];
+
+			//   ,    
+			Seed = Seed * 1664525 + 1013904223;
+			UINT64 Size = (Seed >> 8) % 64 == 0 ? Capacity - ((Seed >> 16) % 1024) : 1 + (Seed >> 8) % 8192;
+
+			UINT64 Offset;
+			UINT Id;
+			bool Allocated = Ring.Allocate(Size, Align, Offset, Id);
+
+			//     -  GPU,  CUploadRing
+			UINT64 OldestFence;
+			while (!Allocated && Ring.Oldest_Fence(OldestFence))
+			{
+				if (OldestFence > Completed)
+				{
+					Completed = OldestFence;
+					Waits++;
+				}
+
+				Ring.Reclaim(Completed);
+
+				while (!Live.empty() && Live.front().Retired && Live.front().Fence <= Completed)
+				{
+					for (UINT64 b = 0; b < Live.front().Size; b++)
+						Owner[(size_t)(Live.front().Offset + b)] = -1;
+					Live.pop_front();
+				}
+
+				Allocated = Ring.Allocate(Size, Align, Offset, Id);
+			}
+
+			if (!Allocated)
+			{
+				//     
+				if (Live.empty())
+					Valid = false;
+
+				Full++;
+				continue;
+			}
+
+			if (Offset % Align != 0 || Offset + Size > Capacity)
+			{
+				Valid = false;
+				continue;
+			}
+
+			if (!Live.empty() && Offset < Live.back().Offset)
+				Wraps++;
+
+			for (UINT64 b = 0; b < Size; b++)
+			{
+				if (Owner[(size_t)(Offset + b)] != -1)
+					Valid = false;
+				Owner[(size_t)(Offset + b)] = (int)Id;
+			}
+
+			TestBlock Block = { Id, Offset, Size, 0, false };
+			Live.push_back(Block);
+			Allocations++;
+
+			if (Ring.Used() > PeakUsed)
+				PeakUsed = Ring.Used();
+		}
+
+		//    ,     
+		for (TestBlock& Block : Live)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			if (!Block.Retired && (Seed >> 8) % 2 == 0)
+			{
+				Ring.Retire(Block.Id, Fence);
+				Block.Fence = Fence;
+				Block.Retired = true;
+			}
+		}
+
+		//  GPU   0..3 
+		Seed = Seed * 1664525 + 1013904223;
+		UINT64 Lag = (Seed >> 8) % 4;
+		if (Fence > Lag && Fence - Lag > Completed)
+			Completed = Fence - Lag;
+
+		Ring.Reclaim(Completed);
+
+		while (!Live.empty() && Live.front().Retired && Live.front().Fence <= Completed)
+		{
+			for (UINT64 b = 0; b < Live.front().Size; b++)
+				Owner[(size_t)(Live.front().Offset + b)] = -1;
+			Live.pop_front();
+		}
+
+		UINT64 OldestFence;
+		bool HasOldest = Ring.Oldest_Fence(OldestFence);
+		if (HasOldest != (!Live.empty() && Live.front().Retired) ||
+			(HasOldest && OldestFence != Live.front().Fence) ||
+			(Ring.Used() == 0) != Live.empty() || Ring.Used() > Capacity)
+			Valid = false;
+
+		UINT Pending = 0;
+		for (const TestBlock& Block : Live)
+		{
+			if (!Block.Retired)
+				Pending++;
+		}
+
+		if (Ring.Pending() != Pending)
+			Valid = false;
+	}
+
+	Ring.Retire_All(Fence + 1);
+	Ring.Reclaim(Fence + 1);
+
+	if (Ring.Used() != 0 || Ring.Pending() != 0)
+		Valid = false;
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Ring allocator: %u allocations, %u wraps, %u fence waits, %u full, peak %llu of %llu bytes %s\n",
+		Allocations, Wraps, Waits, Full, PeakUsed, Capacity, Valid ? "OK" : "FAILED");
+	OutputDebugStringA(Buffer);
+}
@@ -0,0 +1,404 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Texture File DirectX12
+//======================================================================================
+
+#include "TextureFile.h"
+
+#include "BmpFile.h"
+#include "BcEncoder.h"
+#include "MipGenerator.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+static UINT Texture_Align(UINT Offset)
+{
+	return (Offset + TEXTURE_FILE_ALIGN - 1) & ~(TEXTURE_FILE_ALIGN - 1);
+}
+
+static const char* Format_Name(DXGI_FORMAT Format)
+{
+	if (Format == DXGI_FORMAT_BC1_UNORM)
+		return "BC1";
+
+	if (Format == DXGI_FORMAT_BC3_UNORM)
+		return "BC3";
+
+	return "RGBA8";
+}
+
+UINT Texture_Row_Pitch(DXGI_FORMAT Format, UINT Width)
+{
+	UINT BlockSize = Bc_Block_Size(Format);
+
+	return BlockSize ? ((Width + 3) / 4) * BlockSize : Width * 4;
+}
+
+UINT Texture_Num_Rows(DXGI_FORMAT Format, UINT Height)
+{
+	return Bc_Block_Size(Format) ? (Height + 3) / 4 : Height;
+}
+
+//BC      4,   BC3
+//        255
+static DXGI_FORMAT Choose_Texture_Format(const std::vector<BYTE>& Texels, UINT Width, UINT Height, bool AlphaUsed)
+{
+	if ((Width % 4) != 0 || (Height % 4) != 0)
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
+
+	if (AlphaUsed)
+	{
+		for (size_t i = 3; i < Texels.size(); i += 4)
+		{
+			if (Texels[i] != 255)
+				return DXGI_FORMAT_BC3_UNORM;
+		}
+	}
+
+	return DXGI_FORMAT_BC1_UNORM;
+}
+
+// BMP,  mip    , FileData -  
+static void Cook_Texture(const CBmpFile& Bmp, UINT Flags, bool AlphaUsed, bool GenerateMips, CThreadPool* Pool,
+	std::vector<BYTE>& FileData, std::vector<BYTE>& Texels)
+{
+	UINT Width = Bmp.Width();
+	UINT Height = Bmp.Height();
+
+	Texels.resize((size_t)Width * Height * 4);
+	Bmp.Decode_RGBA(Texels.data(), Width * 4, Flags);
+
+	TextureFileHeader Header = {};
+	Header.Magic = TEXTURE_FILE_MAGIC;
+	Header.Version = TEXTURE_FILE_VERSION;
+	Header.HeaderSize = sizeof(TextureFileHeader);
+	Header.Format = Choose_Texture_Format(Texels, Width, Height, AlphaUsed);
+	Header.Width = Width;
+	Header.Height = Height;
+	Header.MipLevels = GenerateMips ? Mip_Level_Count(Width, Height) : 1;
+
+	//  1..MipLevels-1,  0  Texels
+	std::vector<std::vector<BYTE>> Levels(Header.MipLevels);
+	std::vector<MipLevelData> LevelData(Header.MipLevels);
+
+	UINT Offset = Texture_Align(sizeof(TextureFileHeader));
+	UINT LevelWidth = Width;
+	UINT LevelHeight = Height;
+
+	for (UINT i = 0; i < Header.MipLevels; i++)
+	{
+		if (i > 0)
+			Levels[i].resize((size_t)LevelWidth * LevelHeight * 4);
+
+		LevelData[i].Data = i > 0 ? Levels[i].data() : nullptr;
+		LevelData[i].RowPitch = LevelWidth * 4;
+
+		Header.LevelOffset[i] = Offset;
+		Header.LevelRowPitch[i] = Texture_Row_Pitch((DXGI_FORMAT)Header.Format, LevelWidth);
+		Header.LevelNumRows[i] = Texture_Num_Rows((DXGI_FORMAT)Header.Format, LevelHeight);
+
+		Offset = Texture_Align(Offset + Header.LevelRowPitch[i] * Header.LevelNumRows[i]);
+
+		LevelWidth = LevelWidth > 1 ? LevelWidth / 2 : 1;
+		LevelHeight = LevelHeight > 1 ? LevelHeight / 2 : 1;
+	}
+
+	Generate_Mip_Chain(Texels.data(), Width * 4, Width, Height, LevelData.data(), Header.MipLevels, Pool);
+
+	FileData.assign(Offset, 0);
+	memcpy(FileData.data(), &Header, sizeof(TextureFileHeader));
+
+	LevelWidth = Width;
+	LevelHeight = Height;
+
+	for (UINT i = 0; i < Header.MipLevels; i++)
+	{
+		const BYTE* Src = i > 0 ? Levels[i].data() : Texels.data();
+		BYTE* Dst = FileData.data() + Header.LevelOffset[i];
+
+		if (Header.Format == DXGI_FORMAT_R8G8B8A8_UNORM)
+			memcpy(Dst, Src, (size_t)LevelWidth * LevelHeight * 4);
+		else
+			Compress_BC((DXGI_FORMAT)Header.Format, Src, LevelWidth * 4, LevelWidth, LevelHeight,
+				Dst, Header.LevelRowPitch[i], Pool);
+
+		LevelWidth = LevelWidth > 1 ? LevelWidth / 2 : 1;
+		LevelHeight = LevelHeight > 1 ? LevelHeight / 2 : 1;
+	}
+}
+
+bool Convert_Bmp_To_Texture(const std::wstring& BmpFilename, const std::wstring& TexFilename,
+	UINT Flags, bool AlphaUsed, bool GenerateMips, CThreadPool* Pool)
+{
+	CBmpFile Bmp;
+	if (!Bmp.Open(BmpFilename))
+		return false;
+
+	std::vector<BYTE> FileData;
+	std::vector<BYTE> Texels;
+	Cook_Texture(Bmp, Flags, AlphaUsed, GenerateMips, Pool, FileData, Texels);
+
+	FILE* f = NULL;
+	_wfopen_s(&f, TexFilename.c_str(), L"wb");
+	if (f == NULL)
+		return false;
+
+	size_t Written = fwrite(FileData.data(), 1, FileData.size(), f);
+
+	fclose(f);
+
+	const TextureFileHeader* Header = (const TextureFileHeader*)FileData.data();
+
+	char Buffer[512];
+	sprintf_s(Buffer, "%ls: %s %ux%u, %u mip levels, %u bytes\n",
+		BmpFilename.c_str(), Format_Name((DXGI_FORMAT)Header->Format),
+		Header->Width, Header->Height, Header->MipLevels, (UINT)FileData.size());
+	OutputDebugStringA(Buffer);
+
+	return Written == FileData.size();
+}
+
+bool Texture_Binary_Is_Stale(const std::wstring& BmpFilename, const std::wstring& TexFilename)
+{
+	WIN32_FILE_ATTRIBUTE_DATA TexData;
+	if (!GetFileAttributesExW(TexFilename.c_str(), GetFileExInfoStandard, &TexData))
+		return true;
+
+	//   
+	TextureFileHeader Header = {};
+
+	FILE* f = NULL;
+	_wfopen_s(&f, TexFilename.c_str(), L"rb");
+	if (f != NULL)
+	{
+		fread(&Header, sizeof(TextureFileHeader), 1, f);
+		fclose(f);
+	}
+
+	if (Header.Magic != TEXTURE_FILE_MAGIC || Header.Version != TEXTURE_FILE_VERSION)
+		return true;
+
+	//BMP  -     
+	WIN32_FILE_ATTRIBUTE_DATA BmpData;
+	if (!GetFileAttributesExW(BmpFilename.c_str(), GetFileExInfoStandard, &BmpData))
+		return false;
+
+	return CompareFileTime(&TexData.ftLastWriteTime, &BmpData.ftLastWriteTime) < 0;
+}
+
+CTextureFile::CTextureFile()
+{
+}
+
+CTextureFile::~CTextureFile()
+{
+	Close();
+}
+
+bool CTextureFile::Open(const std::wstring& Filename)
+{
+	Close();
+
+	m_File = CreateFileW(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (m_File == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(m_File, &FileSize) || FileSize.QuadPart < (LONGLONG)sizeof(TextureFileHeader))
+	{
+		Close();
+		return false;
+	}
+
+	m_Mapping = CreateFileMappingW(m_File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_Mapping == NULL)
+	{
+		Close();
+		return false;
+	}
+
+	m_View = (const BYTE*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_View == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	m_Header = (const TextureFileHeader*)m_View;
+
+	DXGI_FORMAT Format = (DXGI_FORMAT)m_Header->Format;
+
+	bool Valid = m_Header->Magic == TEXTURE_FILE_MAGIC &&
+		m_Header->Version == TEXTURE_FILE_VERSION &&
+		m_Header->HeaderSize == sizeof(TextureFileHeader) &&
+		(Format == DXGI_FORMAT_BC1_UNORM || Format == DXGI_FORMAT_BC3_UNORM || Format == DXGI_FORMAT_R8G8B8A8_UNORM) &&
+		m_Header->Width > 0 && m_Header->Height > 0 &&
+		m_Header->MipLevels > 0 && m_Header->MipLevels <= TEXTURE_MAX_MIP_LEVELS;
+
+	//          
+	UINT LevelWidth = m_Header->Width;
+	UINT LevelHeight = m_Header->Height;
+
+	for (UINT i = 0; Valid && i < m_Header->MipLevels; i++)
+	{
+		UINT64 LevelEnd = (UINT64)m_Header->LevelOffset[i] +
+			(UINT64)m_Header->LevelRowPitch[i] * m_Header->LevelNumRows[i];
+
+		if ((m_Header->LevelOffset[i] % TEXTURE_FILE_ALIGN) != 0 ||
+			m_Header->LevelRowPitch[i] != Texture_Row_Pitch(Format, LevelWidth) ||
+			m_Header->LevelNumRows[i] != Texture_Num_Rows(Format, LevelHeight) ||
+			LevelEnd > (UINT64)FileSize.QuadPart)
+		{
+			Valid = false;
+		}
+
+		LevelWidth = LevelWidth > 1 ? LevelWidth / 2 : 1;
+		LevelHeight = LevelHeight > 1 ? LevelHeight / 2 : 1;
+	}
+
+	if (!Valid)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void CTextureFile::Close()
+{
+	if (m_View != nullptr)
+		UnmapViewOfFile(m_View);
+
+	if (m_Mapping != NULL)
+		CloseHandle(m_Mapping);
+
+	if (m_File != INVALID_HANDLE_VALUE)
+		CloseHandle(m_File);
+
+	m_View = nullptr;
+	m_Header = nullptr;
+	m_Mapping = NULL;
+	m_File = INVALID_HANDLE_VALUE;
+}
+
+DXGI_FORMAT CTextureFile::Format() const
+{
+	return (DXGI_FORMAT)m_Header->Format;
+}
+
+UINT CTextureFile::Width() const
+{
+	return m_Header->Width;
+}
+
+UINT CTextureFile::Height() const
+{
+	return m_Header->Height;
+}
+
+UINT CTextureFile::MipLevels() const
+{
+	return m_Header->MipLevels;
+}
+
+const BYTE* CTextureFile::Level_Data(UINT Level) const
+{
+	return m_View + m_Header->LevelOffset[Level];
+}
+
+UINT CTextureFile::Level_Row_Pitch(UINT Level) const
+{
+	return m_Header->LevelRowPitch[Level];
+}
+
+UINT CTextureFile::Level_Num_Rows(UINT Level) const
+{
+	return m_Header->LevelNumRows[Level];
+}
+
+void CTextureFile::Copy_Level(UINT Level, void* Dst, UINT DstRowPitch) const
+{
+	const BYTE* Src = Level_Data(Level);
+	UINT RowPitch = m_Header->LevelRowPitch[Level];
+
+	for (UINT y = 0; y < m_Header->LevelNumRows[Level]; y++)
+		memcpy((BYTE*)Dst + (size_t)y * DstRowPitch, Src + (size_t)y * RowPitch, RowPitch);
+}
+
+void Report_Texture_Compression(const std::vector<std::wstring>& BmpFilenames,
+	UINT Flags, bool AlphaUsed, bool GenerateMips, CThreadPool* Pool)
+{
+	__int64 PerfFreq;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&PerfFreq);
+
+	for (size_t i = 0; i < BmpFilenames.size(); i++)
+	{
+		CBmpFile Bmp;
+		if (!Bmp.Open(BmpFilenames[i]))
+			continue;
+
+		//     Pool,   
+		std::vector<BYTE> FileData[2];
+		std::vector<BYTE> Texels;
+		double Ms[2];
+
+		for (UINT v = 0; v < 2; v++)
+		{
+			__int64 Time0, Time1;
+			QueryPerformanceCounter((LARGE_INTEGER*)&Time0);
+
+			Cook_Texture(Bmp, Flags, AlphaUsed, GenerateMips, v == 1 ? Pool : nullptr, FileData[v], Texels);
+
+			QueryPerformanceCounter((LARGE_INTEGER*)&Time1);
+			Ms[v] = (double)(Time1 - Time0) * 1000.0 / PerfFreq;
+		}
+
+		const TextureFileHeader* Header = (const TextureFileHeader*)FileData[0].data();
+		DXGI_FORMAT Format = (DXGI_FORMAT)Header->Format;
+
+		//     RGBA8    
+		UINT64 RawSize = 0;
+		UINT64 PackedSize = 0;
+
+		UINT LevelWidth = Header->Width;
+		UINT LevelHeight = Header->Height;
+
+		for (UINT l = 0; l < Header->MipLevels; l++)
+		{
+			RawSize += (UINT64)LevelWidth * LevelHeight * 4;
+			PackedSize += (UINT64)Header->LevelRowPitch[l] * Header->LevelNumRows[l];
+
+			LevelWidth = LevelWidth > 1 ? LevelWidth / 2 : 1;
+			LevelHeight = LevelHeight > 1 ? LevelHeight / 2 : 1;
+		}
+
+		double PsnrRgb = 100.0;
+		double PsnrRgba = 100.0;
+
+		if (Format != DXGI_FORMAT_R8G8B8A8_UNORM)
+		{
+			std::vector<BYTE> Decoded(Texels.size());
+			Decompress_BC(Format, FileData[0].data() + Header->LevelOffset[0], Header->LevelRowPitch[0],
+				Header->Width, Header->Height, Decoded.data(), Header->Width * 4);
+
+			PsnrRgb = Compute_PSNR(Texels.data(), Decoded.data(), Header->Width, Header->Height, 3);
+			PsnrRgba = Compute_PSNR(Texels.data(), Decoded.data(), Header->Width, Header->Height, 4);
+		}
+
+		// BC1   ,   RGB
+		if (Format != DXGI_FORMAT_BC3_UNORM)
+			PsnrRgba = PsnrRgb;
+
+		char Buffer[512];
+		sprintf_s(Buffer, "%ls: %s %ux%u, %u mip levels, %llu -> %llu bytes (%.1f:1), PSNR RGB %.2f dB RGBA %.2f dB, "
+			"encode %.2f ms, with threads %.2f ms%s\n",
+			BmpFilenames[i].c_str(), Format_Name(Format), Header->Width, Header->Height, Header->MipLevels,
+			RawSize, PackedSize, (double)RawSize / (double)PackedSize, PsnrRgb, PsnrRgba,
+			Ms[0], Ms[1], FileData[0] == FileData[1] ? "" : " (MISMATCH)");
+		OutputDebugStringA(Buffer);
+	}
+}
@@ -0,0 +1,91 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Thread Pool
+//======================================================================================
+
+#ifndef _THREADPOOL_
+#define _THREADPOOL_
+
+#include <windows.h>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <vector>
+#include <exception>
+
+//   ,
+//    
+class CThreadPool
+{
+public:
+	CThreadPool(UINT NumThreads = 0);
+	~CThreadPool();
+
+	CThreadPool(const CThreadPool& rhs) = delete;
+	CThreadPool& operator=(const CThreadPool& rhs) = delete;
+
+	void Add_Task(std::function<void()> Task);
+
+	//     ,  
+	//      
+	void Wait_All();
+
+	UINT Get_Num_Threads() const;
+
+private:
+	void Worker_Proc();
+
+	std::vector<std::thread> m_Threads;
+	std::queue<std::function<void()>> m_Tasks;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_TaskReady;
+	std::condition_variable m_AllDone;
+
+	UINT m_TasksInFlight = 0;
+	bool m_Quit = false;
+
+	//      Wait_All
+	std::exception_ptr m_Error;
+};
+
+//Func(Row0, Row1)   ,    MinRowsPerBand
+//  Pool   .  Pool    
+//    .     Pool
+//  Pool  - Wait_All    
+template<class F>
+void Run_Parallel_Rows(CThreadPool* Pool, UINT Rows, UINT MinRowsPerBand, const F& Func)
+{
+	UINT NumBands = 1;
+
+	if (Pool)
+	{
+		NumBands = Pool->Get_Num_Threads();
+
+		UINT MaxBands = Rows / (MinRowsPerBand > 0 ? MinRowsPerBand : 1);
+		if (NumBands > MaxBands)
+			NumBands = MaxBands;
+	}
+
+	if (NumBands <= 1)
+	{
+		Func(0, Rows);
+		return;
+	}
+
+	for (UINT b = 0; b < NumBands; b++)
+	{
+		UINT Row0 = (UINT)((UINT64)Rows * b / NumBands);
+		UINT Row1 = (UINT)((UINT64)Rows * (b + 1) / NumBands);
+
+		Pool->Add_Task([&Func, Row0, Row1]()
+		{
+			Func(Row0, Row1);
+		});
+	}
+
+	Pool->Wait_All();
+}
+
+#endif
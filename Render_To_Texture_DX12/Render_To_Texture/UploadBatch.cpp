@@ -0,0 +1,103 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Upload Batch DirectX12
+//======================================================================================
+
+#include "UploadBatch.h"
+
+#include <stdio.h>
+
+static double Get_Time_Ms()
+{
+	__int64 PerfFreq, Time;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&PerfFreq);
+	QueryPerformanceCounter((LARGE_INTEGER*)&Time);
+
+	return Time * 1000.0 / PerfFreq;
+}
+
+void CUploadBatch::Init(CUploadRing* UploadRing)
+{
+	m_UploadRing = UploadRing;
+	m_StartMs = Get_Time_Ms();
+}
+
+void CUploadBatch::Add_Resource(ID3D12Resource* Resource, D3D12_RESOURCE_STATES Before, D3D12_RESOURCE_STATES After)
+{
+	if (Before != D3D12_RESOURCE_STATE_COPY_DEST)
+		m_Before.push_back(CD3DX12_RESOURCE_BARRIER::Transition(Resource, Before, D3D12_RESOURCE_STATE_COPY_DEST));
+
+	if (After != D3D12_RESOURCE_STATE_COPY_DEST)
+		m_After.push_back(CD3DX12_RESOURCE_BARRIER::Transition(Resource, D3D12_RESOURCE_STATE_COPY_DEST, After));
+
+	m_Stats.Resources++;
+}
+
+void CUploadBatch::Upload_Buffer(ID3D12Resource* Dst, const void* Data, UINT64 Size, D3D12_RESOURCE_STATES After)
+{
+	UploadAllocation Upload = m_UploadRing->Allocate(Size, UPLOAD_BUFFER_ALIGN);
+	memcpy(Upload.Mapped + Upload.Offset, Data, (size_t)Size);
+
+	Add_Resource(Dst, D3D12_RESOURCE_STATE_COMMON, After);
+
+	BufferCopy Copy = { Dst, Upload.Resource, Upload.Offset, Size };
+	m_BufferCopies.push_back(Copy);
+}
+
+UploadAllocation CUploadBatch::Allocate_Texture(const D3D12_RESOURCE_DESC& Desc,
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT* Footprints)
+{
+	return m_UploadRing->Allocate_Texture(Desc, Footprints);
+}
+
+void CUploadBatch::Copy_Texture_Region(const D3D12_TEXTURE_COPY_LOCATION& Dst, UINT DstX, UINT DstY,
+	const D3D12_TEXTURE_COPY_LOCATION& Src)
+{
+	TextureCopy Copy = { Dst, DstX, DstY, Src };
+	m_TextureCopies.push_back(Copy);
+}
+
+void CUploadBatch::Record(ID3D12GraphicsCommandList* CmdList)
+{
+	if (!m_Before.empty())
+	{
+		CmdList->ResourceBarrier((UINT)m_Before.size(), m_Before.data());
+		m_Stats.BarrierCalls++;
+	}
+
+	for (const BufferCopy& Copy : m_BufferCopies)
+		CmdList->CopyBufferRegion(Copy.Dst, 0, Copy.Src, Copy.SrcOffset, Copy.Size);
+
+	for (const TextureCopy& Copy : m_TextureCopies)
+		CmdList->CopyTextureRegion(&Copy.Dst, Copy.DstX, Copy.DstY, 0, &Copy.Src, nullptr);
+
+	if (!m_After.empty())
+	{
+		CmdList->ResourceBarrier((UINT)m_After.size(), m_After.data());
+		m_Stats.BarrierCalls++;
+	}
+
+	m_Stats.Copies += (UINT)(m_BufferCopies.size() + m_TextureCopies.size());
+	m_Stats.Barriers += (UINT)(m_Before.size() + m_After.size());
+	m_Stats.Records++;
+
+	m_Before.clear();
+	m_After.clear();
+	m_BufferCopies.clear();
+	m_TextureCopies.clear();
+}
+
+const UploadBatchStats& CUploadBatch::Get_Stats() const
+{
+	return m_Stats;
+}
+
+void CUploadBatch::Report(const char* Name)
+{
+	UploadRingStats RingStats = m_UploadRing->Get_Stats();
+
+	char Buffer[256];
+	sprintf_s(Buffer, "%s: %u resources, %u copies, %u barriers in %u calls, %u submits, peak upload memory %.2f MB, %.2f ms since start\n",
+		Name, m_Stats.Resources, m_Stats.Copies, m_Stats.Barriers, m_Stats.BarrierCalls, m_Stats.Records,
+		(RingStats.PeakUsed + RingStats.OverflowBytes) / (1024.0 * 1024.0), Get_Time_Ms() - m_StartMs);
+	OutputDebugStringA(Buffer);
+}
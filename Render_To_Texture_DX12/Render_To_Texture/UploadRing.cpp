@@ -0,0 +1,209 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Upload Ring DirectX12
+//======================================================================================
+
+#include "UploadRing.h"
+#include "FrameScheduler.h"
+
+#include <stdio.h>
+
+static void Wait_For_Fence(ID3D12Fence* Fence, UINT64 Value)
+{
+	//Allocate     ,    
+	static thread_local CFenceEvent Event;
+
+	Event.Wait(Fence, Value);
+}
+
+CUploadRing::~CUploadRing()
+{
+	if (m_Buffer != nullptr)
+		m_Buffer->Unmap(0, nullptr);
+}
+
+void CUploadRing::Init(ID3D12Device* Device, ID3D12Fence* Fence, UINT64 Capacity)
+{
+	m_Device = Device;
+	m_Fence = Fence;
+
+	ThrowIfFailed(Device->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(Capacity),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(m_Buffer.GetAddressOf())));
+
+	//upload      ,
+	//CPU    
+	CD3DX12_RANGE ReadRange(0, 0);
+	ThrowIfFailed(m_Buffer->Map(0, &ReadRange, reinterpret_cast<void**>(&m_Mapped)));
+
+	m_Ring.Init(Capacity);
+}
+
+UploadAllocation CUploadRing::Allocate(UINT64 Size, UINT64 Align)
+{
+	UploadAllocation Allocation;
+
+	std::unique_lock<std::mutex> Lock(m_Mutex);
+
+	Reclaim_Locked(m_Fence->GetCompletedValue());
+
+	UINT64 Offset = 0;
+	UINT Id = 0;
+	bool Fits = Size <= m_Ring.Capacity();
+	bool Allocated = Fits && m_Ring.Allocate(Size, Align, Offset, Id);
+
+	//     -     ,
+	//Retire          Signal
+	UINT64 OldestFence;
+	while (!Allocated && Fits && m_Ring.Oldest_Fence(OldestFence))
+	{
+		Lock.unlock();
+		Wait_For_Fence(m_Fence, OldestFence);
+		Lock.lock();
+
+		m_Stats.Waits++;
+
+		Reclaim_Locked(m_Fence->GetCompletedValue());
+		Allocated = m_Ring.Allocate(Size, Align, Offset, Id);
+	}
+
+	m_Stats.Allocations++;
+	m_Stats.Bytes += Size;
+
+	if (Allocated)
+	{
+		Allocation.Resource = m_Buffer.Get();
+		Allocation.Offset = Offset;
+		Allocation.Mapped = m_Mapped;
+		Allocation.Id = Id;
+
+		if (m_Ring.Used() > m_Stats.PeakUsed)
+			m_Stats.PeakUsed = m_Ring.Used();
+
+		return Allocation;
+	}
+
+	//   ,     
+	//(   ) -  ,   
+	OverflowBuffer Buffer;
+	Buffer.Id = m_NextOverflowId++;
+	Buffer.Fence = 0;
+	Buffer.Retired = false;
+
+	ThrowIfFailed(m_Device->CreateCommittedResource(
+		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+		D3D12_HEAP_FLAG_NONE,
+		&CD3DX12_RESOURCE_DESC::Buffer(Size),
+		D3D12_RESOURCE_STATE_GENERIC_READ,
+		nullptr,
+		IID_PPV_ARGS(Buffer.Resource.GetAddressOf())));
+
+	CD3DX12_RANGE ReadRange(0, 0);
+	ThrowIfFailed(Buffer.Resource->Map(0, &ReadRange, reinterpret_cast<void**>(&Allocation.Mapped)));
+
+	Allocation.Resource = Buffer.Resource.Get();
+	Allocation.Offset = 0;
+	Allocation.Id = Buffer.Id;
+	Allocation.Overflow = true;
+
+	m_Overflow.push_back(Buffer);
+
+	m_Stats.Overflows++;
+	m_Stats.OverflowBytes += Size;
+
+	return Allocation;
+}
+
+UploadAllocation CUploadRing::Allocate_Texture(const D3D12_RESOURCE_DESC& Desc,
+	D3D12_PLACED_SUBRESOURCE_FOOTPRINT* Footprints)
+{
+	UINT NumSubresources = Desc.MipLevels * Desc.DepthOrArraySize;
+
+	//   D3D12 ( 256 ), 
+	//    512    
+	UINT64 Size = 0;
+	m_Device->GetCopyableFootprints(&Desc, 0, NumSubresources, 0, Footprints, nullptr, nullptr, &Size);
+
+	UploadAllocation Allocation = Allocate(Size, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+	for (UINT i = 0; i < NumSubresources; i++)
+		Footprints[i].Offset += Allocation.Offset;
+
+	return Allocation;
+}
+
+void CUploadRing::Retire(const UploadAllocation& Allocation, UINT64 Fence)
+{
+	std::lock_guard<std::mutex> Lock(m_Mutex);
+
+	if (!Allocation.Overflow)
+	{
+		m_Ring.Retire(Allocation.Id, Fence);
+		return;
+	}
+
+	for (OverflowBuffer& Buffer : m_Overflow)
+	{
+		if (Buffer.Id == Allocation.Id)
+		{
+			Buffer.Fence = Fence;
+			Buffer.Retired = true;
+		}
+	}
+}
+
+void CUploadRing::Retire_All(UINT64 Fence)
+{
+	std::lock_guard<std::mutex> Lock(m_Mutex);
+
+	m_Ring.Retire_All(Fence);
+
+	for (OverflowBuffer& Buffer : m_Overflow)
+	{
+		if (!Buffer.Retired)
+		{
+			Buffer.Fence = Fence;
+			Buffer.Retired = true;
+		}
+	}
+}
+
+void CUploadRing::Reclaim()
+{
+	std::lock_guard<std::mutex> Lock(m_Mutex);
+	Reclaim_Locked(m_Fence->GetCompletedValue());
+}
+
+void CUploadRing::Reclaim_Locked(UINT64 CompletedFence)
+{
+	m_Ring.Reclaim(CompletedFence);
+
+	for (size_t i = 0; i < m_Overflow.size(); )
+	{
+		if (m_Overflow[i].Retired && m_Overflow[i].Fence <= CompletedFence)
+			m_Overflow.erase(m_Overflow.begin() + i);
+		else
+			i++;
+	}
+}
+
+UploadRingStats CUploadRing::Get_Stats()
+{
+	std::lock_guard<std::mutex> Lock(m_Mutex);
+	return m_Stats;
+}
+
+void CUploadRing::Report(const char* Name)
+{
+	UploadRingStats Stats = Get_Stats();
+
+	char Buffer[256];
+	sprintf_s(Buffer, "%s: %u allocations %.2f MB, ring peak %.2f of %.2f MB, %u fence waits, %u overflows %.2f MB\n",
+		Name, Stats.Allocations, Stats.Bytes / (1024.0 * 1024.0),
+		Stats.PeakUsed / (1024.0 * 1024.0), m_Ring.Capacity() / (1024.0 * 1024.0),
+		Stats.Waits, Stats.Overflows, Stats.OverflowBytes / (1024.0 * 1024.0));
+	OutputDebugStringA(Buffer);
+}
@@ -3,6 +3,7 @@
 //======================================================================================
 
 #include "d3dUtil.h"
+#include "UploadBatch.h"
 
 DxException::DxException(HRESULT hr, const std::wstring& functionName, const std::wstring& Filename, int lineNumber) :
 	ErrorCode(hr),
@@ -48,10 +49,9 @@ Microsoft::WRL::ComPtr<ID3DBlob> d3dUtil::CompileShader(
 
 Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
 	ID3D12Device* device,
-	ID3D12GraphicsCommandList* CmdList,
 	const void* initData,
 	UINT64 byteSize,
-	Microsoft::WRL::ComPtr<ID3D12Resource>& UploadBuffer)
+	CUploadBatch& UploadBatch)
 {
 	Microsoft::WRL::ComPtr<ID3D12Resource> defaultBuffer;
 
@@ -63,24 +63,8 @@ Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
 		nullptr,
 		IID_PPV_ARGS(defaultBuffer.GetAddressOf())));
 
-	ThrowIfFailed(device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(byteSize),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(UploadBuffer.GetAddressOf())));
-
-	D3D12_SUBRESOURCE_DATA subResourceData = {};
-	subResourceData.pData = initData;
-	subResourceData.RowPitch = (LONG_PTR)byteSize;
-	subResourceData.SlicePitch = subResourceData.RowPitch;
-
-	CmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(defaultBuffer.Get(),
-		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST));
-	UpdateSubresources<1>(CmdList, defaultBuffer.Get(), UploadBuffer.Get(), 0, 0, 1, &subResourceData);
-	CmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(defaultBuffer.Get(),
-		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
+	//    upload ,     
+	UploadBatch.Upload_Buffer(defaultBuffer.Get(), initData, byteSize, D3D12_RESOURCE_STATE_GENERIC_READ);
 
 	return defaultBuffer;
 }
@@ -0,0 +1,154 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Asset Cache DirectX12
+//======================================================================================
+
+#include "AssetCache.h"
+
+#include <stdio.h>
+#include <atomic>
+#include <vector>
+
+#define ASSET_HASH_PRIME 0x100000001b3ULL
+
+//     
+#define ASSET_HASH_CHUNK 65536
+
+static std::wstring g_CacheDirectory = ASSET_CACHE_DIRECTORY;
+
+static std::atomic<UINT> g_CacheHits[ASSET_KIND_COUNT];
+static std::atomic<UINT> g_CacheMisses[ASSET_KIND_COUNT];
+
+static const wchar_t* Kind_Prefix(AssetKind Kind)
+{
+	static const wchar_t* Prefix[ASSET_KIND_COUNT] = { L"room_", L"texture_", L"shader_" };
+	return Prefix[Kind];
+}
+
+static const wchar_t* Kind_Extension(AssetKind Kind)
+{
+	static const wchar_t* Extension[ASSET_KIND_COUNT] = { L".room", L".tex", L".cso" };
+	return Extension[Kind];
+}
+
+UINT64 Hash_Bytes(const void* Data, size_t Size, UINT64 Hash)
+{
+	const BYTE* Bytes = (const BYTE*)Data;
+
+	for (size_t i = 0; i < Size; i++)
+	{
+		Hash ^= Bytes[i];
+		Hash *= ASSET_HASH_PRIME;
+	}
+
+	return Hash;
+}
+
+bool Hash_File(const std::wstring& Filename, UINT64& Hash)
+{
+	FILE* f = NULL;
+	_wfopen_s(&f, Filename.c_str(), L"rb");
+	if (f == NULL)
+		return false;
+
+	std::vector<BYTE> Chunk(ASSET_HASH_CHUNK);
+	Hash = ASSET_HASH_SEED;
+
+	size_t Read;
+	while ((Read = fread(Chunk.data(), 1, Chunk.size(), f)) > 0)
+		Hash = Hash_Bytes(Chunk.data(), Read, Hash);
+
+	fclose(f);
+
+	return true;
+}
+
+bool Asset_Cache_Lookup(AssetKind Kind, const std::wstring& SourceFilename, UINT64 Key,
+	std::wstring& CachedFilename, bool& Hit)
+{
+	Hit = false;
+
+	UINT64 Hash;
+	if (!Hash_File(SourceFilename, Hash))
+		return false;
+
+	UINT Version = ASSET_CACHE_VERSION;
+	Hash = Hash_Bytes(&Key, sizeof(Key), Hash);
+	Hash = Hash_Bytes(&Version, sizeof(Version), Hash);
+
+	wchar_t Name[64];
+	swprintf_s(Name, L"%ls%016llx%ls", Kind_Prefix(Kind), Hash, Kind_Extension(Kind));
+
+	//    ,        
+	CreateDirectoryW(g_CacheDirectory.c_str(), NULL);
+
+	CachedFilename = g_CacheDirectory + Name;
+	Hit = GetFileAttributesW(CachedFilename.c_str()) != INVALID_FILE_ATTRIBUTES;
+
+	if (Hit)
+		g_CacheHits[Kind]++;
+	else
+		g_CacheMisses[Kind]++;
+
+	return true;
+}
+
+std::wstring Asset_Cache_Temp_Filename(const std::wstring& CachedFilename)
+{
+	//    -       
+	return CachedFilename + L"." + std::to_wstring(GetCurrentThreadId()) + L".tmp";
+}
+
+bool Asset_Cache_Commit(const std::wstring& TempFilename, const std::wstring& CachedFilename)
+{
+	if (MoveFileExW(TempFilename.c_str(), CachedFilename.c_str(), MOVEFILE_REPLACE_EXISTING))
+		return true;
+
+	DeleteFileW(TempFilename.c_str());
+	return false;
+}
+
+void Asset_Cache_Set_Directory(const std::wstring& Directory)
+{
+	g_CacheDirectory = Directory;
+}
+
+const std::wstring& Asset_Cache_Directory()
+{
+	return g_CacheDirectory;
+}
+
+void Asset_Cache_Clear()
+{
+	WIN32_FIND_DATAW FindData;
+	HANDLE Find = FindFirstFileW((g_CacheDirectory + L"*").c_str(), &FindData);
+	if (Find == INVALID_HANDLE_VALUE)
+		return;
+
+	do
+	{
+		if (!(FindData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+			DeleteFileW((g_CacheDirectory + FindData.cFileName).c_str());
+	} while (FindNextFileW(Find, &FindData));
+
+	FindClose(Find);
+}
+
+void Asset_Cache_Reset_Stats()
+{
+	for (UINT i = 0; i < ASSET_KIND_COUNT; i++)
+	{
+		g_CacheHits[i] = 0;
+		g_CacheMisses[i] = 0;
+	}
+}
+
+void Asset_Cache_Report()
+{
+	char Buffer[256];
+	sprintf_s(Buffer, "Asset cache %ls: rooms %u hit %u miss, textures %u hit %u miss, shaders %u hit %u miss\n",
+		g_CacheDirectory.c_str(),
+		g_CacheHits[ASSET_ROOM].load(), g_CacheMisses[ASSET_ROOM].load(),
+		g_CacheHits[ASSET_TEXTURE].load(), g_CacheMisses[ASSET_TEXTURE].load(),
+		g_CacheHits[ASSET_SHADER].load(), g_CacheMisses[ASSET_SHADER].load());
+	OutputDebugStringA(Buffer);
+}
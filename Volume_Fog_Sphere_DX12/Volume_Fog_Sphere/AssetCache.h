@@ -0,0 +1,56 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Asset Cache DirectX12
+//======================================================================================
+
+#ifndef _ASSETCACHE_
+#define _ASSETCACHE_
+
+#include <windows.h>
+#include <string>
+
+#define ASSET_CACHE_DIRECTORY L".\\Cache\\"
+
+//    ,  
+//      
+#define ASSET_CACHE_VERSION 1
+
+//  64- FNV-1a
+#define ASSET_HASH_SEED 0xcbf29ce484222325ULL
+
+enum AssetKind
+{
+	ASSET_ROOM,
+	ASSET_TEXTURE,
+	ASSET_SHADER,
+	ASSET_KIND_COUNT
+};
+
+//   Hash,      
+UINT64 Hash_Bytes(const void* Data, size_t Size, UINT64 Hash = ASSET_HASH_SEED);
+bool Hash_File(const std::wstring& Filename, UINT64& Hash);
+
+//       SourceFilename.   -
+//  , Key ( ,  , 
+//)  ASSET_CACHE_VERSION,    
+//  . CachedFilename   , Hit - 
+//    . false -   
+bool Asset_Cache_Lookup(AssetKind Kind, const std::wstring& SourceFilename, UINT64 Key,
+	std::wstring& CachedFilename, bool& Hit);
+
+//      ,   
+//     -    
+std::wstring Asset_Cache_Temp_Filename(const std::wstring& CachedFilename);
+bool Asset_Cache_Commit(const std::wstring& TempFilename, const std::wstring& CachedFilename);
+
+void Asset_Cache_Set_Directory(const std::wstring& Directory);
+const std::wstring& Asset_Cache_Directory();
+
+//      
+void Asset_Cache_Clear();
+
+//     ,     ,
+//Asset_Cache_Report    OutputDebugString
+void Asset_Cache_Reset_Stats();
+void Asset_Cache_Report();
+
+#endif
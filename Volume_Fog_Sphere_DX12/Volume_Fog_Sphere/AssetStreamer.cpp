@@ -0,0 +1,292 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Asset Streamer DirectX12
+//======================================================================================
+
+#include "AssetStreamer.h"
+
+#include <stdio.h>
+
+static double Get_Time_Ms()
+{
+	__int64 PerfFreq, Time;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&PerfFreq);
+	QueryPerformanceCounter((LARGE_INTEGER*)&Time);
+
+	return Time * 1000.0 / PerfFreq;
+}
+
+void CAssetStreamer::Add_Request(CThreadPool* Pool, const StreamRequest& Request)
+{
+	if (m_Items.empty())
+		m_StartMs = Get_Time_Ms();
+
+	m_Items.push_back(std::make_unique<StreamItem>());
+
+	StreamItem* Item = m_Items.back().get();
+	Item->Request = Request;
+
+	Pool->Add_Task([this, Item]()
+	{
+		Item->Loaded = Item->Request.Load(Item->Bytes);
+
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_Ready.push_back(Item);
+	});
+}
+
+bool CAssetStreamer::Has_Uploads()
+{
+	std::lock_guard<std::mutex> Lock(m_Mutex);
+	return !m_Ready.empty();
+}
+
+UINT64 CAssetStreamer::Process_Uploads(const StreamBudget& Budget)
+{
+	double Time0 = Get_Time_Ms();
+	UINT64 FrameBytes = 0;
+
+	for (;;)
+	{
+		StreamItem* Item;
+
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			if (m_Ready.empty())
+				break;
+
+			Item = m_Ready.front();
+		}
+
+		//    ,  
+		if (Item->Loaded && Item->Offset < Item->Bytes)
+		{
+			//    ,   
+			// ,     
+			if (FrameBytes > 0 && Get_Time_Ms() - Time0 >= Budget.MaxMs)
+				break;
+
+			//   ,    
+			if (FrameBytes >= Budget.MaxBytes)
+				break;
+
+			UINT64 Copied = Item->Request.Upload(Item->Offset, Budget.MaxBytes - FrameBytes);
+			if (Copied == 0)
+			{
+				if (FrameBytes == 0)
+					m_Stats.Stalls++;
+				break;
+			}
+
+			Item->Offset += Copied;
+			FrameBytes += Copied;
+
+			if (Item->Offset < Item->Bytes)
+				continue;
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+			m_Ready.pop_front();
+		}
+
+		Item->Request.Finish(Item->Loaded);
+
+		if (Item->Loaded)
+			m_Stats.Completed++;
+		else
+			m_Stats.Failed++;
+
+		m_Finished++;
+
+		if (Is_Complete())
+			m_Stats.CompleteMs = Get_Time_Ms() - m_StartMs;
+	}
+
+	double FrameMs = Get_Time_Ms() - Time0;
+
+	if (FrameBytes > 0)
+	{
+		m_Stats.Frames++;
+		m_Stats.TotalBytes += FrameBytes;
+
+		if (FrameBytes > m_Stats.MaxFrameBytes)
+			m_Stats.MaxFrameBytes = FrameBytes;
+
+		if (FrameMs > m_Stats.MaxFrameMs)
+			m_Stats.MaxFrameMs = FrameMs;
+	}
+
+	return FrameBytes;
+}
+
+bool CAssetStreamer::Is_Complete() const
+{
+	return m_Finished == (UINT)m_Items.size();
+}
+
+const StreamStats& CAssetStreamer::Get_Stats() const
+{
+	return m_Stats;
+}
+
+void CAssetStreamer::Report(const char* Name) const
+{
+	char Buffer[256];
+	sprintf_s(Buffer, "%s: %u resident, %u failed in %.2f ms, %u frames, %.2f MB, max frame %llu bytes %.3f ms, %u stalls\n",
+		Name, m_Stats.Completed, m_Stats.Failed, m_Stats.CompleteMs, m_Stats.Frames,
+		m_Stats.TotalBytes / (1024.0 * 1024.0), m_Stats.MaxFrameBytes, m_Stats.MaxFrameMs, m_Stats.Stalls);
+	OutputDebugStringA(Buffer);
+}
+
+void Verify_Asset_Streamer(CThreadPool* Pool)
+{
+	struct TestAsset
+	{
+		UINT64 Bytes = 0;
+		// : 1 - ,    
+		UINT64 Unit = 1;
+		bool Fails = false;
+
+		UINT64 Copied = 0;
+		UINT Finished = 0;
+		bool Loaded = false;
+		bool Valid = true;
+	};
+
+	static const StreamBudget Budgets[] =
+	{
+		{ 1024 * 1024, 2.0 },
+		{ 256 * 1024, 0.5 },
+		{ 65536, 0.1 },
+	};
+
+	static const UINT64 Units[] = { 1, 256, 4096, 65536 };
+
+	//          CAssetStreamer
+	const double TimeSlackMs = 0.05;
+
+	UINT Seed = 12345;
+
+	for (UINT b = 0; b < _countof(Budgets); b++)
+	{
+		const StreamBudget& Budget = Budgets[b];
+
+		std::vector<TestAsset> Assets(64);
+
+		for (UINT i = 0; i < (UINT)Assets.size(); i++)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			Assets[i].Bytes = (Seed >> 8) % (1024 * 1024 + 1);
+
+			Seed = Seed * 1664525 + 1013904223;
+			Assets[i].Unit = Units[(Seed >> 8) % _countof(Units)];
+
+			Assets[i].Fails = i % 16 == 5;
+		}
+
+		UINT64 FrameBytes = 0;
+		double FrameStartMs = 0.0;
+		double MaxCallMs = 0.0;
+
+		CAssetStreamer Streamer;
+
+		for (TestAsset& Asset : Assets)
+		{
+			TestAsset* A = &Asset;
+
+			StreamRequest Request;
+
+			Request.Load = [A](UINT64& Bytes)
+			{
+				//    
+				Sleep((DWORD)(A->Bytes % 3));
+				Bytes = A->Bytes;
+				return !A->Fails;
+			};
+
+			Request.Upload = [A, &Budget, &FrameBytes, &FrameStartMs, &MaxCallMs, TimeSlackMs](UINT64 Offset, UINT64 MaxBytes)
+			{
+				double Time0 = Get_Time_Ms();
+
+				if (Offset != A->Copied || A->Fails)
+					A->Valid = false;
+
+				//    ,     
+				if (FrameBytes > 0 && Time0 - FrameStartMs > Budget.MaxMs + TimeSlackMs)
+					A->Valid = false;
+
+				//      
+				UINT64 Left = A->Bytes - Offset;
+				UINT64 Bytes = Left <= MaxBytes ? Left : MaxBytes / A->Unit * A->Unit;
+
+				//   , ~4 GB/s
+				while (Get_Time_Ms() - Time0 < Bytes / 4.0e6);
+
+				A->Copied += Bytes;
+				FrameBytes += Bytes;
+
+				double CallMs = Get_Time_Ms() - Time0;
+				if (CallMs > MaxCallMs)
+					MaxCallMs = CallMs;
+
+				return Bytes;
+			};
+
+			Request.Finish = [A](bool Loaded)
+			{
+				A->Finished++;
+				A->Loaded = Loaded;
+			};
+
+			Streamer.Add_Request(Pool, Request);
+		}
+
+		bool Valid = true;
+		UINT Frames = 0;
+		UINT64 MaxFrameBytes = 0;
+
+		while (!Streamer.Is_Complete() && Frames < 100000)
+		{
+			FrameBytes = 0;
+			FrameStartMs = Get_Time_Ms();
+
+			UINT64 Returned = Streamer.Process_Uploads(Budget);
+
+			if (FrameBytes > Budget.MaxBytes || Returned != FrameBytes)
+				Valid = false;
+
+			if (FrameBytes > MaxFrameBytes)
+				MaxFrameBytes = FrameBytes;
+
+			Frames++;
+
+			//   
+			Sleep(1);
+		}
+
+		Pool->Wait_All();
+
+		UINT Failed = 0;
+
+		for (const TestAsset& Asset : Assets)
+		{
+			if (!Asset.Valid || Asset.Finished != 1 || Asset.Loaded == Asset.Fails ||
+				Asset.Copied != (Asset.Fails ? 0 : Asset.Bytes))
+				Valid = false;
+
+			if (Asset.Fails)
+				Failed++;
+		}
+
+		const StreamStats& Stats = Streamer.Get_Stats();
+
+		if (!Streamer.Is_Complete() || Stats.Stalls > 0 || Stats.Failed != Failed)
+			Valid = false;
+
+		char Buffer[256];
+		sprintf_s(Buffer, "Asset streamer %llu KB / %.2f ms: %u assets (%u failed) in %u frames, max frame %llu bytes %.3f ms, max chunk %.3f ms %s\n",
+			Budget.MaxBytes / 1024, Budget.MaxMs, (UINT)Assets.size(), Failed, Frames,
+			MaxFrameBytes, Stats.MaxFrameMs, MaxCallMs, Valid ? "OK" : "FAILED");
+		OutputDebugStringA(Buffer);
+	}
+}
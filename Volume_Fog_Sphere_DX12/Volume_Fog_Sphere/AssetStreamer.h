@@ -0,0 +1,106 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Asset Streamer DirectX12
+//======================================================================================
+
+#ifndef _ASSETSTREAMER_
+#define _ASSETSTREAMER_
+
+#include <windows.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <deque>
+#include <vector>
+
+#include "ThreadPool.h"
+
+//   . Load    ,
+//    CPU    Bytes   
+//  GPU, false -   . Upload 
+//  ,    MaxBytes   Offset
+//     , 0 - 
+//  . Finish      ,
+//    Load  false
+struct StreamRequest
+{
+	std::function<bool(UINT64& Bytes)> Load;
+	std::function<UINT64(UINT64 Offset, UINT64 MaxBytes)> Upload;
+	std::function<void(bool Loaded)> Finish;
+};
+
+//    
+struct StreamBudget
+{
+	UINT64 MaxBytes;
+	double MaxMs;
+};
+
+struct StreamStats
+{
+	//   - 
+	UINT Frames = 0;
+	UINT Completed = 0;
+	UINT Failed = 0;
+	//        
+	UINT Stalls = 0;
+	UINT64 TotalBytes = 0;
+	UINT64 MaxFrameBytes = 0;
+	double MaxFrameMs = 0.0;
+	//     Finish
+	double CompleteMs = 0.0;
+};
+
+class CAssetStreamer
+{
+public:
+	CAssetStreamer() = default;
+
+	CAssetStreamer(const CAssetStreamer& rhs) = delete;
+	CAssetStreamer& operator=(const CAssetStreamer& rhs) = delete;
+
+	//Load   Pool,   CAssetStreamer
+	//    (Pool->Wait_All)
+	void Add_Request(CThreadPool* Pool, const StreamRequest& Request);
+
+	//  ,   
+	bool Has_Uploads();
+
+	//        ,
+	//     .
+	//     
+	UINT64 Process_Uploads(const StreamBudget& Budget);
+
+	//    
+	bool Is_Complete() const;
+
+	const StreamStats& Get_Stats() const;
+	void Report(const char* Name) const;
+
+private:
+	struct StreamItem
+	{
+		StreamRequest Request;
+		UINT64 Bytes = 0;
+		UINT64 Offset = 0;
+		bool Loaded = false;
+	};
+
+	//  ,     
+	std::vector<std::unique_ptr<StreamItem>> m_Items;
+	UINT m_Finished = 0;
+
+	//  ,  m_Mutex
+	std::mutex m_Mutex;
+	std::deque<StreamItem*> m_Ready;
+
+	StreamStats m_Stats;
+	double m_StartMs = 0.0;
+};
+
+//CPU :       ,
+//  .        
+// ,          
+//    .   OutputDebugString
+void Verify_Asset_Streamer(CThreadPool* Pool);
+
+#endif
@@ -0,0 +1,41 @@
+//======================================================================================
+//	Ed Kurlyak 2023 BC Encoder DirectX12
+//======================================================================================
+
+#ifndef _BCENCODER_
+#define _BCENCODER_
+
+#include <windows.h>
+#include <dxgiformat.h>
+
+#include "ThreadPool.h"
+
+// 4x4 : BC1 -  565  2  ,
+//BC3 -    8      BC1
+#define BC1_BLOCK_SIZE 8
+#define BC3_BLOCK_SIZE 16
+
+//Texels - 16  RGBA8 
+void Encode_BC1_Block(const BYTE* Texels, BYTE* Block);
+void Encode_BC3_Block(const BYTE* Texels, BYTE* Block);
+void Decode_BC1_Block(const BYTE* Block, BYTE* Texels);
+void Decode_BC3_Block(const BYTE* Block, BYTE* Texels);
+
+//8  BC1, 16  BC3, 0   
+UINT Bc_Block_Size(DXGI_FORMAT Format);
+
+// RGBA8   BC1  BC3, Dst -    
+//DstRowPitch,       .
+//     Pool (nullptr -   )
+void Compress_BC(DXGI_FORMAT Format, const BYTE* Src, UINT SrcRowPitch, UINT Width, UINT Height,
+	BYTE* Dst, UINT DstRowPitch, CThreadPool* Pool);
+
+//  RGBA8,   
+void Decompress_BC(DXGI_FORMAT Format, const BYTE* Src, UINT SrcRowPitch, UINT Width, UINT Height,
+	BYTE* Dst, UINT DstRowPitch);
+
+//PSNR  dB   Channels   RGBA8 
+//  ,    100 dB
+double Compute_PSNR(const BYTE* A, const BYTE* B, UINT Width, UINT Height, UINT Channels);
+
+#endif
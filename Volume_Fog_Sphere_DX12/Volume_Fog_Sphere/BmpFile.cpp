@@ -0,0 +1,428 @@
+//======================================================================================
+//	Ed Kurlyak 2023 BMP File DirectX12
+//======================================================================================
+
+#include "BmpFile.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <intrin.h>
+#include <immintrin.h>
+
+#define BMP_SIMD_SCALAR 0
+#define BMP_SIMD_SSSE3 1
+#define BMP_SIMD_AVX2 2
+
+//D3D12     16384
+#define BMP_MAX_DIMENSION 16384
+
+static UINT Detect_Simd_Level()
+{
+	int Regs[4];
+
+	__cpuid(Regs, 0);
+	int MaxLeaf = Regs[0];
+
+	__cpuid(Regs, 1);
+	bool Ssse3 = (Regs[2] & (1 << 9)) != 0;
+
+	//AVX     (OSXSAVE  XCR0)
+	bool OsAvx = (Regs[2] & (1 << 27)) != 0 && (Regs[2] & (1 << 28)) != 0 &&
+		(_xgetbv(0) & 6) == 6;
+
+	bool Avx2 = false;
+	if (OsAvx && MaxLeaf >= 7)
+	{
+		__cpuidex(Regs, 7, 0);
+		Avx2 = (Regs[1] & (1 << 5)) != 0;
+	}
+
+	if (Avx2)
+		return BMP_SIMD_AVX2;
+
+	return Ssse3 ? BMP_SIMD_SSSE3 : BMP_SIMD_SCALAR;
+}
+
+static UINT Get_Simd_Level()
+{
+	static const UINT Level = Detect_Simd_Level();
+
+	return Level;
+}
+
+static UINT Read_U16(const BYTE* p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static UINT Read_U32(const BYTE* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((UINT)p[3] << 24);
+}
+
+bool Bmp_Parse_Header(const BYTE* Data, UINT64 Size, BmpInfo& Info)
+{
+	//BITMAPFILEHEADER 14  + BITMAPINFOHEADER 40 
+	if (Size < 54 || Data[0] != 'B' || Data[1] != 'M')
+		return false;
+
+	UINT DataOffset = Read_U32(Data + 10);
+	UINT HeaderSize = Read_U32(Data + 14);
+	INT Width = (INT)Read_U32(Data + 18);
+	INT Height = (INT)Read_U32(Data + 22);
+	UINT Planes = Read_U16(Data + 26);
+	UINT BitCount = Read_U16(Data + 28);
+	UINT Compression = Read_U32(Data + 30);
+
+	if (HeaderSize < 40 || 14 + (UINT64)HeaderSize > Size || Planes != 1)
+		return false;
+
+	if (BitCount != 24 && BitCount != 32)
+		return false;
+
+	if (Compression == BI_BITFIELDS)
+	{
+		// R G B    BITMAPINFOHEADER,  V4/V5   
+		if (BitCount != 32 || Size < 54 + 12)
+			return false;
+
+		if (Read_U32(Data + 54) != 0x00FF0000 ||
+			Read_U32(Data + 58) != 0x0000FF00 ||
+			Read_U32(Data + 62) != 0x000000FF)
+			return false;
+	}
+	else if (Compression != BI_RGB)
+	{
+		return false;
+	}
+
+	//  -    
+	bool TopDown = Height < 0;
+	UINT AbsHeight = TopDown ? 0u - (UINT)Height : (UINT)Height;
+
+	if (Width <= 0 || Width > BMP_MAX_DIMENSION || AbsHeight == 0 || AbsHeight > BMP_MAX_DIMENSION)
+		return false;
+
+	UINT RowPitch = ((Width * BitCount + 31) / 32) * 4;
+
+	if ((UINT64)DataOffset + (UINT64)RowPitch * AbsHeight > Size)
+		return false;
+
+	Info.Width = Width;
+	Info.Height = AbsHeight;
+	Info.BitCount = BitCount;
+	Info.TopDown = TopDown;
+	Info.DataOffset = DataOffset;
+	Info.RowPitch = RowPitch;
+
+	return true;
+}
+
+//BGRA -> RGBA
+static void Convert_Row_32_Scalar(const BYTE* Src, BYTE* Dst, UINT Width)
+{
+	for (UINT x = 0; x < Width; x++)
+	{
+		Dst[x * 4 + 0] = Src[x * 4 + 2];
+		Dst[x * 4 + 1] = Src[x * 4 + 1];
+		Dst[x * 4 + 2] = Src[x * 4 + 0];
+		Dst[x * 4 + 3] = Src[x * 4 + 3];
+	}
+}
+
+//BGR -> RGBA,  255
+static void Convert_Row_24_Scalar(const BYTE* Src, BYTE* Dst, UINT Width)
+{
+	for (UINT x = 0; x < Width; x++)
+	{
+		Dst[x * 4 + 0] = Src[x * 3 + 2];
+		Dst[x * 4 + 1] = Src[x * 3 + 1];
+		Dst[x * 4 + 2] = Src[x * 3 + 0];
+		Dst[x * 4 + 3] = 255;
+	}
+}
+
+static void Convert_Row_32_SSSE3(const BYTE* Src, BYTE* Dst, UINT Width)
+{
+	const __m128i Shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+	UINT x = 0;
+
+	//4   
+	for (; x + 4 <= Width; x += 4)
+	{
+		__m128i Pixels = _mm_loadu_si128((const __m128i*)(Src + x * 4));
+		_mm_storeu_si128((__m128i*)(Dst + x * 4), _mm_shuffle_epi8(Pixels, Shuffle));
+	}
+
+	Convert_Row_32_Scalar(Src + x * 4, Dst + x * 4, Width - x);
+}
+
+static void Convert_Row_24_SSSE3(const BYTE* Src, BYTE* Dst, UINT Width)
+{
+	// 12  BGR  4  RGB0,    OR
+	const __m128i Shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+	const __m128i Alpha = _mm_set1_epi32((int)0xFF000000);
+
+	UINT x = 0;
+
+	//  16 ,     
+	for (; x * 3 + 16 <= Width * 3; x += 4)
+	{
+		__m128i Pixels = _mm_loadu_si128((const __m128i*)(Src + x * 3));
+		Pixels = _mm_or_si128(_mm_shuffle_epi8(Pixels, Shuffle), Alpha);
+		_mm_storeu_si128((__m128i*)(Dst + x * 4), Pixels);
+	}
+
+	Convert_Row_24_Scalar(Src + x * 3, Dst + x * 4, Width - x);
+}
+
+static void Convert_Row_32_AVX2(const BYTE* Src, BYTE* Dst, UINT Width)
+{
+	const __m256i Shuffle = _mm256_setr_epi8(
+		2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+		2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+	UINT x = 0;
+
+	//8   
+	for (; x + 8 <= Width; x += 8)
+	{
+		__m256i Pixels = _mm256_loadu_si256((const __m256i*)(Src + x * 4));
+		_mm256_storeu_si256((__m256i*)(Dst + x * 4), _mm256_shuffle_epi8(Pixels, Shuffle));
+	}
+
+	Convert_Row_32_SSSE3(Src + x * 4, Dst + x * 4, Width - x);
+}
+
+static void Convert_Row_24_AVX2(const BYTE* Src, BYTE* Dst, UINT Width)
+{
+	//pshufb   128  ,  
+	//  12..27   
+	const __m256i Permute = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+	const __m256i Shuffle = _mm256_setr_epi8(
+		2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+		2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+	const __m256i Alpha = _mm256_set1_epi32((int)0xFF000000);
+
+	UINT x = 0;
+
+	//  32 ,     
+	for (; x * 3 + 32 <= Width * 3; x += 8)
+	{
+		__m256i Pixels = _mm256_loadu_si256((const __m256i*)(Src + x * 3));
+		Pixels = _mm256_permutevar8x32_epi32(Pixels, Permute);
+		Pixels = _mm256_or_si256(_mm256_shuffle_epi8(Pixels, Shuffle), Alpha);
+		_mm256_storeu_si256((__m256i*)(Dst + x * 4), Pixels);
+	}
+
+	Convert_Row_24_SSSE3(Src + x * 3, Dst + x * 4, Width - x);
+}
+
+typedef void (*Bmp_Row_Func)(const BYTE* Src, BYTE* Dst, UINT Width);
+
+static Bmp_Row_Func Select_Row_Func(UINT BitCount, UINT SimdLevel)
+{
+	if (BitCount == 32)
+	{
+		if (SimdLevel >= BMP_SIMD_AVX2) return Convert_Row_32_AVX2;
+		if (SimdLevel >= BMP_SIMD_SSSE3) return Convert_Row_32_SSSE3;
+		return Convert_Row_32_Scalar;
+	}
+
+	if (SimdLevel >= BMP_SIMD_AVX2) return Convert_Row_24_AVX2;
+	if (SimdLevel >= BMP_SIMD_SSSE3) return Convert_Row_24_SSSE3;
+	return Convert_Row_24_Scalar;
+}
+
+static void Decode_Rows(const BYTE* Data, const BmpInfo& Info, void* Dst, UINT DstRowPitch, UINT Flags, UINT SimdLevel)
+{
+	Bmp_Row_Func Convert_Row = Select_Row_Func(Info.BitCount, SimdLevel);
+
+	const BYTE* Pixels = Data + Info.DataOffset;
+
+	for (UINT y = 0; y < Info.Height; y++)
+	{
+		//    
+		UINT ImageRow = (Flags & BMP_DECODE_TOP_DOWN) ? y : Info.Height - 1 - y;
+		UINT FileRow = Info.TopDown ? ImageRow : Info.Height - 1 - ImageRow;
+
+		Convert_Row(Pixels + (size_t)FileRow * Info.RowPitch, (BYTE*)Dst + (size_t)y * DstRowPitch, Info.Width);
+	}
+}
+
+void Bmp_Decode_RGBA(const BYTE* Data, const BmpInfo& Info, void* Dst, UINT DstRowPitch, UINT Flags)
+{
+	Decode_Rows(Data, Info, Dst, DstRowPitch, Flags, Get_Simd_Level());
+}
+
+CBmpFile::CBmpFile()
+{
+}
+
+CBmpFile::~CBmpFile()
+{
+	Close();
+}
+
+bool CBmpFile::Open(const std::wstring& Filename)
+{
+	Close();
+
+	m_File = CreateFileW(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (m_File == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(m_File, &FileSize) || FileSize.QuadPart < 54)
+	{
+		Close();
+		return false;
+	}
+
+	m_Mapping = CreateFileMappingW(m_File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_Mapping == NULL)
+	{
+		Close();
+		return false;
+	}
+
+	m_View = (const BYTE*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_View == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	if (!Bmp_Parse_Header(m_View, (UINT64)FileSize.QuadPart, m_Info))
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void CBmpFile::Close()
+{
+	if (m_View != nullptr)
+		UnmapViewOfFile(m_View);
+
+	if (m_Mapping != NULL)
+		CloseHandle(m_Mapping);
+
+	if (m_File != INVALID_HANDLE_VALUE)
+		CloseHandle(m_File);
+
+	m_View = nullptr;
+	m_Mapping = NULL;
+	m_File = INVALID_HANDLE_VALUE;
+	m_Info = {};
+}
+
+UINT CBmpFile::Width() const
+{
+	return m_Info.Width;
+}
+
+UINT CBmpFile::Height() const
+{
+	return m_Info.Height;
+}
+
+const BmpInfo& CBmpFile::Info() const
+{
+	return m_Info;
+}
+
+void CBmpFile::Decode_RGBA(void* Dst, UINT DstRowPitch, UINT Flags) const
+{
+	Bmp_Decode_RGBA(m_View, m_Info, Dst, DstRowPitch, Flags);
+}
+
+static UINT64 Hash_Texels(const std::vector<BYTE>& Texels)
+{
+	UINT64 Hash = 14695981039346656037ull;
+
+	for (size_t i = 0; i < Texels.size(); i++)
+	{
+		Hash ^= Texels[i];
+		Hash *= 1099511628211ull;
+	}
+
+	return Hash;
+}
+
+void Benchmark_Bmp_Decoder()
+{
+	static const char* LevelNames[] = { "scalar", "SSSE3", "AVX2" };
+
+	UINT MaxLevel = Get_Simd_Level();
+
+	__int64 PerfFreq;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&PerfFreq);
+
+	for (UINT Size = 256; Size <= 8192; Size *= 2)
+	{
+		for (UINT BitCount = 24; BitCount <= 32; BitCount += 8)
+		{
+			BmpInfo Info;
+			Info.Width = Size;
+			Info.Height = Size;
+			Info.BitCount = BitCount;
+			Info.TopDown = false;
+			Info.DataOffset = 54;
+			Info.RowPitch = ((Size * BitCount + 31) / 32) * 4;
+
+			//  , Info  
+			std::vector<BYTE> File(Info.DataOffset + (size_t)Info.RowPitch * Size);
+
+			UINT Seed = 12345;
+			for (size_t i = 0; i < File.size(); i++)
+			{
+				Seed = Seed * 1664525 + 1013904223;
+				File[i] = (BYTE)(Seed >> 24);
+			}
+
+			std::vector<BYTE> Texels((size_t)Size * Size * 4);
+
+			//    
+			//   
+			UINT Repeat = (UINT)((64u << 20) / Texels.size());
+			if (Repeat == 0)
+				Repeat = 1;
+
+			char Buffer[256];
+			int Len = sprintf_s(Buffer, "BMP decode %ux%u %u bpp:", Size, Size, BitCount);
+
+			UINT64 ScalarHash = 0;
+
+			for (UINT Level = BMP_SIMD_SCALAR; Level <= MaxLevel; Level++)
+			{
+				__int64 Time0, Time1;
+				QueryPerformanceCounter((LARGE_INTEGER*)&Time0);
+
+				for (UINT r = 0; r < Repeat; r++)
+					Decode_Rows(File.data(), Info, Texels.data(), Size * 4, BMP_DECODE_TOP_DOWN, Level);
+
+				QueryPerformanceCounter((LARGE_INTEGER*)&Time1);
+
+				double Seconds = (double)(Time1 - Time0) / PerfFreq;
+				double MBytes = (double)Texels.size() * Repeat / (1024.0 * 1024.0);
+
+				UINT64 Hash = Hash_Texels(Texels);
+				if (Level == BMP_SIMD_SCALAR)
+					ScalarHash = Hash;
+
+				Len += sprintf_s(Buffer + Len, sizeof(Buffer) - Len, " %s %.0f MB/s%s", LevelNames[Level],
+					Seconds > 0.0 ? MBytes / Seconds : 0.0, Hash == ScalarHash ? "" : " (MISMATCH)");
+			}
+
+			sprintf_s(Buffer + Len, sizeof(Buffer) - Len, "\n");
+			OutputDebugStringA(Buffer);
+		}
+	}
+}
@@ -0,0 +1,373 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Command List State DirectX12
+//======================================================================================
+
+#include "CommandListState.h"
+
+#include <stdio.h>
+#include <string.h>
+
+static const char* g_CommandStateNames[COMMAND_STATE_CALL_COUNT] =
+{
+	"heaps", "root signature", "pso", "tables", "root cbv", "root constants", "vb", "ib", "topology"
+};
+
+void CCommandListState::Begin(ID3D12GraphicsCommandList* CmdList, ID3D12PipelineState* PSO)
+{
+	// Reset     ,  root signature,  
+	m_CmdList = CmdList;
+	m_Heap = nullptr;
+	m_RootSignature = nullptr;
+	m_PSO = PSO;
+
+	Clear_Root_Arguments();
+
+	memset(&m_VertexBuffer, 0, sizeof(m_VertexBuffer));
+	memset(&m_IndexBuffer, 0, sizeof(m_IndexBuffer));
+	m_Topology = D3D_PRIMITIVE_TOPOLOGY_UNDEFINED;
+
+	m_Stats.Lists++;
+}
+
+void CCommandListState::Clear_Root_Arguments()
+{
+	for (UINT i = 0; i < COMMAND_STATE_MAX_ROOT_PARAMS; i++)
+		m_Root[i].Kind = ROOT_NONE;
+}
+
+bool CCommandListState::Issue(UINT Call, bool Changed)
+{
+	m_Stats.Requested[Call]++;
+
+	if (Changed)
+		m_Stats.Issued[Call]++;
+
+	return Changed && m_CmdList != nullptr;
+}
+
+void CCommandListState::Set_Descriptor_Heap(ID3D12DescriptorHeap* Heap)
+{
+	bool Changed = Heap != m_Heap;
+
+	if (Changed)
+	{
+		m_Heap = Heap;
+
+		//    
+		for (UINT i = 0; i < COMMAND_STATE_MAX_ROOT_PARAMS; i++)
+		{
+			if (m_Root[i].Kind == ROOT_TABLE)
+				m_Root[i].Kind = ROOT_NONE;
+		}
+	}
+
+	if (Issue(COMMAND_STATE_DESCRIPTOR_HEAPS, Changed))
+	{
+		ID3D12DescriptorHeap* DescriptorHeaps[] = { Heap };
+		m_CmdList->SetDescriptorHeaps(_countof(DescriptorHeaps), DescriptorHeaps);
+	}
+}
+
+void CCommandListState::Set_Root_Signature(ID3D12RootSignature* RootSignature)
+{
+	bool Changed = RootSignature != m_RootSignature;
+
+	if (Changed)
+	{
+		m_RootSignature = RootSignature;
+		Clear_Root_Arguments();
+	}
+
+	if (Issue(COMMAND_STATE_ROOT_SIGNATURE, Changed))
+		m_CmdList->SetGraphicsRootSignature(RootSignature);
+}
+
+void CCommandListState::Set_Pipeline_State(ID3D12PipelineState* PSO)
+{
+	bool Changed = PSO != m_PSO;
+	m_PSO = PSO;
+
+	if (Issue(COMMAND_STATE_PIPELINE_STATE, Changed))
+		m_CmdList->SetPipelineState(PSO);
+}
+
+void CCommandListState::Set_Root_Table(UINT Param, D3D12_GPU_DESCRIPTOR_HANDLE Table)
+{
+	bool Changed = true;
+
+	if (Param < COMMAND_STATE_MAX_ROOT_PARAMS)
+	{
+		RootArgument& Arg = m_Root[Param];
+		Changed = Arg.Kind != ROOT_TABLE || Arg.Value != Table.ptr;
+
+		Arg.Kind = ROOT_TABLE;
+		Arg.Value = Table.ptr;
+	}
+
+	if (Issue(COMMAND_STATE_ROOT_TABLE, Changed))
+		m_CmdList->SetGraphicsRootDescriptorTable(Param, Table);
+}
+
+void CCommandListState::Set_Root_Cbv(UINT Param, D3D12_GPU_VIRTUAL_ADDRESS Address)
+{
+	bool Changed = true;
+
+	if (Param < COMMAND_STATE_MAX_ROOT_PARAMS)
+	{
+		RootArgument& Arg = m_Root[Param];
+		Changed = Arg.Kind != ROOT_CBV || Arg.Value != Address;
+
+		Arg.Kind = ROOT_CBV;
+		Arg.Value = Address;
+	}
+
+	if (Issue(COMMAND_STATE_ROOT_CBV, Changed))
+		m_CmdList->SetGraphicsRootConstantBufferView(Param, Address);
+}
+
+void CCommandListState::Set_Root_Constants(UINT Param, UINT Num32BitValues, const void* Data)
+{
+	bool Changed = true;
+
+	//    ,  
+	if (Param < COMMAND_STATE_MAX_ROOT_PARAMS)
+	{
+		RootArgument& Arg = m_Root[Param];
+
+		if (Num32BitValues <= COMMAND_STATE_MAX_CONSTANTS)
+		{
+			Changed = Arg.Kind != ROOT_CONSTANTS || Arg.Count != Num32BitValues ||
+				memcmp(Arg.Constants, Data, Num32BitValues * sizeof(UINT)) != 0;
+
+			Arg.Kind = ROOT_CONSTANTS;
+			Arg.Count = Num32BitValues;
+			memcpy(Arg.Constants, Data, Num32BitValues * sizeof(UINT));
+		}
+		else
+		{
+			Arg.Kind = ROOT_NONE;
+		}
+	}
+
+	if (Issue(COMMAND_STATE_ROOT_CONSTANTS, Changed))
+		m_CmdList->SetGraphicsRoot32BitConstants(Param, Num32BitValues, Data, 0);
+}
+
+void CCommandListState::Set_Vertex_Buffer(const D3D12_VERTEX_BUFFER_VIEW& View)
+{
+	bool Changed = View.BufferLocation != m_VertexBuffer.BufferLocation ||
+		View.SizeInBytes != m_VertexBuffer.SizeInBytes ||
+		View.StrideInBytes != m_VertexBuffer.StrideInBytes;
+	m_VertexBuffer = View;
+
+	if (Issue(COMMAND_STATE_VERTEX_BUFFER, Changed))
+		m_CmdList->IASetVertexBuffers(0, 1, &View);
+}
+
+void CCommandListState::Set_Index_Buffer(const D3D12_INDEX_BUFFER_VIEW& View)
+{
+	bool Changed = View.BufferLocation != m_IndexBuffer.BufferLocation ||
+		View.SizeInBytes != m_IndexBuffer.SizeInBytes ||
+		View.Format != m_IndexBuffer.Format;
+	m_IndexBuffer = View;
+
+	if (Issue(COMMAND_STATE_INDEX_BUFFER, Changed))
+		m_CmdList->IASetIndexBuffer(&View);
+}
+
+void CCommandListState::Set_Topology(D3D12_PRIMITIVE_TOPOLOGY Topology)
+{
+	bool Changed = Topology != m_Topology;
+	m_Topology = Topology;
+
+	if (Issue(COMMAND_STATE_TOPOLOGY, Changed))
+		m_CmdList->IASetPrimitiveTopology(Topology);
+}
+
+void CCommandListState::Draw_Indexed(UINT IndexCount, UINT StartIndex, INT BaseVertex)
+{
+	m_Stats.Draws++;
+
+	if (m_CmdList != nullptr)
+		m_CmdList->DrawIndexedInstanced(IndexCount, 1, StartIndex, BaseVertex, 0);
+}
+
+void CCommandListState::Draw(UINT VertexCount, UINT InstanceCount)
+{
+	m_Stats.Draws++;
+
+	if (m_CmdList != nullptr)
+		m_CmdList->DrawInstanced(VertexCount, InstanceCount, 0, 0);
+}
+
+const CommandStateStats& CCommandListState::Get_Stats() const
+{
+	return m_Stats;
+}
+
+void CCommandListState::Report(const char* Name)
+{
+	if (m_Stats.Lists == 0)
+		return;
+
+	double Lists = (double)m_Stats.Lists;
+	UINT64 Requested = 0;
+	UINT64 Issued = 0;
+
+	char Buffer[512];
+	int Length = sprintf_s(Buffer, "%s: %u lists, %.1f draws per list, requested/issued per list",
+		Name, m_Stats.Lists, m_Stats.Draws / Lists);
+
+	for (UINT i = 0; i < COMMAND_STATE_CALL_COUNT; i++)
+	{
+		Requested += m_Stats.Requested[i];
+		Issued += m_Stats.Issued[i];
+
+		if (m_Stats.Requested[i] != 0 && Length > 0)
+			Length += sprintf_s(Buffer + Length, sizeof(Buffer) - Length, " %s %.1f/%.1f",
+				g_CommandStateNames[i], m_Stats.Requested[i] / Lists, m_Stats.Issued[i] / Lists);
+	}
+
+	if (Length > 0)
+		sprintf_s(Buffer + Length, sizeof(Buffer) - Length, ", total %.1f/%.1f\n", Requested / Lists, Issued / Lists);
+	OutputDebugStringA(Buffer);
+}
+
+void Verify_Command_List_State()
+{
+	const UINT RoomCount = 12;
+	const UINT Frames = 100;
+
+	//  ,     
+	ID3D12DescriptorHeap* CbvHeap = reinterpret_cast<ID3D12DescriptorHeap*>(0x1000);
+	ID3D12DescriptorHeap* SrvHeap = reinterpret_cast<ID3D12DescriptorHeap*>(0x2000);
+	ID3D12RootSignature* RootSignature = reinterpret_cast<ID3D12RootSignature*>(0x3000);
+	ID3D12PipelineState* PSO = reinterpret_cast<ID3D12PipelineState*>(0x4000);
+	ID3D12PipelineState* PSOSAQ = reinterpret_cast<ID3D12PipelineState*>(0x5000);
+
+	D3D12_VERTEX_BUFFER_VIEW RoomVB = { 0x100000, 4096, 24 };
+	D3D12_INDEX_BUFFER_VIEW RoomIB = { 0x200000, 1024, DXGI_FORMAT_R16_UINT };
+	D3D12_VERTEX_BUFFER_VIEW SaqVB = { 0x300000, 256, 32 };
+
+	const UINT64 Increment = 32;
+	const UINT64 HeapStart = 0x800000000ull;
+
+	//:   (CBV  SRV)    
+	CCommandListState Legacy;
+
+	for (UINT Frame = 0; Frame < Frames; Frame++)
+	{
+		Legacy.Begin(nullptr, PSO);
+		Legacy.Set_Root_Signature(RootSignature);
+
+		for (UINT i = 0; i < RoomCount; i++)
+		{
+			Legacy.Set_Vertex_Buffer(RoomVB);
+			Legacy.Set_Index_Buffer(RoomIB);
+			Legacy.Set_Topology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+			Legacy.Set_Descriptor_Heap(CbvHeap);
+			Legacy.Set_Root_Table(0, { 0x900000000ull + i * Increment });
+			Legacy.Set_Root_Table(1, { 0x900000000ull + RoomCount * Increment });
+
+			Legacy.Set_Descriptor_Heap(SrvHeap);
+			Legacy.Set_Root_Table(2, { 0xA00000000ull + i * Increment });
+
+			Legacy.Draw_Indexed(36, i * 36, 0);
+		}
+	}
+
+	//:  ,      (  
+	//,  SRV    )    SAQ
+	CCommandListState Unified;
+	bool Valid = true;
+
+	for (UINT Frame = 0; Frame < Frames; Frame++)
+	{
+		Unified.Begin(nullptr, PSO);
+		Unified.Set_Root_Signature(RootSignature);
+		Unified.Set_Descriptor_Heap(SrvHeap);
+		Unified.Set_Root_Table(1, { HeapStart + RoomCount * Increment });
+
+		for (UINT i = 0; i < RoomCount; i++)
+		{
+			Unified.Set_Vertex_Buffer(RoomVB);
+			Unified.Set_Index_Buffer(RoomIB);
+			Unified.Set_Topology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+			Unified.Set_Root_Table(0, { HeapStart + i * Increment });
+			Unified.Set_Root_Table(2, { HeapStart + (RoomCount + 1 + i / 2) * Increment });
+
+			UINT Constants[5] = { 0, 0, 1, 1, i / 2 };
+			Unified.Set_Root_Constants(3, 5, Constants);
+
+			Unified.Draw_Indexed(36, i * 36, 0);
+		}
+
+		Unified.Set_Pipeline_State(PSOSAQ);
+		Unified.Set_Root_Signature(RootSignature);
+		Unified.Set_Root_Table(2, { HeapStart + (RoomCount + 7) * Increment });
+		Unified.Set_Vertex_Buffer(SaqVB);
+		Unified.Set_Topology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+		Unified.Draw(4, 2);
+	}
+
+	const CommandStateStats& Before = Legacy.Get_Stats();
+	const CommandStateStats& After = Unified.Get_Stats();
+
+	//     
+	if (Before.Issued[COMMAND_STATE_DESCRIPTOR_HEAPS] != Frames * RoomCount * 2 ||
+		Before.Issued[COMMAND_STATE_ROOT_TABLE] != Frames * RoomCount * 3)
+		Valid = false;
+
+	if (After.Issued[COMMAND_STATE_DESCRIPTOR_HEAPS] != Frames ||
+		After.Issued[COMMAND_STATE_ROOT_SIGNATURE] != Frames ||
+		After.Issued[COMMAND_STATE_PIPELINE_STATE] != Frames ||
+		After.Issued[COMMAND_STATE_ROOT_TABLE] != Frames * (1 + RoomCount + RoomCount / 2 + 1) ||
+		After.Issued[COMMAND_STATE_ROOT_CONSTANTS] != Frames * RoomCount / 2 ||
+		After.Issued[COMMAND_STATE_VERTEX_BUFFER] != Frames * 2 ||
+		After.Issued[COMMAND_STATE_INDEX_BUFFER] != Frames ||
+		After.Issued[COMMAND_STATE_TOPOLOGY] != Frames * 2 ||
+		After.Draws != Frames * (RoomCount + 1))
+		Valid = false;
+
+	//   ,  root signature -  
+	CCommandListState Reset;
+	Reset.Begin(nullptr, PSO);
+	Reset.Set_Root_Signature(RootSignature);
+	Reset.Set_Descriptor_Heap(CbvHeap);
+	Reset.Set_Root_Table(0, { HeapStart });
+	Reset.Set_Root_Cbv(1, 0x400000);
+	Reset.Set_Descriptor_Heap(SrvHeap);
+	Reset.Set_Root_Table(0, { HeapStart });
+	Reset.Set_Root_Cbv(1, 0x400000);
+	Reset.Set_Root_Signature(reinterpret_cast<ID3D12RootSignature*>(0x3100));
+	Reset.Set_Root_Cbv(1, 0x400000);
+	//  -  
+	Reset.Begin(nullptr, PSO);
+	Reset.Set_Descriptor_Heap(SrvHeap);
+
+	const CommandStateStats& ResetStats = Reset.Get_Stats();
+	bool Invalidated = ResetStats.Issued[COMMAND_STATE_ROOT_TABLE] == 2 &&
+		ResetStats.Issued[COMMAND_STATE_ROOT_CBV] == 2 &&
+		ResetStats.Issued[COMMAND_STATE_DESCRIPTOR_HEAPS] == 3;
+
+	//      
+	UINT64 BeforeTotal = 0;
+	UINT64 AfterTotal = 0;
+	for (UINT i = 0; i < COMMAND_STATE_CALL_COUNT; i++)
+	{
+		BeforeTotal += Before.Requested[i];
+		AfterTotal += After.Issued[i];
+	}
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Command list state: %s, per frame heaps %.1f -> %.1f, state calls %.1f -> %.1f, invalidation %s\n",
+		Valid && Invalidated ? "OK" : "FAILED",
+		Before.Issued[COMMAND_STATE_DESCRIPTOR_HEAPS] / (double)Frames, After.Issued[COMMAND_STATE_DESCRIPTOR_HEAPS] / (double)Frames,
+		BeforeTotal / (double)Frames, AfterTotal / (double)Frames, Invalidated ? "OK" : "FAILED");
+	OutputDebugStringA(Buffer);
+
+	Legacy.Report("Scene state calls before");
+	Unified.Report("Scene state calls after");
+}
@@ -0,0 +1,116 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Command List State DirectX12
+//======================================================================================
+
+#ifndef _COMMANDLISTSTATE_
+#define _COMMANDLISTSTATE_
+
+#include <windows.h>
+
+#include "d3dUtil.h"
+
+//root   DWORD root   ,   
+#define COMMAND_STATE_MAX_ROOT_PARAMS 8
+#define COMMAND_STATE_MAX_CONSTANTS 16
+
+enum CommandStateCall
+{
+	COMMAND_STATE_DESCRIPTOR_HEAPS,
+	COMMAND_STATE_ROOT_SIGNATURE,
+	COMMAND_STATE_PIPELINE_STATE,
+	COMMAND_STATE_ROOT_TABLE,
+	COMMAND_STATE_ROOT_CBV,
+	COMMAND_STATE_ROOT_CONSTANTS,
+	COMMAND_STATE_VERTEX_BUFFER,
+	COMMAND_STATE_INDEX_BUFFER,
+	COMMAND_STATE_TOPOLOGY,
+	COMMAND_STATE_CALL_COUNT
+};
+
+//Requested -      ,
+//Issued -      
+struct CommandStateStats
+{
+	UINT64 Requested[COMMAND_STATE_CALL_COUNT] = {};
+	UINT64 Issued[COMMAND_STATE_CALL_COUNT] = {};
+	UINT64 Draws = 0;
+	UINT Lists = 0;
+};
+
+//    :   
+//, root signature, PSO, root     
+//   ,    .  
+// ,  root signature -  root .
+//CmdList == nullptr -  ,    CPU
+class CCommandListState
+{
+public:
+	CCommandListState() = default;
+
+	CCommandListState(const CCommandListState& rhs) = delete;
+	CCommandListState& operator=(const CCommandListState& rhs) = delete;
+
+	// Reset , PSO - ,    Reset
+	void Begin(ID3D12GraphicsCommandList* CmdList, ID3D12PipelineState* PSO);
+
+	void Set_Descriptor_Heap(ID3D12DescriptorHeap* Heap);
+	void Set_Root_Signature(ID3D12RootSignature* RootSignature);
+	void Set_Pipeline_State(ID3D12PipelineState* PSO);
+
+	void Set_Root_Table(UINT Param, D3D12_GPU_DESCRIPTOR_HANDLE Table);
+	void Set_Root_Cbv(UINT Param, D3D12_GPU_VIRTUAL_ADDRESS Address);
+	void Set_Root_Constants(UINT Param, UINT Num32BitValues, const void* Data);
+
+	void Set_Vertex_Buffer(const D3D12_VERTEX_BUFFER_VIEW& View);
+	void Set_Index_Buffer(const D3D12_INDEX_BUFFER_VIEW& View);
+	void Set_Topology(D3D12_PRIMITIVE_TOPOLOGY Topology);
+
+	void Draw_Indexed(UINT IndexCount, UINT StartIndex, INT BaseVertex);
+	void Draw(UINT VertexCount, UINT InstanceCount);
+
+	const CommandStateStats& Get_Stats() const;
+
+	//     :  / 
+	void Report(const char* Name);
+
+private:
+	bool Issue(UINT Call, bool Changed);
+	void Clear_Root_Arguments();
+
+	enum RootKind
+	{
+		ROOT_NONE,
+		ROOT_TABLE,
+		ROOT_CBV,
+		ROOT_CONSTANTS
+	};
+
+	struct RootArgument
+	{
+		RootKind Kind;
+		UINT64 Value;
+		UINT Count;
+		UINT Constants[COMMAND_STATE_MAX_CONSTANTS];
+	};
+
+	ID3D12GraphicsCommandList* m_CmdList = nullptr;
+
+	ID3D12DescriptorHeap* m_Heap = nullptr;
+	ID3D12RootSignature* m_RootSignature = nullptr;
+	ID3D12PipelineState* m_PSO = nullptr;
+
+	RootArgument m_Root[COMMAND_STATE_MAX_ROOT_PARAMS];
+
+	D3D12_VERTEX_BUFFER_VIEW m_VertexBuffer;
+	D3D12_INDEX_BUFFER_VIEW m_IndexBuffer;
+	D3D12_PRIMITIVE_TOPOLOGY m_Topology;
+
+	CommandStateStats m_Stats;
+};
+
+//CPU   :    DrawRenderItems_Scene (12 ,
+//   SRV),     ,  
+// root signature   .   OutputDebugString
+void Verify_Command_List_State();
+
+#endif
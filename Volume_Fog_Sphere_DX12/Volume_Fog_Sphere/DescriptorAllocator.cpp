@@ -0,0 +1,322 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Descriptor Allocator DirectX12
+//======================================================================================
+
+#include "DescriptorAllocator.h"
+
+#include <stdio.h>
+#include <vector>
+
+//    
+#define DESCRIPTOR_MOCK_INCREMENT 32
+#define DESCRIPTOR_MOCK_CPU_START 0x10000000ull
+#define DESCRIPTOR_MOCK_GPU_START 0x800000000ull
+
+void CDescriptorAllocator::Init(ID3D12Device* Device, bool ShaderVisible, UINT PersistentCount, UINT TransientCount)
+{
+	m_Device = Device;
+	m_ShaderVisible = ShaderVisible;
+	m_PersistentCount = PersistentCount;
+
+	if (Device != nullptr)
+	{
+		D3D12_DESCRIPTOR_HEAP_DESC HeapDesc;
+		HeapDesc.NumDescriptors = PersistentCount + TransientCount;
+		HeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
+		HeapDesc.Flags = ShaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+		HeapDesc.NodeMask = 0;
+		ThrowIfFailed(Device->CreateDescriptorHeap(&HeapDesc, IID_PPV_ARGS(m_Heap.GetAddressOf())));
+
+		m_CpuStart = m_Heap->GetCPUDescriptorHandleForHeapStart();
+		if (ShaderVisible)
+			m_GpuStart = m_Heap->GetGPUDescriptorHandleForHeapStart();
+		m_Increment = Device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+	}
+	else
+	{
+		m_CpuStart.ptr = (SIZE_T)DESCRIPTOR_MOCK_CPU_START;
+		if (ShaderVisible)
+			m_GpuStart.ptr = DESCRIPTOR_MOCK_GPU_START;
+		m_Increment = DESCRIPTOR_MOCK_INCREMENT;
+	}
+
+	m_Persistent.Init(PersistentCount);
+	m_Transient.Init(TransientCount);
+
+	m_Stats.PersistentCount = PersistentCount;
+	m_Stats.TransientCount = TransientCount;
+}
+
+ID3D12DescriptorHeap* CDescriptorAllocator::Heap() const
+{
+	return m_Heap.Get();
+}
+
+void CDescriptorAllocator::Fill_Range(UINT Index, UINT Count, DescriptorRange& Range) const
+{
+	Range.Index = Index;
+	Range.Count = Count;
+	Range.Increment = m_Increment;
+	Range.Cpu.ptr = m_CpuStart.ptr + (SIZE_T)Index * m_Increment;
+	Range.Gpu.ptr = m_ShaderVisible ? m_GpuStart.ptr + (UINT64)Index * m_Increment : 0;
+}
+
+bool CDescriptorAllocator::Allocate(UINT Count, DescriptorRange& Range)
+{
+	UINT64 Offset;
+	UINT Handle;
+
+	//  ,     
+	if (Count == 0 || !m_Persistent.Allocate(Count, 1, Offset, Handle))
+	{
+		m_Stats.Failed++;
+		return false;
+	}
+
+	Fill_Range((UINT)Offset, Count, Range);
+	Range.Handle = Handle;
+
+	m_Stats.Allocations++;
+
+	return true;
+}
+
+void CDescriptorAllocator::Free(DescriptorRange& Range)
+{
+	if (Range.Handle == UINT_MAX)
+		return;
+
+	m_Persistent.Free(Range.Handle);
+	Range = DescriptorRange();
+}
+
+bool CDescriptorAllocator::Allocate_Transient(UINT Count, DescriptorRange& Range)
+{
+	UINT64 Offset;
+	UINT Id;
+
+	//     
+	if (Count == 0 || !m_Transient.Allocate(Count, 1, Offset, Id))
+	{
+		m_Stats.Failed++;
+		return false;
+	}
+
+	Fill_Range(m_PersistentCount + (UINT)Offset, Count, Range);
+
+	UINT Used = (UINT)m_Transient.Used();
+	if (Used > m_Stats.TransientPeak)
+		m_Stats.TransientPeak = Used;
+
+	m_Stats.TransientAllocations++;
+
+	return true;
+}
+
+void CDescriptorAllocator::Begin_Frame(UINT64 CompletedFence)
+{
+	m_Transient.Reclaim(CompletedFence);
+}
+
+void CDescriptorAllocator::End_Frame(UINT64 Fence)
+{
+	m_Transient.Retire_All(Fence);
+}
+
+void CDescriptorAllocator::Copy(const DescriptorRange& Dst, UINT DstOffset, D3D12_CPU_DESCRIPTOR_HANDLE Src, UINT Count)
+{
+	if (m_Device != nullptr)
+		m_Device->CopyDescriptorsSimple(Count, Dst.Cpu_At(DstOffset), Src, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+
+	m_Stats.Copies += Count;
+}
+
+DescriptorAllocatorStats CDescriptorAllocator::Get_Stats() const
+{
+	DescriptorAllocatorStats Stats = m_Stats;
+	Stats.PersistentUsed = (UINT)m_Persistent.Used();
+	Stats.TransientUsed = (UINT)m_Transient.Used();
+
+	return Stats;
+}
+
+void CDescriptorAllocator::Report(const char* Name)
+{
+	DescriptorAllocatorStats Stats = Get_Stats();
+
+	char Buffer[256];
+	sprintf_s(Buffer, "%s: persistent %u/%u, transient %u/%u peak %u, %llu + %llu transient allocations, %llu failed, %llu copied\n",
+		Name, Stats.PersistentUsed, Stats.PersistentCount, Stats.TransientUsed, Stats.TransientCount,
+		Stats.TransientPeak, Stats.Allocations, Stats.TransientAllocations, Stats.Failed, Stats.Copies);
+	OutputDebugStringA(Buffer);
+}
+
+void Verify_Descriptor_Allocator()
+{
+	const UINT PersistentCount = 512;
+	const UINT TransientCount = 256;
+	const UINT FramesInFlight = 3;
+
+	bool Valid = true;
+	UINT Seed = 12345;
+
+	// :        
+	CDescriptorAllocator Descriptors;
+	Descriptors.Init(nullptr, true, PersistentCount, TransientCount);
+
+	std::vector<DescriptorRange> Live;
+	std::vector<bool> Used(PersistentCount, false);
+
+	for (UINT Step = 0; Step < 20000; Step++)
+	{
+		Seed = Seed * 1664525 + 1013904223;
+		bool DoFree = !Live.empty() && ((Seed >> 8) % 100 < 45 || Live.size() > 64);
+
+		if (DoFree)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			size_t Victim = (Seed >> 8) % Live.size();
+
+			for (UINT i = 0; i < Live[Victim].Count; i++)
+				Used[Live[Victim].Index + i] = false;
+
+			Descriptors.Free(Live[Victim]);
+			Live[Victim] = Live.back();
+			Live.pop_back();
+			continue;
+		}
+
+		Seed = Seed * 1664525 + 1013904223;
+		UINT Count = 1 + (Seed >> 8) % ((Seed >> 20) % 8 == 0 ? 48 : 4);
+
+		DescriptorRange Range;
+		if (!Descriptors.Allocate(Count, Range))
+			continue;
+
+		if (Range.Count != Count || Range.Index + Count > PersistentCount ||
+			Range.Cpu.ptr != DESCRIPTOR_MOCK_CPU_START + (UINT64)Range.Index * DESCRIPTOR_MOCK_INCREMENT ||
+			Range.Gpu.ptr != DESCRIPTOR_MOCK_GPU_START + (UINT64)Range.Index * DESCRIPTOR_MOCK_INCREMENT ||
+			Range.Gpu_At(Count - 1).ptr - Range.Gpu.ptr != (UINT64)(Count - 1) * DESCRIPTOR_MOCK_INCREMENT)
+			Valid = false;
+
+		for (UINT i = 0; i < Count; i++)
+		{
+			if (Used[Range.Index + i])
+				Valid = false;
+			Used[Range.Index + i] = true;
+		}
+
+		Live.push_back(Range);
+	}
+
+	for (DescriptorRange& Range : Live)
+		Descriptors.Free(Range);
+
+	//     
+	DescriptorRange Whole;
+	bool Merged = Descriptors.Allocate(PersistentCount, Whole) && Whole.Index == 0;
+	Descriptors.Free(Whole);
+
+	//:   , GPU   FramesInFlight 
+	struct FrameTables
+	{
+		UINT64 Fence;
+		std::vector<DescriptorRange> Tables;
+	};
+
+	std::vector<FrameTables> InFlight;
+	UINT64 Fence = 0;
+	UINT64 Completed = 0;
+	UINT Tables = 0;
+
+	for (UINT Frame = 0; Frame < 1000; Frame++)
+	{
+		//  Update_MeshManager,     FramesInFlight 
+		while (InFlight.size() >= FramesInFlight)
+		{
+			Completed = InFlight.front().Fence;
+			InFlight.erase(InFlight.begin());
+		}
+
+		Descriptors.Begin_Frame(Completed);
+
+		FrameTables Current;
+		Fence++;
+		Current.Fence = Fence;
+
+		Seed = Seed * 1664525 + 1013904223;
+		UINT TableCount = 1 + (Seed >> 8) % 4;
+
+		for (UINT t = 0; t < TableCount; t++)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			UINT Count = 1 + (Seed >> 8) % 13;
+
+			DescriptorRange Range;
+			if (!Descriptors.Allocate_Transient(Count, Range))
+			{
+				Valid = false;
+				continue;
+			}
+
+			if (Range.Index < PersistentCount || Range.Index + Count > PersistentCount + TransientCount ||
+				Range.Cpu.ptr != DESCRIPTOR_MOCK_CPU_START + (UINT64)Range.Index * DESCRIPTOR_MOCK_INCREMENT)
+				Valid = false;
+
+			//      
+			for (const FrameTables& Older : InFlight)
+			{
+				for (const DescriptorRange& Other : Older.Tables)
+				{
+					if (Range.Index < Other.Index + Other.Count && Other.Index < Range.Index + Count)
+						Valid = false;
+				}
+			}
+
+			for (const DescriptorRange& Other : Current.Tables)
+			{
+				if (Range.Index < Other.Index + Other.Count && Other.Index < Range.Index + Count)
+					Valid = false;
+			}
+
+			Current.Tables.push_back(Range);
+			Tables++;
+		}
+
+		Descriptors.End_Frame(Current.Fence);
+		InFlight.push_back(Current);
+	}
+
+	//GPU :     
+	Descriptors.Begin_Frame(Fence);
+	Descriptors.End_Frame(Fence);
+
+	UINT Filled = 0;
+	DescriptorRange Range;
+	while (Filled < TransientCount + 1 && Descriptors.Allocate_Transient(16, Range))
+		Filled++;
+
+	bool Refused = Filled == TransientCount / 16;
+
+	Descriptors.End_Frame(Fence + 1);
+	Descriptors.Begin_Frame(Fence + 1);
+	Refused = Refused && Descriptors.Get_Stats().TransientUsed == 0 && Descriptors.Allocate_Transient(16, Range);
+
+	//staging   GPU ,  
+	CDescriptorAllocator Staging;
+	Staging.Init(nullptr, false, 16, 0);
+
+	DescriptorRange Src;
+	bool StagingOK = Staging.Allocate(4, Src) && Src.Gpu.ptr == 0;
+
+	Descriptors.Copy(Range, 0, Src.Cpu, 4);
+	StagingOK = StagingOK && Descriptors.Get_Stats().Copies == 4;
+
+	DescriptorAllocatorStats Stats = Descriptors.Get_Stats();
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Descriptor allocator: %s, %llu persistent allocations, merge %s, %u tables in 1000 frames peak %u/%u, full ring %s, staging %s\n",
+		Valid && Merged && Refused && StagingOK ? "OK" : "FAILED", Stats.Allocations, Merged ? "OK" : "FAILED",
+		Tables, Stats.TransientPeak, TransientCount, Refused ? "OK" : "FAILED", StagingOK ? "OK" : "FAILED");
+	OutputDebugStringA(Buffer);
+}
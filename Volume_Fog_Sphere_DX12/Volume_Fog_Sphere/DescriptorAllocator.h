@@ -0,0 +1,114 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Descriptor Allocator DirectX12
+//======================================================================================
+
+#ifndef _DESCRIPTORALLOCATOR_
+#define _DESCRIPTORALLOCATOR_
+
+#include <windows.h>
+#include <limits.h>
+
+#include "d3dUtil.h"
+#include "RingAllocator.h"
+#include "TlsfAllocator.h"
+
+// ,     root signature
+struct DescriptorRange
+{
+	D3D12_CPU_DESCRIPTOR_HANDLE Cpu = {};
+	//0  ,   
+	D3D12_GPU_DESCRIPTOR_HANDLE Gpu = {};
+	UINT Index = 0;
+	UINT Count = 0;
+	//  TLSF  Free,    
+	UINT Handle = UINT_MAX;
+	UINT Increment = 0;
+
+	D3D12_CPU_DESCRIPTOR_HANDLE Cpu_At(UINT i) const
+	{
+		return { Cpu.ptr + (SIZE_T)i * Increment };
+	}
+
+	D3D12_GPU_DESCRIPTOR_HANDLE Gpu_At(UINT i) const
+	{
+		return { Gpu.ptr + (UINT64)i * Increment };
+	}
+};
+
+struct DescriptorAllocatorStats
+{
+	UINT PersistentCount = 0;
+	UINT PersistentUsed = 0;
+	UINT TransientCount = 0;
+	UINT TransientUsed = 0;
+	UINT TransientPeak = 0;
+	UINT64 Allocations = 0;
+	UINT64 TransientAllocations = 0;
+	UINT64 Failed = 0;
+	UINT64 Copies = 0;
+};
+
+//  CBV/SRV/UAV  : [0, PersistentCount) - 
+// ()     CTlsfAllocator,
+//   CRingAllocator    , 
+//     .     
+//  staging:       
+// . Device == nullptr -  ,   
+//    DESCRIPTOR_MOCK_INCREMENT,    CPU
+class CDescriptorAllocator
+{
+public:
+	CDescriptorAllocator() = default;
+
+	CDescriptorAllocator(const CDescriptorAllocator& rhs) = delete;
+	CDescriptorAllocator& operator=(const CDescriptorAllocator& rhs) = delete;
+
+	void Init(ID3D12Device* Device, bool ShaderVisible, UINT PersistentCount, UINT TransientCount);
+
+	ID3D12DescriptorHeap* Heap() const;
+
+	//false -     Count  
+	bool Allocate(UINT Count, DescriptorRange& Range);
+	//GPU     
+	void Free(DescriptorRange& Range);
+
+	//   ,    
+	bool Allocate_Transient(UINT Count, DescriptorRange& Range);
+
+	//GPU  CompletedFence,    
+	void Begin_Frame(UINT64 CompletedFence);
+	//    ,   Fence
+	void End_Frame(UINT64 Fence);
+
+	// staging  (CPU)   
+	void Copy(const DescriptorRange& Dst, UINT DstOffset, D3D12_CPU_DESCRIPTOR_HANDLE Src, UINT Count);
+
+	DescriptorAllocatorStats Get_Stats() const;
+	void Report(const char* Name);
+
+private:
+	void Fill_Range(UINT Index, UINT Count, DescriptorRange& Range) const;
+
+	ID3D12Device* m_Device = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_Heap;
+
+	D3D12_CPU_DESCRIPTOR_HANDLE m_CpuStart = {};
+	D3D12_GPU_DESCRIPTOR_HANDLE m_GpuStart = {};
+	UINT m_Increment = 0;
+	bool m_ShaderVisible = false;
+
+	UINT m_PersistentCount = 0;
+	CTlsfAllocator m_Persistent;
+	CRingAllocator m_Transient;
+
+	DescriptorAllocatorStats m_Stats;
+};
+
+//CPU    :  Allocate/Free 
+//    ,   
+//    ;     ,
+//     ,  
+// ,   .   OutputDebugString
+void Verify_Descriptor_Allocator();
+
+#endif
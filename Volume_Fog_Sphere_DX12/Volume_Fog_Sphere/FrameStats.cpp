@@ -0,0 +1,655 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Frame Stats
+//======================================================================================
+
+#include "FrameStats.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <memory>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <intrin.h>
+#endif
+
+static double To_Ms(std::chrono::steady_clock::duration Duration)
+{
+	return std::chrono::duration<double, std::milli>(Duration).count();
+}
+
+static unsigned int To_Us(float Ms)
+{
+	if (!(Ms > 0.0f))
+		return 0;
+
+	double Us = Ms * 1000.0 + 0.5;
+	if (Us >= 4294967295.0)
+		return 0xFFFFFFFF;
+
+	return (unsigned int)Us;
+}
+
+static unsigned int Highest_Bit(unsigned int Value)
+{
+#ifdef _MSC_VER
+	unsigned long Index;
+	_BitScanReverse(&Index, Value);
+	return Index;
+#else
+	return 31 - __builtin_clz(Value);
+#endif
+}
+
+static void Print_Report(const char* Buffer)
+{
+#ifdef _WIN32
+	OutputDebugStringA(Buffer);
+#else
+	fputs(Buffer, stdout);
+#endif
+}
+
+static FILE* Open_File(const char* Filename, const char* Mode)
+{
+	FILE* File = nullptr;
+
+#ifdef _WIN32
+	if (fopen_s(&File, Filename, Mode) != 0)
+		return nullptr;
+#else
+	File = fopen(Filename, Mode);
+#endif
+
+	return File;
+}
+
+//      ,
+//      
+static bool Replace_File(const std::string& TempName, const char* Filename)
+{
+#ifdef _WIN32
+	return MoveFileExA(TempName.c_str(), Filename, MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+	return rename(TempName.c_str(), Filename) == 0;
+#endif
+}
+
+CFrameHistogram::CFrameHistogram()
+{
+	Clear();
+}
+
+unsigned int CFrameHistogram::Bucket_Index(unsigned int ValueUs)
+{
+	if (ValueUs < SubCount)
+		return ValueUs;
+
+	unsigned int Shift = Highest_Bit(ValueUs) - FRAME_HISTOGRAM_SUB_BITS;
+
+	return SubCount + Shift * SubCount + ((ValueUs >> Shift) - SubCount);
+}
+
+unsigned int CFrameHistogram::Bucket_Lowest(unsigned int Index)
+{
+	if (Index < SubCount)
+		return Index;
+
+	unsigned int Shift = (Index - SubCount) / SubCount;
+	unsigned int Sub = (Index - SubCount) % SubCount;
+
+	return (SubCount + Sub) << Shift;
+}
+
+unsigned int CFrameHistogram::Bucket_Highest(unsigned int Index)
+{
+	if (Index < SubCount)
+		return Index;
+
+	unsigned int Shift = (Index - SubCount) / SubCount;
+
+	return Bucket_Lowest(Index) + ((1u << Shift) - 1);
+}
+
+// ,      
+void CFrameHistogram::Add(unsigned int ValueUs)
+{
+	std::atomic<unsigned int>& Count = m_Counts[Bucket_Index(ValueUs)];
+	Count.store(Count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void CFrameHistogram::Remove(unsigned int ValueUs)
+{
+	std::atomic<unsigned int>& Count = m_Counts[Bucket_Index(ValueUs)];
+
+	unsigned int Value = Count.load(std::memory_order_relaxed);
+	if (Value > 0)
+		Count.store(Value - 1, std::memory_order_relaxed);
+}
+
+void CFrameHistogram::Clear()
+{
+	for (unsigned int i = 0; i < BucketCount; i++)
+		m_Counts[i].store(0, std::memory_order_relaxed);
+}
+
+unsigned long long CFrameHistogram::Total() const
+{
+	unsigned long long Total = 0;
+
+	for (unsigned int i = 0; i < BucketCount; i++)
+		Total += m_Counts[i].load(std::memory_order_relaxed);
+
+	return Total;
+}
+
+unsigned int CFrameHistogram::Percentile(double Percentile) const
+{
+	//  -       
+	static thread_local unsigned int Counts[BucketCount];
+
+	unsigned long long Total = 0;
+	for (unsigned int i = 0; i < BucketCount; i++)
+	{
+		Counts[i] = m_Counts[i].load(std::memory_order_relaxed);
+		Total += Counts[i];
+	}
+
+	if (Total == 0)
+		return 0;
+
+	if (Percentile < 0.0)
+		Percentile = 0.0;
+	if (Percentile > 100.0)
+		Percentile = 100.0;
+
+	unsigned long long Rank = (unsigned long long)ceil(Percentile / 100.0 * Total);
+	if (Rank < 1)
+		Rank = 1;
+
+	unsigned long long Seen = 0;
+	for (unsigned int i = 0; i < BucketCount; i++)
+	{
+		Seen += Counts[i];
+		if (Seen >= Rank)
+			return Bucket_Highest(i);
+	}
+
+	return Bucket_Highest(BucketCount - 1);
+}
+
+unsigned int CFrameHistogram::Max() const
+{
+	for (unsigned int i = BucketCount; i > 0; i--)
+	{
+		if (m_Counts[i - 1].load(std::memory_order_relaxed) != 0)
+			return Bucket_Highest(i - 1);
+	}
+
+	return 0;
+}
+
+unsigned int CFrameHistogram::Count(unsigned int Index) const
+{
+	return m_Counts[Index].load(std::memory_order_relaxed);
+}
+
+CFrameStats::CFrameStats()
+{
+	m_Writing.store(0, std::memory_order_relaxed);
+	m_Written.store(0, std::memory_order_relaxed);
+	m_Stutters.store(0, std::memory_order_relaxed);
+
+	for (unsigned int i = 0; i < FRAME_STATS_HISTORY; i++)
+	{
+		m_Slots[i].FrameMs.store(0.0f, std::memory_order_relaxed);
+		for (unsigned int j = 0; j < FRAME_PHASE_COUNT; j++)
+			m_Slots[i].PhaseMs[j].store(0.0f, std::memory_order_relaxed);
+		m_Slots[i].Stutter.store(0, std::memory_order_relaxed);
+	}
+}
+
+CFrameStats::~CFrameStats()
+{
+	Stop_Export();
+}
+
+void CFrameStats::Begin_Frame()
+{
+	Clock::time_point Now = Clock::now();
+
+	if (m_Started)
+	{
+		m_PhaseMs[FRAME_PHASE_WAIT] += (float)To_Ms(Now - m_PhaseStart);
+		Record_Frame((float)To_Ms(Now - m_FrameStart), m_PhaseMs);
+	}
+
+	m_Started = true;
+	m_FrameStart = Now;
+	m_PhaseStart = Now;
+
+	for (unsigned int i = 0; i < FRAME_PHASE_COUNT; i++)
+		m_PhaseMs[i] = 0.0f;
+}
+
+void CFrameStats::Phase_End(FramePhase Phase)
+{
+	Clock::time_point Now = Clock::now();
+
+	m_PhaseMs[Phase] += (float)To_Ms(Now - m_PhaseStart);
+	m_PhaseStart = Now;
+}
+
+void CFrameStats::Record_Frame(float FrameMs, const float* PhaseMs)
+{
+	unsigned long long Index = m_Written.load(std::memory_order_relaxed);
+	FrameSlot& Slot = m_Slots[Index % FRAME_STATS_HISTORY];
+
+	//  ,    
+	if (Index >= FRAME_STATS_HISTORY)
+		m_Histogram.Remove(To_Us(Slot.FrameMs.load(std::memory_order_relaxed)));
+
+	//     ,   
+	//     
+	bool Stutter = m_Baseline > 0.0f && FrameMs > m_Baseline * FRAME_STATS_STUTTER_FACTOR;
+	if (!Stutter)
+		m_Baseline = m_Baseline > 0.0f ? m_Baseline + (FrameMs - m_Baseline) / 16.0f : FrameMs;
+
+	//,    ,   m_Writing
+	m_Writing.store(Index + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	Slot.FrameMs.store(FrameMs, std::memory_order_relaxed);
+	for (unsigned int i = 0; i < FRAME_PHASE_COUNT; i++)
+		Slot.PhaseMs[i].store(PhaseMs[i], std::memory_order_relaxed);
+	Slot.Stutter.store(Stutter ? 1 : 0, std::memory_order_relaxed);
+
+	m_Histogram.Add(To_Us(FrameMs));
+
+	if (Stutter)
+		m_Stutters.store(m_Stutters.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+	m_Written.store(Index + 1, std::memory_order_release);
+}
+
+unsigned int CFrameStats::Snapshot(FrameRecord* Records) const
+{
+	unsigned long long Written = m_Written.load(std::memory_order_acquire);
+	unsigned long long First = Written > FRAME_STATS_HISTORY ? Written - FRAME_STATS_HISTORY : 0;
+
+	for (unsigned long long i = First; i < Written; i++)
+	{
+		const FrameSlot& Slot = m_Slots[i % FRAME_STATS_HISTORY];
+		FrameRecord& Record = Records[i - First];
+
+		Record.Index = i;
+		Record.FrameMs = Slot.FrameMs.load(std::memory_order_relaxed);
+		for (unsigned int j = 0; j < FRAME_PHASE_COUNT; j++)
+			Record.PhaseMs[j] = Slot.PhaseMs[j].load(std::memory_order_relaxed);
+		Record.Stutter = Slot.Stutter.load(std::memory_order_relaxed);
+	}
+
+	// ,     :   
+	//Writing - 1    Writing - 1 - HISTORY
+	std::atomic_thread_fence(std::memory_order_acquire);
+	unsigned long long Writing = m_Writing.load(std::memory_order_relaxed);
+
+	unsigned long long Valid = Writing > FRAME_STATS_HISTORY ? Writing - FRAME_STATS_HISTORY : 0;
+	if (Valid <= First)
+		return (unsigned int)(Written - First);
+
+	if (Valid >= Written)
+		return 0;
+
+	unsigned int Skip = (unsigned int)(Valid - First);
+	unsigned int Count = (unsigned int)(Written - Valid);
+
+	for (unsigned int i = 0; i < Count; i++)
+		Records[i] = Records[i + Skip];
+
+	return Count;
+}
+
+FrameStatsSummary CFrameStats::Get_Summary() const
+{
+	std::unique_ptr<FrameRecord[]> Records(new FrameRecord[FRAME_STATS_HISTORY]);
+	unsigned int Count = Snapshot(Records.get());
+
+	FrameStatsSummary Summary;
+	Summary.Frames = m_Written.load(std::memory_order_acquire);
+	Summary.Stutters = m_Stutters.load(std::memory_order_relaxed);
+	Summary.Window = Count;
+
+	Summary.P50Ms = m_Histogram.Percentile(50.0) / 1000.0;
+	Summary.P95Ms = m_Histogram.Percentile(95.0) / 1000.0;
+	Summary.P99Ms = m_Histogram.Percentile(99.0) / 1000.0;
+	Summary.MaxMs = m_Histogram.Max() / 1000.0;
+
+	if (Count == 0)
+		return Summary;
+
+	for (unsigned int i = 0; i < Count; i++)
+	{
+		Summary.AvgMs += Records[i].FrameMs;
+		for (unsigned int j = 0; j < FRAME_PHASE_COUNT; j++)
+			Summary.PhaseMs[j] += Records[i].PhaseMs[j];
+	}
+
+	Summary.AvgMs /= Count;
+	for (unsigned int j = 0; j < FRAME_PHASE_COUNT; j++)
+		Summary.PhaseMs[j] /= Count;
+
+	return Summary;
+}
+
+bool CFrameStats::Export_Csv(const char* Filename) const
+{
+	std::unique_ptr<FrameRecord[]> Records(new FrameRecord[FRAME_STATS_HISTORY]);
+	unsigned int Count = Snapshot(Records.get());
+
+	std::string TempName = std::string(Filename) + ".tmp";
+	FILE* File = Open_File(TempName.c_str(), "wt");
+	if (File == nullptr)
+		return false;
+
+	fprintf(File, "frame,frame_ms,update_ms,record_ms,submit_ms,wait_ms,stutter\n");
+
+	for (unsigned int i = 0; i < Count; i++)
+	{
+		const FrameRecord& Record = Records[i];
+		fprintf(File, "%llu,%.3f,%.3f,%.3f,%.3f,%.3f,%u\n", Record.Index, Record.FrameMs,
+			Record.PhaseMs[FRAME_PHASE_UPDATE], Record.PhaseMs[FRAME_PHASE_RECORD],
+			Record.PhaseMs[FRAME_PHASE_SUBMIT], Record.PhaseMs[FRAME_PHASE_WAIT], Record.Stutter);
+	}
+
+	bool Written = ferror(File) == 0;
+	fclose(File);
+
+	return Written && Replace_File(TempName, Filename);
+}
+
+bool CFrameStats::Export_Json(const char* Filename) const
+{
+	FrameStatsSummary Summary = Get_Summary();
+
+	std::string TempName = std::string(Filename) + ".tmp";
+	FILE* File = Open_File(TempName.c_str(), "wt");
+	if (File == nullptr)
+		return false;
+
+	fprintf(File, "{\n");
+	fprintf(File, "\t\"frames\": %llu,\n\t\"window\": %u,\n\t\"stutters\": %llu,\n",
+		Summary.Frames, Summary.Window, Summary.Stutters);
+	fprintf(File, "\t\"frame_ms\": { \"avg\": %.3f, \"p50\": %.3f, \"p95\": %.3f, \"p99\": %.3f, \"max\": %.3f },\n",
+		Summary.AvgMs, Summary.P50Ms, Summary.P95Ms, Summary.P99Ms, Summary.MaxMs);
+	fprintf(File, "\t\"phase_ms\": { \"update\": %.3f, \"record\": %.3f, \"submit\": %.3f, \"wait\": %.3f },\n",
+		Summary.PhaseMs[FRAME_PHASE_UPDATE], Summary.PhaseMs[FRAME_PHASE_RECORD],
+		Summary.PhaseMs[FRAME_PHASE_SUBMIT], Summary.PhaseMs[FRAME_PHASE_WAIT]);
+
+	//  : [ ,  , ]
+	fprintf(File, "\t\"histogram_us\": [");
+
+	bool First = true;
+	for (unsigned int i = 0; i < CFrameHistogram::BucketCount; i++)
+	{
+		unsigned int Count = m_Histogram.Count(i);
+		if (Count == 0)
+			continue;
+
+		fprintf(File, "%s[%u, %u, %u]", First ? "" : ", ", CFrameHistogram::Bucket_Lowest(i),
+			CFrameHistogram::Bucket_Highest(i), Count);
+		First = false;
+	}
+
+	fprintf(File, "]\n}\n");
+
+	bool Written = ferror(File) == 0;
+	fclose(File);
+
+	return Written && Replace_File(TempName, Filename);
+}
+
+void CFrameStats::Start_Export(const std::string& BaseName, double IntervalSec)
+{
+	Stop_Export();
+
+	m_ExportName = BaseName;
+	m_ExportStop = false;
+
+	std::chrono::duration<double> Interval(IntervalSec);
+
+	m_ExportThread = std::thread([this, Interval]()
+	{
+		std::string Csv = m_ExportName + ".csv";
+		std::string Json = m_ExportName + ".json";
+
+		std::unique_lock<std::mutex> Lock(m_ExportMutex);
+
+		//    
+		bool Stop = false;
+		while (!Stop)
+		{
+			Stop = m_ExportSignal.wait_for(Lock, Interval, [this]() { return m_ExportStop; });
+
+			Export_Csv(Csv.c_str());
+			Export_Json(Json.c_str());
+		}
+	});
+}
+
+void CFrameStats::Stop_Export()
+{
+	if (!m_ExportThread.joinable())
+		return;
+
+	{
+		std::lock_guard<std::mutex> Lock(m_ExportMutex);
+		m_ExportStop = true;
+	}
+
+	m_ExportSignal.notify_all();
+	m_ExportThread.join();
+}
+
+void CFrameStats::Report(const char* Name) const
+{
+	FrameStatsSummary Summary = Get_Summary();
+
+	char Buffer[320];
+	snprintf(Buffer, sizeof(Buffer), "%s: %llu frames, last %u avg %.2f p50 %.2f p95 %.2f p99 %.2f max %.2f ms, update %.2f record %.2f submit %.2f wait %.2f ms, %llu stutters\n",
+		Name, Summary.Frames, Summary.Window, Summary.AvgMs, Summary.P50Ms, Summary.P95Ms, Summary.P99Ms,
+		Summary.MaxMs, Summary.PhaseMs[FRAME_PHASE_UPDATE], Summary.PhaseMs[FRAME_PHASE_RECORD],
+		Summary.PhaseMs[FRAME_PHASE_SUBMIT], Summary.PhaseMs[FRAME_PHASE_WAIT], Summary.Stutters);
+	Print_Report(Buffer);
+}
+
+static bool Near(double Value, double Expected, double Tolerance)
+{
+	return fabs(Value - Expected) <= Tolerance;
+}
+
+void Verify_Frame_Stats()
+{
+	char Buffer[256];
+	bool Valid = true;
+
+	//:    ,    
+	//1/SubCount  ,    
+	bool Buckets = true;
+	unsigned int Seed = 12345;
+
+	for (unsigned int i = 0; i < 300000; i++)
+	{
+		unsigned int Value = i;
+		if (i >= 100000)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			Value = Seed >> (Seed & 15);
+		}
+
+		unsigned int Index = CFrameHistogram::Bucket_Index(Value);
+		unsigned int Lowest = CFrameHistogram::Bucket_Lowest(Index);
+		unsigned int Highest = CFrameHistogram::Bucket_Highest(Index);
+
+		if (Index >= CFrameHistogram::BucketCount || Value < Lowest || Value > Highest ||
+			Highest - Lowest > Lowest / CFrameHistogram::SubCount)
+			Buckets = false;
+	}
+
+	for (unsigned int i = 0; i + 1 < CFrameHistogram::BucketCount; i++)
+	{
+		if (CFrameHistogram::Bucket_Lowest(i + 1) != CFrameHistogram::Bucket_Highest(i) + 1 ||
+			CFrameHistogram::Bucket_Index(CFrameHistogram::Bucket_Lowest(i)) != i)
+			Buckets = false;
+	}
+
+	if (CFrameHistogram::Bucket_Index(0xFFFFFFFF) != CFrameHistogram::BucketCount - 1)
+		Buckets = false;
+
+	//  1..100000 
+	bool Percentiles = true;
+	std::unique_ptr<CFrameHistogram> Histogram(new CFrameHistogram());
+
+	for (unsigned int Value = 1; Value <= 100000; Value++)
+		Histogram->Add(Value);
+
+	const double Error = 1.0 / CFrameHistogram::SubCount;
+	unsigned int P50 = Histogram->Percentile(50.0);
+	unsigned int P99 = Histogram->Percentile(99.0);
+	unsigned int Max = Histogram->Max();
+
+	if (Histogram->Total() != 100000 ||
+		P50 < 50000 || P50 > 50000 * (1.0 + Error) ||
+		P99 < 99000 || P99 > 99000 * (1.0 + Error) ||
+		Max < 100000 || Max > 100000 * (1.0 + Error) ||
+		Histogram->Percentile(0.0) != 1)
+		Percentiles = false;
+
+	for (unsigned int Value = 1; Value <= 100000; Value++)
+		Histogram->Remove(Value);
+
+	if (Histogram->Total() != 0 || Histogram->Max() != 0)
+		Percentiles = false;
+
+	//:  HISTORY   20    10    ,
+	//    -   
+	bool Window = true;
+	std::unique_ptr<CFrameStats> Stats(new CFrameStats());
+
+	float Phases[FRAME_PHASE_COUNT] = { 1.0f, 2.0f, 3.0f, 4.0f };
+	for (unsigned int i = 0; i < FRAME_STATS_HISTORY; i++)
+		Stats->Record_Frame(10.0f, Phases);
+	for (unsigned int i = 0; i < FRAME_STATS_HISTORY; i++)
+		Stats->Record_Frame(20.0f, Phases);
+
+	FrameStatsSummary Summary = Stats->Get_Summary();
+	if (Summary.Frames != 2 * FRAME_STATS_HISTORY || Summary.Window != FRAME_STATS_HISTORY ||
+		!Near(Summary.AvgMs, 20.0, 0.001) || Summary.P50Ms < 20.0 || Summary.P50Ms > 20.0 * (1.0 + Error) ||
+		Summary.MaxMs > 20.0 * (1.0 + Error) || !Near(Summary.PhaseMs[FRAME_PHASE_RECORD], 2.0, 0.001) ||
+		Summary.Stutters != 0)
+		Window = false;
+
+	//: 50   16.7 , 30  -   
+	bool Stutters = true;
+	Stats.reset(new CFrameStats());
+
+	for (unsigned int i = 0; i < 300; i++)
+	{
+		float FrameMs = 16.7f;
+		if (i == 100)
+			FrameMs = 50.0f;
+		if (i == 200)
+			FrameMs = 30.0f;
+
+		Stats->Record_Frame(FrameMs, Phases);
+	}
+
+	Summary = Stats->Get_Summary();
+	if (Summary.Stutters != 1 || Summary.P99Ms < 16.7)
+		Stutters = false;
+
+	//    ,   :  
+	//        
+	bool Concurrent = true;
+	Stats.reset(new CFrameStats());
+
+	std::atomic<bool> Done(false);
+	CFrameStats* Writer = Stats.get();
+
+	std::thread WriterThread([Writer, &Done]()
+	{
+		for (unsigned int i = 0; i < 2000000; i++)
+		{
+			float FrameMs = (float)(i % 1000 + 1);
+			float Phase[FRAME_PHASE_COUNT] = { FrameMs, FrameMs * 2.0f, FrameMs * 4.0f, FrameMs * 8.0f };
+			Writer->Record_Frame(FrameMs, Phase);
+		}
+
+		Done.store(true);
+	});
+
+	std::unique_ptr<CFrameStats::FrameRecord[]> Records(new CFrameStats::FrameRecord[FRAME_STATS_HISTORY]);
+	unsigned int Snapshots = 0;
+
+	while (!Done.load())
+	{
+		unsigned int Count = Stats->Snapshot(Records.get());
+		Snapshots++;
+
+		for (unsigned int i = 0; i < Count; i++)
+		{
+			float FrameMs = (float)(Records[i].Index % 1000 + 1);
+			if (Records[i].FrameMs != FrameMs || Records[i].PhaseMs[1] != FrameMs * 2.0f ||
+				Records[i].PhaseMs[3] != FrameMs * 8.0f ||
+				(i > 0 && Records[i].Index != Records[i - 1].Index + 1))
+				Concurrent = false;
+		}
+	}
+
+	WriterThread.join();
+
+	if (Stats->Get_Summary().Window != FRAME_STATS_HISTORY)
+		Concurrent = false;
+
+	Valid = Buckets && Percentiles && Window && Stutters && Concurrent;
+
+	snprintf(Buffer, sizeof(Buffer), "Frame stats: buckets %s, percentiles %s (p50 %u p99 %u us), window %s, stutters %s, concurrent %s (%u snapshots), %s\n",
+		Buckets ? "OK" : "FAILED", Percentiles ? "OK" : "FAILED", P50, P99, Window ? "OK" : "FAILED",
+		Stutters ? "OK" : "FAILED", Concurrent ? "OK" : "FAILED", Snapshots, Valid ? "OK" : "FAILED");
+	Print_Report(Buffer);
+}
+
+void Benchmark_Frame_Stats()
+{
+	const unsigned int Frames = 1000000;
+
+	std::unique_ptr<CFrameStats> Stats(new CFrameStats());
+	float Phases[FRAME_PHASE_COUNT] = { 1.0f, 2.0f, 3.0f, 4.0f };
+
+	std::chrono::steady_clock::time_point Start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < Frames; i++)
+		Stats->Record_Frame((float)(i % 50 + 1), Phases);
+
+	double RecordNs = To_Ms(std::chrono::steady_clock::now() - Start) * 1000000.0 / Frames;
+
+	// :      
+	Stats.reset(new CFrameStats());
+	Start = std::chrono::steady_clock::now();
+
+	for (unsigned int i = 0; i < Frames; i++)
+	{
+		Stats->Begin_Frame();
+		Stats->Phase_End(FRAME_PHASE_WAIT);
+		Stats->Phase_End(FRAME_PHASE_UPDATE);
+		Stats->Phase_End(FRAME_PHASE_RECORD);
+		Stats->Phase_End(FRAME_PHASE_SUBMIT);
+	}
+
+	double FrameNs = To_Ms(std::chrono::steady_clock::now() - Start) * 1000000.0 / Frames;
+
+	char Buffer[256];
+	snprintf(Buffer, sizeof(Buffer), "Frame stats record: %.1f ns per Record_Frame, %.1f ns per frame with clock (Begin_Frame + 4 phases), %u frames\n",
+		RecordNs, FrameNs, Frames);
+	Print_Report(Buffer);
+}
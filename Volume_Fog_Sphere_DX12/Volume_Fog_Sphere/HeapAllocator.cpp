@@ -0,0 +1,181 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Heap Allocator DirectX12
+//======================================================================================
+
+#include "HeapAllocator.h"
+
+#include <stdio.h>
+
+static const D3D12_HEAP_FLAGS Category_Heap_Flags[HEAP_CATEGORY_COUNT] =
+{
+	D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+	D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES
+};
+
+static const char* Category_Names[HEAP_CATEGORY_COUNT] = { "buffers", "textures" };
+
+void CHeapAllocator::Init(ID3D12Device* Device, UINT64 PageSize)
+{
+	m_Device = Device;
+	m_PageSize = (PageSize + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1) &
+		~(UINT64)(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> CHeapAllocator::Create_Buffer(UINT64 Size,
+	D3D12_RESOURCE_STATES State, PlacedAllocation* Allocation)
+{
+	//     64 KB
+	D3D12_RESOURCE_DESC Desc = CD3DX12_RESOURCE_DESC::Buffer(Size);
+	D3D12_RESOURCE_ALLOCATION_INFO Info = m_Device->GetResourceAllocationInfo(0, 1, &Desc);
+
+	return Create_Placed(HEAP_CATEGORY_BUFFERS, Desc, Info, State, Size, Allocation);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> CHeapAllocator::Create_Texture(const D3D12_RESOURCE_DESC& Desc,
+	D3D12_RESOURCE_STATES State, PlacedAllocation* Allocation)
+{
+	D3D12_RESOURCE_DESC Placed = Desc;
+	D3D12_RESOURCE_ALLOCATION_INFO Info;
+
+	// 4 KB ,    
+	// 64 KB,     64 KB
+	Placed.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+	Info = m_Device->GetResourceAllocationInfo(0, 1, &Placed);
+
+	if (Info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+	{
+		Placed.Alignment = 0;
+		Info = m_Device->GetResourceAllocationInfo(0, 1, &Placed);
+	}
+
+	//  ,    
+	return Create_Placed(HEAP_CATEGORY_TEXTURES, Placed, Info, State, Info.SizeInBytes, Allocation);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> CHeapAllocator::Create_Placed(UINT Category, const D3D12_RESOURCE_DESC& Desc,
+	const D3D12_RESOURCE_ALLOCATION_INFO& Info, D3D12_RESOURCE_STATES State, UINT64 Requested,
+	PlacedAllocation* Allocation)
+{
+	PlacedAllocation Placed;
+	Placed.Category = Category;
+	Placed.Requested = Requested;
+
+	ID3D12Heap* Heap = nullptr;
+	UINT64 Offset = 0;
+
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+
+		std::vector<std::unique_ptr<HeapPage>>& Pages = m_Pages[Category];
+
+		for (UINT i = 0; i < (UINT)Pages.size(); i++)
+		{
+			if (Pages[i]->Allocator.Allocate(Info.SizeInBytes, Info.Alignment, Offset, Placed.Handle))
+			{
+				Placed.Page = i;
+				break;
+			}
+		}
+
+		//     ,  
+		if (Placed.Page == UINT_MAX)
+		{
+			UINT64 PageSize = m_PageSize;
+			if (Info.SizeInBytes > PageSize)
+				PageSize = (Info.SizeInBytes + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1) &
+					~(UINT64)(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1);
+
+			CD3DX12_HEAP_DESC HeapDesc(PageSize, D3D12_HEAP_TYPE_DEFAULT, 0, Category_Heap_Flags[Category]);
+
+			std::unique_ptr<HeapPage> Page = std::make_unique<HeapPage>();
+			ThrowIfFailed(m_Device->CreateHeap(&HeapDesc, IID_PPV_ARGS(Page->Heap.GetAddressOf())));
+			Page->Allocator.Init(PageSize);
+
+			if (!Page->Allocator.Allocate(Info.SizeInBytes, Info.Alignment, Offset, Placed.Handle))
+				ThrowIfFailed(E_OUTOFMEMORY);
+
+			Placed.Page = (UINT)Pages.size();
+			Pages.push_back(std::move(Page));
+		}
+
+		Heap = Pages[Placed.Page]->Heap.Get();
+
+		m_Resources[Category]++;
+		m_Requested[Category] += Requested;
+	}
+
+	//  ,    
+	Microsoft::WRL::ComPtr<ID3D12Resource> Resource;
+
+	HRESULT hr = m_Device->CreatePlacedResource(Heap, Offset, &Desc, State, nullptr,
+		IID_PPV_ARGS(Resource.GetAddressOf()));
+
+	if (FAILED(hr))
+		Free(Placed);
+
+	ThrowIfFailed(hr);
+
+	if (Allocation != nullptr)
+		*Allocation = Placed;
+
+	return Resource;
+}
+
+void CHeapAllocator::Free(const PlacedAllocation& Allocation)
+{
+	std::lock_guard<std::mutex> Lock(m_Mutex);
+
+	if (Allocation.Category >= HEAP_CATEGORY_COUNT || Allocation.Page >= (UINT)m_Pages[Allocation.Category].size())
+		return;
+
+	m_Pages[Allocation.Category][Allocation.Page]->Allocator.Free(Allocation.Handle);
+
+	m_Resources[Allocation.Category]--;
+	m_Requested[Allocation.Category] -= Allocation.Requested;
+}
+
+HeapCategoryStats CHeapAllocator::Get_Stats(UINT Category)
+{
+	std::lock_guard<std::mutex> Lock(m_Mutex);
+
+	HeapCategoryStats Stats;
+	Stats.Pages = (UINT)m_Pages[Category].size();
+	Stats.Resources = m_Resources[Category];
+	Stats.RequestedBytes = m_Requested[Category];
+
+	for (const std::unique_ptr<HeapPage>& Page : m_Pages[Category])
+	{
+		TlsfStats PageStats = Page->Allocator.Get_Stats();
+
+		Stats.HeapBytes += PageStats.Size;
+		Stats.UsedBytes += PageStats.Used;
+		Stats.FreeBytes += PageStats.Free;
+		Stats.FreeBlocks += PageStats.FreeBlocks;
+		Stats.Merges += PageStats.Merges;
+
+		if (PageStats.LargestFree > Stats.LargestFree)
+			Stats.LargestFree = PageStats.LargestFree;
+	}
+
+	if (Stats.FreeBytes > 0)
+		Stats.Fragmentation = 1.0 - (double)Stats.LargestFree / Stats.FreeBytes;
+
+	return Stats;
+}
+
+void CHeapAllocator::Report(const char* Name)
+{
+	const double MB = 1024.0 * 1024.0;
+
+	for (UINT Category = 0; Category < HEAP_CATEGORY_COUNT; Category++)
+	{
+		HeapCategoryStats Stats = Get_Stats(Category);
+
+		char Buffer[320];
+		sprintf_s(Buffer, "%s %s: %u resources in %u heaps %.2f MB, used %.2f MB (alignment %.2f MB), free %.2f MB in %u blocks, largest %.2f MB, fragmentation %.1f%%, %llu merges\n",
+			Name, Category_Names[Category], Stats.Resources, Stats.Pages, Stats.HeapBytes / MB,
+			Stats.UsedBytes / MB, (Stats.UsedBytes - Stats.RequestedBytes) / MB, Stats.FreeBytes / MB,
+			Stats.FreeBlocks, Stats.LargestFree / MB, 100.0 * Stats.Fragmentation, Stats.Merges);
+		OutputDebugStringA(Buffer);
+	}
+}
@@ -0,0 +1,96 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Heap Allocator DirectX12
+//======================================================================================
+
+#ifndef _HEAPALLOCATOR_
+#define _HEAPALLOCATOR_
+
+#include <windows.h>
+#include <limits.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "d3dUtil.h"
+#include "TlsfAllocator.h"
+
+// Resource Heap Tier 1       
+enum HeapCategory
+{
+	HEAP_CATEGORY_BUFFERS,
+	HEAP_CATEGORY_TEXTURES,
+	HEAP_CATEGORY_COUNT
+};
+
+//   ,   Free
+struct PlacedAllocation
+{
+	UINT Category = HEAP_CATEGORY_BUFFERS;
+	UINT Page = UINT_MAX;
+	UINT Handle = UINT_MAX;
+	//     64 KB,     
+	UINT64 Requested = 0;
+};
+
+struct HeapCategoryStats
+{
+	UINT Pages = 0;
+	UINT Resources = 0;
+	UINT64 HeapBytes = 0;
+	UINT64 UsedBytes = 0;
+	UINT64 RequestedBytes = 0;
+	UINT64 FreeBytes = 0;
+	UINT64 LargestFree = 0;
+	UINT FreeBlocks = 0;
+	UINT64 Merges = 0;
+	//1 - LargestFree / FreeBytes,       
+	double Fragmentation = 0.0;
+};
+
+//default   :  ID3D12Heap () 
+//,     CreatePlacedResource  
+// CTlsfAllocator.      
+class CHeapAllocator
+{
+public:
+	CHeapAllocator() = default;
+
+	CHeapAllocator(const CHeapAllocator& rhs) = delete;
+	CHeapAllocator& operator=(const CHeapAllocator& rhs) = delete;
+
+	void Init(ID3D12Device* Device, UINT64 PageSize);
+
+	Microsoft::WRL::ComPtr<ID3D12Resource> Create_Buffer(UINT64 Size,
+		D3D12_RESOURCE_STATES State, PlacedAllocation* Allocation = nullptr);
+
+	//  RT/DS,     4 KB
+	Microsoft::WRL::ComPtr<ID3D12Resource> Create_Texture(const D3D12_RESOURCE_DESC& Desc,
+		D3D12_RESOURCE_STATES State, PlacedAllocation* Allocation = nullptr);
+
+	//    GPU    
+	void Free(const PlacedAllocation& Allocation);
+
+	HeapCategoryStats Get_Stats(UINT Category);
+	void Report(const char* Name);
+
+private:
+	struct HeapPage
+	{
+		Microsoft::WRL::ComPtr<ID3D12Heap> Heap;
+		CTlsfAllocator Allocator;
+	};
+
+	Microsoft::WRL::ComPtr<ID3D12Resource> Create_Placed(UINT Category, const D3D12_RESOURCE_DESC& Desc,
+		const D3D12_RESOURCE_ALLOCATION_INFO& Info, D3D12_RESOURCE_STATES State, UINT64 Requested,
+		PlacedAllocation* Allocation);
+
+	ID3D12Device* m_Device = nullptr;
+	UINT64 m_PageSize = 0;
+
+	std::mutex m_Mutex;
+	std::vector<std::unique_ptr<HeapPage>> m_Pages[HEAP_CATEGORY_COUNT];
+	UINT m_Resources[HEAP_CATEGORY_COUNT] = {};
+	UINT64 m_Requested[HEAP_CATEGORY_COUNT] = {};
+};
+
+#endif
@@ -0,0 +1,238 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Linear Allocator DirectX12
+//======================================================================================
+
+#include "LinearAllocator.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+// GPU    ,    
+#define LINEAR_FAKE_GPU_STRIDE 0x100000000ull
+
+static UINT64 Align_Up(UINT64 Value, UINT64 Align)
+{
+	return (Value + Align - 1) & ~(Align - 1);
+}
+
+CLinearAllocator::~CLinearAllocator()
+{
+	for (LinearPage& Page : m_Pages)
+	{
+		if (Page.Resource != nullptr)
+			Page.Resource->Unmap(0, nullptr);
+	}
+}
+
+void CLinearAllocator::Init(ID3D12Device* Device, UINT64 PageSize)
+{
+	m_Device = Device;
+	m_PageSize = Align_Up(PageSize, LINEAR_ALLOCATOR_ALIGN);
+}
+
+void CLinearAllocator::Add_Page(UINT64 Size)
+{
+	LinearPage Page;
+	Page.Size = Size;
+
+	if (m_Device != nullptr)
+	{
+		ThrowIfFailed(m_Device->CreateCommittedResource(
+			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
+			D3D12_HEAP_FLAG_NONE,
+			&CD3DX12_RESOURCE_DESC::Buffer(Size),
+			D3D12_RESOURCE_STATE_GENERIC_READ,
+			nullptr,
+			IID_PPV_ARGS(Page.Resource.GetAddressOf())));
+
+		ThrowIfFailed(Page.Resource->Map(0, nullptr, reinterpret_cast<void**>(&Page.Cpu)));
+		Page.Gpu = Page.Resource->GetGPUVirtualAddress();
+	}
+	else
+	{
+		Page.Memory.reset(new BYTE[(size_t)Size]);
+		Page.Cpu = Page.Memory.get();
+		Page.Gpu = (m_Pages.size() + 1) * LINEAR_FAKE_GPU_STRIDE;
+	}
+
+	m_Pages.push_back(std::move(Page));
+
+	m_Stats.Pages++;
+	m_Stats.PageBytes += Size;
+}
+
+LinearAllocation CLinearAllocator::Allocate(UINT64 Size, UINT64 Align)
+{
+	Size = Align_Up(Size, Align);
+
+	//     ,    
+	while (m_Page < m_Pages.size())
+	{
+		UINT64 Offset = Align_Up(m_Offset, Align);
+
+		if (Offset + Size <= m_Pages[m_Page].Size)
+		{
+			LinearAllocation Allocation;
+			Allocation.Cpu = m_Pages[m_Page].Cpu + Offset;
+			Allocation.Gpu = m_Pages[m_Page].Gpu + Offset;
+			Allocation.Size = Size;
+
+			m_Stats.Used += Offset + Size - m_Offset;
+			m_Stats.Allocations++;
+
+			m_Offset = Offset + Size;
+
+			return Allocation;
+		}
+
+		//    Reset
+		m_Stats.Used += m_Pages[m_Page].Size - m_Offset;
+
+		m_Page++;
+		m_Offset = 0;
+	}
+
+	// ,    
+	Add_Page(Align_Up(Size, m_PageSize));
+
+	return Allocate(Size, Align);
+}
+
+void CLinearAllocator::Reset()
+{
+	if (m_Stats.Used > m_Stats.PeakUsed)
+		m_Stats.PeakUsed = m_Stats.Used;
+
+	m_Stats.Used = 0;
+	m_Stats.Resets++;
+
+	m_Page = 0;
+	m_Offset = 0;
+}
+
+const LinearAllocatorStats& CLinearAllocator::Get_Stats() const
+{
+	return m_Stats;
+}
+
+void CLinearAllocator::Report(const char* Name)
+{
+	UINT64 PeakUsed = m_Stats.Used > m_Stats.PeakUsed ? m_Stats.Used : m_Stats.PeakUsed;
+
+	char Buffer[256];
+	sprintf_s(Buffer, "%s: %u pages %.1f KB, peak frame %.1f KB, %llu allocations in %u frames\n",
+		Name, m_Stats.Pages, m_Stats.PageBytes / 1024.0, PeakUsed / 1024.0,
+		m_Stats.Allocations, m_Stats.Resets);
+	OutputDebugStringA(Buffer);
+}
+
+void Verify_Linear_Allocator()
+{
+	struct TestBlock
+	{
+		BYTE* Cpu;
+		D3D12_GPU_VIRTUAL_ADDRESS Gpu;
+		UINT64 Size;
+		UINT64 Requested;
+		BYTE Fill;
+	};
+
+	const UINT64 PageSize = 64 * 1024;
+	static const UINT64 Aligns[] = { 256, 512, 4096 };
+
+	CLinearAllocator Allocator;
+	Allocator.Init(nullptr, PageSize);
+
+	bool Valid = true;
+	UINT Seed = 12345;
+
+	std::vector<TestBlock> Blocks;
+	std::vector<D3D12_GPU_VIRTUAL_ADDRESS> FirstFrame;
+
+	UINT FirstFramePages = 0;
+	bool Reused = true;
+
+	for (UINT Frame = 0; Frame < 200; Frame++)
+	{
+		Blocks.clear();
+
+		//     , 
+		// ,     
+		UINT FrameSeed = Seed;
+		UINT Count = Frame % 4 == 0 ? 400 : 150;
+
+		for (UINT i = 0; i < Count; i++)
+		{
+			FrameSeed = FrameSeed * 1664525 + 1013904223;
+			UINT64 Align = Aligns[(FrameSeed >> 8) % 8 == 0 ? (FrameSeed >> 12) % _countof(Aligns) : 0];
+
+			FrameSeed = FrameSeed * 1664525 + 1013904223;
+			UINT64 Requested = (FrameSeed >> 8) % 256 == 0 ? PageSize + (FrameSeed >> 12) % PageSize : 1 + (FrameSeed >> 8) % 600;
+
+			LinearAllocation Allocation = Allocator.Allocate(Requested, Align);
+
+			if (Allocation.Gpu % Align != 0 || Allocation.Size < Requested || Allocation.Size % Align != 0)
+				Valid = false;
+
+			TestBlock Block = { Allocation.Cpu, Allocation.Gpu, Allocation.Size, Requested, (BYTE)(i * 7 + Frame) };
+			memset(Block.Cpu, Block.Fill, (size_t)Block.Requested);
+			Blocks.push_back(Block);
+		}
+
+		//        
+		for (const TestBlock& Block : Blocks)
+		{
+			for (UINT64 i = 0; i < Block.Requested; i++)
+			{
+				if (Block.Cpu[i] != Block.Fill)
+				{
+					Valid = false;
+					break;
+				}
+			}
+		}
+
+		// GPU   
+		std::vector<TestBlock> Sorted = Blocks;
+		std::sort(Sorted.begin(), Sorted.end(), [](const TestBlock& a, const TestBlock& b) { return a.Gpu < b.Gpu; });
+
+		for (size_t i = 1; i < Sorted.size(); i++)
+		{
+			if (Sorted[i - 1].Gpu + Sorted[i - 1].Size > Sorted[i].Gpu)
+				Valid = false;
+		}
+
+		// Reset           
+		if (Frame == 0)
+		{
+			for (const TestBlock& Block : Blocks)
+				FirstFrame.push_back(Block.Gpu);
+
+			FirstFramePages = Allocator.Get_Stats().Pages;
+		}
+		else
+		{
+			for (size_t i = 0; i < Blocks.size(); i++)
+			{
+				if (Blocks[i].Gpu != FirstFrame[i])
+					Reused = false;
+			}
+
+			if (Allocator.Get_Stats().Pages != FirstFramePages)
+				Reused = false;
+		}
+
+		Allocator.Reset();
+	}
+
+	const LinearAllocatorStats& Stats = Allocator.Get_Stats();
+
+	//  400      
+	bool Grew = Stats.Pages > 1;
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Linear allocator: %s, %u pages %.1f KB, peak frame %.1f KB, %llu allocations, reuse %s\n",
+		Valid && Grew && Reused ? "OK" : "FAILED", Stats.Pages, Stats.PageBytes / 1024.0,
+		Stats.PeakUsed / 1024.0, Stats.Allocations, Reused ? "OK" : "FAILED");
+	OutputDebugStringA(Buffer);
+}
@@ -0,0 +1,101 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Linear Allocator DirectX12
+//======================================================================================
+
+#ifndef _LINEARALLOCATOR_
+#define _LINEARALLOCATOR_
+
+#include <windows.h>
+#include <memory>
+#include <vector>
+
+#include "d3dUtil.h"
+
+// root CBV    256 
+#define LINEAR_ALLOCATOR_ALIGN D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT
+
+//   Cpu,     Gpu
+struct LinearAllocation
+{
+	BYTE* Cpu = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS Gpu = 0;
+	UINT64 Size = 0;
+};
+
+struct LinearAllocatorStats
+{
+	UINT Pages = 0;
+	UINT64 PageBytes = 0;
+	//   Reset,   
+	UINT64 Used = 0;
+	UINT64 PeakUsed = 0;
+	UINT64 Allocations = 0;
+	UINT Resets = 0;
+};
+
+//  :     
+// upload , Reset     
+// .      ,
+//   -   (  - ).
+//Device == nullptr -       GPU
+//,    CPU
+class CLinearAllocator
+{
+public:
+	CLinearAllocator() = default;
+	~CLinearAllocator();
+
+	CLinearAllocator(const CLinearAllocator& rhs) = delete;
+	CLinearAllocator& operator=(const CLinearAllocator& rhs) = delete;
+
+	void Init(ID3D12Device* Device, UINT64 PageSize);
+
+	//   Align,   CBV 
+	// 256      
+	LinearAllocation Allocate(UINT64 Size, UINT64 Align = LINEAR_ALLOCATOR_ALIGN);
+
+	template<typename T>
+	D3D12_GPU_VIRTUAL_ADDRESS Push(const T& Data)
+	{
+		LinearAllocation Allocation = Allocate(sizeof(T));
+		memcpy(Allocation.Cpu, &Data, sizeof(T));
+
+		return Allocation.Gpu;
+	}
+
+	//GPU   ,   
+	void Reset();
+
+	const LinearAllocatorStats& Get_Stats() const;
+	void Report(const char* Name);
+
+private:
+	struct LinearPage
+	{
+		Microsoft::WRL::ComPtr<ID3D12Resource> Resource;
+		std::unique_ptr<BYTE[]> Memory;
+		BYTE* Cpu;
+		D3D12_GPU_VIRTUAL_ADDRESS Gpu;
+		UINT64 Size;
+	};
+
+	void Add_Page(UINT64 Size);
+
+	ID3D12Device* m_Device = nullptr;
+	UINT64 m_PageSize = 0;
+
+	std::vector<LinearPage> m_Pages;
+	//        m_Offset
+	size_t m_Page = 0;
+	UINT64 m_Offset = 0;
+
+	LinearAllocatorStats m_Stats;
+};
+
+//CPU   :   , 
+//      CPU,   GPU , 
+//   ,  Reset   
+//      .   OutputDebugString
+void Verify_Linear_Allocator();
+
+#endif
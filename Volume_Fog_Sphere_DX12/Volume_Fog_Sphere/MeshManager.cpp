@@ -10,8 +10,44 @@ CMeshManager::CMeshManager()
 
 CMeshManager::~CMeshManager()
 {
+	//    m_RoomStaging  m_Scene,
+	//      
+	if (m_WorkerPool)
+	{
+		try
+		{
+			m_WorkerPool->Wait_All();
+		}
+		catch (...)
+		{
+		}
+	}
+
 	if (m_d3dDevice != nullptr)
 		FlushCommandQueue();
+
+	m_FrameScheduler.Report("Frame scheduler");
+	m_FramePacer.Report("Frame pacing");
+	m_Timer.Report("Frame limiter");
+	m_FrameStats.Report("Frame stats");
+
+	for (auto& Frame : m_FrameResources)
+		Frame->Constants.Report("Frame constants");
+
+	m_Descriptors.Report("Descriptors");
+	m_CmdState.Report("Scene state calls");
+
+#ifdef PARALLEL_RECORD
+	for (UINT i = 0; i < RECORD_THREADS; i++)
+	{
+		if (m_RecordCmdState[i].Get_Stats().Lists == 0)
+			continue;
+
+		char Name[64];
+		sprintf_s(Name, "Scene state calls, record list %u", i);
+		m_RecordCmdState[i].Report(Name);
+	}
+#endif
 }
 
 void CMeshManager::EnableDebugLayer_CreateFactory()
@@ -97,29 +133,44 @@ void CMeshManager::Create_CommandList_Allocator_Queue()
 
 void CMeshManager::Create_SwapChain()
 {
+	m_FramePacer.Release();
 	m_SwapChain.Reset();
 
-	DXGI_SWAP_CHAIN_DESC sd;
-	sd.BufferDesc.Width = m_ClientWidth;
-	sd.BufferDesc.Height = m_ClientHeight;
-	sd.BufferDesc.RefreshRate.Numerator = 60;
-	sd.BufferDesc.RefreshRate.Denominator = 1;
-	sd.BufferDesc.Format = m_BackBufferFormat;
-	sd.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-	sd.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+	//waitable object   , tearing - FRAME_PACING_MAX_THROUGHPUT
+	m_TearingSupported = Check_Tearing_Support(m_dxgiFactory.Get());
+	m_SwapChainFlags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH |
+		Get_Frame_Pacing_Swap_Chain_Flags(m_TearingSupported);
+
+	DXGI_SWAP_CHAIN_DESC1 sd = {};
+	sd.Width = m_ClientWidth;
+	sd.Height = m_ClientHeight;
+	sd.Format = m_BackBufferFormat;
+	sd.Stereo = false;
 	sd.SampleDesc.Count = m_4xMsaaState ? 4 : 1;
 	sd.SampleDesc.Quality = m_4xMsaaState ? (m_4xMsaaQuality - 1) : 0;
 	sd.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
 	sd.BufferCount = m_SwapChainBufferCount;
-	sd.OutputWindow = m_hWnd;
-	sd.Windowed = true;
+	sd.Scaling = DXGI_SCALING_STRETCH;
 	sd.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-	sd.Flags = DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH;
+	sd.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
+	sd.Flags = m_SwapChainFlags;
 
-	ThrowIfFailed(m_dxgiFactory->CreateSwapChain(
+	Microsoft::WRL::ComPtr<IDXGISwapChain1> SwapChain1;
+	ThrowIfFailed(m_dxgiFactory->CreateSwapChainForHwnd(
 		m_CommandQueue.Get(),
+		m_hWnd,
 		&sd,
-		m_SwapChain.GetAddressOf()));
+		nullptr,
+		nullptr,
+		SwapChain1.GetAddressOf()));
+
+	ThrowIfFailed(SwapChain1.As(&m_SwapChain));
+
+	//Present  ALLOW_TEARING    exclusive fullscreen
+	if (m_TearingSupported)
+		ThrowIfFailed(m_dxgiFactory->MakeWindowAssociation(m_hWnd, DXGI_MWA_NO_ALT_ENTER));
+
+	m_FramePacer.Init(m_SwapChain.Get(), FRAME_PACING_MODE, FRAMES_IN_FLIGHT, m_TearingSupported);
 }
 
 void CMeshManager::Resize_SwapChainBuffers()
@@ -141,24 +192,12 @@ void CMeshManager::Resize_SwapChainBuffers()
 		m_SwapChainBufferCount,
 		m_ClientWidth, m_ClientHeight,
 		m_BackBufferFormat,
-		DXGI_SWAP_CHAIN_FLAG_ALLOW_MODE_SWITCH));
+		m_SwapChainFlags));
 }
 
 void CMeshManager::FlushCommandQueue()
 {
-	m_CurrentFence++;
-
-	ThrowIfFailed(m_CommandQueue->Signal(m_Fence.Get(), m_CurrentFence));
-
-	if (m_Fence->GetCompletedValue() < m_CurrentFence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-
-		ThrowIfFailed(m_Fence->SetEventOnCompletion(m_CurrentFence, eventHandle));
-
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+	m_FrameScheduler.Flush();
 }
 
 void CMeshManager::Create_Dsv_DescriptorHeaps_And_View()
@@ -214,11 +253,18 @@ D3D12_CPU_DESCRIPTOR_HANDLE CMeshManager::DepthStencilView()
 
 void CMeshManager::Execute_Init_Commands()
 {
+	//    
+	m_UploadBatch.Record(m_CommandList.Get());
+
 	ThrowIfFailed(m_CommandList->Close());
 	ID3D12CommandList* cmdsLists[] = { m_CommandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
 	FlushCommandQueue();
+
+	// , upload    
+	m_UploadRing.Retire_All(m_FrameScheduler.Current_Fence());
+	m_UploadRing.Reclaim();
 }
 
 void CMeshManager::Update_ViewPort_And_Scissor()
@@ -269,168 +315,951 @@ void CMeshManager::Create_RenderTargetHeap_And_View_For_Pass1()
 	m_d3dDevice->CreateRenderTargetView(m_RenderTargetTex.Get(), nullptr, m_RTVTexHandle);
 }
 
+static double Get_Time_Ms()
+{
+	__int64 PerfFreq, Time;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&PerfFreq);
+	QueryPerformanceCounter((LARGE_INTEGER*)&Time);
+
+	return Time * 1000.0 / PerfFreq;
+}
+
+bool CMeshManager::Decode_Bmp_To_Upload(CUploadRing* UploadRing, const std::wstring& Filename,
+	UploadAllocation& Upload, std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints)
+{
+	//BMP    
+	CBmpFile Bmp;
+	if (!Bmp.Open(Filename))
+		return false;
+
+	UINT Width = Bmp.Width();
+	UINT Height = Bmp.Height();
+	UINT MipLevels = Mip_Level_Count(Width, Height);
+
+	D3D12_RESOURCE_DESC TextureDesc = CD3DX12_RESOURCE_DESC::Tex2D(DXGI_FORMAT_R8G8B8A8_UNORM,
+		Width, Height, 1, (UINT16)MipLevels);
+
+	// mip      upload 
+	Footprints.resize(MipLevels);
+	Upload = UploadRing->Allocate_Texture(TextureDesc, Footprints.data());
+
+	// 0    ,   
+	// ,    upload   
+	std::vector<BYTE> Texels((size_t)Width * Height * 4);
+	Bmp.Decode_RGBA(Texels.data(), Width * 4, BMP_DECODE_TOP_DOWN);
+
+	std::vector<MipLevelData> Levels(MipLevels);
+	for (UINT i = 0; i < MipLevels; i++)
+	{
+		Levels[i].Data = Upload.Mapped + Footprints[i].Offset;
+		Levels[i].RowPitch = Footprints[i].Footprint.RowPitch;
+	}
+
+	//    m_WorkerPool,     
+	//,     
+	Generate_Mip_Chain(Texels.data(), Width * 4, Width, Height, Levels.data(), MipLevels, nullptr);
+
+	return true;
+}
+
+bool CMeshManager::Load_Texture_To_Upload(CUploadRing* UploadRing, const std::wstring& Filename,
+	UploadAllocation& Upload, std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints)
+{
+	//   mip       
+	CTextureFile Tex;
+	if (!Tex.Open(Filename))
+		return false;
+
+	UINT MipLevels = Tex.MipLevels();
+
+	D3D12_RESOURCE_DESC TextureDesc = CD3DX12_RESOURCE_DESC::Tex2D(Tex.Format(),
+		Tex.Width(), Tex.Height(), 1, (UINT16)MipLevels);
+
+	Footprints.resize(MipLevels);
+	Upload = UploadRing->Allocate_Texture(TextureDesc, Footprints.data());
+
+	for (UINT i = 0; i < MipLevels; i++)
+		Tex.Copy_Level(i, Upload.Mapped + Footprints[i].Offset, Footprints[i].Footprint.RowPitch);
+
+	return true;
+}
+
+void CMeshManager::Load_Room_Staging(CUploadRing* UploadRing, const std::string& Filename, RoomStaging& Staging)
+{
+	//         roomN.txt,
+	//       
+	std::wstring BinFilename;
+	bool Hit = false;
+	if (!Asset_Cache_Lookup(ASSET_ROOM, AnsiToWString(Filename), ROOM_FILE_VERSION, BinFilename, Hit))
+		return;
+
+	if (Hit)
+		Staging.RoomLoaded = Staging.Room.Open(WStringToAnsi(BinFilename));
+
+	//     -  
+	if (!Staging.RoomLoaded)
+	{
+		std::wstring TempFilename = Asset_Cache_Temp_Filename(BinFilename);
+		if (Convert_Room_Text_To_Binary(Filename, WStringToAnsi(TempFilename)))
+			Asset_Cache_Commit(TempFilename, BinFilename);
+
+		Staging.RoomLoaded = Staging.Room.Open(WStringToAnsi(BinFilename));
+		if (!Staging.RoomLoaded)
+			return;
+	}
+
+	//      
+	Staging.TextureFilename = AnsiToWString(".\\Rooms\\" + std::string(Staging.Room.TextureName()));
+
+	//  (BC1  mip ,    ) 
+	//    BMP   ,    
+	const UINT TextureKey[] = { TEXTURE_FILE_VERSION, BMP_DECODE_TOP_DOWN, FALSE, TRUE };
+
+	std::wstring TexFilename;
+	if (Asset_Cache_Lookup(ASSET_TEXTURE, Staging.TextureFilename,
+		Hash_Bytes(TextureKey, sizeof(TextureKey)), TexFilename, Hit))
+	{
+		//CUploadRing , upload      
+		if (Hit)
+			Staging.TextureLoaded = Load_Texture_To_Upload(UploadRing, TexFilename,
+				Staging.TextureUpload, Staging.TextureFootprints);
+
+		if (!Staging.TextureLoaded)
+		{
+			std::wstring TempFilename = Asset_Cache_Temp_Filename(TexFilename);
+			if (Convert_Bmp_To_Texture(Staging.TextureFilename, TempFilename, BMP_DECODE_TOP_DOWN, false, true, nullptr))
+				Asset_Cache_Commit(TempFilename, TexFilename);
+
+			Staging.TextureLoaded = Load_Texture_To_Upload(UploadRing, TexFilename,
+				Staging.TextureUpload, Staging.TextureFootprints);
+		}
+	}
+
+	//     -  BMP  
+	if (!Staging.TextureLoaded)
+		Staging.TextureLoaded = Decode_Bmp_To_Upload(UploadRing, Staging.TextureFilename,
+			Staging.TextureUpload, Staging.TextureFootprints);
+}
+
+static std::vector<std::string> Room_Filenames()
+{
+	return {
+		".\\Rooms\\room0.txt",
+		".\\Rooms\\room1.txt",
+		".\\Rooms\\room2.txt",
+		".\\Rooms\\room3.txt",
+		".\\Rooms\\room4.txt",
+		".\\Rooms\\room5.txt",
+		".\\Rooms\\room6.txt",
+		".\\Rooms\\room7.txt",
+		".\\Rooms\\room8.txt",
+		".\\Rooms\\room9.txt",
+		".\\Rooms\\room10.txt",
+		".\\Rooms\\room11.txt" };
+}
+
+void CMeshManager::Load_Scene_Assets()
+{
+	std::vector<std::string> Filename = Room_Filenames();
+
+#ifdef ROOM_LOADER_BENCHMARK
+	Benchmark_Room_Loader(1000000);
+	Benchmark_Room_Text_Parser(Filename, 100);
+#endif
+
+#ifdef BMP_DECODER_BENCHMARK
+	Benchmark_Bmp_Decoder();
+#endif
+
+#ifdef ASSET_CACHE_BENCHMARK
+	Benchmark_Asset_Cache(Filename);
+#endif
+
+	//       
+	for (int j = 0; j < MeshNums; j++)
+	{
+		RoomStaging* Staging = &m_RoomStaging[j];
+		std::string RoomFilename = Filename[j];
+		CUploadRing* UploadRing = &m_UploadRing;
+
+		m_WorkerPool->Add_Task([UploadRing, RoomFilename, Staging]()
+		{
+			Load_Room_Staging(UploadRing, RoomFilename, *Staging);
+		});
+	}
+
+	m_WorkerPool->Wait_All();
+
+#ifdef PARALLEL_LOAD_VERIFY
+	Verify_Parallel_Load(Filename);
+#endif
+
+#ifdef MIP_GENERATOR_VERIFY
+	Verify_Mip_Generator(m_WorkerPool.get());
+#endif
+
+#ifdef TEXTURE_ATLAS_VERIFY
+	Verify_Skyline_Packer();
+#endif
+
+#ifdef MESH_OPTIMIZER_VERIFY
+	Verify_Vertex_Cache_Optimizer();
+#endif
+
+#ifdef TEXTURE_COOKER_REPORT
+	std::vector<std::wstring> TextureFilenames;
+	for (int j = 0; j < MeshNums; j++)
+		TextureFilenames.push_back(m_RoomStaging[j].TextureFilename);
+
+	Report_Texture_Compression(TextureFilenames, BMP_DECODE_TOP_DOWN, false, true, m_WorkerPool.get());
+#endif
+}
+
+void CMeshManager::Verify_Parallel_Load(const std::vector<std::string>& Filename)
+{
+	//        
+	bool Identical = true;
+
+	for (int j = 0; j < MeshNums; j++)
+	{
+		RoomStaging Serial;
+		Load_Room_Staging(&m_UploadRing, Filename[j], Serial);
+
+		//   upload   ,  
+		//    Allocate,   
+		if (Serial.TextureLoaded)
+			m_UploadRing.Retire(Serial.TextureUpload, 0);
+
+		RoomStaging& Parallel = m_RoomStaging[j];
+
+		if (Serial.RoomLoaded != Parallel.RoomLoaded ||
+			Serial.TextureLoaded != Parallel.TextureLoaded)
+		{
+			Identical = false;
+			continue;
+		}
+
+		if (Serial.TextureLoaded)
+		{
+			if (Serial.TextureFootprints.size() != Parallel.TextureFootprints.size())
+			{
+				Identical = false;
+				continue;
+			}
+
+			//  upload  ,     
+			for (size_t Level = 0; Level < Serial.TextureFootprints.size(); Level++)
+			{
+				const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& SerialLevel = Serial.TextureFootprints[Level];
+				const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& ParallelLevel = Parallel.TextureFootprints[Level];
+
+				if (SerialLevel.Offset - Serial.TextureUpload.Offset != ParallelLevel.Offset - Parallel.TextureUpload.Offset ||
+					memcmp(&SerialLevel.Footprint, &ParallelLevel.Footprint, sizeof(D3D12_SUBRESOURCE_FOOTPRINT)) != 0)
+					Identical = false;
+			}
+
+			if (!Identical)
+				continue;
+
+			//     upload ,     
+			// ,    RowPitch  ,
+			// BC      4x4
+			for (size_t Level = 0; Level < Serial.TextureFootprints.size(); Level++)
+			{
+				const D3D12_SUBRESOURCE_FOOTPRINT& Footprint = Serial.TextureFootprints[Level].Footprint;
+
+				UINT RowSize = Texture_Row_Pitch(Footprint.Format, Footprint.Width);
+				UINT NumRows = Texture_Num_Rows(Footprint.Format, Footprint.Height);
+
+				const BYTE* SerialTexels = Serial.TextureUpload.Mapped + Serial.TextureFootprints[Level].Offset;
+				const BYTE* ParallelTexels = Parallel.TextureUpload.Mapped + Parallel.TextureFootprints[Level].Offset;
+
+				for (UINT y = 0; y < NumRows; y++)
+				{
+					SIZE_T Offset = (SIZE_T)y * Footprint.RowPitch;
+
+					if (memcmp(SerialTexels + Offset, ParallelTexels + Offset, RowSize) != 0)
+						Identical = false;
+				}
+			}
+		}
+
+		if (Serial.RoomLoaded &&
+			(Serial.Room.VertexBufferByteSize() != Parallel.Room.VertexBufferByteSize() ||
+			Serial.Room.IndexBufferByteSize() != Parallel.Room.IndexBufferByteSize() ||
+			memcmp(Serial.Room.Vertices(), Parallel.Room.Vertices(), Serial.Room.VertexBufferByteSize()) != 0 ||
+			memcmp(Serial.Room.Indices(), Parallel.Room.Indices(), Serial.Room.IndexBufferByteSize()) != 0))
+		{
+			Identical = false;
+		}
+	}
+
+	OutputDebugStringA(Identical ? "Parallel load: identical to serial load\n" :
+		"Parallel load: MISMATCH with serial load\n");
+}
+
+void CMeshManager::Benchmark_Asset_Cache(const std::vector<std::string>& Filename)
+{
+	//  -   , ,   
+	// ,  -      
+	std::wstring Directory = Asset_Cache_Directory();
+	Asset_Cache_Set_Directory(Directory + L"Benchmark\\");
+	Asset_Cache_Clear();
+
+	double Ms[2];
+
+	for (UINT Pass = 0; Pass < 2; Pass++)
+	{
+		Asset_Cache_Reset_Stats();
+
+		double Time0 = Get_Time_Ms();
+
+		std::unique_ptr<RoomStaging[]> Staging(new RoomStaging[MeshNums]);
+
+		for (int j = 0; j < MeshNums; j++)
+		{
+			RoomStaging* RoomStage = &Staging[j];
+			std::string RoomFilename = Filename[j];
+			CUploadRing* UploadRing = &m_UploadRing;
+
+			m_WorkerPool->Add_Task([UploadRing, RoomFilename, RoomStage]()
+			{
+				Load_Room_Staging(UploadRing, RoomFilename, *RoomStage);
+			});
+		}
+
+		m_WorkerPool->Wait_All();
+
+		//   upload   
+		for (int j = 0; j < MeshNums; j++)
+		{
+			if (Staging[j].TextureLoaded)
+				m_UploadRing.Retire(Staging[j].TextureUpload, 0);
+		}
+
+		Create_Mesh_Shaders_And_InputLayout_Pass1();
+		Create_ScreenAlignedQuad_Shaders_And_InputLayout_Pass2();
+
+		Ms[Pass] = Get_Time_Ms() - Time0;
+
+		Asset_Cache_Report();
+	}
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Asset cache benchmark: cold start %.2f ms, warm start %.2f ms (%.1fx)\n",
+		Ms[0], Ms[1], Ms[0] / Ms[1]);
+	OutputDebugStringA(Buffer);
+
+	Asset_Cache_Clear();
+	Asset_Cache_Set_Directory(Directory);
+	Asset_Cache_Reset_Stats();
+}
+
 void CMeshManager::LoadTextures()
 {
-	std::vector<std::string> Filename = {
-	".\\Rooms\\texture0.bmp",
-	".\\Rooms\\texture1.bmp",
-	".\\Rooms\\texture2.bmp",
-	".\\Rooms\\texture3.bmp",
-	".\\Rooms\\texture4.bmp",
-	".\\Rooms\\texture5.bmp",
-	".\\Rooms\\texture6.bmp",
-	".\\Rooms\\texture7.bmp",
-	".\\Rooms\\texture8.bmp",
-	".\\Rooms\\texture9.bmp",
-	".\\Rooms\\texture10.bmp",
-	".\\Rooms\\texture11.bmp" };
-	
-	for (UINT j = 0; j < Filename.size(); j++)
+#ifdef TEXTURE_ARRAY_ROOMS
+	//     -  Texture2DArray, 
+	// -  ,     
+	if (Create_Room_Texture_Array() || Create_Room_Texture_Atlas())
+		return;
+#endif
+
+	for (int j = 0; j < MeshNums; j++)
+	{
+		RoomStaging& Staging = m_RoomStaging[j];
+
+		if (!Staging.TextureLoaded)
+		{
+			MessageBox(NULL, L"Error Open File", L"INFO", MB_OK);
+			ThrowIfFailed(E_FAIL);
+		}
+
+		//upload      
+		m_Scene[j]->Textures["SceneMeshTex"]->Resource = CreateTexture(&m_HeapAllocator,
+			m_UploadBatch, Staging.TextureFootprints, Staging.TextureUpload.Resource);
+	}
+}
+
+static Microsoft::WRL::ComPtr<ID3D12Resource> Create_Texture_Resource(CHeapAllocator* HeapAllocator,
+	const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints)
+{
+	D3D12_RESOURCE_DESC textureDesc = {};
+	textureDesc.MipLevels = (UINT16)Footprints.size();
+	textureDesc.Format = Footprints[0].Footprint.Format;
+	textureDesc.Width = Footprints[0].Footprint.Width;
+	textureDesc.Height = Footprints[0].Footprint.Height;
+	textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
+	textureDesc.DepthOrArraySize = 1;
+	textureDesc.SampleDesc.Count = 1;
+	textureDesc.SampleDesc.Quality = 0;
+	textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+
+	return HeapAllocator->Create_Texture(textureDesc, D3D12_RESOURCE_STATE_COMMON);
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> CMeshManager::CreateTexture(
+	CHeapAllocator* HeapAllocator,
+	CUploadBatch& UploadBatch,
+	const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints,
+	ID3D12Resource* UploadBuffer)
+{
+	Microsoft::WRL::ComPtr<ID3D12Resource> m_Texture = Create_Texture_Resource(HeapAllocator, Footprints);
+
+	UploadBatch.Add_Resource(m_Texture.Get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+	// mip     upload    ,
+	//     subresource
+	for (UINT i = 0; i < (UINT)Footprints.size(); i++)
+	{
+		CD3DX12_TEXTURE_COPY_LOCATION Dst(m_Texture.Get(), i);
+		CD3DX12_TEXTURE_COPY_LOCATION Src(UploadBuffer, Footprints[i]);
+		UploadBatch.Copy_Texture_Region(Dst, 0, 0, Src);
+	}
+
+	return m_Texture;
+}
+
+bool CMeshManager::Create_Room_Texture_Array()
+{
+	for (int j = 0; j < MeshNums; j++)
+	{
+		if (!m_RoomStaging[j].TextureLoaded)
+			return false;
+	}
+
+	//     ,    
+	const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& First = m_RoomStaging[0].TextureFootprints;
+	UINT MipLevels = (UINT)First.size();
+
+	for (int j = 1; j < MeshNums; j++)
+	{
+		const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints = m_RoomStaging[j].TextureFootprints;
+
+		if (Footprints.size() != MipLevels ||
+			Footprints[0].Footprint.Format != First[0].Footprint.Format ||
+			Footprints[0].Footprint.Width != First[0].Footprint.Width ||
+			Footprints[0].Footprint.Height != First[0].Footprint.Height)
+			return false;
+	}
+
+	D3D12_RESOURCE_DESC TextureDesc = CD3DX12_RESOURCE_DESC::Tex2D(First[0].Footprint.Format,
+		First[0].Footprint.Width, First[0].Footprint.Height, (UINT16)MeshNums, (UINT16)MipLevels);
+
+	m_RoomTexturePack = m_HeapAllocator.Create_Texture(TextureDesc, D3D12_RESOURCE_STATE_COPY_DEST);
+
+	for (int j = 0; j < MeshNums; j++)
+	{
+		RoomStaging& Staging = m_RoomStaging[j];
+
+		// j -  j,     subresource
+		for (UINT Level = 0; Level < MipLevels; Level++)
+		{
+			CD3DX12_TEXTURE_COPY_LOCATION Dst(m_RoomTexturePack.Get(),
+				D3D12CalcSubresource(Level, j, 0, MipLevels, MeshNums));
+			CD3DX12_TEXTURE_COPY_LOCATION Src(Staging.TextureUpload.Resource, Staging.TextureFootprints[Level]);
+			m_UploadBatch.Copy_Texture_Region(Dst, 0, 0, Src);
+		}
+
+		m_Scene[j]->TexConstants = RoomTextureConstants();
+		m_Scene[j]->TexConstants.Slice = j;
+	}
+
+	m_UploadBatch.Add_Resource(m_RoomTexturePack.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Room textures: Texture2DArray %ux%u, %d slices, %u levels\n",
+		First[0].Footprint.Width, First[0].Footprint.Height, MeshNums, MipLevels);
+	OutputDebugStringA(Buffer);
+
+	return true;
+}
+
+bool CMeshManager::Create_Room_Texture_Atlas()
+{
+	std::vector<AtlasRect> Rects(MeshNums);
+	DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+	UINT MaxLevels = TEXTURE_MAX_MIP_LEVELS;
+	UINT64 Area = 0;
+
+	//   ,  
+	for (int j = 0; j < MeshNums; j++)
+	{
+		const RoomStaging& Staging = m_RoomStaging[j];
+		if (!Staging.TextureLoaded)
+			return false;
+
+		const D3D12_SUBRESOURCE_FOOTPRINT& Footprint = Staging.TextureFootprints[0].Footprint;
+		if (j == 0)
+			Format = Footprint.Format;
+		else if (Footprint.Format != Format)
+			return false;
+
+		Rects[j].X = Rects[j].Y = 0;
+		Rects[j].Width = Footprint.Width;
+		Rects[j].Height = Footprint.Height;
+		Area += (UINT64)Footprint.Width * Footprint.Height;
+
+		if (Staging.TextureFootprints.size() < MaxLevels)
+			MaxLevels = (UINT)Staging.TextureFootprints.size();
+	}
+
+	//  ROOM_ATLAS_ALIGN ,   
+	//      
+	UINT BlockSize = Bc_Block_Size(Format) ? 4 : 1;
+
+	UINT AtlasWidth, AtlasHeight;
+	if (!Pack_Atlas(Rects, BlockSize * ROOM_ATLAS_ALIGN, D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION, AtlasWidth, AtlasHeight))
+		return false;
+
+	UINT MipLevels = Atlas_Mip_Levels(Rects, BlockSize, MaxLevels);
+	if (MipLevels > Mip_Level_Count(AtlasWidth, AtlasHeight))
+		MipLevels = Mip_Level_Count(AtlasWidth, AtlasHeight);
+
+	//  Texture2DArray   ,   
+	D3D12_RESOURCE_DESC TextureDesc = CD3DX12_RESOURCE_DESC::Tex2D(Format,
+		AtlasWidth, AtlasHeight, 1, (UINT16)MipLevels);
+
+	m_RoomTexturePack = m_HeapAllocator.Create_Texture(TextureDesc, D3D12_RESOURCE_STATE_COPY_DEST);
+
+	for (int j = 0; j < MeshNums; j++)
+	{
+		RoomStaging& Staging = m_RoomStaging[j];
+
+		for (UINT Level = 0; Level < MipLevels; Level++)
+		{
+			CD3DX12_TEXTURE_COPY_LOCATION Dst(m_RoomTexturePack.Get(), Level);
+			CD3DX12_TEXTURE_COPY_LOCATION Src(Staging.TextureUpload.Resource, Staging.TextureFootprints[Level]);
+			m_UploadBatch.Copy_Texture_Region(Dst, Rects[j].X >> Level, Rects[j].Y >> Level, Src);
+		}
+
+		//UV 0..1      ,
+		//       
+		RoomTextureConstants& Constants = m_Scene[j]->TexConstants;
+		Constants.Rect.x = (Rects[j].X + 0.5f) / AtlasWidth;
+		Constants.Rect.y = (Rects[j].Y + 0.5f) / AtlasHeight;
+		Constants.Rect.z = (Rects[j].Width - 1.0f) / AtlasWidth;
+		Constants.Rect.w = (Rects[j].Height - 1.0f) / AtlasHeight;
+		Constants.Slice = 0;
+	}
+
+	m_UploadBatch.Add_Resource(m_RoomTexturePack.Get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Room textures: atlas %ux%u, %u levels, occupancy %.1f%%\n",
+		AtlasWidth, AtlasHeight, MipLevels, 100.0 * (double)Area / ((double)AtlasWidth * AtlasHeight));
+	OutputDebugStringA(Buffer);
+
+	return true;
+}
+
+static void Create_Staged_Buffer(CUploadRing* UploadRing, CHeapAllocator* HeapAllocator, const void* Data, UINT64 ByteSize,
+	Microsoft::WRL::ComPtr<ID3D12Resource>& DefaultBuffer, UploadAllocation& Upload)
+{
+	DefaultBuffer = HeapAllocator->Create_Buffer(ByteSize, D3D12_RESOURCE_STATE_COMMON);
+
+	Upload = UploadRing->Allocate(ByteSize, UPLOAD_BUFFER_ALIGN);
+	memcpy(Upload.Mapped + Upload.Offset, Data, (size_t)ByteSize);
+}
+
+//     (BC - 4 
+//),  footprint RowPitch      
+static void Texture_Level_Rows(const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Footprint, UINT& RowHeight, UINT& NumRows)
+{
+	RowHeight = Bc_Block_Size(Footprint.Footprint.Format) ? 4 : 1;
+	NumRows = (Footprint.Footprint.Height + RowHeight - 1) / RowHeight;
+}
+
+static UINT64 Room_Upload_Bytes(const MeshGeometry& Geo, const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints)
+{
+	UINT64 Bytes = (UINT64)Geo.VertexBufferByteSize + Geo.IndexBufferByteSize;
+
+	for (const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Footprint : Footprints)
 	{
+		UINT RowHeight, NumRows;
+		Texture_Level_Rows(Footprint, RowHeight, NumRows);
+
+		Bytes += (UINT64)NumRows * Footprint.Footprint.RowPitch;
+	}
+
+	return Bytes;
+}
+
+//    - 16384  RGBA8
+static_assert(STREAM_UPLOAD_BYTES >= D3D12_REQ_TEXTURE2D_U_OR_V_DIMENSION * 4,
+	"STREAM_UPLOAD_BYTES must fit one row of the widest texture");
+
+void CMeshManager::Create_Streaming_Rooms()
+{
+	//  ,  SRV    
+	for (int j = 0; j < MeshNums; j++)
+	{
+		m_Scene[j] = std::make_unique<MeshGeometry>();
+		m_Scene[j]->Name = "Scene";
+
 		auto SceneTex = std::make_unique<Texture>();
 		SceneTex->Name = "SceneMeshTex";
-		//SceneTex->Filename = Filename[j].c_str();
+		m_Scene[j]->Textures[SceneTex->Name] = std::move(SceneTex);
+	}
+}
+
+bool CMeshManager::Stage_Room_Resources(CUploadRing* UploadRing, CHeapAllocator* HeapAllocator,
+	RoomStaging& Staging, MeshGeometry* Geo, UINT64& Bytes)
+{
+	if (!Staging.RoomLoaded)
+		return false;
+
+	if (!Staging.TextureLoaded)
+	{
+		Staging.Room.Close();
+		return false;
+	}
+
+	const UINT IbByteSize = Staging.Room.IndexBufferByteSize();
+
+#ifdef COMPACT_VERTEX_FORMAT
+	QuantizeBounds Bounds;
+	Compute_Quantize_Bounds(Staging.Room.Vertices(), Staging.Room.VertexCount(), sizeof(Vertex), Bounds);
+
+	std::vector<VertexCompact> Compact(Staging.Room.VertexCount());
+	Quantize_Pos_Tex(Staging.Room.Vertices(), Staging.Room.VertexCount(), sizeof(Vertex), Bounds, Compact.data());
+
+	const void* Vertices = Compact.data();
+	const UINT VbByteSize = (UINT)Compact.size() * sizeof(VertexCompact);
+
+	Geo->VertexByteStride = sizeof(VertexCompact);
+	Geo->PosScale = DirectX::XMFLOAT4(Bounds.Extent[0], Bounds.Extent[1], Bounds.Extent[2], 0.0f);
+	Geo->PosBias = DirectX::XMFLOAT4(Bounds.Min[0], Bounds.Min[1], Bounds.Min[2], 0.0f);
+#else
+	const void* Vertices = Staging.Room.Vertices();
+	const UINT VbByteSize = Staging.Room.VertexBufferByteSize();
+
+	Geo->VertexByteStride = sizeof(Vertex);
+#endif
+
+	//    , 
+	//    
+	Create_Staged_Buffer(UploadRing, HeapAllocator, Vertices, VbByteSize, Geo->VertexBufferGPU, Staging.VertexUpload);
+	Create_Staged_Buffer(UploadRing, HeapAllocator, Staging.Room.Indices(), IbByteSize, Geo->IndexBufferGPU, Staging.IndexUpload);
+
+	Geo->VertexBufferByteSize = VbByteSize;
+	Geo->IndexFormat = Staging.Room.IndexSize() == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	Geo->IndexBufferByteSize = IbByteSize;
+
+	Geo->DrawArgs.VertexCount = Staging.Room.VertexCount();
+	Geo->DrawArgs.IndexCount = Staging.Room.IndexCount();
+	Geo->DrawArgs.StartIndexLocation = 0;
+	Geo->DrawArgs.BaseVertexLocation = 0;
+
+	Staging.Room.Close();
+
+	auto& SceneTex = Geo->Textures["SceneMeshTex"];
+	SceneTex->Filename = Staging.TextureFilename;
+	SceneTex->Resource = Create_Texture_Resource(HeapAllocator, Staging.TextureFootprints);
+
+	Bytes = Room_Upload_Bytes(*Geo, Staging.TextureFootprints);
+
+	return true;
+}
+
+void CMeshManager::Start_Room_Streaming()
+{
+	ThrowIfFailed(m_d3dDevice->CreateCommandList(
+		0,
+		D3D12_COMMAND_LIST_TYPE_DIRECT,
+		m_FrameResources[0]->StreamCmdListAlloc.Get(),
+		nullptr,
+		IID_PPV_ARGS(m_StreamCommandList.GetAddressOf())));
+
+	m_StreamCommandList->Close();
+
+	std::vector<std::string> Filename = Room_Filenames();
+
+	for (int j = 0; j < MeshNums; j++)
+	{
+		RoomStaging* Staging = &m_RoomStaging[j];
+		MeshGeometry* Geo = m_Scene[j].get();
+		std::string RoomFilename = Filename[j];
+		CUploadRing* UploadRing = &m_UploadRing;
+		CHeapAllocator* HeapAllocator = &m_HeapAllocator;
+
+		StreamRequest Request;
+
+		Request.Load = [UploadRing, HeapAllocator, RoomFilename, Staging, Geo](UINT64& Bytes)
+		{
+			Load_Room_Staging(UploadRing, RoomFilename, *Staging);
+			return Stage_Room_Resources(UploadRing, HeapAllocator, *Staging, Geo, Bytes);
+		};
+
+		Request.Upload = [this, j](UINT64 Offset, UINT64 MaxBytes)
+		{
+			return Upload_Room_Range(j, Offset, MaxBytes);
+		};
+
+		Request.Finish = [this, j](bool Loaded)
+		{
+			Finish_Room_Upload(j, Loaded);
+		};
+
+		m_RoomStreamer.Add_Request(m_WorkerPool.get(), Request);
+	}
+}
+
+UINT64 CMeshManager::Upload_Room_Range(int j, UINT64 Offset, UINT64 MaxBytes)
+{
+	MeshGeometry* Geo = m_Scene[j].get();
+	Texture* SceneTex = Geo->Textures["SceneMeshTex"].get();
+	RoomStaging& Staging = m_RoomStaging[j];
+	const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints = Staging.TextureFootprints;
+
+	if (MaxBytes == 0)
+		return 0;
+
+	//     (   ),
+	//      Offset == 0,   
+	//simultaneous-access     COMMON -    
+	if (!Staging.CopyDest)
+	{
+		Staging.CopyDest = true;
+
+		D3D12_RESOURCE_BARRIER Barriers[] =
+		{
+			CD3DX12_RESOURCE_BARRIER::Transition(Geo->VertexBufferGPU.Get(),
+				D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST),
+			CD3DX12_RESOURCE_BARRIER::Transition(Geo->IndexBufferGPU.Get(),
+				D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST),
+			CD3DX12_RESOURCE_BARRIER::Transition(SceneTex->Resource.Get(),
+				D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST)
+		};
+
+		m_StreamCommandList->ResourceBarrier(_countof(Barriers), Barriers);
+	}
+
+	//   : , ,  .
+	//Segment -      
+	UINT64 Copied = 0;
+	UINT64 Segment = 0;
+
+	//    
+	ID3D12Resource* DstBuffer[2] = { Geo->VertexBufferGPU.Get(), Geo->IndexBufferGPU.Get() };
+	const UploadAllocation* SrcBuffer[2] = { &Staging.VertexUpload, &Staging.IndexUpload };
+	UINT64 BufferSize[2] = { Geo->VertexBufferByteSize, Geo->IndexBufferByteSize };
+
+	for (UINT k = 0; k < 2; k++)
+	{
+		UINT64 Pos = Offset + Copied;
+
+		if (Pos < Segment + BufferSize[k])
+		{
+			UINT64 Bytes = Segment + BufferSize[k] - Pos;
+			if (Bytes > MaxBytes - Copied)
+				Bytes = MaxBytes - Copied;
+
+			if (Bytes == 0)
+				return Copied;
+
+			m_StreamCommandList->CopyBufferRegion(DstBuffer[k], Pos - Segment,
+				SrcBuffer[k]->Resource, SrcBuffer[k]->Offset + Pos - Segment, Bytes);
+			Copied += Bytes;
+		}
+
+		Segment += BufferSize[k];
+	}
+
+	//    
+	for (UINT Level = 0; Level < (UINT)Footprints.size(); Level++)
+	{
+		const D3D12_PLACED_SUBRESOURCE_FOOTPRINT& Footprint = Footprints[Level];
+
+		UINT RowHeight, NumRows;
+		Texture_Level_Rows(Footprint, RowHeight, NumRows);
+
+		UINT64 RowBytes = Footprint.Footprint.RowPitch;
+		UINT64 LevelBytes = NumRows * RowBytes;
+		UINT64 Pos = Offset + Copied;
+
+		if (Pos < Segment + LevelBytes)
+		{
+			UINT Row0 = (UINT)((Pos - Segment) / RowBytes);
+			UINT64 FitRows = (MaxBytes - Copied) / RowBytes;
+			UINT Row1 = FitRows < NumRows - Row0 ? Row0 + (UINT)FitRows : NumRows;
+
+			if (Row1 == Row0)
+				return Copied;
+
+			CD3DX12_TEXTURE_COPY_LOCATION Dst(SceneTex->Resource.Get(), Level);
+			CD3DX12_TEXTURE_COPY_LOCATION Src(Staging.TextureUpload.Resource, Footprint);
+
+			if (Row0 == 0 && Row1 == NumRows)
+			{
+				m_StreamCommandList->CopyTextureRegion(&Dst, 0, 0, 0, &Src, nullptr);
+			}
+			else
+			{
+				UINT Top = Row0 * RowHeight;
+				UINT Bottom = Row1 * RowHeight;
+				if (Bottom > Footprint.Footprint.Height)
+					Bottom = Footprint.Footprint.Height;
+
+				D3D12_BOX Box = { 0, Top, 0, Footprint.Footprint.Width, Bottom, 1 };
+				m_StreamCommandList->CopyTextureRegion(&Dst, 0, Top, 0, &Src, &Box);
+			}
+
+			Copied += (Row1 - Row0) * RowBytes;
+
+			if (Row1 < NumRows)
+				return Copied;
+		}
+
+		Segment += LevelBytes;
+	}
 
-		// BMP      
-		FILE* Fp = NULL;
-		fopen_s(&Fp, Filename[j].c_str(), "rb");
-		if (Fp == NULL)
-			MessageBox(NULL, L"Error Open File", L"INFO", MB_OK);
+	return Copied;
+}
 
-		//   
-		BITMAPFILEHEADER Bfh;
-		fread(&Bfh, sizeof(BITMAPFILEHEADER), 1, Fp);
+void CMeshManager::Finish_Room_Upload(int j, bool Loaded)
+{
+	if (!Loaded)
+	{
+		MessageBox(NULL, L"Error Open Room File", L"INFO", MB_OK);
+		return;
+	}
 
-		//   
-		BITMAPINFOHEADER Bih;
-		fread(&Bih, sizeof(BITMAPINFOHEADER), 1, Fp);
+	MeshGeometry* Geo = m_Scene[j].get();
+	ID3D12Resource* SceneTex = Geo->Textures["SceneMeshTex"]->Resource.Get();
 
-		//   BMP    
-		fseek(Fp, Bfh.bfOffBits, SEEK_SET);
+	D3D12_RESOURCE_BARRIER Barriers[] =
+	{
+		CD3DX12_RESOURCE_BARRIER::Transition(Geo->VertexBufferGPU.Get(),
+			D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ),
+		CD3DX12_RESOURCE_BARRIER::Transition(Geo->IndexBufferGPU.Get(),
+			D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ),
+		CD3DX12_RESOURCE_BARRIER::Transition(SceneTex,
+			D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE)
+	};
 
-		//      BMP 
-		unsigned char* ResTemp;
-		ResTemp = new unsigned char[Bih.biHeight * Bih.biWidth * 4];
-		//   rgb  
-		fread(ResTemp, Bih.biHeight * Bih.biWidth * 4, 1, Fp);
+	m_StreamCommandList->ResourceBarrier(_countof(Barriers), Barriers);
+
+	// SRV        
+	Create_Scene_Srv(j, SceneTex);
+
+	//        ,
+	//       
+	RenderItem* Ritem = m_AllRitems[j].get();
+	Ritem->VertexCount = Geo->DrawArgs.VertexCount;
+	Ritem->IndexCount = Geo->DrawArgs.IndexCount;
+	Ritem->StartIndexLocation = Geo->DrawArgs.StartIndexLocation;
+	Ritem->BaseVertexLocation = Geo->DrawArgs.BaseVertexLocation;
+	Ritem->Visible = true;
+
+	//  Update_Room_Streaming   ,
+	//     upload   
+	RoomStaging& Staging = m_RoomStaging[j];
+	m_UploadRing.Retire(Staging.VertexUpload, m_FrameScheduler.Current_Fence() + 1);
+	m_UploadRing.Retire(Staging.IndexUpload, m_FrameScheduler.Current_Fence() + 1);
+	m_UploadRing.Retire(Staging.TextureUpload, m_FrameScheduler.Current_Fence() + 1);
+}
 
-		//   
-		fclose(Fp);
+void CMeshManager::Update_Room_Streaming()
+{
+	// ,   GPU  
+	m_UploadRing.Reclaim();
 
-		TextureWidth = Bih.biWidth;
-		TextureHeight = Bih.biHeight;
+	if (!m_RoomStreamer.Has_Uploads())
+		return;
 
-		unsigned char* Res = new unsigned char[TextureWidth * TextureHeight * 4];
+	//  FrameResource  ,  
+	auto CmdListAlloc = m_CurrFrameResource->StreamCmdListAlloc;
 
-		for (UINT h = 0; h < TextureHeight; h++)
-		{
-			for (UINT w = 0; w < TextureWidth; w++)
-			{
-				int Index1 = (h * TextureWidth + w) * 4;
-				int Index2 = ((TextureHeight - 1 - h) * TextureWidth + w) * 4;
+	ThrowIfFailed(CmdListAlloc->Reset());
+	ThrowIfFailed(m_StreamCommandList->Reset(CmdListAlloc.Get(), nullptr));
 
-				// RGB 
-				// BMP   
-				Res[Index2 + 0] = ResTemp[Index1 + 2];
-				Res[Index2 + 1] = ResTemp[Index1 + 1];
-				Res[Index2 + 2] = ResTemp[Index1 + 0];
-				Res[Index2 + 3] = ResTemp[Index1 + 3];
+	StreamBudget Budget = { STREAM_UPLOAD_BYTES, STREAM_UPLOAD_MS };
+	m_RoomStreamer.Process_Uploads(Budget);
 
-			}
-		}
+	ThrowIfFailed(m_StreamCommandList->Close());
 
-		SceneTex->Resource = CreateTexture(m_d3dDevice.Get(),
-			m_CommandList.Get(), Res, TextureWidth * TextureHeight * 4, SceneTex->UploadHeap);
+	ID3D12CommandList* cmdsLists[] = { m_StreamCommandList.Get() };
+	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
 
-		delete[] Res;
+	m_FrameScheduler.Signal();
 
-		m_Scene[j]->Textures[SceneTex->Name] = std::move(SceneTex);
+	if (m_RoomStreamer.Is_Complete())
+	{
+		m_RoomStreamer.Report("Room streaming");
+		m_UploadRing.Report("Upload ring");
+		m_HeapAllocator.Report("Default heap");
+		Asset_Cache_Report();
 	}
 }
 
-Microsoft::WRL::ComPtr<ID3D12Resource> CMeshManager::CreateTexture(
-	ID3D12Device* device,
-	ID3D12GraphicsCommandList* cmdList,
-	const void* initData,
-	UINT64 byteSize,
-	Microsoft::WRL::ComPtr<ID3D12Resource>& UploadBuffer)
+void CMeshManager::Create_ShaderResource_Heap_And_View_Pass1()
 {
-	Microsoft::WRL::ComPtr<ID3D12Resource> m_Texture;
-	
-	D3D12_RESOURCE_DESC textureDesc = {};
-	textureDesc.MipLevels = 1;
-	textureDesc.Format = m_BackBufferFormat;
-	textureDesc.Width = TextureWidth;
-	textureDesc.Height = TextureHeight;
-	textureDesc.Flags = D3D12_RESOURCE_FLAG_NONE;
-	textureDesc.DepthOrArraySize = 1;
-	textureDesc.SampleDesc.Count = 1;
-	textureDesc.SampleDesc.Quality = 0;
-	textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+	//   ,      
+	if (!m_Descriptors.Allocate(MeshNums, m_SceneSrv) ||
+		!m_StagingDescriptors.Allocate(MeshNums, m_SceneSrvStaging))
+		ThrowIfFailed(E_OUTOFMEMORY);
+
+#ifdef TEXTURE_ARRAY_ROOMS
+	//  Texture2DArray    SRV  
+	//  .      
+	//  
+#ifdef STREAM_ROOM_ASSETS
+	//SRV      
+	for (int j = 0; j < MeshNums; j++)
+		m_Scene[j]->SrvIndex = j;
 
-	ThrowIfFailed(device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-		D3D12_HEAP_FLAG_NONE,
-		&textureDesc,
-		//D3D12_RESOURCE_STATE_COPY_DEST,
-		D3D12_RESOURCE_STATE_COMMON,
-		nullptr,
-		IID_PPV_ARGS(m_Texture.GetAddressOf())));
+	return;
+#endif
 
-	const UINT64 UploadBufferSize = GetRequiredIntermediateSize(m_Texture.Get(), 0, 1);
+	for (int j = 0; j < MeshNums; j++)
+	{
+		m_Scene[j]->SrvIndex = m_RoomTexturePack ? 0 : j;
 
-	ThrowIfFailed(device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(UploadBufferSize),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(&UploadBuffer)));
+		if (m_RoomTexturePack && j > 0)
+			continue;
 
-	D3D12_SUBRESOURCE_DATA textureData = {};
-	textureData.pData = initData;
-	textureData.RowPitch = TextureWidth * 4;
-	textureData.SlicePitch = textureData.RowPitch * TextureHeight;
+		Create_Scene_Srv(j, m_RoomTexturePack ? m_RoomTexturePack.Get() :
+			m_Scene[j]->Textures["SceneMeshTex"]->Resource.Get());
+	}
 
-	cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_Texture.Get(),
-		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST));
-	
-	UpdateSubresources(cmdList, m_Texture.Get(), UploadBuffer.Get(), 0, 0, 1, &textureData);
+	return;
+#endif
 
-	cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_Texture.Get(),
-		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+#ifdef STREAM_ROOM_ASSETS
+	return;
+#endif
 
-	return m_Texture;
+	for (int j = 0; j < MeshNums; j++)
+		Create_Scene_Srv(j, m_Scene[j]->Textures["SceneMeshTex"]->Resource.Get());
 }
 
-void CMeshManager::Create_ShaderResource_Heap_And_View_Pass1()
+void CMeshManager::Create_Scene_Srv(int j, ID3D12Resource* Resource)
 {
-	D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-	srvHeapDesc.NumDescriptors = MeshNums;
-	srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	ThrowIfFailed(m_d3dDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&m_SrvDescriptorHeap)));
-
-	for (int j = 0; j < MeshNums; j++)
-	{
-
-
-		CD3DX12_CPU_DESCRIPTOR_HANDLE hDescriptor(m_SrvDescriptorHeap->GetCPUDescriptorHandleForHeapStart());
-		hDescriptor.Offset(j, m_CbvSrvUavDescriptorSize);
+	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
+	srvDesc.Format = Resource->GetDesc().Format;
 
-		auto SceneMeshTex = m_Scene[j]->Textures["SceneMeshTex"]->Resource;
+#ifdef TEXTURE_ARRAY_ROOMS
+	UINT Slot = m_Scene[j]->SrvIndex;
 
-		D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
-		srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
-		srvDesc.Format = SceneMeshTex->GetDesc().Format;
-		srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
-		srvDesc.Texture2D.MostDetailedMip = 0;
-		srvDesc.Texture2D.MipLevels = SceneMeshTex->GetDesc().MipLevels;
-		srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2DARRAY;
+	srvDesc.Texture2DArray.MostDetailedMip = 0;
+	srvDesc.Texture2DArray.MipLevels = Resource->GetDesc().MipLevels;
+	srvDesc.Texture2DArray.FirstArraySlice = 0;
+	srvDesc.Texture2DArray.ArraySize = Resource->GetDesc().DepthOrArraySize;
+	srvDesc.Texture2DArray.ResourceMinLODClamp = 0.0f;
+#else
+	UINT Slot = j;
 
-		m_d3dDevice->CreateShaderResourceView(SceneMeshTex.Get(), &srvDesc, hDescriptor);
-	}
+	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
+	srvDesc.Texture2D.MostDetailedMip = 0;
+	srvDesc.Texture2D.MipLevels = Resource->GetDesc().MipLevels;
+	srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
+#endif
 
+	//  CPU      
+	m_d3dDevice->CreateShaderResourceView(Resource, &srvDesc, m_SceneSrvStaging.Cpu_At(Slot));
+	m_Descriptors.Copy(m_SceneSrv, Slot, m_SceneSrvStaging.Cpu_At(Slot), 1);
 }
 
 void CMeshManager::Create_Main_RenderTargetHeap_And_View_Pass2()
@@ -457,13 +1286,8 @@ void CMeshManager::Create_Main_RenderTargetHeap_And_View_Pass2()
 
 void CMeshManager::Create_ShaderRVHeap_And_View_Pass2()
 {
-	D3D12_DESCRIPTOR_HEAP_DESC srvHeapDesc = {};
-	srvHeapDesc.NumDescriptors = 1;
-	srvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	srvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	ThrowIfFailed(m_d3dDevice->CreateDescriptorHeap(&srvHeapDesc, IID_PPV_ARGS(&m_SrvDescriptorHeapSAQ)));
-
-	CD3DX12_CPU_DESCRIPTOR_HANDLE hDescriptor1(m_SrvDescriptorHeapSAQ->GetCPUDescriptorHandleForHeapStart());
+	if (!m_Descriptors.Allocate(1, m_SaqSrv))
+		ThrowIfFailed(E_OUTOFMEMORY);
 
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
@@ -473,89 +1297,117 @@ void CMeshManager::Create_ShaderRVHeap_And_View_Pass2()
 	srvDesc.Texture2D.MipLevels = m_RenderTargetTex->GetDesc().MipLevels;
 	srvDesc.Texture2D.ResourceMinLODClamp = 0.0f;
 
-	m_d3dDevice->CreateShaderResourceView(m_RenderTargetTex.Get(), &srvDesc, hDescriptor1);
+	m_d3dDevice->CreateShaderResourceView(m_RenderTargetTex.Get(), &srvDesc, m_SaqSrv.Cpu);
 }
 
 void CMeshManager::Create_Mesh_Shaders_And_InputLayout_Pass1()
 {
-	m_VsByteCode = d3dUtil::CompileShader(L"Shaders\\tex.hlsl", nullptr, "VS", "vs_5_0");
-	m_PsByteCode = d3dUtil::CompileShader(L"Shaders\\tex.hlsl", nullptr, "PS", "ps_5_0");
+	std::vector<D3D_SHADER_MACRO> Defines;
+#ifdef COMPACT_VERTEX_FORMAT
+	Defines.push_back({ "COMPACT_VERTEX_FORMAT", "1" });
+#endif
+#ifdef TEXTURE_ARRAY_ROOMS
+	Defines.push_back({ "TEXTURE_ARRAY_ROOMS", "1" });
+#endif
+#ifdef ROOT_CONSTANT_BINDING
+	Defines.push_back({ "ROOT_CONSTANT_BINDING", "1" });
+#endif
+	Defines.push_back({ nullptr, nullptr });
 
+	m_VsByteCode = d3dUtil::CompileShader(L"Shaders\\tex.hlsl", Defines.data(), "VS", "vs_5_0");
+	m_PsByteCode = d3dUtil::CompileShader(L"Shaders\\tex.hlsl", Defines.data(), "PS", "ps_5_0");
+
+#ifdef COMPACT_VERTEX_FORMAT
+	m_InputLayout =
+	{
+		{ "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+		{ "TEXCOORD", 0, DXGI_FORMAT_R16G16_FLOAT, 0, 8, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+	};
+#else
 	m_InputLayout =
 	{
 		{ "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
 		{ "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
 	};
+#endif
 }
 
 void CMeshManager::Create_Mesh_Geometry_Pass1()
 {
-	ThrowIfFailed(m_CommandList->Reset(m_DirectCmdListAlloc.Get(), nullptr));
-
-	std::vector<std::string> Filename = {
-		".\\Rooms\\room0.txt",
-		".\\Rooms\\room1.txt",
-		".\\Rooms\\room2.txt",
-		".\\Rooms\\room3.txt",
-		".\\Rooms\\room4.txt",
-		".\\Rooms\\room5.txt",
-		".\\Rooms\\room6.txt",
-		".\\Rooms\\room7.txt",
-		".\\Rooms\\room8.txt",
-		".\\Rooms\\room9.txt",
-		".\\Rooms\\room10.txt",
-		".\\Rooms\\room11.txt" };
-	
-	for ( UINT j = 0; j < Filename.size(); j++)
+	for (int j = 0; j < MeshNums; j++)
 	{
+		RoomStaging& Staging = m_RoomStaging[j];
+
+		//    : render item, 
+		// SRV     m_Scene[j]
+		if (!Staging.RoomLoaded)
+		{
+			MessageBox(NULL, L"Error Open Room File", L"INFO", MB_OK);
+			ThrowIfFailed(E_FAIL);
+		}
 
-		FILE* f;
-		fopen_s(&f, Filename[j].c_str(), "rt");
+		const UINT IbByteSize = Staging.Room.IndexBufferByteSize();
 
-		char Buffer[1024];
+		m_Scene[j] = std::make_unique<MeshGeometry>();
+		m_Scene[j]->Name = "Scene";
 
-		//   
-		fgets(Buffer, 1024, f);
+		auto SceneTex = std::make_unique<Texture>();
+		SceneTex->Name = "SceneMeshTex";
+		SceneTex->Filename = Staging.TextureFilename;
+		m_Scene[j]->Textures[SceneTex->Name] = std::move(SceneTex);
 
-		//  
-		fgets(Buffer, 1024, f);
+#ifdef COMPACT_VERTEX_FORMAT
+		//    , UV  half float
+		QuantizeBounds Bounds;
+		Compute_Quantize_Bounds(Staging.Room.Vertices(), Staging.Room.VertexCount(), sizeof(Vertex), Bounds);
 
-		//  
-		int Size;
-		sscanf_s(Buffer, "%d", &Size);
+		std::vector<VertexCompact> Compact(Staging.Room.VertexCount());
+		Quantize_Pos_Tex(Staging.Room.Vertices(), Staging.Room.VertexCount(), sizeof(Vertex), Bounds, Compact.data());
 
-		std::vector<Vertex> Vertices;
-		Vertices.resize(Size);
+		const UINT VbByteSize = (UINT)Compact.size() * sizeof(VertexCompact);
 
-		for (int i = 0; i < Size; i++)
-		{
-			fgets(Buffer, 1024, f);
-			sscanf_s(Buffer, "%f;%f;%f;%f;%f", &Vertices[i].Pos.x,
-				&Vertices[i].Pos.y,
-				&Vertices[i].Pos.z,
-				&Vertices[i].Tex.x,
-				&Vertices[i].Tex.y);
-		}
+		m_Scene[j]->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
+			Compact.data(), VbByteSize, m_UploadBatch, m_HeapAllocator);
 
-		fclose(f);
+		m_Scene[j]->VertexByteStride = sizeof(VertexCompact);
+		m_Scene[j]->PosScale = DirectX::XMFLOAT4(Bounds.Extent[0], Bounds.Extent[1], Bounds.Extent[2], 0.0f);
+		m_Scene[j]->PosBias = DirectX::XMFLOAT4(Bounds.Min[0], Bounds.Min[1], Bounds.Min[2], 0.0f);
 
-		const UINT VbByteSize = (UINT)Vertices.size() * sizeof(Vertex);
+		//  CPU    
+		QuantizeError Error = Verify_Quantize_Pos_Tex(Staging.Room.Vertices(), Staging.Room.VertexCount(),
+			sizeof(Vertex), Bounds, Compact.data());
 
-		m_Scene[j] = std::make_unique<MeshGeometry>();
-		m_Scene[j]->Name = "Scene";
+		char Buffer[256];
+		sprintf_s(Buffer, "Room %d: compact VB %u -> %u bytes, max pos error %.4f, max uv error %.6f%s\n", j,
+			Staging.Room.VertexBufferByteSize(), VbByteSize, Error.MaxPosError, Error.MaxAttrError,
+			Error.PosInTolerance ? "" : " (OUT OF TOLERANCE)");
+		OutputDebugStringA(Buffer);
+#else
+		const UINT VbByteSize = Staging.Room.VertexBufferByteSize();
 
+		//       
 		m_Scene[j]->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
-			m_CommandList.Get(), Vertices.data(), VbByteSize, m_Scene[j]->VertexBufferUploader);
+			Staging.Room.Vertices(), VbByteSize, m_UploadBatch, m_HeapAllocator);
 
 		m_Scene[j]->VertexByteStride = sizeof(Vertex);
+#endif
+
+		m_Scene[j]->IndexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
+			Staging.Room.Indices(), IbByteSize, m_UploadBatch, m_HeapAllocator);
+
 		m_Scene[j]->VertexBufferByteSize = VbByteSize;
+		m_Scene[j]->IndexFormat = Staging.Room.IndexSize() == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+		m_Scene[j]->IndexBufferByteSize = IbByteSize;
 
 		SubmeshGeometry submesh;
-		submesh.VertexCount = (UINT)Vertices.size();
+		submesh.VertexCount = Staging.Room.VertexCount();
+		submesh.IndexCount = Staging.Room.IndexCount();
 		submesh.StartIndexLocation = 0;
 		submesh.BaseVertexLocation = 0;
 
 		m_Scene[j]->DrawArgs = submesh;
+
+		Staging.Room.Close();
 	}
 }
 
@@ -567,14 +1419,20 @@ void CMeshManager::Create_Render_Items()
 
 		//XMStoreFloat4x4(&boxRitem->World, DirectX::XMMatrixScaling(1.0f, 1.0f, 1.0f) * DirectX::XMMatrixTranslation(0.0f, 0.0f, 0.0f));
 		boxRitem->World = Identity4x4();
-		boxRitem->ObjCBIndex = 0;
+		//       
 		boxRitem->Geo = m_Scene[i].get();
 		boxRitem->PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 		//boxRitem->PrimitiveType = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 		boxRitem->VertexCount = m_Scene[i]->DrawArgs.VertexCount;
+		boxRitem->IndexCount = m_Scene[i]->DrawArgs.IndexCount;
 		boxRitem->StartIndexLocation = m_Scene[i]->DrawArgs.StartIndexLocation;
 		boxRitem->BaseVertexLocation = m_Scene[i]->DrawArgs.BaseVertexLocation;
 
+#ifdef STREAM_ROOM_ASSETS
+		//     
+		boxRitem->Visible = false;
+#endif
+
 		m_AllRitems.push_back(std::move(boxRitem));
 
 	}
@@ -584,96 +1442,73 @@ void CMeshManager::Create_Frame_Resources()
 {
 	for (int i = 0; i < m_NumFrameResources; ++i)
 	{
-		m_FrameResources.push_back(std::make_unique<FrameResource>(m_d3dDevice.Get(),
-			1, (UINT)m_AllRitems.size()));
+		m_FrameResources.push_back(std::make_unique<FrameResource>(m_d3dDevice.Get()));
 	}
-}
-
-void CMeshManager::Create_ConstBuff_Descriptors_Heap_And_View()
-{
-	UINT objCount = (UINT)m_AllRitems.size();
-
-	//object constants  pass constants    
-	// objCount + 1
-	UINT numDescriptors = (objCount + 1) * m_NumFrameResources;
-
-	m_PassCbvOffset = objCount * m_NumFrameResources;
-
-	D3D12_DESCRIPTOR_HEAP_DESC cbvHeapDesc;
-	cbvHeapDesc.NumDescriptors = numDescriptors;
-	cbvHeapDesc.Type = D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV;
-	cbvHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
-	cbvHeapDesc.NodeMask = 0;
-	ThrowIfFailed(m_d3dDevice->CreateDescriptorHeap(&cbvHeapDesc,
-		IID_PPV_ARGS(&m_CbvHeap)));
 
-	UINT ObjCBByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(ObjectConstants));
-
-	for (int frameIndex = 0; frameIndex < m_NumFrameResources; ++frameIndex)
+#ifdef PARALLEL_RECORD
+	//  , Reset     Draw_MeshManager
+	for (UINT i = 0; i < RECORD_THREADS; i++)
 	{
-		auto objectCB = m_FrameResources[frameIndex]->ObjectCB->Resource();
-		for (UINT i = 0; i < objCount; ++i)
-		{
-			D3D12_GPU_VIRTUAL_ADDRESS cbAddress = objectCB->GetGPUVirtualAddress();
-
-			cbAddress += i * ObjCBByteSize;
-
-			int heapIndex = frameIndex * objCount + i;
-			auto handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_CbvHeap->GetCPUDescriptorHandleForHeapStart());
-			handle.Offset(heapIndex, m_CbvSrvUavDescriptorSize);
-
-			D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-			cbvDesc.BufferLocation = cbAddress;
-			cbvDesc.SizeInBytes = ObjCBByteSize;
-
-			m_d3dDevice->CreateConstantBufferView(&cbvDesc, handle);
-		}
+		ThrowIfFailed(m_d3dDevice->CreateCommandList(
+			0,
+			D3D12_COMMAND_LIST_TYPE_DIRECT,
+			m_FrameResources[0]->RecordCmdListAlloc[i].Get(),
+			nullptr,
+			IID_PPV_ARGS(m_RecordCommandList[i].GetAddressOf())));
+
+		m_RecordCommandList[i]->Close();
 	}
 
-	UINT passCBByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(PassConstants));
-
-	for (int frameIndex = 0; frameIndex < m_NumFrameResources; ++frameIndex)
-	{
-		auto passCB = m_FrameResources[frameIndex]->PassCB->Resource();
-		D3D12_GPU_VIRTUAL_ADDRESS cbAddress = passCB->GetGPUVirtualAddress();
-
-		int heapIndex = m_PassCbvOffset + frameIndex;
-		auto handle = CD3DX12_CPU_DESCRIPTOR_HANDLE(m_CbvHeap->GetCPUDescriptorHandleForHeapStart());
-		handle.Offset(heapIndex, m_CbvSrvUavDescriptorSize);
-
-		D3D12_CONSTANT_BUFFER_VIEW_DESC cbvDesc;
-		cbvDesc.BufferLocation = cbAddress;
-		cbvDesc.SizeInBytes = passCBByteSize;
+	ThrowIfFailed(m_d3dDevice->CreateCommandList(
+		0,
+		D3D12_COMMAND_LIST_TYPE_DIRECT,
+		m_FrameResources[0]->PostCmdListAlloc.Get(),
+		nullptr,
+		IID_PPV_ARGS(m_PostCommandList.GetAddressOf())));
 
-		m_d3dDevice->CreateConstantBufferView(&cbvDesc, handle);
-	}
+	m_PostCommandList->Close();
 
+	m_RecordPool = std::make_unique<CThreadPool>(RECORD_THREADS);
+	m_RecordCosts.resize(m_AllRitems.size());
+#endif
 }
 
 
+
 void CMeshManager::Create_RootSignature()
 {
-	CD3DX12_DESCRIPTOR_RANGE cbvTable0;
-	cbvTable0.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
-
-	CD3DX12_DESCRIPTOR_RANGE cbvTable1;
-	cbvTable1.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 1);
-
 	CD3DX12_DESCRIPTOR_RANGE srvTable;
 	srvTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
 
-	CD3DX12_ROOT_PARAMETER slotRootParameter[3];
+	CD3DX12_ROOT_PARAMETER slotRootParameter[ROOT_PARAM_COUNT];
 
-	slotRootParameter[0].InitAsDescriptorTable(1, &cbvTable0);
-	slotRootParameter[1].InitAsDescriptorTable(1, &cbvTable1);
-	slotRootParameter[2].InitAsDescriptorTable(1, &srvTable);
+	//     
+	slotRootParameter[ROOT_PARAM_OBJECT].InitAsConstantBufferView(0);
+	slotRootParameter[ROOT_PARAM_PASS].InitAsConstantBufferView(1);
+	slotRootParameter[ROOT_PARAM_SRV].InitAsDescriptorTable(1, &srvTable);
+
+#ifdef TEXTURE_ARRAY_ROOMS
+	//    , register(b2)
+	slotRootParameter[ROOT_PARAM_ROOM_TEXTURE].InitAsConstants(sizeof(RoomTextureConstants) / 4, 2);
+#endif
+
+#ifdef ROOT_CONSTANT_BINDING
+	//   , register(b3)
+	slotRootParameter[ROOT_PARAM_FOG].InitAsConstants(sizeof(FogConstants) / 4, 3);
+#endif
 
 	auto staticSamplers = GetStaticSamplers();
 
-	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(3, slotRootParameter,
+	CD3DX12_ROOT_SIGNATURE_DESC rootSigDesc(_countof(slotRootParameter), slotRootParameter,
 		(UINT)staticSamplers.size(), staticSamplers.data(),
 		D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT);
 
+	//root        draw,
+	// 64 DWORD   
+	RootSignatureCost Cost = Get_Root_Signature_Cost(rootSigDesc);
+	if (!Report_Root_Signature_Cost("Root signature", Cost))
+		ThrowIfFailed(E_INVALIDARG);
+
 	Microsoft::WRL::ComPtr<ID3DBlob> SerializedRootSig = nullptr;
 	Microsoft::WRL::ComPtr<ID3DBlob> ErrorBlob = nullptr;
 	HRESULT hr = D3D12SerializeRootSignature(&rootSigDesc, D3D_ROOT_SIGNATURE_VERSION_1,
@@ -807,7 +1642,7 @@ void CMeshManager::Create_ScreenAlignedQuad_Geometry_Pass2()
 	m_SQABuff->Name = "SAQ";
 	
 	m_SQABuff->VertexBufferGPU = d3dUtil::CreateDefaultBuffer(m_d3dDevice.Get(),
-		m_CommandList.Get(), VerticesSAQ.data(), vbSAQByteSize, m_SQABuff->VertexBufferUploader);
+		VerticesSAQ.data(), vbSAQByteSize, m_UploadBatch, m_HeapAllocator);
 
 	m_SQABuff->VertexByteStride = sizeof(VertexSAQ);
 	m_SQABuff->VertexBufferByteSize = vbSAQByteSize;
@@ -867,18 +1702,35 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 
 	CreateFence_GetDescriptorsSize();
 
+	m_Descriptors.Init(m_d3dDevice.Get(), true, DESCRIPTOR_PERSISTENT_COUNT, DESCRIPTOR_TRANSIENT_COUNT);
+	m_StagingDescriptors.Init(m_d3dDevice.Get(), false, DESCRIPTOR_STAGING_COUNT, 0);
+
+	m_UploadRing.Init(m_d3dDevice.Get(), m_Fence.Get(), UPLOAD_RING_SIZE);
+
+	m_HeapAllocator.Init(m_d3dDevice.Get(), HEAP_PAGE_SIZE);
+	m_UploadBatch.Init(&m_UploadRing);
+
 	Check_Multisample_Quality();
 
 	Create_CommandList_Allocator_Queue();
 
+	m_FrameScheduler.Init(m_CommandQueue.Get(), m_Fence.Get(), m_NumFrameResources);
+	m_FrameScheduler.Set_Frames_In_Flight(FRAMES_IN_FLIGHT);
+
+#ifdef FRAME_SCHEDULER_VERIFY
+	Verify_Frame_Scheduler();
+#endif
+
+#ifdef FRAME_PACING_VERIFY
+	Verify_Frame_Pacing();
+#endif
+
 	Create_SwapChain();
 
 	Resize_SwapChainBuffers();
 
 	Create_Dsv_DescriptorHeaps_And_View();
 
-	Execute_Init_Commands();
-
 	Update_ViewPort_And_Scissor();
 
 	Create_RenderTargetHeap_And_View_For_Pass1();
@@ -889,17 +1741,73 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 
 	Create_Mesh_Shaders_And_InputLayout_Pass1();
 
+	//   ,     
+	m_WorkerPool = std::make_unique<CThreadPool>();
+
+#ifdef UPLOAD_RING_VERIFY
+	Verify_Ring_Allocator();
+#endif
+
+#ifdef HEAP_ALLOCATOR_VERIFY
+	Verify_Tlsf_Allocator();
+#endif
+
+#ifdef HEAP_ALLOCATOR_BENCHMARK
+	Benchmark_Tlsf_Allocator();
+#endif
+
+#ifdef LINEAR_ALLOCATOR_VERIFY
+	Verify_Linear_Allocator();
+#endif
+
+#ifdef DESCRIPTOR_ALLOCATOR_VERIFY
+	Verify_Descriptor_Allocator();
+#endif
+
+#ifdef COMMAND_STATE_VERIFY
+	Verify_Command_List_State();
+#endif
+
+#ifdef ROOT_SIGNATURE_VERIFY
+	Verify_Root_Signature_Cost();
+#endif
+
+#ifdef RECORD_PARTITION_VERIFY
+	Verify_Record_Partition();
+#endif
+
+#ifdef PARALLEL_RECORD_BENCHMARK
+	Benchmark_Parallel_Record(4096, RECORD_THREADS, 0.2);
+#endif
+
+#ifdef ASSET_STREAMER_VERIFY
+	Verify_Asset_Streamer(m_WorkerPool.get());
+#endif
+
+#ifdef STREAM_ROOM_ASSETS
+	//      
+	Create_Streaming_Rooms();
+#else
+	double Time0 = Get_Time_Ms();
+
+	Load_Scene_Assets();
+
+	double Time1 = Get_Time_Ms();
+
 	Create_Mesh_Geometry_Pass1();
 
+	double Time2 = Get_Time_Ms();
+
 	LoadTextures();
 
-	Create_ShaderResource_Heap_And_View_Pass1();
+	double Time3 = Get_Time_Ms();
+#endif
 
 	Create_Render_Items();
 
 	Create_Frame_Resources();
 
-	Create_ConstBuff_Descriptors_Heap_And_View();
+	Create_ShaderResource_Heap_And_View_Pass1();
 
 	Create_RootSignature();
 
@@ -911,8 +1819,27 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 
 	Create_PipelineStateObject_Pass2();
 
+	double Time4 = Get_Time_Ms();
+
 	Execute_Init_Commands();
 
+	double Time5 = Get_Time_Ms();
+
+	m_UploadBatch.Report("Init upload");
+
+#ifdef STREAM_ROOM_ASSETS
+	Start_Room_Streaming();
+#else
+	Asset_Cache_Report();
+	m_UploadRing.Report("Upload ring");
+	m_HeapAllocator.Report("Default heap");
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Init: load rooms/textures %.2f ms (%u threads), record rooms %.2f ms, record textures %.2f ms, GPU upload %.2f ms\n",
+		Time1 - Time0, m_WorkerPool->Get_Num_Threads(), Time2 - Time1, Time3 - Time2, Time5 - Time4);
+	OutputDebugStringA(Buffer);
+#endif
+
 	DirectX::XMVECTOR Pos = DirectX::XMVectorSet(25.0f, 5.0f, -5000.0f, 1.0f);
 	//DirectX::XMVECTOR Target = DirectX::XMVectorZero();
 	DirectX::XMVECTOR Target = DirectX::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
@@ -924,13 +1851,37 @@ void CMeshManager::Init_MeshManager(HWND hWnd)
 	DirectX::XMMATRIX MatProj = DirectX::XMMatrixPerspectiveFovLH(0.25f * DirectX::XM_PI, 4.0f / 3.0f, 1.0f, 50000.0f);
 	XMStoreFloat4x4(&m_Proj, MatProj);
 	
+#ifdef TIMER_LIMITER_BENCHMARK
+	Benchmark_Frame_Limiter(30.0f, 90, 2.0);
+#endif
+
 	m_Timer.Timer_Start(30);
+
+#ifdef FRAME_STATS_VERIFY
+	Verify_Frame_Stats();
+#endif
+
+#ifdef FRAME_STATS_BENCHMARK
+	Benchmark_Frame_Stats();
+#endif
+
+#if FRAME_STATS_EXPORT_SECONDS > 0
+	m_FrameStats.Start_Export(FRAME_STATS_EXPORT_NAME, FRAME_STATS_EXPORT_SECONDS);
+#endif
 }
 
 void CMeshManager::Update_MeshManager()
 {
+	m_FrameStats.Begin_Frame();
+
+	//    swap chain   ,  LOW_LATENCY
+	//     
+	m_FramePacer.Wait_Frame();
+
 	m_Timer.Calculate_FPS();
 	float ElapsedTime = m_Timer.Get_Elapsed_Time();
+	m_FramePacer.Input_Sampled();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
 
 	DirectX::XMMATRIX World = XMLoadFloat4x4(&m_World);
 	DirectX::XMMATRIX Proj = XMLoadFloat4x4(&m_Proj);
@@ -939,169 +1890,252 @@ void CMeshManager::Update_MeshManager()
 	//    
 	DirectX::XMMATRIX ViewProj = MatView * Proj;
 
-	m_CurrFrameResourceIndex = (m_CurrFrameResourceIndex + 1) % m_NumFrameResources;
+	m_FrameStats.Phase_End(FRAME_PHASE_UPDATE);
+
+	//,  GPU    
+	m_CurrFrameResourceIndex = m_FrameScheduler.Begin_Frame();
+	m_FrameStats.Phase_End(FRAME_PHASE_WAIT);
 	m_CurrFrameResource = m_FrameResources[m_CurrFrameResourceIndex].get();
 
-	if (m_CurrFrameResource->Fence != 0 && m_Fence->GetCompletedValue() < m_CurrFrameResource->Fence)
-	{
-		HANDLE eventHandle = CreateEventEx(nullptr, false, false, EVENT_ALL_ACCESS);
-		ThrowIfFailed(m_Fence->SetEventOnCompletion(m_CurrFrameResource->Fence, eventHandle));
-		WaitForSingleObject(eventHandle, INFINITE);
-		CloseHandle(eventHandle);
-	}
+#ifdef STREAM_ROOM_ASSETS
+	Update_Room_Streaming();
+#endif
+
+	//   
+	m_Descriptors.Begin_Frame(m_FrameScheduler.Completed_Fence());
 
-	auto currObjectCB = m_CurrFrameResource->ObjectCB.get();
+	//GPU  ,     
+	CLinearAllocator& Constants = m_CurrFrameResource->Constants;
+	Constants.Reset();
 
 	for (auto& e : m_AllRitems)
 	{
+		//       
+		if (!e->Visible)
+			continue;
+
 		//if (e->NumFramesDirty > 0)
 		{
 			//DirectX::XMMATRIX World = XMLoadFloat4x4(&e->World);
 
 			ObjectConstants ObjConstants;
 			DirectX::XMStoreFloat4x4(&ObjConstants.World, DirectX::XMMatrixTranspose(World));
+			ObjConstants.PosScale = e->Geo->PosScale;
+			ObjConstants.PosBias = e->Geo->PosBias;
 		
-			currObjectCB->CopyData(e->ObjCBIndex, ObjConstants);
+			e->ObjCBAddress = Constants.Push(ObjConstants);
 
 			//e->NumFramesDirty--;
 		}
 	}
 
-	auto currPassCB = m_CurrFrameResource->PassCB.get();
-
 	PassConstants ObjConstants;
 	DirectX::XMStoreFloat4x4(&ObjConstants.ViewProj, DirectX::XMMatrixTranspose(ViewProj));
 	DirectX::XMStoreFloat3(&ObjConstants.VecCamPos, m_Camera.VecCamPos);
-	currPassCB->CopyData(0, ObjConstants);
+
+	m_PassCBAddress = Constants.Push(ObjConstants);
 }
 
 D3D12_CPU_DESCRIPTOR_HANDLE CMeshManager::GetCurrentSrvView(int Num)
 {
-	return CD3DX12_CPU_DESCRIPTOR_HANDLE(
-		m_SrvDescriptorHeap->GetCPUDescriptorHandleForHeapStart(),
-		Num,
-		m_CbvSrvUavDescriptorSize);
+	return m_SceneSrv.Cpu_At(Num);
 }
 
-void CMeshManager::DrawRenderItems_Scene(ID3D12GraphicsCommandList* CmdList, const std::vector<std::unique_ptr<RenderItem>>& Ritems)
+void CMeshManager::Set_Scene_Pass_State(ID3D12GraphicsCommandList* CmdList, CCommandListState& CmdState)
 {
+	CmdList->RSSetViewports(1, &m_ScreenViewport);
+	CmdList->RSSetScissorRects(1, &m_ScissorRect);
 
-	//CmdList->SetGraphicsRootDescriptorTable(2, m_SrvDescriptorHeap->GetGPUDescriptorHandleForHeapStart());
+	CmdList->OMSetRenderTargets(1, &m_RTVTexHandle, true, &DepthStencilView());
 
-	UINT ObjCBByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(ObjectConstants));
+	CmdState.Set_Root_Signature(m_RootSignature.Get());
 
-	//auto ObjectCB = m_CurrFrameResource->ObjectCB->Resource();
+	//SRV   SRV    ,   
+	//    
+	CmdState.Set_Descriptor_Heap(m_Descriptors.Heap());
+
+	CmdState.Set_Root_Cbv(ROOT_PARAM_PASS, m_PassCBAddress);
+
+#ifdef ROOT_CONSTANT_BINDING
+	//8 DWORD    ,    
+	CmdState.Set_Root_Constants(ROOT_PARAM_FOG, sizeof(FogConstants) / 4, &m_Fog);
+#endif
+}
 
-	for (size_t i = 0; i < Ritems.size(); ++i)
+void CMeshManager::DrawRenderItems_Scene(CCommandListState& CmdState, const std::vector<std::unique_ptr<RenderItem>>& Ritems, UINT Begin, UINT End)
+{
+	//,   ,   
+	//, CmdState    .
+	//Ritems  ,     
+	for (UINT i = Begin; i < End; ++i)
 	{
 		auto ri = Ritems[i].get();
 
-		CmdList->IASetVertexBuffers(0, 1, &ri->Geo->VertexBufferView());
-		CmdList->IASetPrimitiveTopology(ri->PrimitiveType);
+		if (!ri->Visible)
+			continue;
+
+		CmdState.Set_Vertex_Buffer(ri->Geo->VertexBufferView());
+		CmdState.Set_Index_Buffer(ri->Geo->IndexBufferView());
+		CmdState.Set_Topology(ri->PrimitiveType);
+
+		CmdState.Set_Root_Cbv(ROOT_PARAM_OBJECT, ri->ObjCBAddress);
+
+#ifdef TEXTURE_ARRAY_ROOMS
+		// Texture2DArray   SRV    
+		CmdState.Set_Root_Table(ROOT_PARAM_SRV, m_SceneSrv.Gpu_At(ri->Geo->SrvIndex));
+		CmdState.Set_Root_Constants(ROOT_PARAM_ROOM_TEXTURE, sizeof(RoomTextureConstants) / 4, &ri->Geo->TexConstants);
+#else
+		CmdState.Set_Root_Table(ROOT_PARAM_SRV, m_SceneSrv.Gpu_At(i));
+#endif
+
+		CmdState.Draw_Indexed(ri->IndexCount, ri->StartIndexLocation, ri->BaseVertexLocation);
+	}
+}
+
+void CMeshManager::Draw_Screen_Pass(ID3D12GraphicsCommandList* CmdList, CCommandListState& CmdState)
+{
+	CmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_RenderTargetTex.Get(),
+		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+
+	//PASS2
+	//Render Screen Alighed Quad
+	//------------------------------------------
+
+	CmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
+		D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
 
-		UINT cbvIndex = m_CurrFrameResourceIndex * (UINT)m_AllRitems.size() + ri->ObjCBIndex;
-		auto cbvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_CbvHeap->GetGPUDescriptorHandleForHeapStart());
-		cbvHandle.Offset(cbvIndex, m_CbvSrvUavDescriptorSize);
+	CmdState.Set_Pipeline_State(m_PSOSAQ.Get());
 
-		ID3D12DescriptorHeap* DescriptorHeapsCbv[] = { m_CbvHeap.Get() };
-		m_CommandList->SetDescriptorHeaps(_countof(DescriptorHeapsCbv), DescriptorHeapsCbv);
+	float ClearColor1[4] = { 0.0f, 0.125f, 0.3f, 1.0f };
+	CmdList->ClearRenderTargetView(CurrentBackBufferView(), ClearColor1, 0, nullptr);
+	CmdList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
 
-		CmdList->SetGraphicsRootDescriptorTable(0, cbvHandle);
+	CmdList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
 
-		ID3D12DescriptorHeap* descriptorHeapsSRV[] = { m_SrvDescriptorHeap.Get() };
-		m_CommandList->SetDescriptorHeaps(_countof(descriptorHeapsSRV), descriptorHeapsSRV);
+	//   root signature    ,   
+	CmdState.Set_Root_Signature(m_RootSignature.Get());
+	CmdState.Set_Descriptor_Heap(m_Descriptors.Heap());
 
-		CD3DX12_GPU_DESCRIPTOR_HANDLE hDescriptor(m_SrvDescriptorHeap->GetGPUDescriptorHandleForHeapStart());
-		hDescriptor.Offset(i, m_CbvSrvUavDescriptorSize);
+	CmdState.Set_Root_Table(ROOT_PARAM_SRV, m_SaqSrv.Gpu);
 
-		CmdList->SetGraphicsRootDescriptorTable(2, hDescriptor);
+	CmdState.Set_Vertex_Buffer(m_SQABuff->VertexBufferView());
+	CmdState.Set_Topology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
 
-		CmdList->DrawInstanced(
-			ri->VertexCount, 1, 0, 0);
-	}
+	// 4     2 
+	CmdState.Draw(4, 2);
+
+	CmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_RenderTargetTex.Get(),
+		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET));
+
+	CmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
+		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
 }
 
 void CMeshManager::Draw_MeshManager()
 {
+	m_FrameStats.Phase_End(FRAME_PHASE_UPDATE);
+
 	auto CmdListAlloc = m_CurrFrameResource->CmdListAlloc;
 
 	ThrowIfFailed(CmdListAlloc->Reset());
 
-	ThrowIfFailed(m_CommandList->Reset(CmdListAlloc.Get(), m_PSO.Get()));
+#ifdef PARALLEL_RECORD
+	//     ,    
+	//   -    
+	for (size_t i = 0; i < m_AllRitems.size(); i++)
+		m_RecordCosts[i] = m_AllRitems[i]->Visible ? 1 : 0;
 
-	m_CommandList->RSSetViewports(1, &m_ScreenViewport);
-	m_CommandList->RSSetScissorRects(1, &m_ScissorRect);
+	UINT NumChunks = Partition_Record_Chunks(m_RecordCosts.data(), (UINT)m_RecordCosts.size(),
+		RECORD_THREADS, RECORD_MIN_ITEMS_PER_LIST, m_RecordChunks);
 
-	//PASS1
-	//Draw scene to my RTV texture
-	//------------------------------
+	FrameResource* Frame = m_CurrFrameResource;
 
-	float ClearColor[4] = { 0.0f, 0.125f, 0.3f, 1.0f };
-	m_CommandList->ClearRenderTargetView(m_RTVTexHandle, ClearColor, 0, nullptr);
-	m_CommandList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+	Run_Record_Chunks(m_RecordPool.get(), m_RecordChunks, NumChunks, [this, Frame](const RecordChunk& Chunk, UINT Index)
+	{
+		ID3D12CommandAllocator* Alloc = Frame->RecordCmdListAlloc[Index].Get();
+		ID3D12GraphicsCommandList* CmdList = m_RecordCommandList[Index].Get();
+		CCommandListState& CmdState = m_RecordCmdState[Index];
 
-	m_CommandList->OMSetRenderTargets(1, &m_RTVTexHandle, true, &DepthStencilView());
+		ThrowIfFailed(Alloc->Reset());
+		ThrowIfFailed(CmdList->Reset(Alloc, m_PSO.Get()));
+		CmdState.Begin(CmdList, m_PSO.Get());
 
-	m_CommandList->SetGraphicsRootSignature(m_RootSignature.Get());
+		Set_Scene_Pass_State(CmdList, CmdState);
+		DrawRenderItems_Scene(CmdState, m_AllRitems, Chunk.Begin, Chunk.End);
 
-	
-	ID3D12DescriptorHeap* DescriptorHeapsCbv[] = { m_CbvHeap.Get() };
-	m_CommandList->SetDescriptorHeaps(_countof(DescriptorHeapsCbv), DescriptorHeapsCbv);
+		ThrowIfFailed(CmdList->Close());
+	},
+	[this, Frame, CmdListAlloc]()
+	{
+		//   :       
+		ThrowIfFailed(m_CommandList->Reset(CmdListAlloc.Get(), nullptr));
 
-	int PassCbvIndex = m_PassCbvOffset + m_CurrFrameResourceIndex;
-	auto passCbvHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(m_CbvHeap->GetGPUDescriptorHandleForHeapStart());
-	passCbvHandle.Offset(PassCbvIndex, m_CbvSrvUavDescriptorSize);
-	m_CommandList->SetGraphicsRootDescriptorTable(1, passCbvHandle);
+		float ClearColor[4] = { 0.0f, 0.125f, 0.3f, 1.0f };
+		m_CommandList->ClearRenderTargetView(m_RTVTexHandle, ClearColor, 0, nullptr);
+		m_CommandList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
 
-	DrawRenderItems_Scene(m_CommandList.Get(), m_AllRitems);
+		ThrowIfFailed(m_CommandList->Close());
 
-	m_CommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_RenderTargetTex.Get(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE));
+		ThrowIfFailed(Frame->PostCmdListAlloc->Reset());
+		ThrowIfFailed(m_PostCommandList->Reset(Frame->PostCmdListAlloc.Get(), m_PSOSAQ.Get()));
+		m_CmdState.Begin(m_PostCommandList.Get(), m_PSOSAQ.Get());
 
-	//PASS2
-	//Render Screen Alighed Quad
-	//------------------------------------------
+		m_PostCommandList->RSSetViewports(1, &m_ScreenViewport);
+		m_PostCommandList->RSSetScissorRects(1, &m_ScissorRect);
 
-	m_CommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
-		D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET));
+		Draw_Screen_Pass(m_PostCommandList.Get(), m_CmdState);
 
-	m_CommandList->SetPipelineState(m_PSOSAQ.Get());
+		ThrowIfFailed(m_PostCommandList->Close());
+	});
 
-	float ClearColor1[4] = { 0.0f, 0.125f, 0.3f, 1.0f };
-	m_CommandList->ClearRenderTargetView(CurrentBackBufferView(), ClearColor1, 0, nullptr);
-	m_CommandList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
+	m_FrameStats.Phase_End(FRAME_PHASE_RECORD);
 
-	m_CommandList->OMSetRenderTargets(1, &CurrentBackBufferView(), true, &DepthStencilView());
+	ID3D12CommandList* cmdsLists[RECORD_THREADS + 2];
+	UINT NumLists = 0;
 
-	m_CommandList->SetGraphicsRootSignature(m_RootSignature.Get());
+	cmdsLists[NumLists++] = m_CommandList.Get();
+	for (UINT i = 0; i < NumChunks; i++)
+		cmdsLists[NumLists++] = m_RecordCommandList[i].Get();
+	cmdsLists[NumLists++] = m_PostCommandList.Get();
 
-	ID3D12DescriptorHeap* descriptorHeapsSAQ[] = { m_SrvDescriptorHeapSAQ.Get() };
-	m_CommandList->SetDescriptorHeaps(_countof(descriptorHeapsSAQ), descriptorHeapsSAQ);
+	m_CommandQueue->ExecuteCommandLists(NumLists, cmdsLists);
+#else
+	ThrowIfFailed(m_CommandList->Reset(CmdListAlloc.Get(), m_PSO.Get()));
+	m_CmdState.Begin(m_CommandList.Get(), m_PSO.Get());
 
-	m_CommandList->SetGraphicsRootDescriptorTable(2, m_SrvDescriptorHeapSAQ->GetGPUDescriptorHandleForHeapStart());
+	//PASS1
+	//Draw scene to my RTV texture
+	//------------------------------
 
-	m_CommandList->IASetVertexBuffers(0, 1, &m_SQABuff->VertexBufferView());
-	m_CommandList->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+	float ClearColor[4] = { 0.0f, 0.125f, 0.3f, 1.0f };
+	m_CommandList->ClearRenderTargetView(m_RTVTexHandle, ClearColor, 0, nullptr);
+	m_CommandList->ClearDepthStencilView(DepthStencilView(), D3D12_CLEAR_FLAG_DEPTH | D3D12_CLEAR_FLAG_STENCIL, 1.0f, 0, 0, nullptr);
 
-	// 4     2 
-	m_CommandList->DrawInstanced(4, 2, 0, 0);
+	Set_Scene_Pass_State(m_CommandList.Get(), m_CmdState);
 
-	m_CommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(m_RenderTargetTex.Get(),
-		D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, D3D12_RESOURCE_STATE_RENDER_TARGET));
+	DrawRenderItems_Scene(m_CmdState, m_AllRitems, 0, (UINT)m_AllRitems.size());
 
-	m_CommandList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(CurrentBackBuffer(),
-		D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT));
+	Draw_Screen_Pass(m_CommandList.Get(), m_CmdState);
 
 	ThrowIfFailed(m_CommandList->Close());
 
+	m_FrameStats.Phase_End(FRAME_PHASE_RECORD);
+
 	ID3D12CommandList* cmdsLists[] = { m_CommandList.Get() };
 	m_CommandQueue->ExecuteCommandLists(_countof(cmdsLists), cmdsLists);
+#endif
 
-	ThrowIfFailed(m_SwapChain->Present(0, 0));
+	//   Present  FRAME_PACING_MODE
+	m_FramePacer.Present();
 
-	m_CurrBackBuffer = (m_CurrBackBuffer + 1) % m_SwapChainBufferCount;
+	m_CurrBackBuffer = m_SwapChain->GetCurrentBackBufferIndex();
 
-	FlushCommandQueue();
+	//  ,  frame resource    fence
+	m_CurrFrameResource->Fence = m_FrameScheduler.End_Frame();
+	m_FrameStats.Phase_End(FRAME_PHASE_SUBMIT);
+
+	//  ,  GPU   
+	m_Descriptors.End_Frame(m_CurrFrameResource->Fence);
 }
 
 
@@ -28,65 +28,94 @@
 #include "d3dUtil.h"
 
 #include "Timer.h"
+#include "UploadRing.h"
+#include "UploadBatch.h"
+#include "FrameScheduler.h"
+#include "FramePacer.h"
+#include "FrameStats.h"
+#include "HeapAllocator.h"
+#include "LinearAllocator.h"
+#include "DescriptorAllocator.h"
+#include "CommandListState.h"
+#include "RootSignatureCost.h"
+#include "ParallelRecord.h"
 
 #include "Camera.h"
 
-#pragma comment(lib,"d3dcompiler.lib")
-#pragma comment(lib, "D3D12.lib")
-#pragma comment(lib, "dxgi.lib")
+#include "RoomFile.h"
 
-#define NUM_FRAME_RESOURCES 3
+#include "BmpFile.h"
 
-template<typename T>
-class UploadBuffer
-{
-public:
-	UploadBuffer(ID3D12Device* device, UINT elementCount, bool isConstantBuffer) :
-		mIsConstantBuffer(isConstantBuffer)
-	{
-		mElementByteSize = sizeof(T);
+#include "MipGenerator.h"
 
-		if (isConstantBuffer)
-			mElementByteSize = d3dUtil::CalcConstantBufferByteSize(sizeof(T));
+#include "TextureFile.h"
 
-		ThrowIfFailed(device->CreateCommittedResource(
-			&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-			D3D12_HEAP_FLAG_NONE,
-			&CD3DX12_RESOURCE_DESC::Buffer(mElementByteSize * elementCount),
-			D3D12_RESOURCE_STATE_GENERIC_READ,
-			nullptr,
-			IID_PPV_ARGS(&mUploadBuffer)));
+#include "TextureAtlas.h"
 
-		ThrowIfFailed(mUploadBuffer->Map(0, nullptr, reinterpret_cast<void**>(&mMappedData)));
-	}
+#include "AssetCache.h"
 
-	UploadBuffer(const UploadBuffer& rhs) = delete;
-	UploadBuffer& operator=(const UploadBuffer& rhs) = delete;
-	~UploadBuffer()
-	{
-		if (mUploadBuffer != nullptr)
-			mUploadBuffer->Unmap(0, nullptr);
+#include "AssetStreamer.h"
 
-		mMappedData = nullptr;
-	}
+#include "BcEncoder.h"
 
-	ID3D12Resource* Resource()const
-	{
-		return mUploadBuffer.Get();
-	}
+#include "MeshOptimizer.h"
 
-	void CopyData(int elementIndex, const T& data)
-	{
-		memcpy(&mMappedData[elementIndex * mElementByteSize], &data, sizeof(T));
-	}
+#include "ThreadPool.h"
 
-private:
-	Microsoft::WRL::ComPtr<ID3D12Resource> mUploadBuffer;
-	BYTE* mMappedData = nullptr;
+#pragma comment(lib,"d3dcompiler.lib")
+#pragma comment(lib, "D3D12.lib")
+#pragma comment(lib, "dxgi.lib")
 
-	UINT mElementByteSize = 0;
-	bool mIsConstantBuffer = false;
-};
+#define NUM_FRAME_RESOURCES 3
+
+//,  CPU   GPU: 1 - CPU  GPU  ,
+//  NUM_FRAME_RESOURCES
+#define FRAMES_IN_FLIGHT 3
+
+// : FRAME_PACING_MAX_THROUGHPUT, FRAME_PACING_VSYNC
+// FRAME_PACING_LOW_LATENCY, . FramePacer.h.  
+//Present(0)  vsync,    CFramePacer
+#define FRAME_PACING_MODE FRAME_PACING_MAX_THROUGHPUT
+
+//       
+//FRAME_STATS_EXPORT_NAME.csv  .json, 0 -  .  
+//,        
+#define FRAME_STATS_EXPORT_SECONDS 0
+#define FRAME_STATS_EXPORT_NAME "frame_stats"
+
+//upload     
+#define UPLOAD_RING_SIZE (16 * 1024 * 1024)
+
+// default      ,
+//     
+#define HEAP_PAGE_SIZE (32 * 1024 * 1024)
+
+//        
+//  root CBV.  upload ,   -   
+#define CONSTANT_PAGE_SIZE (64 * 1024)
+
+//  CBV/SRV/UAV:  SRV   . CBV 
+//root ,     
+#define DESCRIPTOR_PERSISTENT_COUNT 64
+#define DESCRIPTOR_TRANSIENT_COUNT 0
+//CPU ,   SRV     
+#define DESCRIPTOR_STAGING_COUNT 64
+
+//       (BC 4x4  ),
+//16   5 mip     
+#define ROOM_ATLAS_ALIGN 16
+
+//      (STREAM_ROOM_ASSETS), 
+//      -   
+#define STREAM_UPLOAD_BYTES (1024 * 1024)
+#define STREAM_UPLOAD_MS 2.0
+
+//     (PARALLEL_RECORD):   
+// .     Set_Scene_Pass_State, 
+//    RECORD_MIN_ITEMS_PER_LIST  ,
+//12       
+#define RECORD_THREADS 4
+#define RECORD_MIN_ITEMS_PER_LIST 32
 
 static DirectX::XMFLOAT4X4 Identity4x4()
 {
@@ -105,6 +134,18 @@ struct Vertex
 	DirectX::XMFLOAT2 Tex;
 };
 
+static_assert(sizeof(Vertex) == ROOM_VERTEX_STRIDE, "Vertex must match room file layout");
+
+//  COMPACT_VERTEX_FORMAT:  UNORM16   ,
+//   half float
+struct VertexCompact
+{
+	WORD Pos[4];
+	WORD Tex[2];
+};
+
+static_assert(sizeof(VertexCompact) == QUANTIZED_VERTEX_STRIDE, "VertexCompact must match quantized layout");
+
 struct VertexSAQ
 {
 	DirectX::XMFLOAT3 Pos;
@@ -117,12 +158,69 @@ struct Texture
 	std::wstring Filename;
 
 	Microsoft::WRL::ComPtr<ID3D12Resource> Resource = nullptr;
-	Microsoft::WRL::ComPtr<ID3D12Resource> UploadHeap = nullptr;
 };
 
+//    ,
+//         GPU
+struct RoomStaging
+{
+	CRoomFile Room;
+	std::wstring TextureFilename;
+
+	//   mip     upload 
+	UploadAllocation TextureUpload;
+	std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> TextureFootprints;
+
+	//  ,    
+	UploadAllocation VertexUpload;
+	UploadAllocation IndexUpload;
+
+	bool RoomLoaded = false;
+	bool TextureLoaded = false;
+
+	//     COPY_DEST   
+	bool CopyDest = false;
+};
+
+//     Texture2DArray  ,
+//   root  (TEXTURE_ARRAY_ROOMS)
+struct RoomTextureConstants
+{
+	//xy - , zw -  UV  
+	DirectX::XMFLOAT4 Rect = { 0.0f, 0.0f, 1.0f, 1.0f };
+	UINT Slice = 0;
+};
+
+// ,    root  (ROOT_CONSTANT_BINDING),
+//         
+struct FogConstants
+{
+	//xyz - , w - 
+	DirectX::XMFLOAT4 Sphere = { 46433.0f, 6376.0f, 48650.0f, 4128.0f };
+	//rgb - , w -       
+	DirectX::XMFLOAT4 Color = { 0.0f, 223.0f / 255.0f, 191.0f / 255.0f, 12000.0f };
+};
+
+//  root signature 
+#define ROOT_PARAM_OBJECT 0
+#define ROOT_PARAM_PASS 1
+#define ROOT_PARAM_SRV 2
+#ifdef TEXTURE_ARRAY_ROOMS
+#define ROOT_PARAM_ROOM_TEXTURE 3
+#define ROOT_PARAM_FOG 4
+#else
+#define ROOT_PARAM_FOG 3
+#endif
+#ifdef ROOT_CONSTANT_BINDING
+#define ROOT_PARAM_COUNT (ROOT_PARAM_FOG + 1)
+#else
+#define ROOT_PARAM_COUNT ROOT_PARAM_FOG
+#endif
+
 struct SubmeshGeometry
 {
 	UINT VertexCount = 0;
+	UINT IndexCount = 0;
 	UINT StartIndexLocation = 0;
 	INT BaseVertexLocation = 0;
 };
@@ -136,13 +234,20 @@ struct MeshGeometry
 	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferGPU = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferGPU = nullptr;
 
-	Microsoft::WRL::ComPtr<ID3D12Resource> VertexBufferUploader = nullptr;
-	Microsoft::WRL::ComPtr<ID3D12Resource> IndexBufferUploader = nullptr;
-
 	UINT VertexByteStride = 0;
 	UINT VertexBufferByteSize = 0;
 	DXGI_FORMAT IndexFormat = DXGI_FORMAT_R16_UINT;
 	UINT IndexBufferByteSize = 0;
+
+	//    PosL * PosScale + PosBias,
+	//    
+	DirectX::XMFLOAT4 PosScale = { 1.0f, 1.0f, 1.0f, 0.0f };
+	DirectX::XMFLOAT4 PosBias = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+	//      SRV 
+	// SRV ,  Texture2DArray   SRV 
+	RoomTextureConstants TexConstants;
+	UINT SrvIndex = 0;
 	
 	SubmeshGeometry DrawArgs;
 
@@ -165,12 +270,6 @@ struct MeshGeometry
 
 		return ibv;
 	}
-
-	void DisposeUploaders()
-	{
-		VertexBufferUploader = nullptr;
-		IndexBufferUploader = nullptr;
-	}
 };
 
 struct RenderItem
@@ -181,10 +280,14 @@ struct RenderItem
 
 	int NumFramesDirty = NUM_FRAME_RESOURCES;
 
-	UINT ObjCBIndex = -1;
+	//    , root CBV b0
+	D3D12_GPU_VIRTUAL_ADDRESS ObjCBAddress = 0;
 
 	MeshGeometry* Geo = nullptr;
 
+	//         GPU
+	bool Visible = true;
+
 	D3D12_PRIMITIVE_TOPOLOGY PrimitiveType = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
 
 	UINT VertexCount = 0;
@@ -196,6 +299,8 @@ struct RenderItem
 struct ObjectConstants
 {
 	DirectX::XMFLOAT4X4 World = Identity4x4();
+	DirectX::XMFLOAT4 PosScale = { 1.0f, 1.0f, 1.0f, 0.0f };
+	DirectX::XMFLOAT4 PosBias = { 0.0f, 0.0f, 0.0f, 0.0f };
 };
 
 struct PassConstants
@@ -208,14 +313,33 @@ struct FrameResource
 {
 public:
 
-	FrameResource(ID3D12Device* device, UINT passCount, UINT objectCount)
+	FrameResource(ID3D12Device* device)
 	{
 		ThrowIfFailed(device->CreateCommandAllocator(
 			D3D12_COMMAND_LIST_TYPE_DIRECT,
 			IID_PPV_ARGS(CmdListAlloc.GetAddressOf())));
 
-		PassCB = std::make_unique<UploadBuffer<PassConstants>>(device, passCount, true);
-		ObjectCB = std::make_unique<UploadBuffer<ObjectConstants>>(device, objectCount, true);
+#ifdef STREAM_ROOM_ASSETS
+		ThrowIfFailed(device->CreateCommandAllocator(
+			D3D12_COMMAND_LIST_TYPE_DIRECT,
+			IID_PPV_ARGS(StreamCmdListAlloc.GetAddressOf())));
+#endif
+
+#ifdef PARALLEL_RECORD
+		for (UINT i = 0; i < RECORD_THREADS; i++)
+		{
+			ThrowIfFailed(device->CreateCommandAllocator(
+				D3D12_COMMAND_LIST_TYPE_DIRECT,
+				IID_PPV_ARGS(RecordCmdListAlloc[i].GetAddressOf())));
+		}
+
+		ThrowIfFailed(device->CreateCommandAllocator(
+			D3D12_COMMAND_LIST_TYPE_DIRECT,
+			IID_PPV_ARGS(PostCmdListAlloc.GetAddressOf())));
+#endif
+
+		//       
+		Constants.Init(device, CONSTANT_PAGE_SIZE);
 	}
 
 	FrameResource(const FrameResource& rhs) = delete;
@@ -226,8 +350,20 @@ public:
 
 	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CmdListAlloc;
 
-	std::unique_ptr<UploadBuffer<PassConstants>> PassCB = nullptr;
-	std::unique_ptr<UploadBuffer<ObjectConstants>> ObjectCB = nullptr;
+#ifdef STREAM_ROOM_ASSETS
+	//     
+	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> StreamCmdListAlloc;
+#endif
+
+#ifdef PARALLEL_RECORD
+	//   ,     
+	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> RecordCmdListAlloc[RECORD_THREADS];
+	// ,    
+	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> PostCmdListAlloc;
+#endif
+
+	//    ,    
+	CLinearAllocator Constants;
 
 	UINT64 Fence = 0;
 };
@@ -256,21 +392,37 @@ private:
 	void Execute_Init_Commands();
 	void Update_ViewPort_And_Scissor();
 	void Create_RenderTargetHeap_And_View_For_Pass1();
+	void Load_Scene_Assets();
+	static void Load_Room_Staging(CUploadRing* UploadRing, const std::string& Filename, RoomStaging& Staging);
+	static bool Decode_Bmp_To_Upload(CUploadRing* UploadRing, const std::wstring& Filename,
+		UploadAllocation& Upload, std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints);
+	static bool Load_Texture_To_Upload(CUploadRing* UploadRing, const std::wstring& Filename,
+		UploadAllocation& Upload, std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints);
+	void Verify_Parallel_Load(const std::vector<std::string>& Filename);
+	void Benchmark_Asset_Cache(const std::vector<std::string>& Filename);
 	void LoadTextures();
 	Microsoft::WRL::ComPtr<ID3D12Resource> CreateTexture(
-		ID3D12Device* device,
-		ID3D12GraphicsCommandList* cmdList,
-		const void* initData,
-		UINT64 byteSize,
-		Microsoft::WRL::ComPtr<ID3D12Resource>& UploadBuffer);
+		CHeapAllocator* HeapAllocator,
+		CUploadBatch& UploadBatch,
+		const std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT>& Footprints,
+		ID3D12Resource* UploadBuffer);
+	bool Create_Room_Texture_Array();
+	bool Create_Room_Texture_Atlas();
+	void Create_Streaming_Rooms();
+	void Start_Room_Streaming();
+	void Update_Room_Streaming();
+	static bool Stage_Room_Resources(CUploadRing* UploadRing, CHeapAllocator* HeapAllocator,
+		RoomStaging& Staging, MeshGeometry* Geo, UINT64& Bytes);
+	UINT64 Upload_Room_Range(int j, UINT64 Offset, UINT64 MaxBytes);
+	void Finish_Room_Upload(int j, bool Loaded);
 	void Create_ShaderResource_Heap_And_View_Pass1();
+	void Create_Scene_Srv(int j, ID3D12Resource* Resource);
 	void Create_Main_RenderTargetHeap_And_View_Pass2();
 	void Create_ShaderRVHeap_And_View_Pass2();
 	void Create_Mesh_Shaders_And_InputLayout_Pass1();
 	void Create_Mesh_Geometry_Pass1();
 	void Create_Render_Items();
 	void Create_Frame_Resources();
-	void Create_ConstBuff_Descriptors_Heap_And_View();
 	void Create_RootSignature();
 	void Create_PipelineStateObject_Pass1();
 	std::array<const CD3DX12_STATIC_SAMPLER_DESC, 6> GetStaticSamplers();
@@ -279,19 +431,45 @@ private:
 	void Create_PipelineStateObject_Pass2();
 	D3D12_CPU_DESCRIPTOR_HANDLE CurrentBackBufferView();
 	ID3D12Resource* CurrentBackBuffer();
-	void DrawRenderItems_Scene(ID3D12GraphicsCommandList* CmdList, const std::vector<std::unique_ptr<RenderItem>>& Ritems);
+	void Set_Scene_Pass_State(ID3D12GraphicsCommandList* CmdList, CCommandListState& CmdState);
+	void DrawRenderItems_Scene(CCommandListState& CmdState, const std::vector<std::unique_ptr<RenderItem>>& Ritems, UINT Begin, UINT End);
+	void Draw_Screen_Pass(ID3D12GraphicsCommandList* CmdList, CCommandListState& CmdState);
 
 	CTimer m_Timer;
+	CFrameStats m_FrameStats;
 
 	const int m_NumFrameResources = NUM_FRAME_RESOURCES;
-	UINT m_PassCbvOffset = 0;
+	D3D12_GPU_VIRTUAL_ADDRESS m_PassCBAddress = 0;
+#ifdef ROOT_CONSTANT_BINDING
+	FogConstants m_Fog;
+#endif
 	// render items
 	std::vector<std::unique_ptr<RenderItem>> m_AllRitems;
 	//std::vector<RenderItem*> m_TexturedRitems;
 	std::vector<std::unique_ptr<FrameResource>> m_FrameResources;
 	FrameResource* m_CurrFrameResource = nullptr;
 	int m_CurrFrameResourceIndex = 0;
-	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_CbvHeap = nullptr;
+
+	//      ,   
+	CDescriptorAllocator m_Descriptors;
+	CDescriptorAllocator m_StagingDescriptors;
+
+	//     m_CommandList
+	CCommandListState m_CmdState;
+
+#ifdef PARALLEL_RECORD
+	//  ,   m_WorkerPool:  
+	// ,     
+	std::unique_ptr<CThreadPool> m_RecordPool;
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_RecordCommandList[RECORD_THREADS];
+	CCommandListState m_RecordCmdState[RECORD_THREADS];
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_PostCommandList;
+
+	//     : 1 - , 0 - 
+	std::vector<UINT> m_RecordCosts;
+	RecordChunk m_RecordChunks[RECORD_THREADS];
+#endif
+
 	
 	Microsoft::WRL::ComPtr<IDXGIFactory4> m_dxgiFactory;
 	Microsoft::WRL::ComPtr<ID3D12Device> m_d3dDevice;
@@ -312,19 +490,35 @@ private:
 	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_DirectCmdListAlloc;
 	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_CommandList;
 
-	Microsoft::WRL::ComPtr<IDXGISwapChain> m_SwapChain;
+	Microsoft::WRL::ComPtr<IDXGISwapChain3> m_SwapChain;
 
 	int m_ClientWidth = 800;
 	int m_ClientHeight = 600;
 
-	static const int m_SwapChainBufferCount = 2;
+	//      swap chain (FRAMES_IN_FLIGHT)
+	static const int m_SwapChainBufferCount = 3;
 
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_SwapChainBuffer[m_SwapChainBufferCount];
 	Microsoft::WRL::ComPtr<ID3D12Resource> m_DepthStencilBuffer;
 
 	HWND m_hWnd;
 
-	UINT64 m_CurrentFence = 0;
+	//fence   ,  GPU
+	CFrameScheduler m_FrameScheduler;
+
+	//    ,  swap chain  ResizeBuffers
+	CFramePacer m_FramePacer;
+	bool m_TearingSupported = false;
+	UINT m_SwapChainFlags = 0;
+
+	// upload    , 
+	//     
+	CUploadRing m_UploadRing;
+	CUploadBatch m_UploadBatch;
+
+	//default     ,  
+	//  ,       
+	CHeapAllocator m_HeapAllocator;
 	
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_DsvHeap;
 
@@ -335,13 +529,18 @@ private:
 	CD3DX12_CPU_DESCRIPTOR_HANDLE m_RTVTexHandle;
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_RtvHeapRTTex;
 
-	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_SrvDescriptorHeap = nullptr;
+	//SRV     (SrvIndex  TEXTURE_ARRAY_ROOMS)
+	DescriptorRange m_SceneSrv;
+	DescriptorRange m_SceneSrvStaging;
 	D3D12_CPU_DESCRIPTOR_HANDLE GetCurrentSrvView(int Num);
 
+	//     Texture2DArray  
+	Microsoft::WRL::ComPtr<ID3D12Resource> m_RoomTexturePack;
+
 	int m_CurrBackBuffer = 0;
 	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_RtvHeap;
 
-	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_SrvDescriptorHeapSAQ = nullptr;
+	DescriptorRange m_SaqSrv;
 
 	Microsoft::WRL::ComPtr<ID3DBlob> m_VsByteCode = nullptr;
 	Microsoft::WRL::ComPtr<ID3DBlob> m_PsByteCode = nullptr;
@@ -351,6 +550,14 @@ private:
 	std::unique_ptr<MeshGeometry> m_Scene[12];
 	int MeshNums = 12;
 
+	std::unique_ptr<CThreadPool> m_WorkerPool;
+	RoomStaging m_RoomStaging[12];
+
+	//     (STREAM_ROOM_ASSETS),
+	//upload     GPU  
+	CAssetStreamer m_RoomStreamer;
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> m_StreamCommandList;
+
 	Microsoft::WRL::ComPtr<ID3D12RootSignature> m_RootSignature = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> m_PSO = nullptr;
 
@@ -368,9 +575,6 @@ private:
 	DirectX::XMFLOAT4X4 m_Proj = Identity4x4();
 
 	CFirstPersonCamera m_Camera;
-
-	UINT TextureWidth = 0;
-	UINT TextureHeight = 0;
 };
 
 #endif
\ No newline at end of file
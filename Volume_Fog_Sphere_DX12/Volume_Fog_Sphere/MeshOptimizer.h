@@ -0,0 +1,95 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Mesh Optimizer
+//======================================================================================
+
+#ifndef _MESHOPTIMIZER_
+#define _MESHOPTIMIZER_
+
+#include <windows.h>
+#include <vector>
+
+//     (   ),
+//Indices[i] -   i     UniqueVertices
+void Weld_Vertices(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	std::vector<BYTE>& UniqueVertices, std::vector<UINT>& Indices);
+
+//        
+bool Verify_Welded_Mesh(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	const void* UniqueVertices, const std::vector<UINT>& Indices);
+
+//   post-transform   GPU
+//( Tom Forsyth, LRU   32 )
+void Optimize_Vertex_Cache(UINT* Indices, UINT IndexCount, UINT VertexCount);
+void Optimize_Vertex_Cache(WORD* Indices, UINT IndexCount, UINT VertexCount);
+
+//       ,
+//    .    
+UINT Optimize_Vertex_Fetch(void* Vertices, UINT VertexCount, UINT VertexStride, UINT* Indices, UINT IndexCount);
+UINT Optimize_Vertex_Fetch(void* Vertices, UINT VertexCount, UINT VertexStride, WORD* Indices, UINT IndexCount);
+
+struct VertexCacheStats
+{
+	//   ,    0.5
+	float ACMR;
+	//   ,   1.0
+	float ATVR;
+};
+
+// FIFO    CacheSize
+VertexCacheStats Analyze_Vertex_Cache(const UINT* Indices, UINT IndexCount, UINT VertexCount, UINT CacheSize);
+VertexCacheStats Analyze_Vertex_Cache(const WORD* Indices, UINT IndexCount, UINT VertexCount, UINT CacheSize);
+
+//  12 :  x y z w  16  (UNORM 
+//  )   16   
+#define QUANTIZED_VERTEX_STRIDE 12
+
+//   Min + q / 65535 * Extent
+struct QuantizeBounds
+{
+	float Min[3];
+	float Extent[3];
+};
+
+//   x y z    
+void Compute_Quantize_Bounds(const void* Vertices, UINT VertexCount, UINT VertexStride, QuantizeBounds& Bounds);
+
+WORD Quantize_Unorm16(float Value, float Min, float Extent);
+float Dequantize_Unorm16(WORD Value, float Min, float Extent);
+
+WORD Float_To_Half(float Value);
+float Half_To_Float(WORD Value);
+
+//        [-1, 1] x [-1, 1]
+void Encode_Octahedral(const float Normal[3], SHORT Oct[2]);
+void Decode_Octahedral(const SHORT Oct[2], float Normal[3]);
+
+//x y z u v  float ->  UNORM16 + u v  half float
+void Quantize_Pos_Tex(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	const QuantizeBounds& Bounds, void* Quantized);
+
+//x y z nx ny nz  float ->  UNORM16 +  octahedral SNORM16
+void Quantize_Pos_Normal(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	const QuantizeBounds& Bounds, void* Quantized);
+
+struct QuantizeError
+{
+	//     
+	float MaxPosError;
+	//    u v,     
+	float MaxAttrError;
+	//      
+	bool PosInTolerance;
+};
+
+//   CPU     
+QuantizeError Verify_Quantize_Pos_Tex(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	const QuantizeBounds& Bounds, const void* Quantized);
+QuantizeError Verify_Quantize_Pos_Normal(const void* Vertices, UINT VertexCount, UINT VertexStride,
+	const QuantizeBounds& Bounds, const void* Quantized);
+
+//CPU    256x256:  Optimize_Vertex_Cache  Optimize_Vertex_Fetch
+//ACMR  ATVR ,       ,
+//    .   OutputDebugString
+void Verify_Vertex_Cache_Optimizer();
+
+#endif
@@ -0,0 +1,403 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Mip Generator DirectX12
+//======================================================================================
+
+#include "MipGenerator.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <utility>
+#include <emmintrin.h>
+
+//         ,
+//     
+#define MIP_MIN_BAND_TEXELS 16384
+
+//     float,   8  
+#define MIP_VERIFY_TOLERANCE 1
+
+static float Srgb_To_Linear(float c)
+{
+	return c <= 0.04045f ? c / 12.92f : powf((c + 0.055f) / 1.055f, 2.4f);
+}
+
+static float Linear_To_Srgb(float c)
+{
+	return c <= 0.0031308f ? c * 12.92f : 1.055f * powf(c, 1.0f / 2.4f) - 0.055f;
+}
+
+//  sRGB <->  16 ,   
+struct SrgbTables
+{
+	SrgbTables()
+	{
+		for (UINT i = 0; i < 256; i++)
+			ToLinear[i] = (WORD)(Srgb_To_Linear(i / 255.0f) * 65535.0f + 0.5f);
+
+		for (UINT i = 0; i < 65536; i++)
+			ToSrgb[i] = (BYTE)(Linear_To_Srgb(i / 65535.0f) * 255.0f + 0.5f);
+	}
+
+	WORD ToLinear[256];
+	BYTE ToSrgb[65536];
+};
+
+static const SrgbTables& Get_Srgb_Tables()
+{
+	static const SrgbTables Tables;
+
+	return Tables;
+}
+
+UINT Mip_Level_Count(UINT Width, UINT Height)
+{
+	UINT Levels = 1;
+
+	while (Width > 1 || Height > 1)
+	{
+		Width = Width > 1 ? Width / 2 : 1;
+		Height = Height > 1 ? Height / 2 : 1;
+		Levels++;
+	}
+
+	return Levels;
+}
+
+//    Width   
+static UINT Min_Band_Rows(UINT Width)
+{
+	UINT Rows = MIP_MIN_BAND_TEXELS / Width;
+
+	return Rows > 0 ? Rows : 1;
+}
+
+static void Linearize_Rows(const BYTE* Src, UINT SrcRowPitch, UINT Width, UINT Row0, UINT Row1,
+	WORD* Linear, const MipLevelData& Dst, const SrgbTables& Tables)
+{
+	for (UINT y = Row0; y < Row1; y++)
+	{
+		const BYTE* s = Src + (size_t)y * SrcRowPitch;
+		WORD* l = Linear + (size_t)y * Width * 4;
+
+		if (Dst.Data)
+			memcpy((BYTE*)Dst.Data + (size_t)y * Dst.RowPitch, s, Width * 4);
+
+		for (UINT x = 0; x < Width; x++)
+		{
+			l[0] = Tables.ToLinear[s[0]];
+			l[1] = Tables.ToLinear[s[1]];
+			l[2] = Tables.ToLinear[s[2]];
+			//  -, 255 -> 65535
+			l[3] = (WORD)(s[3] * 257);
+
+			s += 4;
+			l += 4;
+		}
+	}
+}
+
+static void Average_Texel(const WORD* S0, const WORD* S1, UINT x0, UINT x1, WORD* D)
+{
+	for (UINT c = 0; c < 4; c++)
+	{
+		UINT Sum = S0[x0 * 4 + c] + S0[x1 * 4 + c] + S1[x0 * 4 + c] + S1[x1 * 4 + c];
+		D[c] = (WORD)((Sum + 2) >> 2);
+	}
+}
+
+//Count        ,
+//  
+static UINT Downsample_Row_SSE2(const WORD* S0, const WORD* S1, WORD* D, UINT Count)
+{
+	const __m128i Zero = _mm_setzero_si128();
+	const __m128i Round = _mm_set1_epi32(2);
+	const __m128i Bias32 = _mm_set1_epi32(32768);
+	const __m128i Bias16 = _mm_set1_epi16((short)0x8000);
+
+	UINT x = 0;
+
+	//    , 16     
+	for (; x + 2 <= Count; x += 2)
+	{
+		__m128i A0 = _mm_loadu_si128((const __m128i*)(S0 + x * 8));
+		__m128i A1 = _mm_loadu_si128((const __m128i*)(S0 + x * 8 + 8));
+		__m128i B0 = _mm_loadu_si128((const __m128i*)(S1 + x * 8));
+		__m128i B1 = _mm_loadu_si128((const __m128i*)(S1 + x * 8 + 8));
+
+		__m128i Sum0 = _mm_add_epi32(
+			_mm_add_epi32(_mm_unpacklo_epi16(A0, Zero), _mm_unpackhi_epi16(A0, Zero)),
+			_mm_add_epi32(_mm_unpacklo_epi16(B0, Zero), _mm_unpackhi_epi16(B0, Zero)));
+		__m128i Sum1 = _mm_add_epi32(
+			_mm_add_epi32(_mm_unpacklo_epi16(A1, Zero), _mm_unpackhi_epi16(A1, Zero)),
+			_mm_add_epi32(_mm_unpacklo_epi16(B1, Zero), _mm_unpackhi_epi16(B1, Zero)));
+
+		Sum0 = _mm_srli_epi32(_mm_add_epi32(Sum0, Round), 2);
+		Sum1 = _mm_srli_epi32(_mm_add_epi32(Sum1, Round), 2);
+
+		// SSE2    32 -> 16,
+		//     
+		__m128i Packed = _mm_packs_epi32(_mm_sub_epi32(Sum0, Bias32), _mm_sub_epi32(Sum1, Bias32));
+		_mm_storeu_si128((__m128i*)(D + x * 4), _mm_xor_si128(Packed, Bias16));
+	}
+
+	return x;
+}
+
+static void Downsample_Rows(const WORD* Src, UINT SrcWidth, UINT SrcHeight,
+	WORD* Dst, UINT DstWidth, UINT Row0, UINT Row1, bool UseSimd)
+{
+	//        ,
+	//  1    
+	UINT FullPairs = SrcWidth / 2;
+
+	for (UINT y = Row0; y < Row1; y++)
+	{
+		UINT y0 = y * 2;
+		UINT y1 = y0 + 1 < SrcHeight ? y0 + 1 : y0;
+
+		const WORD* S0 = Src + (size_t)y0 * SrcWidth * 4;
+		const WORD* S1 = Src + (size_t)y1 * SrcWidth * 4;
+		WORD* D = Dst + (size_t)y * DstWidth * 4;
+
+		UINT x = UseSimd ? Downsample_Row_SSE2(S0, S1, D, FullPairs) : 0;
+
+		for (; x < DstWidth; x++)
+		{
+			UINT x0 = x * 2;
+			UINT x1 = x0 + 1 < SrcWidth ? x0 + 1 : x0;
+
+			Average_Texel(S0, S1, x0, x1, D + x * 4);
+		}
+	}
+}
+
+static void Encode_Rows(const WORD* Linear, UINT Width, UINT Row0, UINT Row1,
+	const MipLevelData& Dst, const SrgbTables& Tables)
+{
+	for (UINT y = Row0; y < Row1; y++)
+	{
+		const WORD* l = Linear + (size_t)y * Width * 4;
+		BYTE* d = (BYTE*)Dst.Data + (size_t)y * Dst.RowPitch;
+
+		for (UINT x = 0; x < Width; x++)
+		{
+			d[0] = Tables.ToSrgb[l[0]];
+			d[1] = Tables.ToSrgb[l[1]];
+			d[2] = Tables.ToSrgb[l[2]];
+			d[3] = (BYTE)((l[3] * 255u + 32767u) / 65535u);
+
+			l += 4;
+			d += 4;
+		}
+	}
+}
+
+static void Generate_Mip_Chain_Impl(const void* Src, UINT SrcRowPitch, UINT Width, UINT Height,
+	const MipLevelData* Dst, UINT MipLevels, CThreadPool* Pool, bool UseSimd)
+{
+	const BYTE* SrcBytes = (const BYTE*)Src;
+
+	if (MipLevels <= 1)
+	{
+		if (Dst[0].Data)
+		{
+			for (UINT y = 0; y < Height; y++)
+				memcpy((BYTE*)Dst[0].Data + (size_t)y * Dst[0].RowPitch, SrcBytes + (size_t)y * SrcRowPitch, Width * 4);
+		}
+
+		return;
+	}
+
+	const SrgbTables& Tables = Get_Srgb_Tables();
+
+	//     16  ,
+	//    sRGB  
+	UINT HalfWidth = Width > 1 ? Width / 2 : 1;
+	UINT HalfHeight = Height > 1 ? Height / 2 : 1;
+
+	std::vector<WORD> Linear((size_t)Width * Height * 4);
+	std::vector<WORD> Half((size_t)HalfWidth * HalfHeight * 4);
+
+	WORD* SrcLinear = Linear.data();
+	WORD* DstLinear = Half.data();
+
+	Run_Parallel_Rows(Pool, Height, Min_Band_Rows(Width), [&](UINT Row0, UINT Row1)
+	{
+		Linearize_Rows(SrcBytes, SrcRowPitch, Width, Row0, Row1, SrcLinear, Dst[0], Tables);
+	});
+
+	UINT SrcWidth = Width;
+	UINT SrcHeight = Height;
+
+	for (UINT Level = 1; Level < MipLevels; Level++)
+	{
+		UINT DstWidth = SrcWidth > 1 ? SrcWidth / 2 : 1;
+		UINT DstHeight = SrcHeight > 1 ? SrcHeight / 2 : 1;
+
+		Run_Parallel_Rows(Pool, DstHeight, Min_Band_Rows(DstWidth), [&](UINT Row0, UINT Row1)
+		{
+			Downsample_Rows(SrcLinear, SrcWidth, SrcHeight, DstLinear, DstWidth, Row0, Row1, UseSimd);
+			Encode_Rows(DstLinear, DstWidth, Row0, Row1, Dst[Level], Tables);
+		});
+
+		//      ,   
+		std::swap(SrcLinear, DstLinear);
+		SrcWidth = DstWidth;
+		SrcHeight = DstHeight;
+	}
+}
+
+void Generate_Mip_Chain(const void* Src, UINT SrcRowPitch, UINT Width, UINT Height,
+	const MipLevelData* Dst, UINT MipLevels, CThreadPool* Pool)
+{
+	Generate_Mip_Chain_Impl(Src, SrcRowPitch, Width, Height, Dst, MipLevels, Pool, true);
+}
+
+//:   float  ,    SIMD
+static void Reference_Mip_Chain(const BYTE* Src, UINT Width, UINT Height, UINT MipLevels,
+	std::vector<std::vector<BYTE>>& Levels)
+{
+	std::vector<float> Linear((size_t)Width * Height * 4);
+
+	for (size_t i = 0; i < Linear.size(); i++)
+		Linear[i] = (i % 4) == 3 ? Src[i] / 255.0f : Srgb_To_Linear(Src[i] / 255.0f);
+
+	Levels[0].assign(Src, Src + (size_t)Width * Height * 4);
+
+	UINT SrcWidth = Width;
+	UINT SrcHeight = Height;
+
+	for (UINT Level = 1; Level < MipLevels; Level++)
+	{
+		UINT DstWidth = SrcWidth > 1 ? SrcWidth / 2 : 1;
+		UINT DstHeight = SrcHeight > 1 ? SrcHeight / 2 : 1;
+
+		std::vector<float> Next((size_t)DstWidth * DstHeight * 4);
+		Levels[Level].resize(Next.size());
+
+		for (UINT y = 0; y < DstHeight; y++)
+		{
+			UINT y0 = y * 2;
+			UINT y1 = y0 + 1 < SrcHeight ? y0 + 1 : y0;
+
+			for (UINT x = 0; x < DstWidth; x++)
+			{
+				UINT x0 = x * 2;
+				UINT x1 = x0 + 1 < SrcWidth ? x0 + 1 : x0;
+
+				for (UINT c = 0; c < 4; c++)
+				{
+					float Value = (Linear[((size_t)y0 * SrcWidth + x0) * 4 + c] +
+						Linear[((size_t)y0 * SrcWidth + x1) * 4 + c] +
+						Linear[((size_t)y1 * SrcWidth + x0) * 4 + c] +
+						Linear[((size_t)y1 * SrcWidth + x1) * 4 + c]) * 0.25f;
+
+					size_t Index = ((size_t)y * DstWidth + x) * 4 + c;
+					Next[Index] = Value;
+
+					float Encoded = c == 3 ? Value : Linear_To_Srgb(Value);
+					Levels[Level][Index] = (BYTE)(Encoded * 255.0f + 0.5f);
+				}
+			}
+		}
+
+		Linear.swap(Next);
+		SrcWidth = DstWidth;
+		SrcHeight = DstHeight;
+	}
+}
+
+//    
+static void Alloc_Levels(UINT Width, UINT Height, UINT MipLevels,
+	std::vector<std::vector<BYTE>>& Levels, std::vector<MipLevelData>& Data)
+{
+	Levels.resize(MipLevels);
+	Data.resize(MipLevels);
+
+	for (UINT Level = 0; Level < MipLevels; Level++)
+	{
+		Levels[Level].resize((size_t)Width * Height * 4);
+		Data[Level].Data = Levels[Level].data();
+		Data[Level].RowPitch = Width * 4;
+
+		Width = Width > 1 ? Width / 2 : 1;
+		Height = Height > 1 ? Height / 2 : 1;
+	}
+}
+
+void Verify_Mip_Generator(CThreadPool* Pool)
+{
+	static const UINT Sizes[][2] = { { 256, 256 }, { 1024, 1024 }, { 255, 129 }, { 1, 64 }, { 37, 1 }, { 512, 128 } };
+
+	__int64 PerfFreq;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&PerfFreq);
+
+	UINT Seed = 12345;
+
+	for (UINT s = 0; s < _countof(Sizes); s++)
+	{
+		UINT Width = Sizes[s][0];
+		UINT Height = Sizes[s][1];
+		UINT MipLevels = Mip_Level_Count(Width, Height);
+
+		// ,      
+		//    ,  
+		std::vector<BYTE> Src((size_t)Width * Height * 4);
+		for (size_t i = 0; i < Src.size(); i++)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			Src[i] = (BYTE)(Seed >> 24);
+		}
+
+		for (UINT y = 0; y < Height / 2; y++)
+		{
+			for (UINT x = 0; x < Width * 4; x++)
+				Src[(size_t)y * Width * 4 + x] = (BYTE)((x / 4 + y) & 255);
+		}
+
+		std::vector<std::vector<BYTE>> Reference(MipLevels);
+		Reference_Mip_Chain(Src.data(), Width, Height, MipLevels, Reference);
+
+		//0 -    , 1 - SSE2   , 2 - SSE2  Pool
+		std::vector<std::vector<BYTE>> Levels[3];
+		double Ms[3];
+
+		for (UINT v = 0; v < 3; v++)
+		{
+			std::vector<MipLevelData> Data;
+			Alloc_Levels(Width, Height, MipLevels, Levels[v], Data);
+
+			__int64 Time0, Time1;
+			QueryPerformanceCounter((LARGE_INTEGER*)&Time0);
+
+			Generate_Mip_Chain_Impl(Src.data(), Width * 4, Width, Height, Data.data(), MipLevels,
+				v == 2 ? Pool : nullptr, v != 0);
+
+			QueryPerformanceCounter((LARGE_INTEGER*)&Time1);
+			Ms[v] = (double)(Time1 - Time0) * 1000.0 / PerfFreq;
+		}
+
+		bool Identical = Levels[1] == Levels[0] && Levels[2] == Levels[0];
+
+		int MaxDiff = 0;
+		for (UINT Level = 0; Level < MipLevels; Level++)
+		{
+			for (size_t i = 0; i < Reference[Level].size(); i++)
+			{
+				int Diff = abs((int)Levels[0][Level][i] - (int)Reference[Level][i]);
+				if (Diff > MaxDiff)
+					MaxDiff = Diff;
+			}
+		}
+
+		char Buffer[256];
+		sprintf_s(Buffer, "Mip chain %ux%u (%u levels): SIMD and threads %s, max diff to float reference %d%s, "
+			"scalar %.2f ms SSE2 %.2f ms SSE2 + threads %.2f ms\n",
+			Width, Height, MipLevels, Identical ? "identical" : "MISMATCH", MaxDiff,
+			MaxDiff > MIP_VERIFY_TOLERANCE ? " (MISMATCH)" : "", Ms[0], Ms[1], Ms[2]);
+		OutputDebugStringA(Buffer);
+	}
+}
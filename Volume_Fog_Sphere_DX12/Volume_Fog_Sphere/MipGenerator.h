@@ -0,0 +1,38 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Mip Generator DirectX12
+//======================================================================================
+
+#ifndef _MIPGENERATOR_
+#define _MIPGENERATOR_
+
+#include <windows.h>
+
+#include "ThreadPool.h"
+
+//   mip , 
+// upload   D3D12_PLACED_SUBRESOURCE_FOOTPRINT
+struct MipLevelData
+{
+	void* Data;
+	UINT RowPitch;
+};
+
+//      1x1
+UINT Mip_Level_Count(UINT Width, UINT Height);
+
+//  mip   RGBA8     sRGB:
+//RGB  2x2    (16   ),
+//   . Src -  0   
+//(), Dst[0]   Src  Data != nullptr,
+//Dst[1..MipLevels-1]   .   Pool,
+//     ,  
+//       Pool
+void Generate_Mip_Chain(const void* Src, UINT SrcRowPitch, UINT Width, UINT Height,
+	const MipLevelData* Dst, UINT MipLevels, CThreadPool* Pool = nullptr);
+
+// Generate_Mip_Chain (SSE2,    )  
+//  float   sRGB   ,
+//   OutputDebugString
+void Verify_Mip_Generator(CThreadPool* Pool);
+
+#endif
@@ -0,0 +1,389 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Parallel Command List Recording DirectX12
+//======================================================================================
+
+#include "ParallelRecord.h"
+
+#include <stdio.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "CommandListState.h"
+
+static UINT Item_Cost(const UINT* Costs, UINT Item)
+{
+	return Costs ? Costs[Item] : 1;
+}
+
+UINT Partition_Record_Chunks(const UINT* Costs, UINT Count, UINT MaxChunks, UINT64 MinCost, RecordChunk* Chunks)
+{
+	if (Count == 0)
+		return 0;
+
+	UINT64 Total = 0;
+	for (UINT i = 0; i < Count; i++)
+		Total += Item_Cost(Costs, i);
+
+	UINT NumChunks = MaxChunks > 0 ? MaxChunks : 1;
+
+	if (MinCost > 0 && Total / MinCost < NumChunks)
+		NumChunks = (UINT)(Total / MinCost);
+	if (NumChunks > Count)
+		NumChunks = Count;
+	if (NumChunks < 1 || Total == 0)
+		NumChunks = 1;
+
+	UINT Item = 0;
+	UINT64 Prefix = 0;
+
+	for (UINT c = 0; c < NumChunks; c++)
+	{
+		//  c ,       Total * (c + 1) / NumChunks,
+		//       
+		UINT64 Target = Total * (c + 1) / NumChunks;
+		UINT Last = Count - (NumChunks - c - 1);
+
+		RecordChunk& Chunk = Chunks[c];
+		Chunk.Begin = Item;
+		UINT64 Start = Prefix;
+
+		do
+		{
+			Prefix += Item_Cost(Costs, Item);
+			Item++;
+		}
+		while (Item < Last && Prefix * 2 + Item_Cost(Costs, Item) <= Target * 2);
+
+		if (c + 1 == NumChunks)
+		{
+			for (; Item < Count; Item++)
+				Prefix += Item_Cost(Costs, Item);
+		}
+
+		Chunk.End = Item;
+		Chunk.Cost = Prefix - Start;
+	}
+
+	//        
+	UINT Merged = 0;
+	for (UINT c = 0; c < NumChunks; c++)
+	{
+		if (Merged > 0 && (Chunks[c].Cost == 0 || Chunks[Merged - 1].Cost == 0))
+		{
+			Chunks[Merged - 1].End = Chunks[c].End;
+			Chunks[Merged - 1].Cost += Chunks[c].Cost;
+			continue;
+		}
+
+		Chunks[Merged++] = Chunks[c];
+	}
+
+	return Merged;
+}
+
+static bool Check_Chunks(const UINT* Costs, UINT Count, UINT MaxChunks, UINT64 MinCost,
+	const RecordChunk* Chunks, UINT NumChunks)
+{
+	if (Count == 0)
+		return NumChunks == 0;
+
+	if (NumChunks < 1 || NumChunks > MaxChunks || NumChunks > Count)
+		return false;
+
+	UINT64 Total = 0;
+	UINT64 MaxCost = 0;
+	for (UINT i = 0; i < Count; i++)
+	{
+		UINT Cost = Item_Cost(Costs, i);
+		Total += Cost;
+		if (Cost > MaxCost)
+			MaxCost = Cost;
+	}
+
+	UINT Next = 0;
+	for (UINT c = 0; c < NumChunks; c++)
+	{
+		const RecordChunk& Chunk = Chunks[c];
+
+		if (Chunk.Begin != Next || Chunk.End <= Chunk.Begin)
+			return false;
+
+		UINT64 Cost = 0;
+		for (UINT i = Chunk.Begin; i < Chunk.End; i++)
+			Cost += Item_Cost(Costs, i);
+
+		if (Cost != Chunk.Cost)
+			return false;
+
+		// :          
+		//   ,    MinCost
+		if (NumChunks > 1)
+		{
+			UINT64 Share = Total / NumChunks;
+
+			if (Cost == 0 || Cost + MaxCost < Share || Cost > Share + MaxCost + 1)
+				return false;
+
+			if (Cost < MinCost && Cost + MaxCost < MinCost)
+				return false;
+		}
+
+		Next = Chunk.End;
+	}
+
+	return Next == Count;
+}
+
+void Verify_Record_Partition()
+{
+	char Buffer[256];
+
+	std::vector<RecordChunk> Chunks(64);
+	std::vector<UINT> Costs;
+
+	//   
+	bool Even = true;
+
+	UINT Num = Partition_Record_Chunks(nullptr, 1000, 4, 0, Chunks.data());
+	if (Num != 4 || !Check_Chunks(nullptr, 1000, 4, 0, Chunks.data(), Num))
+		Even = false;
+	for (UINT c = 0; c < Num; c++)
+		if (Chunks[c].End - Chunks[c].Begin != 250)
+			Even = false;
+
+	Num = Partition_Record_Chunks(nullptr, 10, 4, 0, Chunks.data());
+	if (Num != 4 || !Check_Chunks(nullptr, 10, 4, 0, Chunks.data(), Num))
+		Even = false;
+	for (UINT c = 0; c < Num; c++)
+		if (Chunks[c].End - Chunks[c].Begin < 2 || Chunks[c].End - Chunks[c].Begin > 3)
+			Even = false;
+
+	//: ,   , MinCost
+	bool Limits = true;
+
+	if (Partition_Record_Chunks(nullptr, 0, 4, 0, Chunks.data()) != 0)
+		Limits = false;
+	if (Partition_Record_Chunks(nullptr, 3, 8, 0, Chunks.data()) != 3)
+		Limits = false;
+	if (Partition_Record_Chunks(nullptr, 12, 4, 8, Chunks.data()) != 1)
+		Limits = false;
+	if (Partition_Record_Chunks(nullptr, 12, 4, 4, Chunks.data()) != 3)
+		Limits = false;
+	if (Partition_Record_Chunks(nullptr, 12, 0, 0, Chunks.data()) != 1)
+		Limits = false;
+
+	//:    ,   
+	bool Hidden = true;
+
+	Costs.assign(1000, 1);
+	for (UINT i = 500; i < 1000; i++)
+		Costs[i] = 0;
+
+	Num = Partition_Record_Chunks(Costs.data(), 1000, 4, 0, Chunks.data());
+	if (Num != 4 || !Check_Chunks(Costs.data(), 1000, 4, 0, Chunks.data(), Num) || Chunks[Num - 1].End != 1000)
+		Hidden = false;
+	for (UINT c = 0; c < Num; c++)
+		if (Chunks[c].Cost != 125)
+			Hidden = false;
+
+	Costs.assign(100, 0);
+	Num = Partition_Record_Chunks(Costs.data(), 100, 4, 0, Chunks.data());
+	if (Num != 1 || Chunks[0].Begin != 0 || Chunks[0].End != 100)
+		Hidden = false;
+
+	// ,   
+	bool Random = true;
+	UINT Seed = 7;
+
+	for (UINT Test = 0; Test < 2000; Test++)
+	{
+		Seed = Seed * 1664525 + 1013904223;
+		UINT Count = (Seed >> 8) % 3000;
+		Seed = Seed * 1664525 + 1013904223;
+		UINT MaxChunks = 1 + (Seed >> 8) % 32;
+		Seed = Seed * 1664525 + 1013904223;
+		UINT64 MinCost = (Seed >> 8) % 4 == 0 ? (Seed >> 12) % 200 : 0;
+
+		Costs.resize(Count);
+		for (UINT i = 0; i < Count; i++)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			//   
+			Costs[i] = (Seed >> 8) % 5 == 0 ? 0 : 1 + (Seed >> 12) % 16;
+		}
+
+		Num = Partition_Record_Chunks(Costs.data(), Count, MaxChunks, MinCost, Chunks.data());
+		if (!Check_Chunks(Costs.data(), Count, MaxChunks, MinCost, Chunks.data(), Num))
+			Random = false;
+	}
+
+	//,     ,   
+	//  , Main   
+	bool Order = true;
+	CThreadPool Pool(4);
+
+	const UINT Items = 10000;
+	Num = Partition_Record_Chunks(nullptr, Items, 8, 0, Chunks.data());
+
+	std::vector<std::vector<UINT>> Lists(Num);
+	UINT MainCalls = 0;
+
+	Run_Record_Chunks(&Pool, Chunks.data(), Num, [&Lists](const RecordChunk& Chunk, UINT Index)
+	{
+		for (UINT i = Chunk.Begin; i < Chunk.End; i++)
+			Lists[Index].push_back(i);
+	},
+	[&MainCalls]()
+	{
+		MainCalls++;
+	});
+
+	UINT Next = 0;
+	for (UINT c = 0; c < Num; c++)
+		for (UINT i = 0; i < Lists[c].size(); i++)
+			if (Lists[c][i] != Next++)
+				Order = false;
+
+	if (Next != Items || MainCalls != 1)
+		Order = false;
+
+	bool Valid = Even && Limits && Hidden && Random && Order;
+
+	sprintf_s(Buffer, "Record partition: even %s, limits %s, hidden %s, random %s, order %s (%u lists), %s\n",
+		Even ? "OK" : "FAILED", Limits ? "OK" : "FAILED", Hidden ? "OK" : "FAILED",
+		Random ? "OK" : "FAILED", Order ? "OK" : "FAILED", Num, Valid ? "OK" : "FAILED");
+	OutputDebugStringA(Buffer);
+}
+
+struct MockRenderItem
+{
+	D3D12_VERTEX_BUFFER_VIEW Vbv;
+	D3D12_INDEX_BUFFER_VIEW Ibv;
+	D3D12_GPU_VIRTUAL_ADDRESS ObjCBAddress;
+	D3D12_GPU_DESCRIPTOR_HANDLE Srv;
+	UINT IndexCount;
+};
+
+static UINT64 Issued_Calls(const CCommandListState& CmdState)
+{
+	const CommandStateStats& Stats = CmdState.Get_Stats();
+
+	UINT64 Calls = Stats.Draws;
+	for (UINT i = 0; i < COMMAND_STATE_CALL_COUNT; i++)
+		Calls += Stats.Issued[i];
+
+	return Calls;
+}
+
+//    DrawRenderItems_Scene,    
+//  CallUs
+static void Record_Mock_Chunk(CCommandListState& CmdState, const MockRenderItem* Items,
+	const RecordChunk& Chunk, double CallUs)
+{
+	typedef std::chrono::steady_clock Clock;
+
+	ID3D12RootSignature* RootSignature = reinterpret_cast<ID3D12RootSignature*>(16);
+	ID3D12DescriptorHeap* Heap = reinterpret_cast<ID3D12DescriptorHeap*>(32);
+	D3D12_GPU_DESCRIPTOR_HANDLE PassTable = { 0x10000 };
+
+	UINT64 Calls = Issued_Calls(CmdState);
+
+	CmdState.Begin(nullptr, nullptr);
+	CmdState.Set_Root_Signature(RootSignature);
+	CmdState.Set_Descriptor_Heap(Heap);
+	CmdState.Set_Root_Table(1, PassTable);
+
+	for (UINT i = Chunk.Begin; i < Chunk.End; i++)
+	{
+		const MockRenderItem& Item = Items[i];
+
+		CmdState.Set_Vertex_Buffer(Item.Vbv);
+		CmdState.Set_Index_Buffer(Item.Ibv);
+		CmdState.Set_Topology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+		CmdState.Set_Root_Cbv(0, Item.ObjCBAddress);
+		CmdState.Set_Root_Table(2, Item.Srv);
+		CmdState.Draw_Indexed(Item.IndexCount, 0, 0);
+
+		UINT64 Now = Issued_Calls(CmdState);
+
+		Clock::time_point End = Clock::now() + std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double, std::micro>(CallUs * (double)(Now - Calls)));
+		while (Clock::now() < End)
+		{
+		}
+
+		Calls = Now;
+	}
+}
+
+void Benchmark_Parallel_Record(UINT Items, UINT MaxThreads, double CallUs)
+{
+	typedef std::chrono::steady_clock Clock;
+
+	if (Items == 0 || MaxThreads == 0)
+		return;
+
+	//12      SRV,    
+	std::vector<MockRenderItem> Scene(Items);
+	for (UINT i = 0; i < Items; i++)
+	{
+		UINT Room = i * 12 / Items;
+
+		Scene[i].Vbv.BufferLocation = 0x100000 * (Room + 1);
+		Scene[i].Vbv.SizeInBytes = 0x10000;
+		Scene[i].Vbv.StrideInBytes = 32;
+		Scene[i].Ibv.BufferLocation = 0x100000 * (Room + 1) + 0x10000;
+		Scene[i].Ibv.SizeInBytes = 0x8000;
+		Scene[i].Ibv.Format = DXGI_FORMAT_R16_UINT;
+		Scene[i].ObjCBAddress = 0x8000000 + (UINT64)i * 256;
+		Scene[i].Srv.ptr = 0x20000 + Room * 32;
+		Scene[i].IndexCount = 36;
+	}
+
+	const UINT Frames = 20;
+	double SingleMs = 0.0;
+
+	for (UINT Threads = 1; Threads <= MaxThreads; Threads++)
+	{
+		std::vector<RecordChunk> Chunks(Threads);
+		UINT NumChunks = Partition_Record_Chunks(nullptr, Items, Threads, 0, Chunks.data());
+
+		std::vector<std::unique_ptr<CCommandListState>> States(NumChunks);
+		for (UINT c = 0; c < NumChunks; c++)
+			States[c] = std::make_unique<CCommandListState>();
+
+		//  -    ,   PARALLEL_RECORD
+		std::unique_ptr<CThreadPool> Pool;
+		if (Threads > 1)
+			Pool = std::make_unique<CThreadPool>(Threads);
+
+		const MockRenderItem* SceneItems = Scene.data();
+
+		Clock::time_point Start = Clock::now();
+
+		for (UINT Frame = 0; Frame < Frames; Frame++)
+		{
+			Run_Record_Chunks(Pool.get(), Chunks.data(), NumChunks, [&States, SceneItems, CallUs](const RecordChunk& Chunk, UINT Index)
+			{
+				Record_Mock_Chunk(*States[Index], SceneItems, Chunk, CallUs);
+			},
+			[]()
+			{
+			});
+		}
+
+		double FrameMs = std::chrono::duration<double, std::milli>(Clock::now() - Start).count() / Frames;
+		if (Threads == 1)
+			SingleMs = FrameMs;
+
+		UINT64 Calls = 0;
+		for (UINT c = 0; c < NumChunks; c++)
+			Calls += Issued_Calls(*States[c]);
+
+		char Buffer[256];
+		sprintf_s(Buffer, "Parallel record: %u items, %u threads, %u lists, %.3f ms per frame, speedup %.2fx, %llu calls per frame\n",
+			Items, Threads, NumChunks, FrameMs, FrameMs > 0.0 ? SingleMs / FrameMs : 0.0, Calls / Frames);
+		OutputDebugStringA(Buffer);
+	}
+}
@@ -0,0 +1,69 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Parallel Command List Recording DirectX12
+//======================================================================================
+
+#ifndef _PARALLELRECORD_
+#define _PARALLELRECORD_
+
+#include <windows.h>
+
+#include "ThreadPool.h"
+
+// render items [Begin, End)    
+struct RecordChunk
+{
+	UINT Begin = 0;
+	UINT End = 0;
+	UINT64 Cost = 0;
+};
+
+// Count    Costs (nullptr -  1)   
+//MaxChunks      ,   
+//MinCost.       ,  ,
+//   ,    .  
+// ( )   .  
+//, 0  Count == 0
+UINT Partition_Record_Chunks(const UINT* Costs, UINT Count, UINT MaxChunks, UINT64 MinCost, RecordChunk* Chunks);
+
+//Func(Chunk, Index)      Pool, Main()  
+//   ,   .  Pool    
+//    .  Pool      -
+//Wait_All   
+template<class F, class M>
+void Run_Record_Chunks(CThreadPool* Pool, const RecordChunk* Chunks, UINT NumChunks, const F& Func, const M& Main)
+{
+	if (!Pool || NumChunks <= 1)
+	{
+		Main();
+
+		for (UINT i = 0; i < NumChunks; i++)
+			Func(Chunks[i], i);
+
+		return;
+	}
+
+	for (UINT i = 0; i < NumChunks; i++)
+	{
+		Pool->Add_Task([&Func, Chunks, i]()
+		{
+			Func(Chunks[i], i);
+		});
+	}
+
+	Main();
+
+	Pool->Wait_All();
+}
+
+//CPU  :     , 
+// , MinCost  MaxChunks,  ,   ,
+// ,   .   OutputDebugString
+void Verify_Record_Partition();
+
+//   Items render items  1..MaxThreads : 
+//      CCommandListState   ,
+//     CallUs  ( ).
+//         OutputDebugString
+void Benchmark_Parallel_Record(UINT Items, UINT MaxThreads, double CallUs);
+
+#endif
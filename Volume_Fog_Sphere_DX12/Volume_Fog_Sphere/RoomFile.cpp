@@ -0,0 +1,679 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Room File DirectX12
+//======================================================================================
+
+#include "RoomFile.h"
+
+#include "MeshOptimizer.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <vector>
+
+static UINT Room_Align(UINT Offset)
+{
+	return (Offset + ROOM_FILE_ALIGN - 1) & ~(ROOM_FILE_ALIGN - 1);
+}
+
+//    fgets/sscanf_s,
+//      Benchmark_Room_Text_Parser
+static bool Read_Room_Text_Scanf(const std::string& TextFilename, RoomFileHeader& Header, std::vector<float>& Vertices)
+{
+	FILE* f = NULL;
+	fopen_s(&f, TextFilename.c_str(), "rt");
+	if (f == NULL)
+		return false;
+
+	char Buffer[1024];
+
+	//   
+	fgets(Buffer, 1024, f);
+	Buffer[strcspn(Buffer, "\r\n")] = 0;
+	strncpy_s(Header.TextureName, Buffer, _TRUNCATE);
+
+	//  
+	fgets(Buffer, 1024, f);
+
+	int Size = 0;
+	sscanf_s(Buffer, "%d", &Size);
+
+	Vertices.resize(Size * 5);
+
+	for (int i = 0; i < Size; i++)
+	{
+		fgets(Buffer, 1024, f);
+		sscanf_s(Buffer, "%f;%f;%f;%f;%f", &Vertices[i * 5 + 0],
+			&Vertices[i * 5 + 1],
+			&Vertices[i * 5 + 2],
+			&Vertices[i * 5 + 3],
+			&Vertices[i * 5 + 4]);
+	}
+
+	fclose(f);
+
+	Header.VertexCount = Size;
+
+	return true;
+}
+
+static bool Read_Whole_File(const std::string& Filename, std::vector<char>& Data)
+{
+	FILE* f = NULL;
+	fopen_s(&f, Filename.c_str(), "rb");
+	if (f == NULL)
+		return false;
+
+	fseek(f, 0, SEEK_END);
+	long Size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	Data.resize(Size);
+	size_t Read = Size > 0 ? fread(Data.data(), 1, Size, f) : 0;
+
+	fclose(f);
+
+	return Read == (size_t)Size;
+}
+
+static const char* Skip_Spaces(const char* p, const char* End)
+{
+	while (p < End && (*p == ' ' || *p == '\t'))
+		p++;
+
+	return p;
+}
+
+// :  \r  \n, false      
+static bool Skip_Line_End(const char*& p, const char* End)
+{
+	p = Skip_Spaces(p, End);
+
+	if (p < End && *p == '\r')
+		p++;
+
+	if (p < End && *p != '\n')
+		return false;
+
+	if (p < End)
+		p++;
+
+	return true;
+}
+
+static bool Parse_Int(const char*& p, const char* End, int& Value)
+{
+	p = Skip_Spaces(p, End);
+
+	if (p == End || *p < '0' || *p > '9')
+		return false;
+
+	//  INT_MAX - ,     
+	Value = 0;
+	while (p < End && *p >= '0' && *p <= '9')
+	{
+		int Digit = *p++ - '0';
+		if (Value > (INT_MAX - Digit) / 10)
+			return false;
+
+		Value = Value * 10 + Digit;
+	}
+
+	return true;
+}
+
+//     : [-+]123[.456][e[-+]7]
+static bool Parse_Float(const char*& p, const char* End, float& Value)
+{
+	static const double Pow10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+	p = Skip_Spaces(p, End);
+
+	bool Negative = false;
+	if (p < End && (*p == '-' || *p == '+'))
+		Negative = *p++ == '-';
+
+	UINT64 Mantissa = 0;
+	int Digits = 0;
+	int Exponent = 0;
+	bool AnyDigits = false;
+
+	// 19    UINT64  ,  
+	while (p < End && *p >= '0' && *p <= '9')
+	{
+		if (Digits < 19)
+		{
+			Mantissa = Mantissa * 10 + (*p - '0');
+			if (Mantissa != 0)
+				Digits++;
+		}
+		else
+		{
+			Exponent++;
+		}
+
+		AnyDigits = true;
+		p++;
+	}
+
+	if (p < End && *p == '.')
+	{
+		p++;
+
+		while (p < End && *p >= '0' && *p <= '9')
+		{
+			if (Digits < 19)
+			{
+				Mantissa = Mantissa * 10 + (*p - '0');
+				if (Mantissa != 0)
+					Digits++;
+				Exponent--;
+			}
+
+			AnyDigits = true;
+			p++;
+		}
+	}
+
+	if (!AnyDigits)
+		return false;
+
+	if (p < End && (*p == 'e' || *p == 'E'))
+	{
+		p++;
+
+		bool NegativeExp = false;
+		if (p < End && (*p == '-' || *p == '+'))
+			NegativeExp = *p++ == '-';
+
+		int Exp = 0;
+		if (!Parse_Int(p, End, Exp))
+			return false;
+
+		Exponent += NegativeExp ? -Exp : Exp;
+	}
+
+	double Result = (double)Mantissa;
+
+	if (Exponent < 0)
+		Result /= (-Exponent <= 22) ? Pow10[-Exponent] : pow(10.0, -Exponent);
+	else if (Exponent > 0)
+		Result *= (Exponent <= 22) ? Pow10[Exponent] : pow(10.0, Exponent);
+
+	Value = (float)(Negative ? -Result : Result);
+
+	return true;
+}
+
+static bool Room_Text_Error(const std::string& TextFilename, int Line, const char* Message)
+{
+	char Buffer[512];
+	sprintf_s(Buffer, "%s(%d): %s\n", TextFilename.c_str(), Line, Message);
+	OutputDebugStringA(Buffer);
+
+	return false;
+}
+
+//   :  ,  ,
+//   x;y;z;u;v.        
+static bool Read_Room_Text(const std::string& TextFilename, RoomFileHeader& Header, std::vector<float>& Vertices)
+{
+	std::vector<char> Text;
+	if (!Read_Whole_File(TextFilename, Text))
+		return false;
+
+	const char* p = Text.data();
+	const char* End = p + Text.size();
+
+	//   
+	const char* NameEnd = p;
+	while (NameEnd < End && *NameEnd != '\r' && *NameEnd != '\n')
+		NameEnd++;
+
+	size_t NameLength = NameEnd - p;
+	if (NameLength > ROOM_TEXTURE_NAME_SIZE - 1)
+		NameLength = ROOM_TEXTURE_NAME_SIZE - 1;
+	memcpy(Header.TextureName, p, NameLength);
+	Header.TextureName[NameLength] = 0;
+
+	p = NameEnd;
+	if (!Skip_Line_End(p, End))
+		return Room_Text_Error(TextFilename, 1, "bad texture name");
+
+	//  
+	int Size = 0;
+	if (!Parse_Int(p, End, Size) || !Skip_Line_End(p, End) || Size > INT_MAX / 5)
+		return Room_Text_Error(TextFilename, 2, "bad vertex count");
+
+	//    "0;0;0;0;0\n",    
+	//  -      
+	int MaxSize = (int)((End - p + 1) / 10);
+	Vertices.clear();
+	Vertices.reserve((size_t)(Size < MaxSize ? Size : MaxSize) * 5);
+
+	int Count = 0;
+
+	for (;;)
+	{
+		//      
+		const char* LineStart = p;
+		while (LineStart < End && (*LineStart == ' ' || *LineStart == '\t' || *LineStart == '\r' || *LineStart == '\n'))
+			LineStart++;
+
+		if (LineStart == End)
+			break;
+
+		if (Count == Size)
+			return Room_Text_Error(TextFilename, Count + 3, "more vertices than declared");
+
+		Vertices.resize((size_t)(Count + 1) * 5);
+		float* V = &Vertices[(size_t)Count * 5];
+
+		for (int i = 0; i < 5; i++)
+		{
+			if (!Parse_Float(p, End, V[i]))
+				return Room_Text_Error(TextFilename, Count + 3, "bad number");
+
+			if (i < 4)
+			{
+				p = Skip_Spaces(p, End);
+				if (p == End || *p != ';')
+					return Room_Text_Error(TextFilename, Count + 3, "expected ';'");
+				p++;
+			}
+		}
+
+		if (!Skip_Line_End(p, End))
+			return Room_Text_Error(TextFilename, Count + 3, "extra characters at end of line");
+
+		Count++;
+	}
+
+	if (Count != Size)
+		return Room_Text_Error(TextFilename, Count + 3, "fewer vertices than declared");
+
+	Header.VertexCount = Size;
+
+	return true;
+}
+
+bool Convert_Room_Text_To_Binary(const std::string& TextFilename, const std::string& BinFilename)
+{
+	RoomFileHeader Header = {};
+	std::vector<float> Vertices;
+
+	if (!Read_Room_Text(TextFilename, Header, Vertices))
+		return false;
+
+	//      ,
+	//  
+	std::vector<BYTE> UniqueVertices;
+	std::vector<UINT> Indices;
+	Weld_Vertices(Vertices.data(), Header.VertexCount, ROOM_VERTEX_STRIDE, UniqueVertices, Indices);
+
+	if (!Verify_Welded_Mesh(Vertices.data(), Header.VertexCount, ROOM_VERTEX_STRIDE, UniqueVertices.data(), Indices))
+		return false;
+
+	UINT UniqueCount = (UINT)(UniqueVertices.size() / ROOM_VERTEX_STRIDE);
+
+	VertexCacheStats Before = Analyze_Vertex_Cache(Indices.data(), (UINT)Indices.size(), UniqueCount, 16);
+
+	Optimize_Vertex_Cache(Indices.data(), (UINT)Indices.size(), UniqueCount);
+	Optimize_Vertex_Fetch(UniqueVertices.data(), UniqueCount, ROOM_VERTEX_STRIDE, Indices.data(), (UINT)Indices.size());
+
+	VertexCacheStats After = Analyze_Vertex_Cache(Indices.data(), (UINT)Indices.size(), UniqueCount, 16);
+
+	Header.Magic = ROOM_FILE_MAGIC;
+	Header.Version = ROOM_FILE_VERSION;
+	Header.HeaderSize = sizeof(RoomFileHeader);
+	Header.VertexStride = ROOM_VERTEX_STRIDE;
+	Header.VertexCount = UniqueCount;
+	Header.VertexOffset = Room_Align(sizeof(RoomFileHeader));
+	Header.IndexCount = (UINT)Indices.size();
+	Header.IndexSize = UniqueCount <= 0xFFFF ? 2 : 4;
+	Header.IndexOffset = Room_Align(Header.VertexOffset + UniqueCount * ROOM_VERTEX_STRIDE);
+
+	std::vector<BYTE> IndexData((size_t)Header.IndexCount * Header.IndexSize);
+
+	for (UINT i = 0; i < Header.IndexCount; i++)
+	{
+		if (Header.IndexSize == 2)
+			((WORD*)IndexData.data())[i] = (WORD)Indices[i];
+		else
+			((UINT*)IndexData.data())[i] = Indices[i];
+	}
+
+	FILE* f = NULL;
+	fopen_s(&f, BinFilename.c_str(), "wb");
+	if (f == NULL)
+		return false;
+
+	BYTE Pad[ROOM_FILE_ALIGN] = {};
+
+	fwrite(&Header, sizeof(RoomFileHeader), 1, f);
+	fwrite(Pad, 1, Header.VertexOffset - sizeof(RoomFileHeader), f);
+	fwrite(UniqueVertices.data(), 1, UniqueVertices.size(), f);
+	fwrite(Pad, 1, Header.IndexOffset - Header.VertexOffset - UniqueVertices.size(), f);
+	size_t Written = fwrite(IndexData.data(), 1, IndexData.size(), f);
+
+	fclose(f);
+
+	char Buffer[512];
+	sprintf_s(Buffer, "%s: %u -> %u vertices, %u -> %u bytes (VB %u + IB %u), ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+		TextFilename.c_str(),
+		(UINT)Indices.size(), UniqueCount,
+		(UINT)Indices.size() * ROOM_VERTEX_STRIDE,
+		(UINT)(UniqueVertices.size() + IndexData.size()),
+		(UINT)UniqueVertices.size(), (UINT)IndexData.size(),
+		Before.ACMR, After.ACMR, Before.ATVR, After.ATVR);
+	OutputDebugStringA(Buffer);
+
+	return Written == IndexData.size();
+}
+
+bool Room_Binary_Is_Stale(const std::string& TextFilename, const std::string& BinFilename)
+{
+	WIN32_FILE_ATTRIBUTE_DATA BinData;
+	if (!GetFileAttributesExA(BinFilename.c_str(), GetFileExInfoStandard, &BinData))
+		return true;
+
+	//   
+	RoomFileHeader Header = {};
+
+	FILE* f = NULL;
+	fopen_s(&f, BinFilename.c_str(), "rb");
+	if (f != NULL)
+	{
+		fread(&Header, sizeof(RoomFileHeader), 1, f);
+		fclose(f);
+	}
+
+	if (Header.Magic != ROOM_FILE_MAGIC || Header.Version != ROOM_FILE_VERSION)
+		return true;
+
+	//   -     
+	WIN32_FILE_ATTRIBUTE_DATA TextData;
+	if (!GetFileAttributesExA(TextFilename.c_str(), GetFileExInfoStandard, &TextData))
+		return false;
+
+	return CompareFileTime(&BinData.ftLastWriteTime, &TextData.ftLastWriteTime) < 0;
+}
+
+//     GPU   
+template<typename T>
+static bool Indices_In_Range(const T* Indices, UINT IndexCount, UINT VertexCount)
+{
+	for (UINT i = 0; i < IndexCount; i++)
+	{
+		if (Indices[i] >= VertexCount)
+			return false;
+	}
+
+	return true;
+}
+
+CRoomFile::CRoomFile()
+{
+}
+
+CRoomFile::~CRoomFile()
+{
+	Close();
+}
+
+bool CRoomFile::Open(const std::string& Filename)
+{
+	Close();
+
+	m_File = CreateFileA(Filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+
+	if (m_File == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER FileSize;
+	if (!GetFileSizeEx(m_File, &FileSize) || FileSize.QuadPart < (LONGLONG)sizeof(RoomFileHeader))
+	{
+		Close();
+		return false;
+	}
+
+	m_Mapping = CreateFileMappingA(m_File, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_Mapping == NULL)
+	{
+		Close();
+		return false;
+	}
+
+	m_View = (const BYTE*)MapViewOfFile(m_Mapping, FILE_MAP_READ, 0, 0, 0);
+	if (m_View == nullptr)
+	{
+		Close();
+		return false;
+	}
+
+	m_Header = (const RoomFileHeader*)m_View;
+
+	//           
+	UINT64 VertexEnd = (UINT64)m_Header->VertexOffset + (UINT64)m_Header->VertexCount * m_Header->VertexStride;
+	UINT64 IndexEnd = (UINT64)m_Header->IndexOffset + (UINT64)m_Header->IndexCount * m_Header->IndexSize;
+
+	if (m_Header->Magic != ROOM_FILE_MAGIC ||
+		m_Header->Version != ROOM_FILE_VERSION ||
+		m_Header->HeaderSize != sizeof(RoomFileHeader) ||
+		m_Header->VertexStride != ROOM_VERTEX_STRIDE ||
+		(m_Header->IndexSize != 2 && m_Header->IndexSize != 4) ||
+		(m_Header->VertexOffset % ROOM_FILE_ALIGN) != 0 ||
+		(m_Header->IndexOffset % ROOM_FILE_ALIGN) != 0 ||
+		VertexEnd > (UINT64)FileSize.QuadPart ||
+		IndexEnd > (UINT64)FileSize.QuadPart)
+	{
+		Close();
+		return false;
+	}
+
+	//      >= VertexCount
+	const BYTE* IndexData = m_View + m_Header->IndexOffset;
+	bool InRange = m_Header->IndexSize == 2 ?
+		Indices_In_Range((const WORD*)IndexData, m_Header->IndexCount, m_Header->VertexCount) :
+		Indices_In_Range((const UINT*)IndexData, m_Header->IndexCount, m_Header->VertexCount);
+
+	if (!InRange)
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void CRoomFile::Close()
+{
+	if (m_View != nullptr)
+		UnmapViewOfFile(m_View);
+
+	if (m_Mapping != NULL)
+		CloseHandle(m_Mapping);
+
+	if (m_File != INVALID_HANDLE_VALUE)
+		CloseHandle(m_File);
+
+	m_View = nullptr;
+	m_Header = nullptr;
+	m_Mapping = NULL;
+	m_File = INVALID_HANDLE_VALUE;
+}
+
+const char* CRoomFile::TextureName() const
+{
+	return m_Header->TextureName;
+}
+
+const void* CRoomFile::Vertices() const
+{
+	return m_View + m_Header->VertexOffset;
+}
+
+UINT CRoomFile::VertexCount() const
+{
+	return m_Header->VertexCount;
+}
+
+UINT CRoomFile::VertexBufferByteSize() const
+{
+	return m_Header->VertexCount * m_Header->VertexStride;
+}
+
+const void* CRoomFile::Indices() const
+{
+	return m_View + m_Header->IndexOffset;
+}
+
+UINT CRoomFile::IndexCount() const
+{
+	return m_Header->IndexCount;
+}
+
+UINT CRoomFile::IndexSize() const
+{
+	return m_Header->IndexSize;
+}
+
+UINT CRoomFile::IndexBufferByteSize() const
+{
+	return m_Header->IndexCount * m_Header->IndexSize;
+}
+
+void Benchmark_Room_Loader(UINT VertexCount)
+{
+	char TempPath[MAX_PATH];
+	GetTempPathA(MAX_PATH, TempPath);
+
+	std::string TextFilename = std::string(TempPath) + "room_bench.txt";
+	std::string BinFilename = std::string(TempPath) + "room_bench.room";
+
+	FILE* f = NULL;
+	fopen_s(&f, TextFilename.c_str(), "wt");
+	if (f == NULL)
+		return;
+
+	fprintf(f, "texture0.bmp\n%u\n", VertexCount);
+	for (UINT i = 0; i < VertexCount; i++)
+	{
+		fprintf(f, "%d;%d;%d;%f;%f\n", (int)(i % 4096) * 256, (int)(i % 64) * 128, (int)(i / 4096) * 256,
+			(i % 5) * 0.249985f, (i % 3) * 0.5f);
+	}
+	fclose(f);
+
+	if (!Convert_Room_Text_To_Binary(TextFilename, BinFilename))
+		return;
+
+	__int64 PerfFreq, Time0, Time1, Time2;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&PerfFreq);
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&Time0);
+
+	RoomFileHeader Header = {};
+	std::vector<float> TextVertices;
+	Read_Room_Text(TextFilename, Header, TextVertices);
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&Time1);
+
+	//        
+	CRoomFile Room;
+	float Sum = 0.0f;
+	if (Room.Open(BinFilename))
+	{
+		const float* BinVertices = (const float*)Room.Vertices();
+		for (UINT i = 0; i < Room.VertexCount() * 5; i += 1024 / sizeof(float))
+			Sum += BinVertices[i];
+	}
+	Room.Close();
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&Time2);
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Room loader %u vertices: text %.2f ms, binary %.2f ms (%f)\n", VertexCount,
+		(Time1 - Time0) * 1000.0 / PerfFreq, (Time2 - Time1) * 1000.0 / PerfFreq, Sum);
+	OutputDebugStringA(Buffer);
+
+	DeleteFileA(TextFilename.c_str());
+	DeleteFileA(BinFilename.c_str());
+}
+
+void Benchmark_Room_Text_Parser(const std::vector<std::string>& TextFilenames, UINT Scale)
+{
+	//       Scale 
+	std::string Body;
+	UINT VertexCount = 0;
+
+	for (size_t i = 0; i < TextFilenames.size(); i++)
+	{
+		std::vector<char> Text;
+		if (!Read_Whole_File(TextFilenames[i], Text))
+			continue;
+
+		std::string Room(Text.begin(), Text.end());
+
+		//   
+		size_t Pos = Room.find('\n');
+		Pos = Room.find('\n', Pos + 1);
+		if (Pos == std::string::npos)
+			continue;
+
+		RoomFileHeader Header = {};
+		std::vector<float> Vertices;
+		if (!Read_Room_Text(TextFilenames[i], Header, Vertices))
+			continue;
+
+		Body += Room.substr(Pos + 1);
+		if (Body.back() != '\n')
+			Body += '\n';
+
+		VertexCount += Header.VertexCount;
+	}
+
+	char TempPath[MAX_PATH];
+	GetTempPathA(MAX_PATH, TempPath);
+
+	std::string TextFilename = std::string(TempPath) + "room_parser_bench.txt";
+
+	FILE* f = NULL;
+	fopen_s(&f, TextFilename.c_str(), "wb");
+	if (f == NULL)
+		return;
+
+	fprintf(f, "texture0.bmp\n%u\n", VertexCount * Scale);
+	for (UINT i = 0; i < Scale; i++)
+		fwrite(Body.data(), 1, Body.size(), f);
+
+	long FileSize = ftell(f);
+	fclose(f);
+
+	__int64 PerfFreq, Time0, Time1, Time2;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&PerfFreq);
+
+	RoomFileHeader Header = {};
+	std::vector<float> Fast, Scanf;
+
+	QueryPerformanceCounter((LARGE_INTEGER*)&Time0);
+	bool FastOk = Read_Room_Text(TextFilename, Header, Fast);
+	QueryPerformanceCounter((LARGE_INTEGER*)&Time1);
+	Read_Room_Text_Scanf(TextFilename, Header, Scanf);
+	QueryPerformanceCounter((LARGE_INTEGER*)&Time2);
+
+	double MegaBytes = FileSize / (1024.0 * 1024.0);
+	double FastSec = (double)(Time1 - Time0) / PerfFreq;
+	double ScanfSec = (double)(Time2 - Time1) / PerfFreq;
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Room text parser %.1f MB x%u: fast %.1f MB/s, sscanf %.1f MB/s, %s\n",
+		MegaBytes, Scale, MegaBytes / FastSec, MegaBytes / ScanfSec,
+		FastOk && Fast == Scanf ? "results match" : "RESULTS DIFFER");
+	OutputDebugStringA(Buffer);
+
+	DeleteFileA(TextFilename.c_str());
+}
@@ -0,0 +1,87 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Room File DirectX12
+//======================================================================================
+
+#ifndef _ROOMFILE_
+#define _ROOMFILE_
+
+#include <windows.h>
+#include <string>
+#include <vector>
+
+//'ROOM'
+#define ROOM_FILE_MAGIC 0x4D4F4F52
+#define ROOM_FILE_VERSION 3
+
+//       16 
+#define ROOM_FILE_ALIGN 16
+
+//x y z u v -   Vertex  MeshManager.h
+#define ROOM_VERTEX_STRIDE 20
+
+#define ROOM_TEXTURE_NAME_SIZE 64
+
+struct RoomFileHeader
+{
+	UINT Magic;
+	UINT Version;
+	UINT HeaderSize;
+	UINT VertexStride;
+	UINT VertexCount;
+	//     
+	UINT VertexOffset;
+	UINT IndexCount;
+	//2  4   
+	UINT IndexSize;
+	UINT IndexOffset;
+	char TextureName[ROOM_TEXTURE_NAME_SIZE];
+};
+
+//     file mapping,
+//       
+class CRoomFile
+{
+public:
+	CRoomFile();
+	~CRoomFile();
+
+	CRoomFile(const CRoomFile& rhs) = delete;
+	CRoomFile& operator=(const CRoomFile& rhs) = delete;
+
+	bool Open(const std::string& Filename);
+	void Close();
+
+	const char* TextureName() const;
+	const void* Vertices() const;
+	UINT VertexCount() const;
+	UINT VertexBufferByteSize() const;
+
+	const void* Indices() const;
+	UINT IndexCount() const;
+	UINT IndexSize() const;
+	UINT IndexBufferByteSize() const;
+
+private:
+	HANDLE m_File = INVALID_HANDLE_VALUE;
+	HANDLE m_Mapping = NULL;
+	const BYTE* m_View = nullptr;
+	const RoomFileHeader* m_Header = nullptr;
+};
+
+//  roomN.txt   roomN.room,
+//      ,
+//       GPU
+bool Convert_Room_Text_To_Binary(const std::string& TextFilename, const std::string& BinFilename);
+
+//  ,     
+bool Room_Binary_Is_Stale(const std::string& TextFilename, const std::string& BinFilename);
+
+//        ,
+//   OutputDebugString
+void Benchmark_Room_Loader(UINT VertexCount);
+
+//     MB/s    TextFilenames,
+// Scale 
+void Benchmark_Room_Text_Parser(const std::vector<std::string>& TextFilenames, UINT Scale);
+
+#endif
@@ -0,0 +1,112 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Root Signature Cost DirectX12
+//======================================================================================
+
+#include "RootSignatureCost.h"
+
+#include <stdio.h>
+
+RootSignatureCost Get_Root_Signature_Cost(const D3D12_ROOT_SIGNATURE_DESC& Desc)
+{
+	RootSignatureCost Cost;
+
+	for (UINT i = 0; i < Desc.NumParameters; i++)
+	{
+		const D3D12_ROOT_PARAMETER& Param = Desc.pParameters[i];
+
+		switch (Param.ParameterType)
+		{
+		case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+			Cost.Tables++;
+			Cost.Dwords += 1;
+			break;
+		case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+			Cost.Constants += Param.Constants.Num32BitValues;
+			Cost.Dwords += Param.Constants.Num32BitValues;
+			break;
+		default:
+			//CBV, SRV, UAV
+			Cost.Descriptors++;
+			Cost.Dwords += 2;
+			break;
+		}
+	}
+
+	return Cost;
+}
+
+bool Report_Root_Signature_Cost(const char* Name, const RootSignatureCost& Cost)
+{
+	bool Fits = Cost.Dwords <= ROOT_SIGNATURE_MAX_DWORDS;
+
+	char Buffer[256];
+	sprintf_s(Buffer, "%s: %u/%u DWORDs, %u tables, %u root descriptors, %u root constants%s\n",
+		Name, Cost.Dwords, ROOT_SIGNATURE_MAX_DWORDS, Cost.Tables, Cost.Descriptors, Cost.Constants,
+		Fits ? "" : ", TOO LARGE");
+	OutputDebugStringA(Buffer);
+
+	return Fits;
+}
+
+void Verify_Root_Signature_Cost()
+{
+	CD3DX12_DESCRIPTOR_RANGE CbvTable0;
+	CbvTable0.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 0);
+	CD3DX12_DESCRIPTOR_RANGE CbvTable1;
+	CbvTable1.Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV, 1, 1);
+	CD3DX12_DESCRIPTOR_RANGE SrvTable;
+	SrvTable.Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV, 1, 0);
+
+	bool Valid = true;
+
+	// CBV   ,  SRV,  
+	CD3DX12_ROOT_PARAMETER Tables[4];
+	Tables[0].InitAsDescriptorTable(1, &CbvTable0);
+	Tables[1].InitAsDescriptorTable(1, &CbvTable1);
+	Tables[2].InitAsDescriptorTable(1, &SrvTable);
+	Tables[3].InitAsConstants(5, 2);
+
+	CD3DX12_ROOT_SIGNATURE_DESC TablesDesc(_countof(Tables), Tables);
+	RootSignatureCost TablesCost = Get_Root_Signature_Cost(TablesDesc);
+
+	if (TablesCost.Dwords != 3 + 5 || TablesCost.Tables != 3 || TablesCost.Constants != 5)
+		Valid = false;
+
+	//root CBV   ,    
+	CD3DX12_ROOT_PARAMETER Root[5];
+	Root[0].InitAsConstantBufferView(0);
+	Root[1].InitAsConstantBufferView(1);
+	Root[2].InitAsDescriptorTable(1, &SrvTable);
+	Root[3].InitAsConstants(5, 2);
+	Root[4].InitAsConstants(8, 3);
+
+	CD3DX12_ROOT_SIGNATURE_DESC RootDesc(_countof(Root), Root);
+	RootSignatureCost RootCost = Get_Root_Signature_Cost(RootDesc);
+
+	if (RootCost.Dwords != 2 * 2 + 1 + 5 + 8 || RootCost.Descriptors != 2 || RootCost.Tables != 1)
+		Valid = false;
+
+	//     DWORD 
+	CD3DX12_ROOT_PARAMETER Limit[3];
+	Limit[0].InitAsConstantBufferView(0);
+	Limit[1].InitAsDescriptorTable(1, &SrvTable);
+	Limit[2].InitAsConstants(ROOT_SIGNATURE_MAX_DWORDS - 3, 1);
+
+	CD3DX12_ROOT_SIGNATURE_DESC LimitDesc(_countof(Limit), Limit);
+	RootSignatureCost LimitCost = Get_Root_Signature_Cost(LimitDesc);
+
+	Limit[2].InitAsConstants(ROOT_SIGNATURE_MAX_DWORDS - 2, 1);
+	RootSignatureCost OverCost = Get_Root_Signature_Cost(LimitDesc);
+
+	bool Limits = LimitCost.Dwords == ROOT_SIGNATURE_MAX_DWORDS &&
+		Report_Root_Signature_Cost("Root signature at limit", LimitCost) &&
+		!Report_Root_Signature_Cost("Root signature over limit", OverCost);
+
+	Report_Root_Signature_Cost("Root signature with tables", TablesCost);
+	Report_Root_Signature_Cost("Root signature with root CBV", RootCost);
+
+	char Buffer[256];
+	sprintf_s(Buffer, "Root signature cost: %s, tables %u DWORDs, root CBV %u DWORDs, limit %s\n",
+		Valid && Limits ? "OK" : "FAILED", TablesCost.Dwords, RootCost.Dwords, Limits ? "OK" : "FAILED");
+	OutputDebugStringA(Buffer);
+}
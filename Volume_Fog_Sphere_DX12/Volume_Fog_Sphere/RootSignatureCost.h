@@ -0,0 +1,36 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Root Signature Cost DirectX12
+//======================================================================================
+
+#ifndef _ROOTSIGNATURECOST_
+#define _ROOTSIGNATURECOST_
+
+#include <windows.h>
+
+#include "d3dUtil.h"
+
+//  root signature  DWORD
+#define ROOT_SIGNATURE_MAX_DWORDS 64
+
+//   DWORD:  - 1, root CBV/SRV/UAV - 2
+//(64- GPU ), root  -    .
+//     
+struct RootSignatureCost
+{
+	UINT Tables = 0;
+	UINT Descriptors = 0;
+	UINT Constants = 0;
+	UINT Dwords = 0;
+};
+
+RootSignatureCost Get_Root_Signature_Cost(const D3D12_ROOT_SIGNATURE_DESC& Desc);
+
+//false - root signature  ROOT_SIGNATURE_MAX_DWORDS
+bool Report_Root_Signature_Cost(const char* Name, const RootSignatureCost& Cost);
+
+//CPU  :  Create_RootSignature ( CBV, root
+//CBV, root CBV     )   DWORD,
+//  64 DWORD .   OutputDebugString
+void Verify_Root_Signature_Cost();
+
+#endif
@@ -1,4 +1,9 @@
+#ifdef TEXTURE_ARRAY_ROOMS
+//all room textures as slices of one array or rectangles of an atlas
+Texture2DArray gDiffuseArray : register(t0);
+#else
 Texture2D    gDiffuseMap : register(t0);
+#endif
 
 SamplerState gsamPointWrap  : register(s0);
 SamplerState gsamPointClamp  : register(s1);
@@ -11,6 +16,9 @@ SamplerState gsamAnisotropicClamp  : register(s5);
 cbuffer cbPerObject : register(b0)
 {
 	float4x4 gWorld; 
+	//unpack quantized position: PosL * gPosScale + gPosBias
+	float4 gPosScale;
+	float4 gPosBias;
 };
 
 cbuffer cbPass : register(b1)
@@ -19,6 +27,27 @@ cbuffer cbPass : register(b1)
 	float3 gCamPos;
 };
 
+#ifdef TEXTURE_ARRAY_ROOMS
+//root constants: room texture rectangle (xy - offset, zw - scale) and array slice
+cbuffer cbRoomTexture : register(b2)
+{
+	float4 gTexRect;
+	uint gTexSlice;
+};
+#endif
+
+#ifdef ROOT_CONSTANT_BINDING
+//root constants: fog sphere (xyz - center, w - radius), fog color and path length for full fog
+cbuffer cbFog : register(b3)
+{
+	float4 gFogSphere;
+	float4 gFogColor;
+};
+#else
+static const float4 gFogSphere = float4(46433.0f, 6376.0f, 48650.0f, 4128.0f);
+static const float4 gFogColor = float4(0.0f, 223.0f / 255.0f, 191.0f / 255.0f, 12000.0f);
+#endif
+
 struct VertexIn
 {
 	float3 PosL  : POSITION;
@@ -42,11 +71,11 @@ float3 ComponentProd(float3 v1, float3 v2)
 
 float Check_Sphere(float3 vertexPos, float3 cameraPos)
 {
-	float fSphereRadius = 4128.0f;
+	float fSphereRadius = gFogSphere.w;
 
 	float val = 0.0f;
 
-	float3 vSphereCenter = float3(46433.0f, 6376.0f, 48650.0f);
+	float3 vSphereCenter = gFogSphere.xyz;
 
 	float3 m_Scale = float3(1.0f / fSphereRadius, 1.0f / fSphereRadius, 1.0f / fSphereRadius);
 
@@ -125,10 +154,17 @@ VertexOut VS(VertexIn vin)
 {
 	VertexOut vout;
 
-	float fog_val = Check_Sphere(vin.PosL, gCamPos);
+#ifdef COMPACT_VERTEX_FORMAT
+	//R16G16B16A16_UNORM gives [0, 1] relative to room bounding box
+	float3 PosL = vin.PosL * gPosScale.xyz + gPosBias.xyz;
+#else
+	float3 PosL = vin.PosL;
+#endif
+
+	float fog_val = Check_Sphere(PosL, gCamPos);
 	vout.fog_val = fog_val;
 	
-	float4 Pos = mul(float4(vin.PosL, 1.0f), gWorld);
+	float4 Pos = mul(float4(PosL, 1.0f), gWorld);
 
 	// Transform to homogeneous clip space.
 	vout.PosH = mul(Pos, gViewProj);
@@ -144,18 +180,26 @@ VertexOut VS(VertexIn vin)
 float4 PS(VertexOut pin) : SV_Target
 {
 	//get texel color
+#ifdef TEXTURE_ARRAY_ROOMS
+	//wrap inside the room rectangle, gradients of the unwrapped uv
+	//keep mip selection continuous across the wrap seam
+	float2 Uv = frac(pin.Tex) * gTexRect.zw + gTexRect.xy;
+	float4 ResColor = gDiffuseArray.SampleGrad(gsamLinearWrap, float3(Uv, gTexSlice),
+		ddx(pin.Tex) * gTexRect.zw, ddy(pin.Tex) * gTexRect.zw);
+#else
 	float4 ResColor =  gDiffuseMap.Sample(gsamLinearWrap, pin.Tex);
+#endif
 
 	//get fog valule
-	float FogVal = pin.fog_val / 12000.0f;
+	float FogVal = pin.fog_val / gFogColor.w;
 
 	//fog value inverse
 	float InvFogVal = 1.0f - FogVal;
 
 	//fog color
-	float fog_r = 0.0f;
-	float fog_g = 223.0f / 255.0f;
-	float fog_b = 191.0f / 255.0f;
+	float fog_r = gFogColor.x;
+	float fog_g = gFogColor.y;
+	float fog_b = gFogColor.z;
 
 	//calculating alpha blending value for fog color and texel color
 	float4 SrcAlpha = float4(fog_r, fog_g * FogVal, fog_b * FogVal, 1.0f);
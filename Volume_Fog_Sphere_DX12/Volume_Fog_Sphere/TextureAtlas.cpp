@@ -0,0 +1,329 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Texture Atlas DirectX12
+//======================================================================================
+
+#include "TextureAtlas.h"
+
+#include <stdio.h>
+#include <limits.h>
+#include <math.h>
+#include <algorithm>
+
+static UINT Align_Up(UINT Value, UINT Align)
+{
+	return (Value + Align - 1) / Align * Align;
+}
+
+static UINT Next_Pow2(UINT Value)
+{
+	UINT Result = 1;
+	while (Result < Value)
+		Result <<= 1;
+
+	return Result;
+}
+
+void CSkylinePacker::Init(UINT Width, UINT Height, UINT Align)
+{
+	m_Width = Width;
+	m_Height = Height;
+	m_Align = Align ? Align : 1;
+
+	//           0
+	m_Skyline.clear();
+	m_Skyline.push_back({ 0, 0, Width });
+}
+
+bool CSkylinePacker::Fit(size_t Index, UINT Width, UINT Height, UINT& Y) const
+{
+	UINT X = m_Skyline[Index].X;
+	if (X + Width > m_Width)
+		return false;
+
+	//       ,
+	//   ,     
+	UINT WidthLeft = Width;
+	Y = 0;
+
+	for (size_t i = Index; ; i++)
+	{
+		Y = std::max(Y, m_Skyline[i].Y);
+		if (Y + Height > m_Height)
+			return false;
+
+		if (m_Skyline[i].Width >= WidthLeft)
+			break;
+
+		WidthLeft -= m_Skyline[i].Width;
+	}
+
+	return true;
+}
+
+void CSkylinePacker::Add_Level(size_t Index, UINT X, UINT Y, UINT Width, UINT Height)
+{
+	SkylineNode Node = { X, Y + Height, Width };
+	m_Skyline.insert(m_Skyline.begin() + Index, Node);
+
+	//   ,   
+	size_t i = Index + 1;
+	while (i < m_Skyline.size())
+	{
+		UINT PrevRight = m_Skyline[i - 1].X + m_Skyline[i - 1].Width;
+		if (m_Skyline[i].X >= PrevRight)
+			break;
+
+		UINT Shrink = PrevRight - m_Skyline[i].X;
+		if (m_Skyline[i].Width <= Shrink)
+		{
+			m_Skyline.erase(m_Skyline.begin() + i);
+			continue;
+		}
+
+		m_Skyline[i].X += Shrink;
+		m_Skyline[i].Width -= Shrink;
+		break;
+	}
+
+	//    
+	i = 0;
+	while (i + 1 < m_Skyline.size())
+	{
+		if (m_Skyline[i].Y == m_Skyline[i + 1].Y)
+		{
+			m_Skyline[i].Width += m_Skyline[i + 1].Width;
+			m_Skyline.erase(m_Skyline.begin() + i + 1);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+bool CSkylinePacker::Insert(UINT Width, UINT Height, UINT& X, UINT& Y)
+{
+	Width = Align_Up(Width, m_Align);
+	Height = Align_Up(Height, m_Align);
+
+	//      ,
+	//  -   
+	size_t BestIndex = m_Skyline.size();
+	UINT BestTop = UINT_MAX;
+	UINT BestWidth = UINT_MAX;
+	UINT BestY = 0;
+
+	for (size_t i = 0; i < m_Skyline.size(); i++)
+	{
+		UINT NodeY;
+		if (!Fit(i, Width, Height, NodeY))
+			continue;
+
+		UINT Top = NodeY + Height;
+		if (Top < BestTop || (Top == BestTop && m_Skyline[i].Width < BestWidth))
+		{
+			BestIndex = i;
+			BestTop = Top;
+			BestWidth = m_Skyline[i].Width;
+			BestY = NodeY;
+		}
+	}
+
+	if (BestIndex == m_Skyline.size())
+		return false;
+
+	X = m_Skyline[BestIndex].X;
+	Y = BestY;
+
+	Add_Level(BestIndex, X, Y, Width, Height);
+
+	return true;
+}
+
+bool Pack_Atlas(std::vector<AtlasRect>& Rects, UINT Align, UINT MaxSize,
+	UINT& AtlasWidth, UINT& AtlasHeight)
+{
+	if (Rects.empty())
+		return false;
+
+	UINT64 Area = 0;
+	UINT MaxWidth = 0;
+	UINT MaxHeight = 0;
+
+	for (const AtlasRect& Rect : Rects)
+	{
+		UINT Width = Align_Up(Rect.Width, Align);
+		UINT Height = Align_Up(Rect.Height, Align);
+
+		Area += (UINT64)Width * Height;
+		MaxWidth = std::max(MaxWidth, Width);
+		MaxHeight = std::max(MaxHeight, Height);
+	}
+
+	//  ,     
+	std::vector<size_t> Order(Rects.size());
+	for (size_t i = 0; i < Order.size(); i++)
+		Order[i] = i;
+
+	std::stable_sort(Order.begin(), Order.end(), [&Rects](size_t a, size_t b)
+	{
+		if (Rects[a].Height != Rects[b].Height)
+			return Rects[a].Height > Rects[b].Height;
+		return Rects[a].Width > Rects[b].Width;
+	});
+
+	//   ,    
+	UINT Width = Next_Pow2(std::max(MaxWidth, (UINT)ceil(sqrt((double)Area))));
+	UINT Height = Next_Pow2(MaxHeight);
+	while ((UINT64)Width * Height < Area)
+		Height *= 2;
+
+	CSkylinePacker Packer;
+
+	while (Width <= MaxSize && Height <= MaxSize)
+	{
+		Packer.Init(Width, Height, Align);
+
+		bool Packed = true;
+		for (size_t i : Order)
+		{
+			if (!Packer.Insert(Rects[i].Width, Rects[i].Height, Rects[i].X, Rects[i].Y))
+			{
+				Packed = false;
+				break;
+			}
+		}
+
+		if (Packed)
+		{
+			//    ,    
+			UINT UsedHeight = 0;
+			for (const AtlasRect& Rect : Rects)
+				UsedHeight = std::max(UsedHeight, Rect.Y + Align_Up(Rect.Height, Align));
+
+			AtlasWidth = Width;
+			AtlasHeight = UsedHeight;
+			return true;
+		}
+
+		if (Height < Width)
+			Height *= 2;
+		else
+			Width *= 2;
+	}
+
+	return false;
+}
+
+UINT Atlas_Mip_Levels(const std::vector<AtlasRect>& Rects, UINT BlockSize, UINT MaxLevels)
+{
+	UINT Levels = 1;
+
+	while (Levels < MaxLevels)
+	{
+		UINT Step = BlockSize << Levels;
+
+		for (const AtlasRect& Rect : Rects)
+		{
+			if (Rect.X % Step || Rect.Y % Step || Rect.Width % Step || Rect.Height % Step)
+				return Levels;
+		}
+
+		Levels++;
+	}
+
+	return Levels;
+}
+
+static bool Check_Atlas(const std::vector<AtlasRect>& Rects, UINT Align, UINT AtlasWidth, UINT AtlasHeight)
+{
+	for (size_t i = 0; i < Rects.size(); i++)
+	{
+		const AtlasRect& A = Rects[i];
+
+		if (A.X % Align || A.Y % Align ||
+			A.X + A.Width > AtlasWidth || A.Y + A.Height > AtlasHeight)
+			return false;
+
+		for (size_t j = i + 1; j < Rects.size(); j++)
+		{
+			const AtlasRect& B = Rects[j];
+
+			if (A.X < B.X + B.Width && B.X < A.X + A.Width &&
+				A.Y < B.Y + B.Height && B.Y < A.Y + A.Height)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void Verify_Skyline_Packer()
+{
+	struct PackerCase
+	{
+		const char* Name;
+		UINT Count;
+		UINT MinSize;
+		UINT MaxSize;
+		UINT Align;
+		bool PowerOfTwo;
+	};
+
+	//12  ,     
+	// BC   mip ,   
+	static const PackerCase Cases[] =
+	{
+		{ "rooms 256x256", 12, 256, 256, 64, true },
+		{ "power of two 32..512", 40, 32, 512, 64, true },
+		{ "mixed 16..256", 64, 16, 256, 16, false },
+		{ "small 4..64", 400, 4, 64, 4, false },
+	};
+
+	__int64 PerfFreq;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&PerfFreq);
+
+	UINT Seed = 12345;
+
+	for (UINT c = 0; c < _countof(Cases); c++)
+	{
+		const PackerCase& Case = Cases[c];
+
+		std::vector<AtlasRect> Rects(Case.Count);
+		UINT64 Area = 0;
+
+		for (AtlasRect& Rect : Rects)
+		{
+			UINT Size[2];
+			for (UINT k = 0; k < 2; k++)
+			{
+				Seed = Seed * 1664525 + 1013904223;
+				Size[k] = Case.MinSize + (Seed >> 8) % (Case.MaxSize - Case.MinSize + 1);
+				if (Case.PowerOfTwo)
+					Size[k] = std::min(Next_Pow2(Size[k]), Case.MaxSize);
+			}
+
+			Rect.X = Rect.Y = 0;
+			Rect.Width = Size[0];
+			Rect.Height = Size[1];
+			Area += (UINT64)Size[0] * Size[1];
+		}
+
+		__int64 Time0, Time1;
+		QueryPerformanceCounter((LARGE_INTEGER*)&Time0);
+
+		UINT AtlasWidth = 0, AtlasHeight = 0;
+		bool Packed = Pack_Atlas(Rects, Case.Align, 16384, AtlasWidth, AtlasHeight);
+
+		QueryPerformanceCounter((LARGE_INTEGER*)&Time1);
+
+		bool Valid = Packed && Check_Atlas(Rects, Case.Align, AtlasWidth, AtlasHeight);
+
+		char Buffer[256];
+		sprintf_s(Buffer, "Skyline packer %s: %u rects -> %ux%u, occupancy %.1f%%, %.3f ms %s\n",
+			Case.Name, Case.Count, AtlasWidth, AtlasHeight,
+			Packed ? 100.0 * (double)Area / ((double)AtlasWidth * AtlasHeight) : 0.0,
+			(double)(Time1 - Time0) * 1000.0 / PerfFreq, Valid ? "OK" : "FAILED");
+		OutputDebugStringA(Buffer);
+	}
+}
@@ -0,0 +1,65 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Texture Atlas DirectX12
+//======================================================================================
+
+#ifndef _TEXTUREATLAS_
+#define _TEXTUREATLAS_
+
+#include <windows.h>
+#include <vector>
+
+//  , Width  Height 
+// , X  Y  
+struct AtlasRect
+{
+	UINT X;
+	UINT Y;
+	UINT Width;
+	UINT Height;
+};
+
+// skyline (bottom-left):    
+//    ,  
+// ,      
+class CSkylinePacker
+{
+public:
+	//       Align
+	void Init(UINT Width, UINT Height, UINT Align);
+	bool Insert(UINT Width, UINT Height, UINT& X, UINT& Y);
+
+private:
+	struct SkylineNode
+	{
+		UINT X;
+		UINT Y;
+		UINT Width;
+	};
+
+	bool Fit(size_t Index, UINT Width, UINT Height, UINT& Y) const;
+	void Add_Level(size_t Index, UINT X, UINT Y, UINT Width, UINT Height);
+
+	std::vector<SkylineNode> m_Skyline;
+	UINT m_Width = 0;
+	UINT m_Height = 0;
+	UINT m_Align = 1;
+};
+
+// Rects        
+//MaxSize,    ,   
+//  .      ,
+//  Align
+bool Pack_Atlas(std::vector<AtlasRect>& Rects, UINT Align, UINT MaxSize,
+	UINT& AtlasWidth, UINT& AtlasHeight);
+
+// mip   (  MaxLevels)  
+//  :   L   
+//    BlockSize << L
+UINT Atlas_Mip_Levels(const std::vector<AtlasRect>& Rects, UINT BlockSize, UINT MaxLevels);
+
+//   ,  ,
+//  ,    
+//  OutputDebugString
+void Verify_Skyline_Packer();
+
+#endif
@@ -0,0 +1,105 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Thread Pool
+//======================================================================================
+
+#include "ThreadPool.h"
+
+CThreadPool::CThreadPool(UINT NumThreads)
+{
+	if (NumThreads == 0)
+		NumThreads = std::thread::hardware_concurrency();
+
+	if (NumThreads == 0)
+		NumThreads = 4;
+
+	for (UINT i = 0; i < NumThreads; i++)
+		m_Threads.emplace_back(&CThreadPool::Worker_Proc, this);
+}
+
+CThreadPool::~CThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_Quit = true;
+	}
+
+	m_TaskReady.notify_all();
+
+	for (auto& Thread : m_Threads)
+		Thread.join();
+}
+
+void CThreadPool::Add_Task(std::function<void()> Task)
+{
+	{
+		std::lock_guard<std::mutex> Lock(m_Mutex);
+		m_Tasks.push(std::move(Task));
+		m_TasksInFlight++;
+	}
+
+	m_TaskReady.notify_one();
+}
+
+void CThreadPool::Wait_All()
+{
+	std::unique_lock<std::mutex> Lock(m_Mutex);
+	m_AllDone.wait(Lock, [this] { return m_TasksInFlight == 0; });
+
+	if (m_Error)
+	{
+		std::exception_ptr Error = m_Error;
+		m_Error = nullptr;
+
+		Lock.unlock();
+		std::rethrow_exception(Error);
+	}
+}
+
+UINT CThreadPool::Get_Num_Threads() const
+{
+	return (UINT)m_Threads.size();
+}
+
+void CThreadPool::Worker_Proc()
+{
+	for (;;)
+	{
+		std::function<void()> Task;
+
+		{
+			std::unique_lock<std::mutex> Lock(m_Mutex);
+			m_TaskReady.wait(Lock, [this] { return m_Quit || !m_Tasks.empty(); });
+
+			if (m_Quit && m_Tasks.empty())
+				return;
+
+			Task = std::move(m_Tasks.front());
+			m_Tasks.pop();
+		}
+
+		//      std::terminate,
+		//   Wait_All
+		std::exception_ptr Error;
+
+		try
+		{
+			Task();
+		}
+		catch (...)
+		{
+			Error = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> Lock(m_Mutex);
+
+			if (Error && !m_Error)
+				m_Error = Error;
+
+			m_TasksInFlight--;
+
+			if (m_TasksInFlight == 0)
+				m_AllDone.notify_all();
+		}
+	}
+}
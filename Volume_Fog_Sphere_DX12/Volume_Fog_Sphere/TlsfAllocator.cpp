@@ -0,0 +1,822 @@
+//======================================================================================
+//	Ed Kurlyak 2023 TLSF Allocator DirectX12
+//======================================================================================
+
+#include "TlsfAllocator.h"
+
+#include <intrin.h>
+#include <stdio.h>
+#include <map>
+
+static UINT Bit_Scan_Forward(UINT64 Mask)
+{
+	unsigned long Index = 0;
+	_BitScanForward64(&Index, Mask);
+	return (UINT)Index;
+}
+
+static UINT Bit_Scan_Reverse(UINT64 Mask)
+{
+	unsigned long Index = 0;
+	_BitScanReverse64(&Index, Mask);
+	return (UINT)Index;
+}
+
+// : FL -  , SL -   16  ,
+//  16         
+static void Mapping_Insert(UINT64 Size, UINT& Fl, UINT& Sl)
+{
+	if (Size < TLSF_SL_COUNT)
+	{
+		Fl = 0;
+		Sl = (UINT)Size;
+	}
+	else
+	{
+		UINT Log2 = Bit_Scan_Reverse(Size);
+		Fl = Log2 - TLSF_SL_LOG2 + 1;
+		Sl = (UINT)(Size >> (Log2 - TLSF_SL_LOG2)) - TLSF_SL_COUNT;
+	}
+}
+
+//        ,
+//       
+static void Mapping_Search(UINT64 Size, UINT& Fl, UINT& Sl)
+{
+	if (Size >= TLSF_SL_COUNT)
+		Size += (1ull << (Bit_Scan_Reverse(Size) - TLSF_SL_LOG2)) - 1;
+
+	Mapping_Insert(Size, Fl, Sl);
+}
+
+static UINT64 Align_Up(UINT64 Value, UINT64 Align)
+{
+	return (Value + Align - 1) & ~(Align - 1);
+}
+
+void CTlsfAllocator::Init(UINT64 Size)
+{
+	m_Blocks.clear();
+	m_Unused.clear();
+
+	m_FlBitmap = 0;
+	for (UINT Fl = 0; Fl < TLSF_FL_COUNT; Fl++)
+	{
+		m_SlBitmap[Fl] = 0;
+		for (UINT Sl = 0; Sl < TLSF_SL_COUNT; Sl++)
+			m_FreeHeads[Fl][Sl] = TLSF_NULL_BLOCK;
+	}
+
+	m_First = TLSF_NULL_BLOCK;
+	m_Size = Size;
+	m_Used = 0;
+	m_UsedBlocks = 0;
+	m_Merges = 0;
+	m_Splits = 0;
+	m_Failed = 0;
+
+	if (Size == 0)
+		return;
+
+	m_First = New_Block();
+
+	Block& First = m_Blocks[m_First];
+	First.Offset = 0;
+	First.Size = Size;
+	First.PrevPhys = TLSF_NULL_BLOCK;
+	First.NextPhys = TLSF_NULL_BLOCK;
+
+	Insert_Free(m_First);
+}
+
+UINT CTlsfAllocator::Find_Free(UINT64 Size)
+{
+	UINT Fl, Sl;
+	Mapping_Search(Size, Fl, Sl);
+
+	if (Fl >= TLSF_FL_COUNT)
+		return TLSF_NULL_BLOCK;
+
+	UINT SlMap = m_SlBitmap[Fl] & (~0u << Sl);
+
+	if (SlMap == 0)
+	{
+		//    ,   
+		UINT64 FlMap = Fl + 1 < 64 ? m_FlBitmap & (~0ull << (Fl + 1)) : 0;
+		if (FlMap == 0)
+			return TLSF_NULL_BLOCK;
+
+		Fl = Bit_Scan_Forward(FlMap);
+		SlMap = m_SlBitmap[Fl];
+	}
+
+	Sl = Bit_Scan_Forward(SlMap);
+
+	return m_FreeHeads[Fl][Sl];
+}
+
+UINT CTlsfAllocator::Find_In_Class(UINT64 Size, UINT64 Align)
+{
+	//      , 
+	// ,      
+	UINT Fl, Sl;
+	Mapping_Insert(Size, Fl, Sl);
+
+	for (UINT Index = m_FreeHeads[Fl][Sl]; Index != TLSF_NULL_BLOCK; Index = m_Blocks[Index].NextFree)
+	{
+		const Block& B = m_Blocks[Index];
+		if (Align_Up(B.Offset, Align) + Size <= B.Offset + B.Size)
+			return Index;
+	}
+
+	return TLSF_NULL_BLOCK;
+}
+
+void CTlsfAllocator::Insert_Free(UINT Index)
+{
+	Block& B = m_Blocks[Index];
+
+	UINT Fl, Sl;
+	Mapping_Insert(B.Size, Fl, Sl);
+
+	B.Free = true;
+	B.PrevFree = TLSF_NULL_BLOCK;
+	B.NextFree = m_FreeHeads[Fl][Sl];
+
+	if (B.NextFree != TLSF_NULL_BLOCK)
+		m_Blocks[B.NextFree].PrevFree = Index;
+
+	m_FreeHeads[Fl][Sl] = Index;
+	m_FlBitmap |= 1ull << Fl;
+	m_SlBitmap[Fl] |= 1u << Sl;
+}
+
+void CTlsfAllocator::Remove_Free(UINT Index)
+{
+	Block& B = m_Blocks[Index];
+
+	UINT Fl, Sl;
+	Mapping_Insert(B.Size, Fl, Sl);
+
+	if (B.PrevFree != TLSF_NULL_BLOCK)
+		m_Blocks[B.PrevFree].NextFree = B.NextFree;
+	else
+		m_FreeHeads[Fl][Sl] = B.NextFree;
+
+	if (B.NextFree != TLSF_NULL_BLOCK)
+		m_Blocks[B.NextFree].PrevFree = B.PrevFree;
+
+	if (m_FreeHeads[Fl][Sl] == TLSF_NULL_BLOCK)
+	{
+		m_SlBitmap[Fl] &= ~(1u << Sl);
+		if (m_SlBitmap[Fl] == 0)
+			m_FlBitmap &= ~(1ull << Fl);
+	}
+
+	B.Free = false;
+}
+
+UINT CTlsfAllocator::New_Block()
+{
+	UINT Index;
+
+	if (!m_Unused.empty())
+	{
+		Index = m_Unused.back();
+		m_Unused.pop_back();
+	}
+	else
+	{
+		Index = (UINT)m_Blocks.size();
+		m_Blocks.push_back(Block());
+	}
+
+	Block& B = m_Blocks[Index];
+	B.Offset = 0;
+	B.Size = 0;
+	B.PrevPhys = B.NextPhys = TLSF_NULL_BLOCK;
+	B.PrevFree = B.NextFree = TLSF_NULL_BLOCK;
+	B.Free = false;
+
+	return Index;
+}
+
+void CTlsfAllocator::Delete_Block(UINT Index)
+{
+	//   ,  Free   
+	m_Blocks[Index].Size = 0;
+	m_Blocks[Index].Free = true;
+	m_Unused.push_back(Index);
+}
+
+bool CTlsfAllocator::Allocate(UINT64 Size, UINT64 Align, UINT64& Offset, UINT& Handle)
+{
+	if (Size == 0)
+		Size = 1;
+
+	if (Align == 0)
+		Align = 1;
+
+	//   ,     ,
+	//     
+	UINT Index = Find_Free(Size);
+
+	if (Index != TLSF_NULL_BLOCK)
+	{
+		const Block& B = m_Blocks[Index];
+		if (Align_Up(B.Offset, Align) + Size > B.Offset + B.Size)
+			Index = TLSF_NULL_BLOCK;
+	}
+
+	if (Index == TLSF_NULL_BLOCK && Align > 1)
+		Index = Find_Free(Size + Align - 1);
+
+	if (Index == TLSF_NULL_BLOCK)
+		Index = Find_In_Class(Size, Align);
+
+	if (Index == TLSF_NULL_BLOCK)
+	{
+		m_Failed++;
+		return false;
+	}
+
+	Remove_Free(Index);
+
+	UINT64 Aligned = Align_Up(m_Blocks[Index].Offset, Align);
+	UINT64 Pad = Aligned - m_Blocks[Index].Offset;
+
+	//     ,  
+	//    ,     
+	if (Pad > 0)
+	{
+		UINT Front = New_Block();
+
+		Block& B = m_Blocks[Index];
+		Block& F = m_Blocks[Front];
+
+		F.Offset = B.Offset;
+		F.Size = Pad;
+		F.PrevPhys = B.PrevPhys;
+		F.NextPhys = Index;
+
+		if (B.PrevPhys != TLSF_NULL_BLOCK)
+			m_Blocks[B.PrevPhys].NextPhys = Front;
+		else
+			m_First = Front;
+
+		B.PrevPhys = Front;
+		B.Offset = Aligned;
+		B.Size -= Pad;
+
+		Insert_Free(Front);
+		m_Splits++;
+	}
+
+	//    ,   
+	if (m_Blocks[Index].Size > Size)
+	{
+		UINT Back = New_Block();
+
+		Block& B = m_Blocks[Index];
+		Block& R = m_Blocks[Back];
+
+		R.Offset = B.Offset + Size;
+		R.Size = B.Size - Size;
+		R.PrevPhys = Index;
+		R.NextPhys = B.NextPhys;
+
+		if (B.NextPhys != TLSF_NULL_BLOCK)
+			m_Blocks[B.NextPhys].PrevPhys = Back;
+
+		B.NextPhys = Back;
+		B.Size = Size;
+
+		Insert_Free(Back);
+		m_Splits++;
+	}
+
+	m_Used += Size;
+	m_UsedBlocks++;
+
+	Offset = Aligned;
+	Handle = Index;
+
+	return true;
+}
+
+void CTlsfAllocator::Free(UINT Handle)
+{
+	if (Handle >= (UINT)m_Blocks.size() || m_Blocks[Handle].Free)
+		return;
+
+	m_Used -= m_Blocks[Handle].Size;
+	m_UsedBlocks--;
+
+	UINT Index = Handle;
+
+	//   ,  
+	UINT Prev = m_Blocks[Index].PrevPhys;
+	if (Prev != TLSF_NULL_BLOCK && m_Blocks[Prev].Free)
+	{
+		Remove_Free(Prev);
+
+		Block& P = m_Blocks[Prev];
+		const Block& B = m_Blocks[Index];
+
+		P.Size += B.Size;
+		P.NextPhys = B.NextPhys;
+		if (B.NextPhys != TLSF_NULL_BLOCK)
+			m_Blocks[B.NextPhys].PrevPhys = Prev;
+
+		Delete_Block(Index);
+		Index = Prev;
+		m_Merges++;
+	}
+
+	//  ,  
+	UINT Next = m_Blocks[Index].NextPhys;
+	if (Next != TLSF_NULL_BLOCK && m_Blocks[Next].Free)
+	{
+		Remove_Free(Next);
+
+		Block& B = m_Blocks[Index];
+		const Block& N = m_Blocks[Next];
+
+		B.Size += N.Size;
+		B.NextPhys = N.NextPhys;
+		if (N.NextPhys != TLSF_NULL_BLOCK)
+			m_Blocks[N.NextPhys].PrevPhys = Index;
+
+		Delete_Block(Next);
+		m_Merges++;
+	}
+
+	Insert_Free(Index);
+}
+
+UINT64 CTlsfAllocator::Block_Size(UINT Handle) const
+{
+	if (Handle >= (UINT)m_Blocks.size() || m_Blocks[Handle].Free)
+		return 0;
+
+	return m_Blocks[Handle].Size;
+}
+
+UINT64 CTlsfAllocator::Size() const
+{
+	return m_Size;
+}
+
+UINT64 CTlsfAllocator::Used() const
+{
+	return m_Used;
+}
+
+bool CTlsfAllocator::Empty() const
+{
+	return m_UsedBlocks == 0;
+}
+
+TlsfStats CTlsfAllocator::Get_Stats() const
+{
+	TlsfStats Stats;
+	Stats.Size = m_Size;
+	Stats.Used = m_Used;
+	Stats.UsedBlocks = m_UsedBlocks;
+	Stats.Merges = m_Merges;
+	Stats.Splits = m_Splits;
+	Stats.Failed = m_Failed;
+
+	for (UINT Index = m_First; Index != TLSF_NULL_BLOCK; Index = m_Blocks[Index].NextPhys)
+	{
+		const Block& B = m_Blocks[Index];
+		if (!B.Free)
+			continue;
+
+		Stats.Free += B.Size;
+		Stats.FreeBlocks++;
+
+		if (B.Size > Stats.LargestFree)
+			Stats.LargestFree = B.Size;
+	}
+
+	if (Stats.Free > 0)
+		Stats.Fragmentation = 1.0 - (double)Stats.LargestFree / Stats.Free;
+
+	return Stats;
+}
+
+void Verify_Tlsf_Allocator()
+{
+	bool Valid = true;
+
+	const UINT64 KB = 1024;
+
+	CTlsfAllocator Tlsf;
+	UINT64 Offset;
+	UINT Handle[8];
+
+	//    ,   
+	Tlsf.Init(1024 * KB);
+
+	for (UINT i = 0; i < 4; i++)
+	{
+		if (!Tlsf.Allocate(256 * KB, 64 * KB, Offset, Handle[i]) || Offset != i * 256 * KB)
+			Valid = false;
+	}
+
+	if (Tlsf.Allocate(1, 1, Offset, Handle[4]) || Tlsf.Get_Stats().FreeBlocks != 0)
+		Valid = false;
+
+	//      
+	Tlsf.Free(Handle[1]);
+	Tlsf.Free(Handle[2]);
+	Tlsf.Free(Handle[2]);
+
+	TlsfStats Stats = Tlsf.Get_Stats();
+	if (Stats.FreeBlocks != 1 || Stats.LargestFree != 512 * KB || Stats.Used != 512 * KB)
+		Valid = false;
+
+	if (!Tlsf.Allocate(512 * KB, 64 * KB, Offset, Handle[1]) || Offset != 256 * KB)
+		Valid = false;
+
+	Tlsf.Free(Handle[0]);
+	Tlsf.Free(Handle[1]);
+	Tlsf.Free(Handle[3]);
+
+	Stats = Tlsf.Get_Stats();
+	if (!Tlsf.Empty() || Stats.FreeBlocks != 1 || Stats.Free != 1024 * KB || Stats.Fragmentation != 0.0)
+		Valid = false;
+
+	//     
+	Tlsf.Init(1024 * KB);
+
+	if (!Tlsf.Allocate(100, 1, Offset, Handle[0]) || Offset != 0)
+		Valid = false;
+
+	if (!Tlsf.Allocate(64 * KB, 64 * KB, Offset, Handle[1]) || Offset != 64 * KB)
+		Valid = false;
+
+	if (!Tlsf.Allocate(1000, 4 * KB, Offset, Handle[2]) || Offset % (4 * KB) != 0 || Offset + 1000 > 64 * KB)
+		Valid = false;
+
+	if (Tlsf.Block_Size(Handle[2]) != 1000 || Tlsf.Used() != 100 + 64 * KB + 1000)
+		Valid = false;
+
+	//      
+	for (UINT i = 0; i < 3; i++)
+		Tlsf.Free(Handle[i]);
+
+	if (!Tlsf.Allocate(1024 * KB, 1, Offset, Handle[0]) || Offset != 0)
+		Valid = false;
+
+	//     ,    
+	Tlsf.Init(16 * 1024 * KB + 64 * KB);
+
+	if (!Tlsf.Allocate(16 * 1024 * KB + 64 * KB, 64 * KB, Offset, Handle[0]) || Offset != 0)
+		Valid = false;
+
+	//      
+	struct TestBlock
+	{
+		UINT Handle;
+		UINT64 Offset;
+		UINT64 Size;
+	};
+
+	const UINT64 Capacity = 16 * 1024 * KB;
+	static const UINT64 Aligns[] = { 1, 4, 256, 4 * KB, 64 * KB };
+
+	Tlsf.Init(Capacity);
+
+	std::vector<TestBlock> Live;
+	std::map<UINT64, UINT64> Ranges;
+	UINT64 LiveBytes = 0;
+	UINT Allocations = 0, Failed = 0;
+	double MaxFragmentation = 0.0;
+
+	UINT Seed = 12345;
+
+	for (UINT Op = 0; Op < 200000; Op++)
+	{
+		Seed = Seed * 1664525 + 1013904223;
+		bool DoFree = !Live.empty() && (Seed >> 8) % 100 < (LiveBytes > Capacity / 2 ? 60u : 40u);
+
+		if (DoFree)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			size_t i = (Seed >> 8) % Live.size();
+
+			Tlsf.Free(Live[i].Handle);
+			Ranges.erase(Live[i].Offset);
+			LiveBytes -= Live[i].Size;
+
+			Live[i] = Live.back();
+			Live.pop_back();
+		}
+		else
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			UINT64 Align = Aligns[(Seed >> 8) % _countof(Aligns)];
+
+			//   ,   1 MB
+			Seed = Seed * 1664525 + 1013904223;
+			UINT64 Size = (Seed >> 8) % 16 == 0 ? 1 + (Seed >> 12) % (1024 * KB) : 1 + (Seed >> 12) % (16 * KB);
+
+			TestBlock Block;
+			if (!Tlsf.Allocate(Size, Align, Block.Offset, Block.Handle))
+			{
+				// ,       
+				//     
+				UINT64 Need = Size + Align - 1;
+				if (Tlsf.Get_Stats().LargestFree > Need + (Need >> TLSF_SL_LOG2))
+					Valid = false;
+
+				Failed++;
+				continue;
+			}
+
+			Block.Size = Size;
+
+			if (Block.Offset % Align != 0 || Block.Offset + Size > Capacity || Tlsf.Block_Size(Block.Handle) != Size)
+				Valid = false;
+
+			//       
+			std::map<UINT64, UINT64>::iterator Next = Ranges.lower_bound(Block.Offset);
+			if (Next != Ranges.end() && Next->first < Block.Offset + Size)
+				Valid = false;
+			if (Next != Ranges.begin())
+			{
+				std::map<UINT64, UINT64>::iterator Prev = Next;
+				--Prev;
+				if (Prev->first + Prev->second > Block.Offset)
+					Valid = false;
+			}
+
+			Ranges[Block.Offset] = Size;
+			Live.push_back(Block);
+			LiveBytes += Size;
+			Allocations++;
+		}
+
+		if (Op % 1000 == 0)
+		{
+			Stats = Tlsf.Get_Stats();
+			if (Stats.Used != LiveBytes || Stats.Used + Stats.Free != Capacity || Stats.UsedBlocks != (UINT)Live.size())
+				Valid = false;
+
+			if (Stats.Fragmentation > MaxFragmentation)
+				MaxFragmentation = Stats.Fragmentation;
+		}
+	}
+
+	for (const TestBlock& Block : Live)
+		Tlsf.Free(Block.Handle);
+
+	Stats = Tlsf.Get_Stats();
+	if (!Tlsf.Empty() || Stats.FreeBlocks != 1 || Stats.Free != Capacity)
+		Valid = false;
+
+	char Buffer[256];
+	sprintf_s(Buffer, "TLSF allocator: %u allocations, %u failed, %llu merges, %llu splits, max fragmentation %.1f%% %s\n",
+		Allocations, Failed, Stats.Merges, Stats.Splits, 100.0 * MaxFragmentation, Valid ? "OK" : "FAILED");
+	OutputDebugStringA(Buffer);
+}
+
+// : first fit     
+class CFirstFitAllocator
+{
+public:
+	void Init(UINT64 Size)
+	{
+		m_Free.clear();
+		m_Free[0] = Size;
+	}
+
+	bool Allocate(UINT64 Size, UINT64 Align, UINT64& Offset)
+	{
+		for (std::map<UINT64, UINT64>::iterator It = m_Free.begin(); It != m_Free.end(); ++It)
+		{
+			UINT64 Start = It->first;
+			UINT64 End = It->first + It->second;
+			UINT64 Aligned = Align_Up(Start, Align);
+
+			if (Aligned + Size > End)
+				continue;
+
+			m_Free.erase(It);
+
+			if (Aligned > Start)
+				m_Free[Start] = Aligned - Start;
+			if (Aligned + Size < End)
+				m_Free[Aligned + Size] = End - Aligned - Size;
+
+			Offset = Aligned;
+			return true;
+		}
+
+		return false;
+	}
+
+	void Free(UINT64 Offset, UINT64 Size)
+	{
+		std::map<UINT64, UINT64>::iterator It = m_Free.insert(std::make_pair(Offset, Size)).first;
+
+		std::map<UINT64, UINT64>::iterator Next = It;
+		++Next;
+		if (Next != m_Free.end() && It->first + It->second == Next->first)
+		{
+			It->second += Next->second;
+			m_Free.erase(Next);
+		}
+
+		if (It != m_Free.begin())
+		{
+			std::map<UINT64, UINT64>::iterator Prev = It;
+			--Prev;
+			if (Prev->first + Prev->second == It->first)
+			{
+				Prev->second += It->second;
+				m_Free.erase(It);
+			}
+		}
+	}
+
+	double Fragmentation() const
+	{
+		UINT64 Free = 0, Largest = 0;
+		for (const std::pair<const UINT64, UINT64>& Range : m_Free)
+		{
+			Free += Range.second;
+			if (Range.second > Largest)
+				Largest = Range.second;
+		}
+
+		return Free > 0 ? 1.0 - (double)Largest / Free : 0.0;
+	}
+
+private:
+	std::map<UINT64, UINT64> m_Free;
+};
+
+void Benchmark_Tlsf_Allocator()
+{
+	struct BenchOp
+	{
+		bool Free;
+		// Free -   ,  Allocate - 
+		UINT64 Value;
+		UINT64 Align;
+	};
+
+	// 256 MB:       64 KB,
+	//  4 KB,    75%
+	const UINT64 KB = 1024;
+	const UINT64 Capacity = 256 * 1024 * KB;
+	const UINT NumOps = 200000;
+
+	std::vector<BenchOp> Ops;
+	Ops.reserve(NumOps);
+
+	std::vector<UINT64> LiveSizes;
+	UINT64 LiveBytes = 0;
+
+	UINT Seed = 12345;
+
+	for (UINT Op = 0; Op < NumOps; Op++)
+	{
+		Seed = Seed * 1664525 + 1013904223;
+		bool DoFree = !LiveSizes.empty() && (LiveBytes > Capacity * 3 / 4 || (Seed >> 8) % 100 < 45);
+
+		BenchOp B;
+		B.Free = DoFree;
+
+		if (DoFree)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			B.Value = (Seed >> 8) % LiveSizes.size();
+			B.Align = 0;
+
+			LiveBytes -= LiveSizes[(size_t)B.Value];
+			LiveSizes[(size_t)B.Value] = LiveSizes.back();
+			LiveSizes.pop_back();
+		}
+		else
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			UINT Kind = (Seed >> 8) % 8;
+
+			Seed = Seed * 1664525 + 1013904223;
+			if (Kind < 3)
+			{
+				B.Value = (1 + (Seed >> 8) % 16) * 4 * KB;
+				B.Align = 4 * KB;
+			}
+			else if (Kind < 7)
+			{
+				B.Value = (1 + (Seed >> 8) % 32) * 64 * KB;
+				B.Align = 64 * KB;
+			}
+			else
+			{
+				B.Value = (1 + (Seed >> 8) % 64) * 256 * KB;
+				B.Align = 64 * KB;
+			}
+
+			LiveSizes.push_back(B.Value);
+			LiveBytes += B.Value;
+		}
+
+		Ops.push_back(B);
+	}
+
+	__int64 PerfFreq;
+	QueryPerformanceFrequency((LARGE_INTEGER*)&PerfFreq);
+
+	static const char* Names[] = { "TLSF", "first fit" };
+
+	for (UINT Kind = 0; Kind < 2; Kind++)
+	{
+		struct LiveBlock
+		{
+			UINT64 Offset;
+			UINT64 Size;
+			UINT Handle;
+			bool Allocated;
+		};
+
+		CTlsfAllocator Tlsf;
+		CFirstFitAllocator FirstFit;
+
+		Tlsf.Init(Capacity);
+		FirstFit.Init(Capacity);
+
+		std::vector<LiveBlock> Live;
+		Live.reserve(NumOps);
+
+		UINT Failed = 0;
+		double SumFragmentation = 0.0, MaxFragmentation = 0.0;
+		UINT Samples = 0;
+		__int64 Ticks = 0;
+
+		for (UINT Op = 0; Op < NumOps; Op++)
+		{
+			const BenchOp& B = Ops[Op];
+
+			__int64 Time0, Time1;
+			QueryPerformanceCounter((LARGE_INTEGER*)&Time0);
+
+			if (B.Free)
+			{
+				LiveBlock& Block = Live[(size_t)B.Value];
+
+				if (Block.Allocated)
+				{
+					if (Kind == 0)
+						Tlsf.Free(Block.Handle);
+					else
+						FirstFit.Free(Block.Offset, Block.Size);
+				}
+
+				Block = Live.back();
+				Live.pop_back();
+			}
+			else
+			{
+				LiveBlock Block;
+				Block.Size = B.Value;
+				Block.Handle = 0;
+
+				if (Kind == 0)
+					Block.Allocated = Tlsf.Allocate(B.Value, B.Align, Block.Offset, Block.Handle);
+				else
+					Block.Allocated = FirstFit.Allocate(B.Value, B.Align, Block.Offset);
+
+				//    ,  
+				// Free    
+				if (!Block.Allocated)
+					Failed++;
+
+				Live.push_back(Block);
+			}
+
+			QueryPerformanceCounter((LARGE_INTEGER*)&Time1);
+			Ticks += Time1 - Time0;
+
+			if (Op % 1000 == 999)
+			{
+				double Fragmentation = Kind == 0 ? Tlsf.Get_Stats().Fragmentation : FirstFit.Fragmentation();
+				SumFragmentation += Fragmentation;
+				if (Fragmentation > MaxFragmentation)
+					MaxFragmentation = Fragmentation;
+				Samples++;
+			}
+		}
+
+		char Buffer[256];
+		sprintf_s(Buffer, "Heap allocator %s: %u ops %.1f ns/op, %u failed, fragmentation avg %.1f%% max %.1f%%\n",
+			Names[Kind], NumOps, (double)Ticks * 1.0e9 / PerfFreq / NumOps, Failed,
+			100.0 * SumFragmentation / Samples, 100.0 * MaxFragmentation);
+		OutputDebugStringA(Buffer);
+	}
+}
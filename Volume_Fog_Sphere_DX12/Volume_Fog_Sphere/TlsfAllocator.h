@@ -0,0 +1,106 @@
+//======================================================================================
+//	Ed Kurlyak 2023 TLSF Allocator DirectX12
+//======================================================================================
+
+#ifndef _TLSFALLOCATOR_
+#define _TLSFALLOCATOR_
+
+#include <windows.h>
+#include <limits.h>
+#include <vector>
+
+//      16  
+#define TLSF_SL_LOG2 4
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+#define TLSF_FL_COUNT (64 - TLSF_SL_LOG2 + 1)
+
+#define TLSF_NULL_BLOCK UINT_MAX
+
+struct TlsfStats
+{
+	UINT64 Size = 0;
+	UINT64 Used = 0;
+	UINT64 Free = 0;
+	UINT64 LargestFree = 0;
+	UINT UsedBlocks = 0;
+	UINT FreeBlocks = 0;
+	//         
+	UINT64 Merges = 0;
+	UINT64 Splits = 0;
+	UINT64 Failed = 0;
+	//1 - LargestFree / Free, 0 -     
+	double Fragmentation = 0.0;
+};
+
+//TLSF (two-level segregated fit)   
+// [0, Size),  D3D12. Allocate  Free  O(1): 
+//      ,   
+//,     
+class CTlsfAllocator
+{
+public:
+	CTlsfAllocator() = default;
+
+	void Init(UINT64 Size);
+
+	//Align -  , Handle   Free
+	bool Allocate(UINT64 Size, UINT64 Align, UINT64& Offset, UINT& Handle);
+	void Free(UINT Handle);
+
+	UINT64 Block_Size(UINT Handle) const;
+	UINT64 Size() const;
+	UINT64 Used() const;
+	bool Empty() const;
+
+	//  ,   
+	TlsfStats Get_Stats() const;
+
+private:
+	struct Block
+	{
+		UINT64 Offset;
+		UINT64 Size;
+		//       
+		UINT PrevPhys;
+		UINT NextPhys;
+		UINT PrevFree;
+		UINT NextFree;
+		bool Free;
+	};
+
+	UINT Find_Free(UINT64 Size);
+	UINT Find_In_Class(UINT64 Size, UINT64 Align);
+	void Insert_Free(UINT Index);
+	void Remove_Free(UINT Index);
+	UINT New_Block();
+	void Delete_Block(UINT Index);
+
+	std::vector<Block> m_Blocks;
+	//     
+	std::vector<UINT> m_Unused;
+
+	UINT64 m_FlBitmap = 0;
+	UINT m_SlBitmap[TLSF_FL_COUNT] = {};
+	UINT m_FreeHeads[TLSF_FL_COUNT][TLSF_SL_COUNT];
+
+	UINT m_First = TLSF_NULL_BLOCK;
+	UINT64 m_Size = 0;
+	UINT64 m_Used = 0;
+	UINT m_UsedBlocks = 0;
+
+	UINT64 m_Merges = 0;
+	UINT64 m_Splits = 0;
+	UINT64 m_Failed = 0;
+};
+
+//CPU :   ( , , )
+//   Allocate/Free     
+// .   OutputDebugString
+void Verify_Tlsf_Allocator();
+
+//     : TLSF  first fit 
+//   ,  ,  
+//   
+void Benchmark_Tlsf_Allocator();
+
+#endif
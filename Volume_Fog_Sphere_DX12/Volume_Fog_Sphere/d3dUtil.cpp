@@ -3,6 +3,9 @@
 //======================================================================================
 
 #include "d3dUtil.h"
+#include "UploadBatch.h"
+#include "HeapAllocator.h"
+#include "AssetCache.h"
 
 DxException::DxException(HRESULT hr, const std::wstring& functionName, const std::wstring& Filename, int lineNumber) :
 	ErrorCode(hr),
@@ -34,6 +37,28 @@ Microsoft::WRL::ComPtr<ID3DBlob> d3dUtil::CompileShader(
 	HRESULT hr = S_OK;
 
 	Microsoft::WRL::ComPtr<ID3DBlob> byteCode = nullptr;
+
+	//      ,  , , 
+	// .   #include    :   
+	//    ,     .hlsl    Asset_Cache_Clear
+	UINT64 Key = Hash_Bytes(Entrypoint.c_str(), Entrypoint.size() + 1);
+	Key = Hash_Bytes(Target.c_str(), Target.size() + 1, Key);
+	Key = Hash_Bytes(&compileFlags, sizeof(compileFlags), Key);
+
+	for (const D3D_SHADER_MACRO* Define = Defines; Define != nullptr && Define->Name != nullptr; Define++)
+	{
+		Key = Hash_Bytes(Define->Name, strlen(Define->Name) + 1, Key);
+		if (Define->Definition != nullptr)
+			Key = Hash_Bytes(Define->Definition, strlen(Define->Definition) + 1, Key);
+	}
+
+	std::wstring CachedFilename;
+	bool Hit = false;
+	bool Cacheable = Asset_Cache_Lookup(ASSET_SHADER, Filename, Key, CachedFilename, Hit);
+
+	if (Hit && SUCCEEDED(D3DReadFileToBlob(CachedFilename.c_str(), &byteCode)))
+		return byteCode;
+
 	Microsoft::WRL::ComPtr<ID3DBlob> errors;
 	hr = D3DCompileFromFile(Filename.c_str(), Defines, D3D_COMPILE_STANDARD_FILE_INCLUDE,
 		Entrypoint.c_str(), Target.c_str(), compileFlags, 0, &byteCode, &errors);
@@ -43,44 +68,29 @@ Microsoft::WRL::ComPtr<ID3DBlob> d3dUtil::CompileShader(
 
 	ThrowIfFailed(hr);
 
+	if (Cacheable)
+	{
+		std::wstring TempFilename = Asset_Cache_Temp_Filename(CachedFilename);
+		if (SUCCEEDED(D3DWriteBlobToFile(byteCode.Get(), TempFilename.c_str(), TRUE)))
+			Asset_Cache_Commit(TempFilename, CachedFilename);
+	}
+
 	return byteCode;
 }
 
 Microsoft::WRL::ComPtr<ID3D12Resource> d3dUtil::CreateDefaultBuffer(
 	ID3D12Device* device,
-	ID3D12GraphicsCommandList* cmdList,
 	const void* initData,
 	UINT64 byteSize,
-	Microsoft::WRL::ComPtr<ID3D12Resource>& UploadBuffer)
+	CUploadBatch& UploadBatch,
+	CHeapAllocator& HeapAllocator)
 {
-	Microsoft::WRL::ComPtr<ID3D12Resource> defaultBuffer;
-
-	ThrowIfFailed(device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(byteSize),
-		D3D12_RESOURCE_STATE_COMMON,
-		nullptr,
-		IID_PPV_ARGS(defaultBuffer.GetAddressOf())));
-
-	ThrowIfFailed(device->CreateCommittedResource(
-		&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-		D3D12_HEAP_FLAG_NONE,
-		&CD3DX12_RESOURCE_DESC::Buffer(byteSize),
-		D3D12_RESOURCE_STATE_GENERIC_READ,
-		nullptr,
-		IID_PPV_ARGS(UploadBuffer.GetAddressOf())));
-
-	D3D12_SUBRESOURCE_DATA subResourceData = {};
-	subResourceData.pData = initData;
-	subResourceData.RowPitch = (LONG_PTR)byteSize;
-	subResourceData.SlicePitch = subResourceData.RowPitch;
-
-	cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(defaultBuffer.Get(),
-		D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST));
-	UpdateSubresources<1>(cmdList, defaultBuffer.Get(), UploadBuffer.Get(), 0, 0, 1, &subResourceData);
-	cmdList->ResourceBarrier(1, &CD3DX12_RESOURCE_BARRIER::Transition(defaultBuffer.Get(),
-		D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_GENERIC_READ));
+	//      default ,    committed 
+	Microsoft::WRL::ComPtr<ID3D12Resource> defaultBuffer =
+		HeapAllocator.Create_Buffer(byteSize, D3D12_RESOURCE_STATE_COMMON);
+
+	//    upload ,     
+	UploadBatch.Upload_Buffer(defaultBuffer.Get(), initData, byteSize, D3D12_RESOURCE_STATE_GENERIC_READ);
 
 	return defaultBuffer;
 }
@@ -14,6 +14,9 @@
 
 #pragma comment(lib,"d3dcompiler.lib")
 
+class CUploadBatch;
+class CHeapAllocator;
+
 class DxException
 {
 public:
@@ -35,6 +38,13 @@ inline std::wstring AnsiToWString(const std::string& str)
 	return std::wstring(buffer);
 }
 
+inline std::string WStringToAnsi(const std::wstring& str)
+{
+	char buffer[512];
+	WideCharToMultiByte(CP_ACP, 0, str.c_str(), -1, buffer, 512, nullptr, nullptr);
+	return std::string(buffer);
+}
+
 #ifndef ThrowIfFailed
 #define ThrowIfFailed(x)                                              \
 {                                                                     \
@@ -55,10 +65,10 @@ public:
 
 	static Microsoft::WRL::ComPtr<ID3D12Resource> CreateDefaultBuffer(
 		ID3D12Device* device,
-		ID3D12GraphicsCommandList* cmdList,
 		const void* initData,
 		UINT64 byteSize,
-		Microsoft::WRL::ComPtr<ID3D12Resource>& UploadBuffer);
+		CUploadBatch& UploadBatch,
+		CHeapAllocator& HeapAllocator);
 
 	static Microsoft::WRL::ComPtr<ID3DBlob> CompileShader(
 		const std::wstring& Filename,
@@ -0,0 +1,114 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Frame Scheduler DirectX12
+//======================================================================================
+
+#ifndef _FRAMESCHEDULER_
+#define _FRAMESCHEDULER_
+
+#include <windows.h>
+#include <functional>
+
+#include "d3dUtil.h"
+
+// frame resources   
+#define FRAME_SCHEDULER_MAX_FRAMES 8
+
+//  fence   ,     .
+//  -      
+class CFenceEvent
+{
+public:
+	CFenceEvent();
+	~CFenceEvent();
+
+	CFenceEvent(const CFenceEvent& rhs) = delete;
+	CFenceEvent& operator=(const CFenceEvent& rhs) = delete;
+
+	void Wait(ID3D12Fence* Fence, UINT64 Value);
+
+private:
+	HANDLE m_Event = nullptr;
+};
+
+struct FrameSchedulerStats
+{
+	UINT64 Frames = 0;
+	//Begin_Frame,    GPU
+	UINT64 Waits = 0;
+	double WaitMs = 0.0;
+	//Flush -    (, , )
+	UINT64 Flushes = 0;
+	UINT PeakInFlight = 0;
+};
+
+//  CPU -> GPU:  ExecuteCommandLists  
+//  fence (End_Frame)  CPU   , 
+//  Begin_Frame,      GPU  
+// Frames_In_Flight .  fence     ,
+//Signal/Flush       .
+//Queue  Fence == nullptr - GPU  : Mock_Complete
+//  , MockWait   
+class CFrameScheduler
+{
+public:
+	CFrameScheduler() = default;
+
+	CFrameScheduler(const CFrameScheduler& rhs) = delete;
+	CFrameScheduler& operator=(const CFrameScheduler& rhs) = delete;
+
+	//FrameCount -  frame resources,     
+	void Init(ID3D12CommandQueue* Queue, ID3D12Fence* Fence, UINT FrameCount);
+
+	//1 - CPU  GPU  , FrameCount -  
+	void Set_Frames_In_Flight(UINT Count);
+	UINT Frames_In_Flight() const;
+
+	//   ,   frame resource
+	UINT Begin_Frame();
+	// ExecuteCommandLists  Present,  fence 
+	UINT64 End_Frame();
+
+	//Signal  ,   
+	UINT64 Signal();
+	void Wait(UINT64 Value);
+	//Signal    
+	void Flush();
+
+	UINT64 Current_Fence() const;
+	UINT64 Completed_Fence() const;
+	UINT Frame_Index() const;
+
+	void Mock_Complete(UINT64 Value);
+	void Set_Mock_Wait(std::function<void(UINT64)> MockWait);
+
+	const FrameSchedulerStats& Get_Stats() const;
+	void Report(const char* Name);
+
+private:
+	ID3D12CommandQueue* m_Queue = nullptr;
+	ID3D12Fence* m_Fence = nullptr;
+
+	UINT m_FrameCount = 1;
+	UINT m_FramesInFlight = 1;
+	UINT m_FrameIndex = 0;
+
+	UINT64 m_CurrentFence = 0;
+	//fence     frame resource, 0 -  
+	UINT64 m_FrameFence[FRAME_SCHEDULER_MAX_FRAMES] = {};
+
+	CFenceEvent m_FenceEvent;
+
+	UINT64 m_MockCompleted = 0;
+	std::function<void(UINT64)> m_MockWait;
+
+	FrameSchedulerStats m_Stats;
+};
+
+//CPU  : CPU    CpuMs, GPU   GpuMs,
+//  .   1   CpuMs + GpuMs,  2-3
+//CPU  GPU ; frame resource  ,  fence 
+//   ,    Frames_In_Flight .
+//  OutputDebugString
+void Verify_Frame_Scheduler();
+
+#endif
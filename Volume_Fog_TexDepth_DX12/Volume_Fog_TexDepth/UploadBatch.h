@@ -0,0 +1,88 @@
+//======================================================================================
+//	Ed Kurlyak 2023 Upload Batch DirectX12
+//======================================================================================
+
+#ifndef _UPLOADBATCH_
+#define _UPLOADBATCH_
+
+#include <windows.h>
+#include <vector>
+
+#include "d3dUtil.h"
+#include "UploadRing.h"
+
+struct UploadBatchStats
+{
+	UINT Resources = 0;
+	UINT Copies = 0;
+	UINT Barriers = 0;
+	UINT BarrierCalls = 0;
+	//      
+	UINT Records = 0;
+};
+
+//       :  
+//  upload ,     Record -
+//  COPY_DEST   ResourceBarrier, ,
+//     .   
+//    
+class CUploadBatch
+{
+public:
+	CUploadBatch() = default;
+
+	CUploadBatch(const CUploadBatch& rhs) = delete;
+	CUploadBatch& operator=(const CUploadBatch& rhs) = delete;
+
+	void Init(CUploadRing* UploadRing);
+
+	//  COPY_DEST      After  ,
+	//Before == COPY_DEST -     
+	void Add_Resource(ID3D12Resource* Resource, D3D12_RESOURCE_STATES Before, D3D12_RESOURCE_STATES After);
+
+	//   COMMON,    upload  
+	void Upload_Buffer(ID3D12Resource* Dst, const void* Data, UINT64 Size, D3D12_RESOURCE_STATES After);
+
+	UploadAllocation Allocate_Texture(const D3D12_RESOURCE_DESC& Desc,
+		D3D12_PLACED_SUBRESOURCE_FOOTPRINT* Footprints);
+
+	void Copy_Texture_Region(const D3D12_TEXTURE_COPY_LOCATION& Dst, UINT DstX, UINT DstY,
+		const D3D12_TEXTURE_COPY_LOCATION& Src);
+
+	//   CmdList   
+	void Record(ID3D12GraphicsCommandList* CmdList);
+
+	const UploadBatchStats& Get_Stats() const;
+
+	//  Init,  upload    
+	void Report(const char* Name);
+
+private:
+	struct BufferCopy
+	{
+		ID3D12Resource* Dst;
+		ID3D12Resource* Src;
+		UINT64 SrcOffset;
+		UINT64 Size;
+	};
+
+	struct TextureCopy
+	{
+		D3D12_TEXTURE_COPY_LOCATION Dst;
+		UINT DstX;
+		UINT DstY;
+		D3D12_TEXTURE_COPY_LOCATION Src;
+	};
+
+	CUploadRing* m_UploadRing = nullptr;
+
+	std::vector<D3D12_RESOURCE_BARRIER> m_Before;
+	std::vector<D3D12_RESOURCE_BARRIER> m_After;
+	std::vector<BufferCopy> m_BufferCopies;
+	std::vector<TextureCopy> m_TextureCopies;
+
+	UploadBatchStats m_Stats;
+	double m_StartMs = 0.0;
+};
+
+#endif